@@ -0,0 +1,275 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Feeds the audio_data.h sample clip through the per-sample audio front end that
+ * audio_task used to run and through the block front end (audio_pcm_to_float() and
+ * batched IMAI_AED_enqueue() calls with one IMAI_AED_dequeue() check per hop),
+ * and compares throughput and predictions.
+ *
+ * The DEEPCRAFT libraries are only available for Arm, so a stand-in model with the
+ * same queue API is used. It works like the cough and baby cry libraries do:
+ * IMAI_AED_enqueue() copies the sample into a buffer of exactly one input window
+ * (512 samples) and refuses it while the buffer is full, and IMAI_AED_dequeue()
+ * takes the features of one window and advances by the model hop (160 samples)
+ * when the buffer is full, with a prediction every 15 windows. A check must
+ * therefore fall on every sample count at which the buffer fills, which any hop
+ * dividing both 512 and 160 does.
+ * Exits with a non-zero status if the block path with such a dequeue hop predicts
+ * differently from the per-sample path or drops samples.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio_frontend.h"
+#include "audio_data.h"
+
+#include "bench_util.h"
+
+#define FRAME_SIZE              (1024u)
+#define DIGITAL_BOOST_FACTOR    (1.0f)
+#define DEFAULT_ITERATIONS      (20u)
+
+#define CLIP_SAMPLES            ((uint32_t) (sizeof(audio_data) / sizeof(audio_data[0])))
+#define CLIP_FRAMES             (CLIP_SAMPLES / FRAME_SIZE)
+
+/* Stand-in for the DEEPCRAFT AED library */
+#define IMAI_RET_SUCCESS        0
+#define IMAI_RET_NODATA         -1
+#define IMAI_RET_NOMEM          -2
+#define IMAI_DATA_OUT_COUNT     2
+
+#define MODEL_WINDOW            (512u)
+#define MODEL_HOP               (160u)
+#define MODEL_FEATURES          (40u)
+#define MODEL_FEATURE_HOP       (15u)
+/* AUDIO_DEQUEUE_HOP of audio.c for the cough and baby cry models */
+#define DEFAULT_DEQUEUE_HOP     (32u)
+
+static struct {
+    float window[MODEL_WINDOW];
+    uint32_t used;
+    uint32_t read;
+    uint32_t write;
+    float features[MODEL_FEATURES];
+    uint32_t n_features;
+    uint32_t since_output;
+    float threshold;
+    uint32_t dropped;
+} model;
+
+static void IMAI_AED_init(void) {
+    float threshold = model.threshold;
+    memset(&model, 0, sizeof(model));
+    model.threshold = threshold;
+}
+
+__attribute__((noinline)) static int IMAI_AED_enqueue(const float *restrict data_in) {
+    if (model.used == MODEL_WINDOW) {
+        model.dropped++;
+        return IMAI_RET_NOMEM;
+    }
+    model.window[model.write] = *data_in;
+    model.write = (model.write + 1) % MODEL_WINDOW;
+    model.used++;
+    return IMAI_RET_SUCCESS;
+}
+
+__attribute__((noinline)) static int IMAI_AED_dequeue(int *restrict data_out) {
+    if (model.used < MODEL_WINDOW) {
+        return IMAI_RET_NODATA;
+    }
+    // The buffer holds exactly one window, its order does not matter for the energy
+    double energy = 0.0;
+    for (uint32_t i = 0; i < MODEL_WINDOW; i++) {
+        energy += (double) model.window[i] * model.window[i];
+    }
+    model.read = (model.read + MODEL_HOP) % MODEL_WINDOW;
+    model.used -= MODEL_HOP;
+    model.features[model.n_features % MODEL_FEATURES] = (float) (energy / MODEL_WINDOW);
+    model.n_features++;
+    if (model.n_features < MODEL_FEATURES || ++model.since_output < MODEL_FEATURE_HOP) {
+        return IMAI_RET_NODATA;
+    }
+    model.since_output = 0;
+    double mean = 0.0;
+    for (uint32_t i = 0; i < MODEL_FEATURES; i++) {
+        mean += model.features[i];
+    }
+    int label = (mean / MODEL_FEATURES) > model.threshold;
+    data_out[0] = !label;
+    data_out[1] = label;
+    return IMAI_RET_SUCCESS;
+}
+
+typedef struct {
+    uint8_t *labels;
+    uint32_t n;
+    uint32_t capacity;
+} predictions_t;
+
+static void record(predictions_t *p, const int *label_scores) {
+    if (p->n < p->capacity) {
+        p->labels[p->n] = (uint8_t) (label_scores[1] == 1);
+    }
+    p->n++;
+}
+
+/* The loop audio_task used to run */
+static void process_per_sample(const int16_t *buffer, predictions_t *p) {
+    int label_scores[IMAI_DATA_OUT_COUNT];
+    for (uint32_t index = 0; index < FRAME_SIZE; index++) {
+        int16_t val_temp = buffer[index];
+        float data_in = (((float) val_temp) / (float) (1 << 15)) * DIGITAL_BOOST_FACTOR;
+        if (data_in > 1.0) {
+            data_in = 1.0f;
+        } else if (data_in < -1.0) {
+            data_in = -1.0f;
+        }
+        (void) IMAI_AED_enqueue(&data_in);
+        if (IMAI_AED_dequeue(label_scores) == IMAI_RET_SUCCESS) {
+            record(p, label_scores);
+        }
+    }
+}
+
+/* The loop audio_task runs now */
+static void process_block(const int16_t *buffer, float *block, uint32_t hop, predictions_t *p) {
+    int label_scores[IMAI_DATA_OUT_COUNT];
+    audio_pcm_to_float(buffer, block, FRAME_SIZE, DIGITAL_BOOST_FACTOR);
+    for (uint32_t index = 0; index < FRAME_SIZE; index += hop) {
+        for (uint32_t i = 0; i < hop; i++) {
+            (void) IMAI_AED_enqueue(&block[index + i]);
+        }
+        if (IMAI_AED_dequeue(label_scores) == IMAI_RET_SUCCESS) {
+            record(p, label_scores);
+        }
+    }
+}
+
+/* Runs the clip through one path, returns ns per frame of the fastest iteration */
+static double run_path(const int16_t *pcm, uint32_t hop, uint32_t iterations, predictions_t *p) {
+    float *block = malloc(sizeof(float) * FRAME_SIZE);
+    uint64_t best_ns = UINT64_MAX;
+    for (uint32_t it = 0; it < iterations; it++) {
+        IMAI_AED_init();
+        p->n = 0;
+        uint64_t t0 = bench_now_ns();
+        for (uint32_t fr = 0; fr < CLIP_FRAMES; fr++) {
+            const int16_t *buffer = pcm + (size_t) fr * FRAME_SIZE;
+            if (hop == 0) {
+                process_per_sample(buffer, p);
+            } else {
+                process_block(buffer, block, hop, p);
+            }
+        }
+        uint64_t ns = bench_now_ns() - t0;
+        best_ns = ns < best_ns ? ns : best_ns;
+    }
+    free(block);
+    return (double) best_ns / CLIP_FRAMES;
+}
+
+static double time_front_end(const int16_t *pcm, bool block_path, uint32_t iterations, float *out) {
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t it = 0; it < iterations; it++) {
+        for (uint32_t fr = 0; fr < CLIP_FRAMES; fr++) {
+            const int16_t *buffer = pcm + (size_t) fr * FRAME_SIZE;
+            float *dst = out + (size_t) fr * FRAME_SIZE;
+            if (block_path) {
+                audio_pcm_to_float(buffer, dst, FRAME_SIZE, DIGITAL_BOOST_FACTOR);
+            } else {
+                audio_pcm_to_float_ref(buffer, dst, FRAME_SIZE, DIGITAL_BOOST_FACTOR);
+            }
+        }
+    }
+    return (double) (bench_now_ns() - t0) / ((double) iterations * CLIP_FRAMES);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    uint32_t channel = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (0 == strcmp(argv[i], "-n") && i + 1 < argc) {
+            iterations = (uint32_t) atoi(argv[++i]);
+        } else if (0 == strcmp(argv[i], "-c") && i + 1 < argc) {
+            channel = (uint32_t) atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [-n iterations] [-c channel 0..3]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (iterations == 0 || channel > 3) {
+        fprintf(stderr, "Usage: %s [-n iterations] [-c channel 0..3]\n", argv[0]);
+        return 1;
+    }
+
+    // The clip holds normalized microphone samples, turn them back into the PDM/PCM output.
+    // Boost quiet recordings so that the clamp is exercised too.
+    int16_t *pcm = malloc(sizeof(int16_t) * CLIP_FRAMES * FRAME_SIZE);
+    float peak = 0.0f;
+    for (uint32_t i = 0; i < CLIP_FRAMES * FRAME_SIZE; i++) {
+        peak = fmaxf(peak, fabsf(audio_data[i][channel]));
+    }
+    float gain = peak > 0.0f ? 1.2f / peak : 1.0f;
+    double mean_energy = 0.0;
+    for (uint32_t i = 0; i < CLIP_FRAMES * FRAME_SIZE; i++) {
+        float x = fmaxf(-1.0f, fminf(1.0f, audio_data[i][channel] * gain));
+        pcm[i] = (int16_t) lrintf(x * 32767.0f);
+        mean_energy += (double) x * x;
+    }
+    // Windows above the clip's average energy are the "event"
+    model.threshold = (float) (mean_energy / (CLIP_FRAMES * FRAME_SIZE));
+
+    printf("Audio clip: %u frames of %u samples, channel %u, %u iterations, model window %u, hop %u\n",
+        CLIP_FRAMES, FRAME_SIZE, channel, iterations, MODEL_WINDOW, MODEL_HOP);
+
+    float *ref = malloc(sizeof(float) * CLIP_FRAMES * FRAME_SIZE);
+    float *blk = malloc(sizeof(float) * CLIP_FRAMES * FRAME_SIZE);
+    double ref_ns = time_front_end(pcm, false, iterations, ref);
+    double blk_ns = time_front_end(pcm, true, iterations, blk);
+    bool ok = 0 == memcmp(ref, blk, sizeof(float) * CLIP_FRAMES * FRAME_SIZE);
+    printf("front end     per-sample %8.1f ns/frame   block %8.1f ns/frame   %s\n",
+        ref_ns, blk_ns, ok ? "identical" : "MISMATCH");
+
+    const uint32_t capacity = CLIP_FRAMES * FRAME_SIZE / (MODEL_HOP * MODEL_FEATURE_HOP) + 1;
+    predictions_t expected = {.labels = calloc(capacity, 1), .capacity = capacity};
+    double per_sample_ns = run_path(pcm, 0, iterations, &expected);
+    uint32_t detections = 0;
+    for (uint32_t i = 0; i < expected.n && i < capacity; i++) {
+        detections += expected.labels[i];
+    }
+    printf("per-sample    %8.1f ns/frame   %u predictions, %u detections, %u samples dropped\n",
+        per_sample_ns, expected.n, detections, model.dropped);
+    ok = ok && 0 == model.dropped;
+
+    const uint32_t hops[] = {1, 16, DEFAULT_DEQUEUE_HOP, 64, 256};
+    for (size_t h = 0; h < sizeof(hops) / sizeof(hops[0]); h++) {
+        predictions_t got = {.labels = calloc(capacity, 1), .capacity = capacity};
+        double ns = run_path(pcm, hops[h], iterations, &got);
+        bool same = got.n == expected.n && 0 == memcmp(got.labels, expected.labels, expected.n);
+        // Hops at which the buffer fills must not drop samples or change the predictions
+        bool must_match = (MODEL_WINDOW % hops[h]) == 0 && (MODEL_HOP % hops[h]) == 0;
+        printf("block hop %4u %7.1f ns/frame   %.2fx   %u predictions, %u samples dropped, %s%s\n",
+            hops[h], ns, per_sample_ns / ns, got.n, model.dropped, same ? "same predictions" : "predictions differ",
+            hops[h] == DEFAULT_DEQUEUE_HOP ? " (default)" : must_match ? "" : " (misses the full buffer, expected)");
+        if (must_match && (!same || model.dropped != 0)) {
+            ok = false;
+        }
+        free(got.labels);
+    }
+
+    printf("audio_bench %s\n", ok ? "OK" : "FAILED");
+    free(expected.labels);
+    free(ref);
+    free(blk);
+    free(pcm);
+    return ok ? 0 : 1;
+}
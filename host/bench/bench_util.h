@@ -0,0 +1,169 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Small timing, reporting and test data helpers shared by the host benchmarks. */
+
+#ifndef HOST_BENCH_UTIL_H
+#define HOST_BENCH_UTIL_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+static inline uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+// Time stamp counter ticks on x86, nanoseconds elsewhere
+static inline uint64_t bench_now_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return bench_now_ns();
+#endif
+}
+
+#define BENCH_MAX_STAGES 16
+
+typedef struct {
+    const char *name;
+    uint64_t ns;
+    uint64_t cycles;
+    uint32_t count;
+} bench_stage_t;
+
+typedef struct {
+    bench_stage_t stages[BENCH_MAX_STAGES];
+    int n_stages;
+    uint64_t last_ns;
+    uint64_t last_cycles;
+} bench_stages_t;
+
+static inline void bench_stages_reset(bench_stages_t *s) {
+    memset(s, 0, sizeof(*s));
+}
+
+static inline void bench_stages_start(bench_stages_t *s) {
+    s->last_ns = bench_now_ns();
+    s->last_cycles = bench_now_cycles();
+}
+
+static inline void bench_stages_mark(bench_stages_t *s, const char *name) {
+    uint64_t now_ns = bench_now_ns();
+    uint64_t now_cycles = bench_now_cycles();
+    int i;
+    for (i = 0; i < s->n_stages; i++) {
+        if (s->stages[i].name == name || 0 == strcmp(s->stages[i].name, name)) {
+            break;
+        }
+    }
+    if (i == s->n_stages) {
+        if (s->n_stages == BENCH_MAX_STAGES) {
+            return;
+        }
+        s->stages[i].name = name;
+        s->n_stages++;
+    }
+    s->stages[i].ns += now_ns - s->last_ns;
+    s->stages[i].cycles += now_cycles - s->last_cycles;
+    s->stages[i].count++;
+    s->last_ns = now_ns;
+    s->last_cycles = now_cycles;
+}
+
+// Accumulated time of one stage, 0 if it was never marked
+static inline uint64_t bench_stages_ns(const bench_stages_t *s, const char *name) {
+    for (int i = 0; i < s->n_stages; i++) {
+        if (0 == strcmp(s->stages[i].name, name)) {
+            return s->stages[i].ns;
+        }
+    }
+    return 0;
+}
+
+static inline void bench_stages_print(const bench_stages_t *s, uint32_t n_frames) {
+    uint64_t total_ns = 0;
+    for (int i = 0; i < s->n_stages; i++) {
+        total_ns += s->stages[i].ns;
+    }
+    for (int i = 0; i < s->n_stages; i++) {
+        printf("    %-16s %10.1f ns %12.1f cyc %6.1f%%\n",
+            s->stages[i].name,
+            (double) s->stages[i].ns / n_frames,
+            (double) s->stages[i].cycles / n_frames,
+            total_ns ? 100.0 * (double) s->stages[i].ns / (double) total_ns : 0.0
+        );
+    }
+}
+
+#ifdef PREPROC_PROFILE
+// Where preproc_profile_stage() times the stages of the preprocessing library, not timed while NULL
+static bench_stages_t *bench_preproc_stages;
+
+// Called by the preprocessing library, built with PREPROC_PROFILE, at the end of every stage.
+// Defined here once for each benchmark program that links the library
+void preproc_profile_stage(const char *stage_name) {
+    if (NULL != bench_preproc_stages) {
+        bench_stages_mark(bench_preproc_stages, stage_name);
+    }
+}
+#endif
+
+// Uniform in [0, n) from rand()
+static inline uint32_t bench_rand_below(uint32_t n) {
+    return (uint32_t) (((uint64_t) rand() * n) / ((uint64_t) RAND_MAX + 1U));
+}
+
+#define BENCH_RX_ANTENNAS 3
+
+/* Deinterleaved raw frames [antenna][chirp][sample] in ADC counts, of a target sweeping through
+ * range and velocity in front of the leakage of the antennas. Its Doppler bin goes up to
+ * doppler_scale * n_chirps. With reflector_bin > 0, a static reflector stands at that range bin. */
+static inline float *bench_synthesize_frames(uint32_t n_frames, uint16_t n_chirps, uint16_t n_samples,
+                                             double doppler_scale, double reflector_bin) {
+    uint32_t frame_size = BENCH_RX_ANTENNAS * n_chirps * n_samples;
+    float *frames = malloc(sizeof(float) * frame_size * n_frames);
+    uint32_t lcg = 12345;
+    const double antenna_phase[BENCH_RX_ANTENNAS] = {0.0, 0.6, 0.25};
+    double n_range_bins = n_samples / 2;
+    if (NULL == frames) {
+        return NULL;
+    }
+    for (uint32_t fr = 0; fr < n_frames; fr++) {
+        double t = (double) fr / (double) n_frames;
+        double range_bin = n_range_bins * (0.25 + 0.15 * sin(2.0 * M_PI * t));
+        double doppler = doppler_scale * cos(2.0 * M_PI * t);
+        float *frame = frames + (size_t) fr * frame_size;
+        for (int a = 0; a < BENCH_RX_ANTENNAS; a++) {
+            for (int c = 0; c < n_chirps; c++) {
+                for (int s = 0; s < n_samples; s++) {
+                    lcg = lcg * 1103515245u + 12345u;
+                    double noise = ((double) ((lcg >> 16) & 0x3FF) - 512.0) * 0.05;
+                    double phase = 2.0 * M_PI * range_bin * s / n_samples
+                                   + 2.0 * M_PI * doppler * c + antenna_phase[a];
+                    double leakage = 300.0 * cos(2.0 * M_PI * 2.0 * s / n_samples);
+                    double v = 2048.0 + 600.0 * cos(phase) + leakage;
+                    if (reflector_bin > 0.0) {
+                        v += 800.0 * cos(2.0 * M_PI * reflector_bin * s / n_samples + 1.0 + antenna_phase[a]);
+                    }
+                    v += noise;
+                    frame[(a * n_chirps + c) * n_samples + s] = (float) fmin(fmax(v, 0.0), 4095.0);
+                }
+            }
+        }
+    }
+    return frames;
+}
+
+#endif // HOST_BENCH_UTIL_H
@@ -0,0 +1,241 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Compares the background level estimators of algo (bg_level_mode) with the
+ * qsort median they replaced, on the masked mean RDIs of replayed frames.
+ *
+ * Frames are read from a raw capture of the sensor FIFO, as for radar_bench
+ * (-f capture.bin). Without a capture file, a deterministic synthetic
+ * recording of a moving target is generated instead. Each frame is run
+ * through algo once to get its masked mean RDI, then every estimator is
+ * timed on the same images and its level compared with the qsort median.
+ * algo is also run end to end in every mode to count the frames whose hand
+ * detection differs from the exact median.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "preprocess.h"
+
+#include "bench_util.h"
+#include "radar_frames.h"
+
+#define DEFAULT_SYNTHETIC_FRAMES    (256)
+#define DEFAULT_ITERATIONS          (50)
+// Largest relative error accepted from the histogram estimator on any frame
+#define HISTOGRAM_MAX_ERROR         (0.02)
+// Largest median relative error accepted from the streaming estimator
+#define STREAMING_MEDIAN_ERROR      (0.10)
+
+// The estimator algo used before bg_level_mode, without its malloc
+static int compare_f32(const void *a, const void *b) {
+    float fa = *(const float *) a;
+    float fb = *(const float *) b;
+    return (fa > fb) - (fa < fb);
+}
+
+static float qsort_background_level(const float *img, float *tmp, uint32_t len) {
+    memcpy(tmp, img, len * sizeof(float));
+    qsort(tmp, len, sizeof(float), compare_f32);
+    uint32_t idx = 0;
+    while (idx < len && !(tmp[idx] > 0.0f)) {
+        idx++;
+    }
+    if (idx == len) {
+        return 0.0f;
+    }
+    uint32_t n = len - idx;
+    if (n % 2 == 0) {
+        return (tmp[idx + n / 2 - 1] + tmp[idx + n / 2]) / 2;
+    }
+    return tmp[idx + n / 2];
+}
+
+typedef struct {
+    const char *name;
+    double ns_per_frame;
+    double mean_error;
+    double median_error;
+    double max_error;
+    uint32_t n_exact;
+    uint32_t n_success;
+    uint32_t detection_mismatches;
+} estimator_result_t;
+
+static int compare_f64(const void *a, const void *b) {
+    double da = *(const double *) a;
+    double db = *(const double *) b;
+    return (da > db) - (da < db);
+}
+
+static const frame_cfg f_cfg = {
+    .n_channels = NUM_RX_ANTENNAS,
+    .n_chirps = NUM_CHIRPS_PER_FRAME,
+    .n_samples = NUM_SAMPLES_PER_CHIRP,
+    .n_range_bins = NUM_SAMPLES_PER_CHIRP / 2
+};
+
+// Runs algo over all frames with the estimator in mode. Stores the masked mean RDIs if images is not NULL
+static void run_algo(bg_level_mode mode, const uint16_t *frames, uint32_t n_frames, float *images,
+                     detection *hands) {
+    frame_cfg cfg = f_cfg;
+    uint32_t img_len = (uint32_t) cfg.n_chirps * cfg.n_range_bins;
+    algo_workspace ws = new_algo_workspace(&cfg);
+    init_bg_level_estimator(&ws.bg_level, mode, ws.bg_level.histogram);
+    estimate_human_cfg h_cfg = {.position_min = 3, .position_current = -1.0f, .alpha = 0.1f};
+    float *frame = malloc(sizeof(float) * NUM_SAMPLES_PER_FRAME);
+    for (uint32_t fr = 0; fr < n_frames; fr++) {
+        deinterleave_antennas(frames + (size_t) fr * NUM_SAMPLES_PER_FRAME, frame);
+        algo_output out;
+        algo(&out, frame, &cfg, &h_cfg, 2, 8, 3, 2, 2, 1, DETECTION_MODE_CLOSEST, 2.0f, &ws);
+        hands[fr] = out.success ? out.hand_features.detection
+                                : (detection) {.doppler_bin = UINT16_MAX, .range_bin = UINT16_MAX};
+        if (images) {
+            memcpy(images + (size_t) fr * img_len, ws.masked_mean_abs_rdi, sizeof(float) * img_len);
+        }
+    }
+    free(frame);
+    free_algo_workspace(&ws);
+}
+
+static void evaluate(estimator_result_t *res, bool use_qsort, bg_level_mode mode, const float *images,
+                     const float *reference, uint32_t n_frames, uint32_t iterations) {
+    uint32_t img_len = (uint32_t) f_cfg.n_chirps * f_cfg.n_range_bins;
+    float *scratch = malloc(sizeof(float) * img_len);
+    uint32_t histogram[BG_LEVEL_HISTOGRAM_BINS];
+    double *errors = malloc(sizeof(double) * n_frames);
+    bg_level_estimator est;
+    // Keeps the timed calls from being optimized out
+    volatile float sink = 0.0f;
+
+    uint64_t total_ns = 0;
+    for (uint32_t it = 0; it < iterations; it++) {
+        // The streaming level carries over between frames, not between iterations
+        init_bg_level_estimator(&est, mode, histogram);
+        uint64_t t0 = bench_now_ns();
+        for (uint32_t fr = 0; fr < n_frames; fr++) {
+            const float *img = images + (size_t) fr * img_len;
+            sink += use_qsort ? qsort_background_level(img, scratch, img_len)
+                              : estimate_background_level(img, &f_cfg, &est, scratch);
+        }
+        total_ns += bench_now_ns() - t0;
+    }
+    res->ns_per_frame = (double) total_ns / ((double) n_frames * iterations);
+
+    init_bg_level_estimator(&est, mode, histogram);
+    res->mean_error = 0.0;
+    res->max_error = 0.0;
+    res->n_exact = 0;
+    for (uint32_t fr = 0; fr < n_frames; fr++) {
+        const float *img = images + (size_t) fr * img_len;
+        float level = use_qsort ? qsort_background_level(img, scratch, img_len)
+                                : estimate_background_level(img, &f_cfg, &est, scratch);
+        if (0 == memcmp(&level, &reference[fr], sizeof(level))) {
+            res->n_exact++;
+        }
+        errors[fr] = reference[fr] > 0.0f ? fabs((double) level - reference[fr]) / reference[fr]
+                                          : fabs((double) level);
+        res->mean_error += errors[fr] / n_frames;
+        res->max_error = fmax(res->max_error, errors[fr]);
+    }
+    qsort(errors, n_frames, sizeof(double), compare_f64);
+    res->median_error = errors[n_frames / 2];
+    free(errors);
+    free(scratch);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-f capture.bin] [-n iterations] [-s synthetic_frames]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    const char *capture = NULL;
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    uint32_t n_frames = DEFAULT_SYNTHETIC_FRAMES;
+
+    for (int i = 1; i < argc; i++) {
+        if (0 == strcmp(argv[i], "-f") && i + 1 < argc) {
+            capture = argv[++i];
+        } else if (0 == strcmp(argv[i], "-n") && i + 1 < argc) {
+            iterations = (uint32_t) atoi(argv[++i]);
+        } else if (0 == strcmp(argv[i], "-s") && i + 1 < argc) {
+            n_frames = (uint32_t) atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (iterations == 0 || n_frames == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    uint16_t *frames = capture ? load_frames(capture, &n_frames) : synthesize_frames(n_frames);
+    if (!frames) {
+        return 1;
+    }
+    uint32_t img_len = (uint32_t) f_cfg.n_chirps * f_cfg.n_range_bins;
+    float *images = malloc(sizeof(float) * img_len * n_frames);
+    float *reference = malloc(sizeof(float) * n_frames);
+    float *scratch = malloc(sizeof(float) * img_len);
+    detection *exact_hands = malloc(sizeof(detection) * n_frames);
+    detection *hands = malloc(sizeof(detection) * n_frames);
+
+    run_algo(BG_LEVEL_EXACT, frames, n_frames, images, exact_hands);
+    for (uint32_t fr = 0; fr < n_frames; fr++) {
+        reference[fr] = qsort_background_level(images + (size_t) fr * img_len, scratch, img_len);
+    }
+
+    estimator_result_t results[] = {
+        {.name = "qsort"},
+        {.name = "exact"},
+        {.name = "histogram"},
+        {.name = "streaming"},
+    };
+    const bg_level_mode modes[] = {BG_LEVEL_EXACT, BG_LEVEL_EXACT, BG_LEVEL_HISTOGRAM, BG_LEVEL_STREAMING};
+    for (size_t i = 0; i < sizeof(results) / sizeof(results[0]); i++) {
+        evaluate(&results[i], i == 0, modes[i], images, reference, n_frames, iterations);
+        if (i == 0) {
+            memcpy(hands, exact_hands, sizeof(detection) * n_frames);
+        } else {
+            run_algo(modes[i], frames, n_frames, NULL, hands);
+        }
+        for (uint32_t fr = 0; fr < n_frames; fr++) {
+            results[i].n_success += hands[fr].range_bin != UINT16_MAX;
+            results[i].detection_mismatches += hands[fr].range_bin != exact_hands[fr].range_bin
+                                               || hands[fr].doppler_bin != exact_hands[fr].doppler_bin;
+        }
+    }
+
+    printf("Background level of %u %s frames (%u cells), %u iterations\n", n_frames,
+        capture ? "recorded" : "synthetic", img_len, iterations);
+    printf("%-10s %10s %8s %11s %11s %11s %10s %11s\n", "estimator", "ns/frame", "speedup", "exact",
+        "mean err", "median err", "max err", "detections");
+    for (size_t i = 0; i < sizeof(results) / sizeof(results[0]); i++) {
+        const estimator_result_t *r = &results[i];
+        printf("%-10s %10.0f %7.2fx %5u/%-5u %10.4f%% %10.4f%% %9.4f%% %4u (%u differ)\n", r->name,
+            r->ns_per_frame, results[0].ns_per_frame / r->ns_per_frame, r->n_exact, n_frames,
+            100.0 * r->mean_error, 100.0 * r->median_error, 100.0 * r->max_error, r->n_success,
+            r->detection_mismatches);
+    }
+
+    bool ok = results[1].n_exact == n_frames
+              && results[1].detection_mismatches == 0
+              && results[2].max_error <= HISTOGRAM_MAX_ERROR
+              && results[3].median_error <= STREAMING_MEDIAN_ERROR;
+    printf("%s\n", ok ? "OK" : "FAIL");
+
+    free(hands);
+    free(exact_hands);
+    free(scratch);
+    free(reference);
+    free(images);
+    free(frames);
+    return ok ? 0 : 1;
+}
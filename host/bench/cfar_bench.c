@@ -0,0 +1,240 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Compares the hand detection modes of detect_hand on synthetic range-Doppler
+ * maps with clutter: Rayleigh noise whose level falls from 20 times the far
+ * floor at the nearest range bins, as leakage and close static objects do,
+ * and one target a fixed factor above the local noise level at a random cell.
+ *
+ * The global modes test against threshold * bg_level, the median of the map
+ * (get_background_level), the CFAR modes against threshold times the noise
+ * level of the training cells (CFAR_CFG_DEFAULT). A detection is correct
+ * within one bin of the target. The CFAR noise levels are also checked
+ * against a brute-force evaluation of every cell, on maps with masked cells.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "preprocess.h"
+
+#include "bench_util.h"
+
+#define N_RANGE_BINS            (32)
+#define MAX_CHIRPS              (128)
+#define MIN_RANGE_BIN           (2)
+#define DEFAULT_MAPS            (500)
+#define TARGET_SNR              (8.0)
+#define GLOBAL_THRESHOLD        (2.0f)
+#define CFAR_THRESHOLD          (4.0f)
+// Smallest share of maps the CFAR modes must detect correctly
+#define CFAR_MIN_DETECTION_RATE (0.9)
+
+static uint32_t lcg = 12345;
+
+static double uniform(void) {
+    lcg = lcg * 1103515245u + 12345u;
+    return ((double) (lcg >> 8) + 0.5) / (double) (1u << 24);
+}
+
+static double clutter_level(uint16_t range_bin) {
+    return 1.0 + 20.0 * exp(-(double) range_bin / 3.0);
+}
+
+// Rayleigh noise of the clutter level, and the target at (*doppler_bin, *range_bin) spread over its neighbours
+static void synthesize_map(float *map, uint16_t n_chirps, uint16_t *doppler_bin, uint16_t *range_bin) {
+    for (uint16_t d = 0; d < n_chirps; d++) {
+        for (uint16_t r = 0; r < N_RANGE_BINS; r++) {
+            map[d * N_RANGE_BINS + r] = (float) (clutter_level(r) * sqrt(-2.0 * log(uniform())) / sqrt(M_PI / 2.0));
+        }
+    }
+    *doppler_bin = (uint16_t) (uniform() * n_chirps);
+    *range_bin = (uint16_t) (MIN_RANGE_BIN + 1 + uniform() * (N_RANGE_BINS - MIN_RANGE_BIN - 2));
+    double amplitude = TARGET_SNR * clutter_level(*range_bin);
+    for (int dd = -1; dd <= 1; dd++) {
+        for (int dr = -1; dr <= 1; dr++) {
+            int d = *doppler_bin + dd;
+            int r = *range_bin + dr;
+            if (d >= 0 && d < n_chirps && r >= 0 && r < N_RANGE_BINS) {
+                map[d * N_RANGE_BINS + r] += (float) (amplitude * ((dd == 0 && dr == 0) ? 1.0 : 0.3));
+            }
+        }
+    }
+}
+
+static double ca_noise_ref(const float *map, uint16_t n_chirps, int d, int r, const cfar_cfg *cfg) {
+    double sum = 0.0;
+    uint32_t count = 0;
+    int outer_d = cfg->guard_doppler + cfg->train_doppler;
+    int outer_r = cfg->guard_range + cfg->train_range;
+    for (int i = d - outer_d; i <= d + outer_d; i++) {
+        for (int j = r - outer_r; j <= r + outer_r; j++) {
+            if (i < 0 || i >= n_chirps || j < 0 || j >= N_RANGE_BINS
+                || (abs(i - d) <= cfg->guard_doppler && abs(j - r) <= cfg->guard_range)) {
+                continue;
+            }
+            float v = map[i * N_RANGE_BINS + j];
+            if (v > 0.0f) {
+                sum += v;
+                count++;
+            }
+        }
+    }
+    return count ? sum / count : 0.0;
+}
+
+static int compare_f32(const void *a, const void *b) {
+    float fa = *(const float *) a;
+    float fb = *(const float *) b;
+    return (fa > fb) - (fa < fb);
+}
+
+static float os_noise_ref(const float *map, uint16_t n_chirps, int d, int r, const cfar_cfg *cfg) {
+    float window[MAX_CHIRPS];
+    uint32_t n = 0;
+    int outer = cfg->guard_doppler + cfg->train_doppler;
+    for (int i = d - outer; i <= d + outer; i++) {
+        if (i >= 0 && i < n_chirps && abs(i - d) > cfg->guard_doppler && map[i * N_RANGE_BINS + r] > 0.0f) {
+            window[n++] = map[i * N_RANGE_BINS + r];
+        }
+    }
+    if (n == 0) {
+        return 0.0f;
+    }
+    qsort(window, n, sizeof(float), compare_f32);
+    uint32_t rank = n * cfg->os_rank / 100;
+    return window[rank < n ? rank : n - 1];
+}
+
+// Largest relative difference between estimate_cfar_noise() and the brute-force noise levels on masked maps
+static double check_noise(uint16_t n_chirps, detection_mode mode, uint32_t n_maps) {
+    const cfar_cfg cfg = CFAR_CFG_DEFAULT;
+    frame_cfg f_cfg = {.n_channels = 3, .n_chirps = n_chirps, .n_samples = 2 * N_RANGE_BINS, .n_range_bins = N_RANGE_BINS};
+    region search = {.row_start = 0, .row_end = n_chirps, .col_start = MIN_RANGE_BIN, .col_end = N_RANGE_BINS};
+    float *map = malloc(sizeof(float) * n_chirps * N_RANGE_BINS);
+    float *noise = malloc(sizeof(float) * n_chirps * N_RANGE_BINS);
+    float *scratch = malloc(sizeof(float) * cfar_scratch_len(&f_cfg));
+    double worst = 0.0;
+    for (uint32_t m = 0; m < n_maps; m++) {
+        uint16_t td, tr;
+        synthesize_map(map, n_chirps, &td, &tr);
+        // Masked cells as mask_hand_roi() leaves them: below the search region, the human and random holes
+        for (uint16_t d = 0; d < n_chirps; d++) {
+            for (uint16_t r = 0; r < N_RANGE_BINS; r++) {
+                bool human = d >= n_chirps / 2 - 1 && d <= n_chirps / 2 + 1 && r >= N_RANGE_BINS - 4;
+                if (r < MIN_RANGE_BIN || human || uniform() < 0.05) {
+                    map[d * N_RANGE_BINS + r] = 0.0f;
+                }
+            }
+        }
+        estimate_cfar_noise(map, noise, &f_cfg, &search, &cfg, mode, scratch);
+        for (int d = 0; d < n_chirps; d++) {
+            for (int r = search.col_start; r < search.col_end; r++) {
+                double ref = mode == DETECTION_MODE_CA_CFAR ? ca_noise_ref(map, n_chirps, d, r, &cfg)
+                                                            : os_noise_ref(map, n_chirps, d, r, &cfg);
+                double v = noise[d * N_RANGE_BINS + r];
+                double err = ref > 0.0 ? fabs(v - ref) / ref : fabs(v);
+                worst = fmax(worst, err);
+            }
+        }
+    }
+    free(scratch);
+    free(noise);
+    free(map);
+    return worst;
+}
+
+typedef struct {
+    const char *name;
+    detection_mode mode;
+    uint32_t correct;
+    uint32_t wrong;
+    uint32_t missed;
+    double ns_per_map;
+} mode_result_t;
+
+static void run_mode(mode_result_t *res, uint16_t n_chirps, uint32_t n_maps) {
+    frame_cfg f_cfg = {.n_channels = 3, .n_chirps = n_chirps, .n_samples = 2 * N_RANGE_BINS, .n_range_bins = N_RANGE_BINS};
+    region search = {.row_start = 0, .row_end = n_chirps, .col_start = MIN_RANGE_BIN, .col_end = N_RANGE_BINS};
+    bool cfar = res->mode == DETECTION_MODE_CA_CFAR || res->mode == DETECTION_MODE_OS_CFAR;
+    float *map = malloc(sizeof(float) * n_chirps * N_RANGE_BINS);
+    uint64_t total_ns = 0;
+    res->correct = res->wrong = res->missed = 0;
+    lcg = 54321;
+    for (uint32_t m = 0; m < n_maps; m++) {
+        uint16_t td, tr;
+        synthesize_map(map, n_chirps, &td, &tr);
+        uint64_t t0 = bench_now_ns();
+        float bg_level = cfar ? 0.0f : get_background_level(map, &f_cfg);
+        detection hand = detect_hand(map, &search, &f_cfg, bg_level, res->mode,
+                                     cfar ? CFAR_THRESHOLD : GLOBAL_THRESHOLD);
+        total_ns += bench_now_ns() - t0;
+        if (hand.range_bin >= N_RANGE_BINS) {
+            res->missed++;
+        } else if (abs(hand.range_bin - tr) <= 1 && abs(hand.doppler_bin - td) <= 1) {
+            res->correct++;
+        } else {
+            res->wrong++;
+        }
+    }
+    res->ns_per_map = (double) total_ns / n_maps;
+    free(map);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-s maps]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t n_maps = DEFAULT_MAPS;
+
+    for (int i = 1; i < argc; i++) {
+        if (0 == strcmp(argv[i], "-s") && i + 1 < argc) {
+            n_maps = (uint32_t) atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (n_maps == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    bool ok = true;
+    const uint16_t chirp_counts[] = {32, 64, 128};
+    printf("Hand detection on %u maps of %u range bins with near-range clutter, target %.0fx above the local noise\n",
+        n_maps, N_RANGE_BINS, TARGET_SNR);
+    printf("%7s %-10s %9s %9s %9s %12s\n", "chirps", "mode", "correct", "wrong", "missed", "ns/map");
+    for (size_t c = 0; c < sizeof(chirp_counts) / sizeof(chirp_counts[0]); c++) {
+        uint16_t n_chirps = chirp_counts[c];
+        mode_result_t results[] = {
+            {.name = "closest", .mode = DETECTION_MODE_CLOSEST},
+            {.name = "strongest", .mode = DETECTION_MODE_STRONGEST},
+            {.name = "ca-cfar", .mode = DETECTION_MODE_CA_CFAR},
+            {.name = "os-cfar", .mode = DETECTION_MODE_OS_CFAR},
+        };
+        for (size_t i = 0; i < sizeof(results) / sizeof(results[0]); i++) {
+            mode_result_t *r = &results[i];
+            run_mode(r, n_chirps, n_maps);
+            printf("%7u %-10s %9u %9u %9u %12.0f\n", n_chirps, r->name, r->correct, r->wrong, r->missed,
+                r->ns_per_map);
+        }
+        for (size_t i = 2; i < sizeof(results) / sizeof(results[0]); i++) {
+            ok = ok && results[i].correct >= CFAR_MIN_DETECTION_RATE * n_maps
+                 && results[i].correct > results[0].correct && results[i].correct > results[1].correct;
+        }
+        double ca_error = check_noise(n_chirps, DETECTION_MODE_CA_CFAR, 20);
+        double os_error = check_noise(n_chirps, DETECTION_MODE_OS_CFAR, 20);
+        printf("%7u noise levels against brute force: ca-cfar %.2e, os-cfar %.2e largest relative error\n",
+            n_chirps, ca_error, os_error);
+        ok = ok && ca_error < 1e-4 && os_error == 0.0;
+    }
+    printf("%s\n", ok ? "OK" : "FAIL");
+    return ok ? 0 : 1;
+}
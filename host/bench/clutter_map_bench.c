@@ -0,0 +1,238 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Compares the static target suppression of slim_algo, the slow-time mean of
+ * each frame against the clutter map carried across frames
+ * (use_clutter_map), at 64, 128 and 256 samples per chirp (32 chirps,
+ * 3 antennas).
+ *
+ * Frames are synthetic: a target moving back and forth within the nearer half
+ * of the range in front of leakage and a strong static reflector. The target
+ * either moves within the frame (Doppler) or only between frames, as a slowly
+ * moving hand does. A detection is correct within one bin of the target
+ * range. The clutter map is seeded with the first frame, target included, so
+ * frames are only counted once it has settled. The suppression is the power
+ * at the range bin of the reflector before the stage over the power left
+ * after it. The time is that of the range FFTs and the suppression together,
+ * as slim_algo subtracts the clutter map within the range FFTs.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "preprocess.h"
+#include "extractions.h"
+
+#include "bench_util.h"
+
+#define N_RX_ANTENNAS           (BENCH_RX_ANTENNAS)
+#define N_CHIRPS                (32)
+#define MIN_RANGE_BIN           (3)
+// Frames before detections are counted, twice the time constant of the clutter map
+#define SETTLE_FRAMES           ((uint32_t) (2.0f / CLUTTER_MAP_ALPHA))
+#define DEFAULT_FRAMES          (128)
+#define DEFAULT_ITERATIONS      (10)
+// Smallest share of frames in which the clutter map must find the target
+#define MIN_DETECTION_RATE      (0.9)
+// Smallest suppression of the static reflector, in dB
+#define MIN_SUPPRESSION_DB      (20.0)
+
+static bench_stages_t stages;
+
+static double target_range_bin(uint32_t fr, uint32_t n_frames, uint16_t n_range_bins) {
+    return n_range_bins * (0.25 + 0.15 * sin(2.0 * M_PI * ((double) fr / (double) n_frames)));
+}
+
+static uint16_t reflector_range_bin(uint16_t n_range_bins) {
+    return (uint16_t) (0.75 * n_range_bins);
+}
+
+typedef struct {
+    uint32_t correct;
+    double suppression_db;
+    double stage_ns_per_frame;
+    double ns_per_frame;
+} clutter_result_t;
+
+// Power at the reflector range bin over all antennas and chirps
+static double reflector_power(const ifx_cf64_t *x_range, const frame_cfg *f_cfg) {
+    uint16_t bin = reflector_range_bin(f_cfg->n_range_bins);
+    double power = 0.0;
+    for (uint32_t row = 0; row < (uint32_t) f_cfg->n_channels * f_cfg->n_chirps; row++) {
+        const ifx_cf64_t *x = x_range + row * f_cfg->n_range_bins + bin;
+        power += (double) x->data[0] * x->data[0] + (double) x->data[1] * x->data[1];
+    }
+    return power;
+}
+
+static void run_slim(clutter_result_t *res, const float *frames, uint32_t n_frames, uint32_t iterations,
+                     frame_cfg *f_cfg, bool use_clutter_map) {
+    uint32_t frame_size = f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_samples;
+    uint32_t cube_size = f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_range_bins;
+    preproc_work_arrays arr = new_preproc_work_arrays(f_cfg);
+    arr.use_clutter_map = use_clutter_map;
+    float *frame = malloc(sizeof(float) * frame_size);
+    ifx_cf64_t *x_range = malloc(sizeof(ifx_cf64_t) * cube_size);
+    double power_before = 0.0, power_after = 0.0;
+    uint64_t best_total_ns = UINT64_MAX, best_stage_ns = UINT64_MAX;
+
+    memset(res, 0, sizeof(*res));
+    for (uint32_t it = 0; it < iterations; it++) {
+        // Every iteration starts over with an empty map
+        reset_clutter_map(&arr.clutter);
+        bench_stages_reset(&stages);
+        uint64_t total_ns = 0;
+        for (uint32_t fr = 0; fr < n_frames; fr++) {
+            memcpy(frame, frames + (size_t) fr * frame_size, sizeof(float) * frame_size);
+            slim_algo_output out;
+            uint64_t t0 = bench_now_ns();
+            bench_stages_start(&stages);
+            slim_algo(&out, frame, f_cfg, MIN_RANGE_BIN, &arr);
+            total_ns += bench_now_ns() - t0;
+            if (it > 0 || fr < SETTLE_FRAMES) {
+                continue;
+            }
+            double range_bin = target_range_bin(fr, n_frames, f_cfg->n_range_bins);
+            if (out.success && fabs(out.detection.range_bin - range_bin) <= 1.0) {
+                res->correct++;
+            }
+            power_after += reflector_power(arr.x_range, f_cfg);
+            memcpy(frame, frames + (size_t) fr * frame_size, sizeof(float) * frame_size);
+            build_complex_range_image(frame, x_range, f_cfg, arr.range_window);
+            power_before += reflector_power(x_range, f_cfg);
+        }
+        // The fastest iteration, the others include the checks above or interruptions
+        uint64_t stage_ns = bench_stages_ns(&stages, "range_fft") + bench_stages_ns(&stages, "mean_removal");
+        best_total_ns = total_ns < best_total_ns ? total_ns : best_total_ns;
+        best_stage_ns = stage_ns < best_stage_ns ? stage_ns : best_stage_ns;
+    }
+    res->ns_per_frame = (double) best_total_ns / n_frames;
+    res->stage_ns_per_frame = (double) best_stage_ns / n_frames;
+    res->suppression_db = 10.0 * log10(power_before / power_after);
+    free(x_range);
+    free(frame);
+    free_preproc_work_arrays(&arr);
+}
+
+/* Moves the start of the range gate of slim_algo out and back in: bins that
+ * leave the gate must be dropped from the map and those entering it seeded by
+ * their first frame, leaving no slow-time mean at them. */
+static bool check_gate_change(const float *frames, uint32_t n_frames, frame_cfg *f_cfg) {
+    const uint16_t moved_start = 4 * MIN_RANGE_BIN;
+    uint32_t frame_size = f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_samples;
+    preproc_work_arrays arr = new_preproc_work_arrays(f_cfg);
+    arr.use_clutter_map = true;
+    arr.range_gated = true;
+    float *frame = malloc(sizeof(float) * frame_size);
+    const uint16_t starts[] = {MIN_RANGE_BIN, moved_start, MIN_RANGE_BIN};
+    bool ok = true;
+
+    for (uint32_t fr = 0; fr < n_frames; fr++) {
+        uint16_t start = starts[fr * 3 / n_frames];
+        memcpy(frame, frames + (size_t) fr * frame_size, sizeof(float) * frame_size);
+        slim_algo_output out;
+        slim_algo(&out, frame, f_cfg, start, &arr);
+        bool entered = fr > 0 && start < starts[(fr - 1) * 3 / n_frames];
+        for (uint16_t bin = MIN_RANGE_BIN; bin < moved_start; bin++) {
+            if (arr.clutter.seeded[bin] != (start == MIN_RANGE_BIN)) {
+                ok = false;
+            }
+            double mean_power = 0.0, power = 0.0;
+            for (uint16_t ch = 0; ch < f_cfg->n_channels; ch++) {
+                const ifx_cf64_t *m = &arr.clutter.map[ch * f_cfg->n_range_bins + bin];
+                if (!arr.clutter.seeded[bin] && (m->data[0] != 0.0f || m->data[1] != 0.0f)) {
+                    ok = false;
+                }
+                double re = 0.0, im = 0.0;
+                for (uint16_t c = 0; c < f_cfg->n_chirps; c++) {
+                    const ifx_cf64_t *x = arr.x_range + (ch * f_cfg->n_chirps + c) * f_cfg->n_range_bins + bin;
+                    re += x->data[0];
+                    im += x->data[1];
+                    power += (double) x->data[0] * x->data[0] + (double) x->data[1] * x->data[1];
+                }
+                mean_power += (re * re + im * im) / f_cfg->n_chirps;
+            }
+            // Seeded by this very frame, the slow-time mean is gone
+            if (entered && mean_power > 1e-6 * power) {
+                ok = false;
+            }
+        }
+    }
+    free(frame);
+    free_preproc_work_arrays(&arr);
+    return ok;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-n iterations] [-s frames]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    bench_preproc_stages = &stages;
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    uint32_t n_frames = DEFAULT_FRAMES;
+
+    for (int i = 1; i < argc; i++) {
+        if (0 == strcmp(argv[i], "-n") && i + 1 < argc) {
+            iterations = (uint32_t) atoi(argv[++i]);
+        } else if (0 == strcmp(argv[i], "-s") && i + 1 < argc) {
+            n_frames = (uint32_t) atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (iterations == 0 || n_frames <= SETTLE_FRAMES) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    bool ok = true;
+    const uint16_t sample_counts[] = {64, 128, 256};
+    const struct {
+        const char *name;
+        double doppler_scale;
+    } targets[] = {
+        {"doppler", 0.25},
+        {"slow", 0.0},
+    };
+    uint32_t n_counted = n_frames - SETTLE_FRAMES;
+    printf("Static target suppression of slim_algo on %u frames, best of %u iterations, alpha %.2f, "
+        "detections counted from frame %u\n", n_frames, iterations, CLUTTER_MAP_ALPHA, SETTLE_FRAMES);
+    printf("%8s %-8s %-12s %9s %15s %15s %13s\n", "samples", "target", "suppression", "correct",
+        "reflector dB", "fft+supp ns", "total ns");
+    for (size_t i = 0; i < sizeof(sample_counts) / sizeof(sample_counts[0]); i++) {
+        uint16_t n_samples = sample_counts[i];
+        frame_cfg f_cfg = {
+            .n_channels = N_RX_ANTENNAS,
+            .n_chirps = N_CHIRPS,
+            .n_samples = n_samples,
+            .n_range_bins = n_samples / 2
+        };
+        for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); t++) {
+            float *frames = bench_synthesize_frames(n_frames, N_CHIRPS, n_samples, targets[t].doppler_scale,
+                                                    reflector_range_bin(n_samples / 2));
+            clutter_result_t mean, map;
+            run_slim(&mean, frames, n_frames, iterations, &f_cfg, false);
+            run_slim(&map, frames, n_frames, iterations, &f_cfg, true);
+            printf("%8u %-8s %-12s %5u/%-5u %13.1f %15.0f %13.0f\n", n_samples, targets[t].name, "frame mean",
+                mean.correct, n_counted, mean.suppression_db, mean.stage_ns_per_frame, mean.ns_per_frame);
+            printf("%8u %-8s %-12s %5u/%-5u %13.1f %15.0f %13.0f\n", n_samples, targets[t].name, "clutter map",
+                map.correct, n_counted, map.suppression_db, map.stage_ns_per_frame, map.ns_per_frame);
+            ok = ok && map.correct >= MIN_DETECTION_RATE * n_counted && map.correct >= mean.correct
+                 && map.suppression_db >= MIN_SUPPRESSION_DB;
+            if (!check_gate_change(frames, n_frames, &f_cfg)) {
+                printf("%8u %-8s clutter map not reseeded after a range gate change\n", n_samples, targets[t].name);
+                ok = false;
+            }
+            free(frames);
+        }
+    }
+    printf("%s\n", ok ? "OK" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Checks and times the fused BGT60 frame front end, prepare_frame_u16(),
+ * against the multi-pass path it replaces: per-sample deinterleave, ADC
+ * normalization over the whole frame, then mean removal and windowing of
+ * every chirp. Exits with a non-zero status if the outputs differ beyond
+ * float rounding or if slim_algo detects something different.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "preprocess.h"
+#include "extractions.h"
+#include "windows.h"
+
+#include "bench_util.h"
+#include "radar_frames.h"
+
+#define DEFAULT_SYNTHETIC_FRAMES    (64)
+#define DEFAULT_ITERATIONS          (200)
+
+// Largest allowed difference between the prepared frames, relative to the frame peak
+#define FRAME_TOLERANCE             (1e-5)
+
+// The front end as it was: deinterleave, normalization pass, then mean and window per chirp
+static void prepare_multi_pass(const uint16_t *fifo, float *frame, const float *window) {
+    deinterleave_antennas(fifo, frame);
+    for (int i = 0; i < NUM_SAMPLES_PER_FRAME; i++) {
+        frame[i] *= 1.0f / (float) ADC_NORMALIZATION;
+    }
+    for (int c = 0; c < NUM_RX_ANTENNAS * NUM_CHIRPS_PER_FRAME; c++) {
+        float *chirp = frame + c * NUM_SAMPLES_PER_CHIRP;
+        float mean = 0.0f;
+        for (int s = 0; s < NUM_SAMPLES_PER_CHIRP; s++) {
+            mean += chirp[s];
+        }
+        mean /= NUM_SAMPLES_PER_CHIRP;
+        for (int s = 0; s < NUM_SAMPLES_PER_CHIRP; s++) {
+            chirp[s] = (chirp[s] - mean) * window[s];
+        }
+    }
+}
+
+static double max_abs_diff(const float *a, const float *b, int n, double *peak) {
+    double d = 0.0;
+    for (int i = 0; i < n; i++) {
+        d = fmax(d, fabs((double) a[i] - (double) b[i]));
+        *peak = fmax(*peak, fabs((double) a[i]));
+    }
+    return d;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-f capture.bin] [-n iterations] [-s synthetic_frames]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    const char *capture = NULL;
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    uint32_t n_frames = DEFAULT_SYNTHETIC_FRAMES;
+
+    for (int i = 1; i < argc; i++) {
+        if (0 == strcmp(argv[i], "-f") && i + 1 < argc) {
+            capture = argv[++i];
+        } else if (0 == strcmp(argv[i], "-n") && i + 1 < argc) {
+            iterations = (uint32_t) atoi(argv[++i]);
+        } else if (0 == strcmp(argv[i], "-s") && i + 1 < argc) {
+            n_frames = (uint32_t) atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (iterations == 0 || n_frames == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    uint16_t *frames = capture ? load_frames(capture, &n_frames) : synthesize_frames(n_frames);
+    if (!frames) {
+        return 1;
+    }
+
+    frame_cfg f_cfg = {
+        .n_channels = NUM_RX_ANTENNAS,
+        .n_chirps = NUM_CHIRPS_PER_FRAME,
+        .n_samples = NUM_SAMPLES_PER_CHIRP,
+        .n_range_bins = NUM_SAMPLES_PER_CHIRP / 2
+    };
+    const float *window = get_normalized_window(&WINDOWS.hann, f_cfg.n_samples);
+    float *multi = malloc(sizeof(float) * NUM_SAMPLES_PER_FRAME);
+    float *ref = malloc(sizeof(float) * NUM_SAMPLES_PER_FRAME);
+    float *fused = malloc(sizeof(float) * NUM_SAMPLES_PER_FRAME);
+    float *raw = malloc(sizeof(float) * NUM_SAMPLES_PER_FRAME);
+    preproc_work_arrays arr_raw = new_preproc_work_arrays(&f_cfg);
+    preproc_work_arrays arr_fused = new_preproc_work_arrays(&f_cfg);
+    arr_fused.frame_prepared = true;
+
+    // Equivalence: prepared frames and slim_algo detections
+    double diff_ref = 0.0, diff_fused = 0.0, peak = 0.0;
+    uint32_t det_mismatch = 0;
+    for (uint32_t fr = 0; fr < n_frames; fr++) {
+        const uint16_t *fifo = frames + (size_t) fr * NUM_SAMPLES_PER_FRAME;
+        prepare_multi_pass(fifo, multi, window);
+        prepare_frame_u16_ref(fifo, ref, &f_cfg, window, true);
+        prepare_frame_u16(fifo, fused, &f_cfg, window, true);
+        diff_ref = fmax(diff_ref, max_abs_diff(multi, ref, NUM_SAMPLES_PER_FRAME, &peak));
+        diff_fused = fmax(diff_fused, max_abs_diff(ref, fused, NUM_SAMPLES_PER_FRAME, &peak));
+
+        slim_algo_output out_raw, out_fused;
+        deinterleave_antennas(fifo, raw);
+        slim_algo(&out_raw, raw, &f_cfg, 3, &arr_raw);
+        slim_algo(&out_fused, fused, &f_cfg, 3, &arr_fused);
+        if (out_raw.success != out_fused.success
+            || out_raw.detection.range_bin != out_fused.detection.range_bin
+            || out_raw.detection.doppler_bin != out_fused.detection.doppler_bin) {
+            det_mismatch++;
+        }
+    }
+    bool ok = diff_ref <= FRAME_TOLERANCE * peak && diff_fused <= FRAME_TOLERANCE * peak && det_mismatch == 0;
+    printf("Equivalence over %u frames: multi-pass vs ref %.3g, ref vs prepare_frame_u16 %.3g "
+           "(peak %.3g), slim_algo detection mismatches %u: %s\n",
+        n_frames, diff_ref, diff_fused, peak, det_mismatch, ok ? "OK" : "FAIL");
+
+    // Timing of the front ends alone
+    struct {
+        const char *name;
+        int which;
+    } variants[] = {{"multi-pass", 0}, {"prepare_frame_u16_ref", 1}, {"prepare_frame_u16", 2}};
+    for (size_t v = 0; v < sizeof(variants) / sizeof(variants[0]); v++) {
+        uint64_t t0 = bench_now_ns();
+        uint64_t c0 = bench_now_cycles();
+        for (uint32_t it = 0; it < iterations; it++) {
+            for (uint32_t fr = 0; fr < n_frames; fr++) {
+                const uint16_t *fifo = frames + (size_t) fr * NUM_SAMPLES_PER_FRAME;
+                switch (variants[v].which) {
+                    case 0: prepare_multi_pass(fifo, multi, window); break;
+                    case 1: prepare_frame_u16_ref(fifo, ref, &f_cfg, window, true); break;
+                    default: prepare_frame_u16(fifo, fused, &f_cfg, window, true); break;
+                }
+            }
+        }
+        uint64_t cycles = bench_now_cycles() - c0;
+        uint64_t ns = bench_now_ns() - t0;
+        uint32_t n_runs = n_frames * iterations;
+        printf("    %-24s %10.1f ns %12.1f cyc per frame\n", variants[v].name,
+            (double) ns / n_runs, (double) cycles / n_runs);
+    }
+
+    free_preproc_work_arrays(&arr_raw);
+    free_preproc_work_arrays(&arr_fused);
+    free(raw);
+    free(fused);
+    free(ref);
+    free(multi);
+    free(frames);
+    return ok ? 0 : 1;
+}
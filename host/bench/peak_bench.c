@@ -0,0 +1,240 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Compares the peak search and clustering of detect_hand (find_peaks and
+ * cluster_peaks) with the argsort and quadratic clustering they replaced,
+ * on synthetic Doppler profiles of 32, 64 and 128 chirps. As in detect_hand,
+ * the strongest 20% of the profile are clustered.
+ *
+ * The old path is reproduced here with its heap use: a sort array per
+ * profile and n_peaks * n_peaks cluster elements. Heap calls are counted by
+ * wrapping them. Both paths must give the same peaks and the same clusters,
+ * element for element, including on profiles with equal values.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "preprocess.h"
+
+#include "bench_util.h"
+
+#define DEFAULT_PROFILES        (512)
+#define DEFAULT_ITERATIONS      (20)
+#define MAX_CHIRPS              (128)
+
+static uint64_t n_mallocs;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    n_mallocs++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    n_mallocs++;
+    return __real_calloc(count, size);
+}
+
+// The argsort and clustering detect_hand used before find_peaks kept a heap
+typedef struct {
+    const float *el;
+    uint16_t idx;
+} argsort_tuple;
+
+// Ascending, equal values by index, so that the largest come last with the higher index first
+static int compare_argsort_tuples(const void *a, const void *b) {
+    const argsort_tuple *ta = a;
+    const argsort_tuple *tb = b;
+    if (*ta->el != *tb->el) {
+        return *ta->el > *tb->el ? 1 : -1;
+    }
+    return (int) ta->idx - (int) tb->idx;
+}
+
+static void find_peaks_ref(const float *in, uint16_t *idx, uint16_t n_elements, uint16_t n_peaks) {
+    argsort_tuple *indexed = malloc(sizeof(argsort_tuple) * n_elements);
+    for (uint16_t i = 0; i < n_elements; ++i) {
+        indexed[i].el = in + i;
+        indexed[i].idx = i;
+    }
+    qsort(indexed, n_elements, sizeof(argsort_tuple), compare_argsort_tuples);
+    for (uint16_t i = 0; i < n_peaks; ++i) {
+        idx[i] = indexed[n_elements - i - 1].idx;
+    }
+    free(indexed);
+}
+
+// clusters[i].elements must fit n_peaks elements each
+static void cluster_peaks_ref(const uint16_t *peaks, peak_cluster *clusters, uint16_t n_peaks) {
+    for (int i = 0; i < n_peaks; ++i) {
+        clusters[i].n_elements = 0;
+    }
+    for (int peak_idx = 0; peak_idx < n_peaks; ++peak_idx) {
+        bool peak_assigned = false;
+        for (int cluster_idx = 0; cluster_idx < n_peaks && !peak_assigned; ++cluster_idx) {
+            for (int el_idx = 0; el_idx < clusters[cluster_idx].n_elements; ++el_idx) {
+                uint16_t el = clusters[cluster_idx].elements[el_idx];
+                if (peaks[peak_idx] - el != 1 && peaks[peak_idx] - el != -1) {
+                    continue;
+                }
+                uint16_t n_el = clusters[cluster_idx].n_elements;
+                clusters[cluster_idx].elements[n_el] = peaks[peak_idx];
+                clusters[cluster_idx].n_elements += 1;
+                peak_assigned = true;
+                break;
+            }
+        }
+        if (!peak_assigned) {
+            clusters[peak_idx].elements[0] = peaks[peak_idx];
+            clusters[peak_idx].n_elements = 1;
+        }
+    }
+}
+
+// Noise floor with a few Doppler lobes. Every fourth profile is quantized coarsely to get equal values
+static float *synthesize_profiles(uint32_t n_profiles, uint16_t n_chirps) {
+    float *profiles = malloc(sizeof(float) * n_chirps * n_profiles);
+    uint32_t lcg = 12345;
+    for (uint32_t p = 0; p < n_profiles; p++) {
+        float *profile = profiles + (size_t) p * n_chirps;
+        for (uint16_t c = 0; c < n_chirps; c++) {
+            lcg = lcg * 1103515245u + 12345u;
+            profile[c] = 1.0f + (float) ((lcg >> 16) & 0x3FF) / 1024.0f;
+        }
+        for (int lobe = 0; lobe < 3; lobe++) {
+            lcg = lcg * 1103515245u + 12345u;
+            double center = (double) ((lcg >> 16) % n_chirps);
+            double width = 0.5 + (double) ((lcg >> 8) & 0x7) * 0.4;
+            double height = 2.0 + (double) ((lcg >> 4) & 0xF);
+            for (uint16_t c = 0; c < n_chirps; c++) {
+                double d = (c - center) / width;
+                profile[c] += (float) (height * exp(-0.5 * d * d));
+            }
+        }
+        if (p % 4 == 3) {
+            for (uint16_t c = 0; c < n_chirps; c++) {
+                profile[c] = floorf(profile[c] * 2.0f) / 2.0f;
+            }
+        }
+    }
+    return profiles;
+}
+
+static bool same_clusters(const peak_cluster *a, const peak_cluster *b, uint16_t n_peaks) {
+    for (uint16_t i = 0; i < n_peaks; i++) {
+        if (a[i].n_elements != b[i].n_elements
+            || 0 != memcmp(a[i].elements, b[i].elements, sizeof(uint16_t) * a[i].n_elements)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+typedef struct {
+    double ns_per_profile;
+    double mallocs_per_profile;
+    uint64_t checksum;
+} path_result_t;
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-n iterations] [-s profiles]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    uint32_t n_profiles = DEFAULT_PROFILES;
+
+    for (int i = 1; i < argc; i++) {
+        if (0 == strcmp(argv[i], "-n") && i + 1 < argc) {
+            iterations = (uint32_t) atoi(argv[++i]);
+        } else if (0 == strcmp(argv[i], "-s") && i + 1 < argc) {
+            n_profiles = (uint32_t) atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (iterations == 0 || n_profiles == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    bool ok = true;
+    const uint16_t chirp_counts[] = {32, 64, 128};
+    printf("Peak search and clustering of %u profiles x %u iterations\n", n_profiles, iterations);
+    printf("%7s %6s %14s %14s %9s %16s %10s\n", "chirps", "peaks", "argsort ns", "top-k ns", "speedup",
+        "mallocs/profile", "mismatches");
+    for (size_t c = 0; c < sizeof(chirp_counts) / sizeof(chirp_counts[0]); c++) {
+        uint16_t n_chirps = chirp_counts[c];
+        uint16_t n_peaks = (uint16_t) (0.2 * n_chirps);
+        float *profiles = synthesize_profiles(n_profiles, n_chirps);
+
+        static uint16_t peaks[MAX_CHIRPS], ref_peaks[MAX_CHIRPS];
+        static uint16_t cluster_elements[MAX_CHIRPS], bin_clusters[MAX_CHIRPS];
+        static peak_cluster clusters[MAX_CHIRPS], ref_clusters[MAX_CHIRPS];
+        path_result_t ref = {0}, topk = {0};
+
+        uint64_t mallocs = n_mallocs;
+        uint64_t t0 = bench_now_ns();
+        for (uint32_t it = 0; it < iterations; it++) {
+            for (uint32_t p = 0; p < n_profiles; p++) {
+                uint16_t *elements = malloc(sizeof(uint16_t) * n_peaks * n_peaks);
+                for (uint16_t i = 0; i < n_peaks; i++) {
+                    ref_clusters[i].elements = elements + i * n_peaks;
+                }
+                find_peaks_ref(profiles + (size_t) p * n_chirps, ref_peaks, n_chirps, n_peaks);
+                cluster_peaks_ref(ref_peaks, ref_clusters, n_peaks);
+                ref.checksum += ref_peaks[0] + ref_clusters[0].n_elements;
+                free(elements);
+            }
+        }
+        ref.ns_per_profile = (double) (bench_now_ns() - t0) / ((double) n_profiles * iterations);
+        ref.mallocs_per_profile = (double) (n_mallocs - mallocs) / ((double) n_profiles * iterations);
+
+        mallocs = n_mallocs;
+        t0 = bench_now_ns();
+        for (uint32_t it = 0; it < iterations; it++) {
+            for (uint32_t p = 0; p < n_profiles; p++) {
+                find_peaks(profiles + (size_t) p * n_chirps, peaks, n_chirps, n_peaks);
+                cluster_peaks(peaks, clusters, n_peaks, cluster_elements, bin_clusters, n_chirps);
+                topk.checksum += peaks[0] + clusters[0].n_elements;
+            }
+        }
+        topk.ns_per_profile = (double) (bench_now_ns() - t0) / ((double) n_profiles * iterations);
+        topk.mallocs_per_profile = (double) (n_mallocs - mallocs) / ((double) n_profiles * iterations);
+
+        uint32_t mismatches = 0;
+        uint16_t *elements = malloc(sizeof(uint16_t) * n_peaks * n_peaks);
+        for (uint16_t i = 0; i < n_peaks; i++) {
+            ref_clusters[i].elements = elements + i * n_peaks;
+        }
+        for (uint32_t p = 0; p < n_profiles; p++) {
+            const float *profile = profiles + (size_t) p * n_chirps;
+            find_peaks_ref(profile, ref_peaks, n_chirps, n_peaks);
+            cluster_peaks_ref(ref_peaks, ref_clusters, n_peaks);
+            find_peaks(profile, peaks, n_chirps, n_peaks);
+            cluster_peaks(peaks, clusters, n_peaks, cluster_elements, bin_clusters, n_chirps);
+            if (0 != memcmp(peaks, ref_peaks, sizeof(uint16_t) * n_peaks)
+                || !same_clusters(clusters, ref_clusters, n_peaks)) {
+                mismatches++;
+            }
+        }
+        free(elements);
+
+        printf("%7u %6u %14.1f %14.1f %8.2fx %7.1f -> %-6.1f %10u\n", n_chirps, n_peaks, ref.ns_per_profile,
+            topk.ns_per_profile, ref.ns_per_profile / topk.ns_per_profile, ref.mallocs_per_profile,
+            topk.mallocs_per_profile, mismatches);
+        ok = ok && mismatches == 0 && topk.mallocs_per_profile == 0.0 && ref.checksum == topk.checksum;
+        free(profiles);
+    }
+    printf("%s\n", ok ? "OK" : "FAIL");
+    return ok ? 0 : 1;
+}
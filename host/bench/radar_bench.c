@@ -0,0 +1,184 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Replays BGT60 radar frames through the gesture preprocessing algorithms
+ * (slim_algo, super_slim_algo and algo) and reports per-stage timings.
+ *
+ * Frames are read from a raw capture of the sensor FIFO: little-endian uint16
+ * words, antenna-interleaved exactly as returned by xensiv_bgt60trxx_get_fifo_data(),
+ * 64 samples x 32 chirps x 3 antennas per frame. Without a capture file,
+ * a deterministic synthetic recording of a moving target is generated instead.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "preprocess.h"
+#include "extractions.h"
+
+#include "bench_util.h"
+#include "radar_frames.h"
+
+#define DEFAULT_SYNTHETIC_FRAMES    (64)
+#define DEFAULT_ITERATIONS          (20)
+
+static bench_stages_t stages;
+
+typedef enum {
+    BENCH_SLIM_ALGO,
+    BENCH_SUPER_SLIM_ALGO,
+    BENCH_ALGO
+} bench_algo_t;
+
+static const char *bench_algo_name(bench_algo_t a) {
+    switch (a) {
+        case BENCH_SLIM_ALGO: return "slim_algo";
+        case BENCH_SUPER_SLIM_ALGO: return "super_slim_algo";
+        default: return "algo";
+    }
+}
+
+static void run_algo(bench_algo_t which, const uint16_t *frames, uint32_t n_frames, uint32_t iterations,
+                     bool prepared) {
+    frame_cfg f_cfg = {
+        .n_channels = NUM_RX_ANTENNAS,
+        .n_chirps = NUM_CHIRPS_PER_FRAME,
+        .n_samples = NUM_SAMPLES_PER_CHIRP,
+        .n_range_bins = NUM_SAMPLES_PER_CHIRP / 2
+    };
+    const uint16_t min_range_bin = 3;
+    preproc_work_arrays arr = new_preproc_work_arrays(&f_cfg);
+    algo_workspace ws = new_algo_workspace(&f_cfg);
+    // algo() always takes raw frames
+    arr.frame_prepared = prepared && which != BENCH_ALGO;
+    estimate_human_cfg h_cfg = {.position_min = 3, .position_current = -1.0f, .alpha = 0.1f};
+    float *frame = malloc(sizeof(float) * NUM_SAMPLES_PER_FRAME);
+    double checksum = 0.0;
+    uint32_t n_success = 0;
+
+    bench_stages_reset(&stages);
+    uint64_t total_ns = 0;
+    uint64_t total_cycles = 0;
+
+    for (uint32_t it = 0; it < iterations; it++) {
+        for (uint32_t fr = 0; fr < n_frames; fr++) {
+            // The algorithms normalize the frame in place, so each run gets a fresh copy
+            const uint16_t *fifo = frames + (size_t) fr * NUM_SAMPLES_PER_FRAME;
+            uint64_t t0 = bench_now_ns();
+            uint64_t c0 = bench_now_cycles();
+            bench_stages_start(&stages);
+            if (arr.frame_prepared) {
+                prepare_frame_u16(fifo, frame, &f_cfg, arr.range_window, true);
+            } else {
+                deinterleave_antennas(fifo, frame);
+            }
+            bench_stages_mark(&stages, "deinterleave");
+            switch (which) {
+                case BENCH_SLIM_ALGO: {
+                    slim_algo_output out;
+                    slim_algo(&out, frame, &f_cfg, min_range_bin, &arr);
+                    if (out.success) {
+                        n_success++;
+                        checksum += out.detection.range_bin + out.detection.doppler_bin;
+                    }
+                    break;
+                }
+                case BENCH_SUPER_SLIM_ALGO: {
+                    super_slim_algo_output out;
+                    super_slim_algo(&out, frame, &f_cfg, min_range_bin, &arr);
+                    if (out.success) {
+                        n_success++;
+                        checksum += out.detection.range_bin + out.detection.doppler_bin;
+                    }
+                    break;
+                }
+                case BENCH_ALGO: {
+                    algo_output out;
+                    algo(&out, frame, &f_cfg, &h_cfg, 2, 8, 3, 2, 2, 1, DETECTION_MODE_CLOSEST, 2.0f, &ws);
+                    if (out.success) {
+                        n_success++;
+                        checksum += out.hand_features.detection.range_bin
+                                    + out.hand_features.detection.doppler_bin;
+                    }
+                    break;
+                }
+            }
+            total_cycles += bench_now_cycles() - c0;
+            total_ns += bench_now_ns() - t0;
+        }
+    }
+
+    uint32_t n_runs = n_frames * iterations;
+    printf("%s%s: %u frames, %u detections, checksum %.1f\n",
+        bench_algo_name(which), arr.frame_prepared ? " (prepared frames)" : "", n_runs, n_success, checksum);
+    bench_stages_print(&stages, n_runs);
+    printf("    %-16s %10.1f ns %12.1f cyc   %.0f frames/s\n", "total",
+        (double) total_ns / n_runs, (double) total_cycles / n_runs,
+        total_ns ? 1e9 * n_runs / (double) total_ns : 0.0);
+
+    free(frame);
+    free_preproc_work_arrays(&arr);
+    free_algo_workspace(&ws);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Usage: %s [-f capture.bin] [-n iterations] [-s synthetic_frames] [-a slim|super|algo|all] [-p]\n"
+        "  -p  prepare frames with prepare_frame_u16() as radar.c does (slim and super only)\n",
+        prog);
+}
+
+int main(int argc, char *argv[]) {
+    bench_preproc_stages = &stages;
+    const char *capture = NULL;
+    const char *which = "all";
+    bool prepared = false;
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    uint32_t n_frames = DEFAULT_SYNTHETIC_FRAMES;
+
+    for (int i = 1; i < argc; i++) {
+        if (0 == strcmp(argv[i], "-f") && i + 1 < argc) {
+            capture = argv[++i];
+        } else if (0 == strcmp(argv[i], "-n") && i + 1 < argc) {
+            iterations = (uint32_t) atoi(argv[++i]);
+        } else if (0 == strcmp(argv[i], "-s") && i + 1 < argc) {
+            n_frames = (uint32_t) atoi(argv[++i]);
+        } else if (0 == strcmp(argv[i], "-a") && i + 1 < argc) {
+            which = argv[++i];
+        } else if (0 == strcmp(argv[i], "-p")) {
+            prepared = true;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (iterations == 0 || n_frames == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    uint16_t *frames = capture ? load_frames(capture, &n_frames) : synthesize_frames(n_frames);
+    if (!frames) {
+        return 1;
+    }
+    printf("Replaying %u %s frames x %u iterations\n", n_frames, capture ? "recorded" : "synthetic", iterations);
+
+    bool all = (0 == strcmp(which, "all"));
+    if (all || 0 == strcmp(which, "slim")) {
+        run_algo(BENCH_SLIM_ALGO, frames, n_frames, iterations, prepared);
+    }
+    if (all || 0 == strcmp(which, "super")) {
+        run_algo(BENCH_SUPER_SLIM_ALGO, frames, n_frames, iterations, prepared);
+    }
+    if (all || 0 == strcmp(which, "algo")) {
+        run_algo(BENCH_ALGO, frames, n_frames, iterations, prepared);
+    }
+
+    free(frames);
+    return 0;
+}
@@ -0,0 +1,92 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* BGT60 frame sources shared by the host benchmarks: raw FIFO captures
+ * (little-endian uint16 words, antenna-interleaved exactly as returned by
+ * xensiv_bgt60trxx_get_fifo_data()) and a deterministic synthetic recording
+ * of a moving target. */
+
+#ifndef HOST_RADAR_FRAMES_H
+#define HOST_RADAR_FRAMES_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUM_RX_ANTENNAS         (3)
+#define NUM_CHIRPS_PER_FRAME    (32)
+#define NUM_SAMPLES_PER_CHIRP   (64)
+#define NUM_SAMPLES_PER_FRAME   (NUM_SAMPLES_PER_CHIRP * NUM_CHIRPS_PER_FRAME * NUM_RX_ANTENNAS)
+
+// Plain per-sample deinterleave, as radar.c did before prepare_frame_u16()
+static inline void deinterleave_antennas(const uint16_t *fifo, float *frame) {
+    int antenna = 0;
+    int index = 0;
+    for (int i = 0; i < NUM_SAMPLES_PER_FRAME; ++i) {
+        frame[index + antenna * NUM_SAMPLES_PER_CHIRP * NUM_CHIRPS_PER_FRAME] = (float) fifo[i];
+        antenna++;
+        if (antenna == NUM_RX_ANTENNAS) {
+            antenna = 0;
+            index++;
+        }
+    }
+}
+
+static inline uint16_t *load_frames(const char *path, uint32_t *n_frames) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    *n_frames = (uint32_t) (size / (long) (NUM_SAMPLES_PER_FRAME * sizeof(uint16_t)));
+    if (*n_frames == 0) {
+        fprintf(stderr, "%s: file contains no complete frame\n", path);
+        fclose(f);
+        return NULL;
+    }
+    uint16_t *frames = malloc((size_t) *n_frames * NUM_SAMPLES_PER_FRAME * sizeof(uint16_t));
+    if (fread(frames, sizeof(uint16_t) * NUM_SAMPLES_PER_FRAME, *n_frames, f) != *n_frames) {
+        fprintf(stderr, "%s: read error\n", path);
+        free(frames);
+        frames = NULL;
+    }
+    fclose(f);
+    return frames;
+}
+
+// A hand-like target sweeping through range and velocity in front of static clutter
+static inline uint16_t *synthesize_frames(uint32_t n_frames) {
+    uint16_t *frames = malloc((size_t) n_frames * NUM_SAMPLES_PER_FRAME * sizeof(uint16_t));
+    uint32_t lcg = 12345;
+    const double antenna_phase[NUM_RX_ANTENNAS] = {0.0, 0.6, 0.25};
+    for (uint32_t fr = 0; fr < n_frames; fr++) {
+        double t = (double) fr / (double) n_frames;
+        double range_bin = 6.0 + 10.0 * sin(2.0 * M_PI * t);
+        double doppler = 0.25 * cos(2.0 * M_PI * t);
+        uint16_t *fifo = frames + (size_t) fr * NUM_SAMPLES_PER_FRAME;
+        int i = 0;
+        for (int c = 0; c < NUM_CHIRPS_PER_FRAME; c++) {
+            for (int s = 0; s < NUM_SAMPLES_PER_CHIRP; s++) {
+                for (int a = 0; a < NUM_RX_ANTENNAS; a++) {
+                    lcg = lcg * 1103515245u + 12345u;
+                    double noise = ((double) ((lcg >> 16) & 0x3FF) - 512.0) * 0.05;
+                    double phase = 2.0 * M_PI * range_bin * s / NUM_SAMPLES_PER_CHIRP
+                                   + 2.0 * M_PI * doppler * c + antenna_phase[a];
+                    double clutter = 300.0 * cos(2.0 * M_PI * 2.0 * s / NUM_SAMPLES_PER_CHIRP);
+                    double v = 2048.0 + 600.0 * cos(phase) + clutter + noise;
+                    v = v < 0.0 ? 0.0 : (v > 4095.0 ? 4095.0 : v);
+                    fifo[i++] = (uint16_t) v;
+                }
+            }
+        }
+    }
+    return frames;
+}
+
+#endif // HOST_RADAR_FRAMES_H
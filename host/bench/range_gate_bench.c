@@ -0,0 +1,156 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Compares slim_algo with and without range gating at 64, 128 and 256
+ * samples per chirp (32 chirps, 3 antennas). The gate always starts at
+ * min_range_bin; it is run over the full range, which must give the same
+ * detections as the ungated mode, and over the nearer half of the range.
+ * Frames are synthetic: a target moving within the nearer half of the
+ * range in front of static clutter. Gating does not change the range FFTs
+ * themselves, so the time after the range FFT stage is reported separately.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "preprocess.h"
+#include "extractions.h"
+
+#include "bench_util.h"
+
+#define N_RX_ANTENNAS           (BENCH_RX_ANTENNAS)
+#define N_CHIRPS                (32)
+#define MIN_RANGE_BIN           (3)
+#define DEFAULT_FRAMES          (64)
+#define DEFAULT_ITERATIONS      (10)
+
+static bench_stages_t stages;
+
+typedef struct {
+    uint32_t n_success;
+    double checksum;
+    double ns_per_frame;
+    double post_fft_ns_per_frame;
+    uint16_t range_bins[DEFAULT_FRAMES * 4];
+    uint16_t doppler_bins[DEFAULT_FRAMES * 4];
+} gate_result_t;
+
+static void run_slim(gate_result_t *res, const float *frames, uint32_t n_frames, uint32_t iterations,
+                     frame_cfg *f_cfg, bool gated, uint16_t gate_end, bool verbose) {
+    uint32_t frame_size = f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_samples;
+    preproc_work_arrays arr = new_preproc_work_arrays(f_cfg);
+    arr.range_gated = gated;
+    arr.range_gate_end = gate_end;
+    float *frame = malloc(sizeof(float) * frame_size);
+    uint64_t total_ns = 0;
+
+    memset(res, 0, sizeof(*res));
+    bench_stages_reset(&stages);
+    for (uint32_t it = 0; it < iterations; it++) {
+        for (uint32_t fr = 0; fr < n_frames; fr++) {
+            memcpy(frame, frames + (size_t) fr * frame_size, sizeof(float) * frame_size);
+            slim_algo_output out;
+            uint64_t t0 = bench_now_ns();
+            bench_stages_start(&stages);
+            slim_algo(&out, frame, f_cfg, MIN_RANGE_BIN, &arr);
+            total_ns += bench_now_ns() - t0;
+            if (it == 0 && fr < sizeof(res->range_bins) / sizeof(res->range_bins[0])) {
+                res->range_bins[fr] = out.success ? out.detection.range_bin : UINT16_MAX;
+                res->doppler_bins[fr] = out.success ? out.detection.doppler_bin : UINT16_MAX;
+            }
+            if (out.success) {
+                res->n_success++;
+                res->checksum += out.detection.range_bin + out.detection.doppler_bin;
+            }
+        }
+    }
+    uint32_t n_runs = n_frames * iterations;
+    res->ns_per_frame = (double) total_ns / n_runs;
+    res->post_fft_ns_per_frame = (double) (total_ns - bench_stages_ns(&stages, "range_fft")) / n_runs;
+    if (verbose) {
+        bench_stages_print(&stages, n_runs);
+    }
+    free(frame);
+    free_preproc_work_arrays(&arr);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-n iterations] [-s frames] [-v]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    bench_preproc_stages = &stages;
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    uint32_t n_frames = DEFAULT_FRAMES;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (0 == strcmp(argv[i], "-n") && i + 1 < argc) {
+            iterations = (uint32_t) atoi(argv[++i]);
+        } else if (0 == strcmp(argv[i], "-s") && i + 1 < argc) {
+            n_frames = (uint32_t) atoi(argv[++i]);
+        } else if (0 == strcmp(argv[i], "-v")) {
+            verbose = true;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (iterations == 0 || n_frames == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    static gate_result_t full, gated_full, gated_half;
+    bool ok = true;
+    const uint16_t sample_counts[] = {64, 128, 256};
+    printf("Time per frame in ns, total / after the range FFTs\n");
+    printf("%8s %20s %20s %20s %9s\n", "samples", "ungated", "gate=all", "gate=half", "speedup");
+    for (size_t i = 0; i < sizeof(sample_counts) / sizeof(sample_counts[0]); i++) {
+        uint16_t n_samples = sample_counts[i];
+        frame_cfg f_cfg = {
+            .n_channels = N_RX_ANTENNAS,
+            .n_chirps = N_CHIRPS,
+            .n_samples = n_samples,
+            .n_range_bins = n_samples / 2
+        };
+        float *frames = bench_synthesize_frames(n_frames, N_CHIRPS, n_samples, 0.25, 0.0);
+        if (verbose) {
+            printf("%u samples, ungated:\n", n_samples);
+        }
+        run_slim(&full, frames, n_frames, iterations, &f_cfg, false, f_cfg.n_range_bins, verbose);
+        if (verbose) {
+            printf("%u samples, gate [%u, %u):\n", n_samples, MIN_RANGE_BIN, f_cfg.n_range_bins);
+        }
+        run_slim(&gated_full, frames, n_frames, iterations, &f_cfg, true, f_cfg.n_range_bins, verbose);
+        if (verbose) {
+            printf("%u samples, gate [%u, %u):\n", n_samples, MIN_RANGE_BIN, f_cfg.n_range_bins / 2);
+        }
+        run_slim(&gated_half, frames, n_frames, iterations, &f_cfg, true, f_cfg.n_range_bins / 2, verbose);
+
+        uint32_t n_check = n_frames < DEFAULT_FRAMES * 4 ? n_frames : DEFAULT_FRAMES * 4;
+        uint32_t mismatch = 0;
+        for (uint32_t fr = 0; fr < n_check; fr++) {
+            if (full.range_bins[fr] != gated_full.range_bins[fr]
+                || full.doppler_bins[fr] != gated_full.doppler_bins[fr]) {
+                mismatch++;
+            }
+        }
+        printf("%8u %9.0f / %8.0f %9.0f / %8.0f %9.0f / %8.0f %8.2fx   "
+               "detections %u/%u/%u, ungated vs gate=all mismatches %u\n",
+            n_samples, full.ns_per_frame, full.post_fft_ns_per_frame,
+            gated_full.ns_per_frame, gated_full.post_fft_ns_per_frame,
+            gated_half.ns_per_frame, gated_half.post_fft_ns_per_frame,
+            full.post_fft_ns_per_frame / gated_half.post_fft_ns_per_frame,
+            full.n_success, gated_full.n_success, gated_half.n_success, mismatch);
+        ok = ok && mismatch == 0;
+        free(frames);
+    }
+    printf("%s\n", ok ? "OK" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,448 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Checks and benchmarks the radar data manager (RDM) ring buffer in
+ * proj_cm55/source/radar/xensiv_radar_data_management.c.
+ *
+ * A fake in_read_radar_data() producer writes a running byte counter in chunks of
+ * varying size, so every byte a subscriber reads can be checked for loss, duplication
+ * and ordering, including blocks that wrap around the end of the ring buffer.
+ * Several subscribers with different overrun policies read the same stream at their own pace.
+ * The throughput of the ring buffer is compared with the memmove compaction it replaced, best of
+ * BENCH_REPEATS runs.
+ * Exits with a non-zero status if a check fails.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xensiv_radar_data_management.h"
+
+#include "bench_util.h"
+
+// One radar frame of 64 samples x 32 chirps x 3 antennas, in bytes
+#define FRAME_BYTES         (64U * 32U * 3U * 2U)
+#define DEFAULT_MEGABYTES   (256U)
+#define BENCH_REPEATS       (8)
+
+static int failures;
+
+#define CHECK(cond, ...) do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: ", __func__, __LINE__); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+            failures++; \
+        } \
+    } while (0)
+
+/* Fake producer: a running byte counter, read in chunks of chunk_min..chunk_max bytes */
+static struct {
+    uint8_t next;
+    uint32_t chunk_min;
+    uint32_t chunk_max;
+    uint32_t rng;
+    bool fill;          // write the counter; off in benchmarks, where the sensor DMA cost is the same for both
+    uint32_t calls;
+    uint64_t bytes;
+} producer;
+
+static void producer_reset(uint32_t chunk_min, uint32_t chunk_max) {
+    memset(&producer, 0, sizeof(producer));
+    producer.chunk_min = chunk_min;
+    producer.chunk_max = chunk_max;
+    producer.rng = 12345;
+    producer.fill = true;
+}
+
+static uint32_t producer_chunk(void) {
+    if (producer.chunk_min == producer.chunk_max) {
+        return producer.chunk_min;
+    }
+    producer.rng = producer.rng * 1664525U + 1013904223U;
+    return producer.chunk_min + (producer.rng >> 8) % (producer.chunk_max - producer.chunk_min + 1);
+}
+
+static int32_t fake_read_radar_data(uint16_t *data, uint32_t *num_samples, uint32_t samples_ub) {
+    uint8_t *bytes = (uint8_t *) data;
+    uint32_t n = producer_chunk();
+    if (n > samples_ub) {
+        n = samples_ub;
+    }
+    for (uint32_t i = 0; producer.fill && i < n; i++) {
+        bytes[i] = producer.next++;
+    }
+    producer.calls++;
+    producer.bytes += n;
+    *num_samples = n;
+    return 0;
+}
+
+/* Checks that a subscriber's spans continue the byte counter where the previous read stopped */
+static bool check_spans(const radar_data_span_s spans[2], uint8_t *expected) {
+    for (int s = 0; s < 2; s++) {
+        const uint8_t *bytes = (const uint8_t *) spans[s].data;
+        for (uint32_t i = 0; i < spans[s].size; i++) {
+            if (bytes[i] != *expected) {
+                return false;
+            }
+            (*expected)++;
+        }
+    }
+    return true;
+}
+
+static radar_data_manager_s rdm;
+
+static void rdm_setup(uint32_t buffer_size, uint32_t fill_level, uint32_t chunk_min, uint32_t chunk_max) {
+    producer_reset(chunk_min, chunk_max);
+    memset(&rdm, 0, sizeof(rdm));
+    rdm.in_read_radar_data = fake_read_radar_data;
+    int32_t result = radar_data_manager_init(&rdm, buffer_size, fill_level);
+    if (result != RDM_SUCCESS) {
+        printf("radar_data_manager_init(%u, %u) failed: %d\n", buffer_size, fill_level, result);
+        exit(1);
+    }
+}
+
+static void rdm_teardown(int32_t sub) {
+    rdm.unsubscribe(sub);
+    if (radar_data_manager_deinit() != RDM_SUCCESS) {
+        printf("radar_data_manager_deinit failed\n");
+        exit(1);
+    }
+}
+
+/* Streams n_blocks fill-level blocks to one subscriber and checks every byte.
+ * Returns the number of blocks that wrapped around the end of the buffer. */
+static uint32_t stream_blocks(int32_t sub, TaskHandle_t task, uint32_t n_blocks, bool legacy_read) {
+    uint8_t expected = 0;
+    uint32_t blocks = 0;
+    uint32_t wrapped = 0;
+    uint32_t idle_runs = 0;
+
+    while (blocks < n_blocks && idle_runs < 1000) {
+        rdm.run(false);
+        if (host_task_notify_take(task) == 0) {
+            idle_runs++;
+            continue;
+        }
+        radar_data_span_s spans[2];
+        // A block acknowledged earlier may still be signalled once, until the next run() consumes it
+        if (rdm.read_from_buffer_spans(sub, spans) != RDM_SUCCESS) {
+            continue;
+        }
+        idle_runs = 0;
+        CHECK(spans[0].size + spans[1].size == (uint32_t) rdm.get_fill_level(),
+            "block %u: %u + %u bytes", blocks, spans[0].size, spans[1].size);
+        if (spans[1].size > 0) {
+            wrapped++;
+        }
+        if (legacy_read) {
+            uint16_t *data;
+            uint32_t size;
+            int32_t result = rdm.read_from_buffer(sub, &data, &size);
+            if (spans[1].size > 0) {
+                CHECK(result == RDM_EOP_CANNOT_COMPLETE, "block %u: legacy read of wrapped data returned %d",
+                    blocks, result);
+            } else {
+                CHECK(result == RDM_SUCCESS && data == spans[0].data && size == spans[0].size,
+                    "block %u: legacy read returned %d", blocks, result);
+            }
+        }
+        CHECK(check_spans(spans, &expected), "block %u: data lost or out of order", blocks);
+        rdm.ack_data_read(sub);
+        blocks++;
+    }
+    CHECK(blocks == n_blocks, "only %u of %u blocks delivered", blocks, n_blocks);
+    return wrapped;
+}
+
+static void test_contiguous(void) {
+    struct tskTaskControlBlock tcb = {0};
+    rdm_setup(4 * 1000, 1000, 1, 700);
+    int32_t sub = rdm.subscribe(&tcb);
+    CHECK(sub == 1, "subscribe returned %d", sub);
+    uint32_t wrapped = stream_blocks(sub, &tcb, 200, true);
+    CHECK(wrapped == 0, "%u blocks wrapped in a buffer that is a multiple of the fill level", wrapped);
+    rdm_teardown(sub);
+}
+
+static void test_wrap(void) {
+    struct tskTaskControlBlock tcb = {0};
+    rdm_setup(1000, 384, 1, 300);
+    int32_t sub = rdm.subscribe(&tcb);
+    uint32_t wrapped = stream_blocks(sub, &tcb, 500, true);
+    CHECK(wrapped > 0, "no block wrapped around the end of the buffer");
+    rdm_teardown(sub);
+}
+
+static void test_full_buffer(void) {
+    struct tskTaskControlBlock tcb = {0};
+    rdm_setup(1000, 300, 128, 128);
+    int32_t sub = rdm.subscribe(&tcb);
+    // Without acknowledgements the buffer fills up and the producer must not overwrite unread data
+    for (int i = 0; i < 50; i++) {
+        rdm.run(false);
+    }
+    CHECK(producer.bytes == 1000, "producer wrote %llu bytes into a 1000 byte buffer",
+        (unsigned long long) producer.bytes);
+    radar_data_span_s spans[2];
+    uint8_t expected = 0;
+    CHECK(rdm.read_from_buffer_spans(sub, spans) == RDM_SUCCESS, "no data to read");
+    CHECK(check_spans(spans, &expected), "first block overwritten");
+    rdm.ack_data_read(sub);
+    rdm.run(false);
+    CHECK(producer.bytes == 1128, "producer did not refill the released space");
+    rdm_teardown(sub);
+}
+
+/* Checks that a block is one contiguous run of the stream, returns its first byte */
+static bool check_block(const radar_data_span_s spans[2], uint8_t *first) {
+    uint8_t expected = *(const uint8_t *) spans[0].data;
+    *first = expected;
+    return check_spans(spans, &expected);
+}
+
+/* Reads and acknowledges one block if the subscriber was notified, returns false if there was none */
+static bool read_one(int32_t sub, TaskHandle_t task, uint8_t *first, int *bad_blocks) {
+    radar_data_span_s spans[2];
+    if (host_task_notify_take(task) == 0 || rdm.read_from_buffer_spans(sub, spans) != RDM_SUCCESS) {
+        return false;
+    }
+    if (!check_block(spans, first)) {
+        (*bad_blocks)++;
+    }
+    rdm.ack_data_read(sub);
+    return true;
+}
+
+static void test_fanout_drop_oldest(void) {
+    struct tskTaskControlBlock gesture = {0}, logger = {0};
+    radar_data_subscriber_stats_s gs, ls;
+    int bad_blocks = 0;
+    uint8_t first, expected = 0;
+
+    rdm_setup(4 * 384, 384, 1, 300);
+    int32_t g = rdm.subscribe(&gesture);
+    int32_t l = rdm.subscribe(&logger);
+    CHECK(rdm.set_policy(l, RDM_POLICY_DROP_OLDEST) == RDM_SUCCESS, "set_policy failed");
+
+    // The logger reads one block in ten, the gesture subscriber every block it is notified about
+    uint32_t gesture_blocks = 0, logger_blocks = 0;
+    for (int run = 0; run < 20000; run++) {
+        rdm.run(false);
+        radar_data_span_s spans[2];
+        if (host_task_notify_take(&gesture) > 0 && rdm.read_from_buffer_spans(g, spans) == RDM_SUCCESS) {
+            CHECK(check_spans(spans, &expected), "gesture block %u lost or out of order", gesture_blocks);
+            rdm.ack_data_read(g);
+            gesture_blocks++;
+        }
+        if ((run % 10) == 0) {
+            logger_blocks += read_one(l, &logger, &first, &bad_blocks);
+            // Blocks are dropped whole, so they stay aligned to the stream
+            CHECK((first % 128) == 0, "logger block starts at %u", first);
+        }
+    }
+    rdm.get_subscriber_stats(g, &gs);
+    rdm.get_subscriber_stats(l, &ls);
+    CHECK(bad_blocks == 0, "%d torn logger blocks", bad_blocks);
+    CHECK(gs.blocks_read == gesture_blocks && ls.blocks_read == logger_blocks, "blocks_read does not match");
+    CHECK(gs.blocks_dropped == 0 && gs.writer_stalls == 0, "gesture subscriber dropped %u blocks, stalled %u runs",
+        gs.blocks_dropped, gs.writer_stalls);
+    CHECK(ls.blocks_dropped > 0, "slow logger did not drop any block");
+    CHECK(ls.writer_stalls == 0, "slow logger stalled the writer %u times", ls.writer_stalls);
+    CHECK(ls.lag_max <= 4 * 384, "logger lag %u above the buffer size", ls.lag_max);
+    rdm.unsubscribe(l);
+    rdm_teardown(g);
+}
+
+static void test_latest_only(void) {
+    struct tskTaskControlBlock gesture = {0}, viewer = {0};
+    radar_data_subscriber_stats_s vs;
+    int bad_blocks = 0;
+    uint8_t first;
+
+    rdm_setup(8 * 256, 256, 200, 200);
+    int32_t g = rdm.subscribe(&gesture);
+    int32_t v = rdm.subscribe(&viewer);
+    rdm.set_policy(v, RDM_POLICY_LATEST_ONLY);
+
+    for (int run = 0; run < 5000; run++) {
+        rdm.run(false);
+        uint8_t unused;
+        (void) read_one(g, &gesture, &unused, &bad_blocks);
+        if ((run % 25) == 24) {
+            radar_data_span_s spans[2];
+            if (rdm.read_from_buffer_spans(v, spans) == RDM_SUCCESS) {
+                CHECK(check_block(spans, &first), "torn block");
+                rdm.get_subscriber_stats(v, &vs);
+                // Only a partial block may follow the one returned
+                CHECK(vs.lag < 2 * 256, "latest-only read returned a block %u bytes behind", vs.lag);
+                rdm.ack_data_read(v);
+            }
+        }
+    }
+    rdm.get_subscriber_stats(v, &vs);
+    CHECK(vs.blocks_read > 0 && vs.blocks_dropped > 0, "latest-only: %u read, %u dropped",
+        vs.blocks_read, vs.blocks_dropped);
+    CHECK(bad_blocks == 0, "%d torn gesture blocks", bad_blocks);
+    rdm.unsubscribe(v);
+    rdm_teardown(g);
+}
+
+static void test_block_stalls_writer(void) {
+    struct tskTaskControlBlock gesture = {0}, slow = {0};
+    radar_data_subscriber_stats_s gs, ss;
+    int bad_blocks = 0;
+    uint8_t first;
+
+    rdm_setup(4 * 256, 256, 100, 100);
+    int32_t g = rdm.subscribe(&gesture);
+    int32_t s = rdm.subscribe(&slow);
+    for (int run = 0; run < 100; run++) {
+        rdm.run(false);
+        (void) read_one(g, &gesture, &first, &bad_blocks);
+    }
+    rdm.get_subscriber_stats(g, &gs);
+    rdm.get_subscriber_stats(s, &ss);
+    // A blocking subscriber that never reads holds up the stream, and is blamed for it
+    CHECK(producer.bytes == 4 * 256, "writer overwrote unread data of a blocking subscriber");
+    CHECK(ss.writer_stalls > 0 && gs.writer_stalls == 0, "stalls: slow %u, gesture %u",
+        ss.writer_stalls, gs.writer_stalls);
+    CHECK(ss.lag == 4 * 256, "slow subscriber lag %u", ss.lag);
+    rdm.unsubscribe(s);
+    // Once it is gone the stream continues
+    for (int run = 0; run < 100; run++) {
+        rdm.run(false);
+        (void) read_one(g, &gesture, &first, &bad_blocks);
+    }
+    CHECK(producer.bytes > 4 * 256, "writer still stalled after unsubscribe");
+    CHECK(bad_blocks == 0, "%d torn gesture blocks", bad_blocks);
+    rdm_teardown(g);
+}
+
+static void test_params(void) {
+    radar_data_manager_s m = {.in_read_radar_data = fake_read_radar_data};
+    struct tskTaskControlBlock tcb = {0};
+    radar_data_span_s spans[2];
+
+    CHECK(radar_data_manager_init(&m, 100, 101) == RDM_EPARAM_INVALID, "fill level above buffer size accepted");
+    CHECK(radar_data_manager_init(&m, 100, 0) == RDM_EPARAM_INVALID, "zero fill level accepted");
+    CHECK(radar_data_manager_init(&m, 100, 50) == RDM_SUCCESS, "init failed");
+    CHECK(radar_data_manager_init(&m, 100, 50) == RDM_EOP_CANNOT_COMPLETE, "double init accepted");
+    int32_t sub = m.subscribe(&tcb);
+    CHECK(m.read_from_buffer_spans(0, spans) == RDM_EPARAM_INVALID, "invalid subscription id accepted");
+    CHECK(m.read_from_buffer_spans(sub, NULL) == RDM_EPARAM_INVALID, "NULL spans accepted");
+    CHECK(m.read_from_buffer_spans(sub, spans) == RDM_EOP_CANNOT_COMPLETE, "read from an empty buffer");
+    m.unsubscribe(sub);
+    CHECK(radar_data_manager_deinit() == RDM_SUCCESS, "deinit failed");
+}
+
+/* The buffering scheme the ring buffer replaced: data is always read from the start
+ * of the buffer, so the remainder is moved to the front after every consumed block. */
+typedef struct {
+    uint8_t *buffer;
+    uint32_t buff_size;
+    uint32_t fill_level;
+    uint32_t tail;
+} compacting_buffer_t;
+
+static uint64_t bench_compacting(uint32_t buffer_size, uint32_t fill_level, uint64_t n_blocks) {
+    compacting_buffer_t b = {.buffer = calloc(1, buffer_size), .buff_size = buffer_size, .fill_level = fill_level};
+    uint64_t moved = 0;
+    producer_reset(fill_level / 8, fill_level / 2);
+    producer.fill = false;
+    for (uint64_t blocks = 0; blocks < n_blocks;) {
+        uint32_t samples = 0;
+        if (b.tail < b.buff_size) {
+            fake_read_radar_data((uint16_t *) (b.buffer + b.tail), &samples, b.buff_size - b.tail);
+            b.tail += samples;
+        }
+        if (b.tail >= b.fill_level) {
+            memmove(b.buffer, b.buffer + b.fill_level, b.tail - b.fill_level);
+            moved += b.tail - b.fill_level;
+            b.tail -= b.fill_level;
+            blocks++;
+        }
+    }
+    free(b.buffer);
+    return moved;
+}
+
+static uint32_t bench_ring(uint32_t buffer_size, uint32_t fill_level, uint64_t n_blocks) {
+    struct tskTaskControlBlock tcb = {0};
+    uint32_t wrapped = 0;
+    rdm_setup(buffer_size, fill_level, fill_level / 8, fill_level / 2);
+    producer.fill = false;
+    int32_t sub = rdm.subscribe(&tcb);
+    for (uint64_t blocks = 0; blocks < n_blocks;) {
+        rdm.run(false);
+        radar_data_span_s spans[2];
+        if (host_task_notify_take(&tcb) == 0 || rdm.read_from_buffer_spans(sub, spans) != RDM_SUCCESS) {
+            continue;
+        }
+        wrapped += spans[1].size > 0;
+        rdm.ack_data_read(sub);
+        blocks++;
+    }
+    rdm_teardown(sub);
+    return wrapped;
+}
+
+/* Buffering overhead per block, subscribers read the data in place in both schemes.
+ * The blocks are streamed BENCH_REPEATS times and the fastest run of each scheme is reported. */
+static void run_bench(const char *name, uint32_t buffer_size, uint32_t fill_level, uint64_t n_blocks) {
+    uint64_t ring_ns = UINT64_MAX, compacting_ns = UINT64_MAX;
+    uint32_t wrapped = 0;
+    uint64_t moved = 0;
+
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        uint64_t t0 = bench_now_ns();
+        wrapped = bench_ring(buffer_size, fill_level, n_blocks);
+        uint64_t t = bench_now_ns() - t0;
+        ring_ns = (t < ring_ns) ? t : ring_ns;
+
+        t0 = bench_now_ns();
+        moved = bench_compacting(buffer_size, fill_level, n_blocks);
+        t = bench_now_ns() - t0;
+        compacting_ns = (t < compacting_ns) ? t : compacting_ns;
+    }
+
+    printf("%-26s ring %8.1f ns/block (%u wrapped)   compacting %8.1f ns/block (%.0f bytes moved/block)\n",
+        name, (double) ring_ns / n_blocks, wrapped, (double) compacting_ns / n_blocks,
+        (double) moved / n_blocks);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t megabytes = DEFAULT_MEGABYTES;
+
+    for (int i = 1; i < argc; i++) {
+        if (0 == strcmp(argv[i], "-m") && i + 1 < argc) {
+            megabytes = (uint32_t) atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [-m megabytes]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    test_params();
+    test_contiguous();
+    test_wrap();
+    test_full_buffer();
+    test_fanout_drop_oldest();
+    test_latest_only();
+    test_block_stalls_writer();
+
+    uint64_t n_blocks = (uint64_t) megabytes * 1000000ULL / FRAME_BYTES;
+    run_bench("3 frames, frame blocks", 3 * FRAME_BYTES, FRAME_BYTES, n_blocks);
+    run_bench("2.5 frames, frame blocks", 5 * FRAME_BYTES / 2, FRAME_BYTES, n_blocks);
+
+    printf("rdm_bench %s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
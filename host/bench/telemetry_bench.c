@@ -0,0 +1,211 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Replays detection streams in simulated time through the telemetry scheduler of app_task
+ * (app_telemetry_sched.c) and through the fixed reporting interval loop it replaced, and
+ * compares detection-to-publish latency and the number of messages sent.
+ *
+ * Streams: idle, sparse detections (random, about one every 5 s) and bursts (one every
+ * 50 ms for 2 s, then quiet). The simulated publish loop mirrors app_task: it wakes when
+ * a detection is notified or when the scheduler says a message is due.
+ * Exits with a non-zero status if a detection is not counted in exactly one message, if
+ * messages come closer than the minimum interval or further apart than the heartbeat, or
+ * if a detection waits longer than the coalescing window plus the minimum interval.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "app_telemetry_sched.h"
+
+#include "bench_util.h"
+
+#define DURATION_MS             (600000U)
+#define FIXED_INTERVAL_MS       (2000U)
+#define MAX_EVENTS              (20000U)
+#define NO_EVENT                UINT32_MAX
+
+typedef struct {
+    const char *name;
+    uint32_t count;
+    uint32_t times_ms[MAX_EVENTS];
+} stream_t;
+
+typedef struct {
+    uint32_t messages;
+    uint32_t events_reported;
+    uint32_t latency_max_ms;
+    uint64_t latency_sum_ms;
+    uint32_t gap_min_ms;
+    uint32_t gap_max_ms;
+} result_t;
+
+static stream_t stream;
+
+static void make_stream(const char *name, uint32_t kind) {
+    memset(&stream, 0, sizeof(stream));
+    stream.name = name;
+    uint32_t t = 0;
+    while (stream.count < MAX_EVENTS) {
+        if (1U == kind) {
+            t += 1000U + bench_rand_below(8000U);
+        } else if (2U == kind) {
+            // 40 detections 50 ms apart, then 10 to 30 s of nothing
+            t += (stream.count % 40U == 0U) ? 10000U + bench_rand_below(20000U) : 50U;
+        } else {
+            break;
+        }
+        if (t >= DURATION_MS) {
+            break;
+        }
+        stream.times_ms[stream.count++] = t;
+    }
+}
+
+// Records a message that reports the oldest events detections not reported yet
+static void record_message(result_t *r, uint32_t now, uint32_t *last, bool *first, uint32_t *next_unreported, uint32_t events) {
+    if (!*first) {
+        uint32_t gap = now - *last;
+        if (gap < r->gap_min_ms) {
+            r->gap_min_ms = gap;
+        }
+        if (gap > r->gap_max_ms) {
+            r->gap_max_ms = gap;
+        }
+    }
+    *first = false;
+    *last = now;
+    r->messages++;
+    r->events_reported += events;
+    for (uint32_t i = 0; i < events && *next_unreported < stream.count; i++) {
+        uint32_t latency = now - stream.times_ms[*next_unreported];
+        r->latency_sum_ms += latency;
+        if (latency > r->latency_max_ms) {
+            r->latency_max_ms = latency;
+        }
+        (*next_unreported)++;
+    }
+}
+
+// The loop app_task used to run: publish, then wait for the reporting interval
+static void run_fixed(result_t *r) {
+    memset(r, 0, sizeof(*r));
+    r->gap_min_ms = UINT32_MAX;
+    uint32_t last = 0;
+    bool first = true;
+    uint32_t next_unreported = 0;
+    for (uint32_t now = 0; now < DURATION_MS; now += FIXED_INTERVAL_MS) {
+        // every detection that arrived before the message
+        uint32_t events = 0;
+        while (next_unreported + events < stream.count && stream.times_ms[next_unreported + events] <= now) {
+            events++;
+        }
+        record_message(r, now, &last, &first, &next_unreported, events);
+    }
+}
+
+// The app_task publish loop, in simulated time
+static void run_sched(result_t *r, const app_telemetry_sched_config_t *config) {
+    memset(r, 0, sizeof(*r));
+    r->gap_min_ms = UINT32_MAX;
+    uint32_t last = 0;
+    bool first = true;
+    uint32_t next_unreported = 0;
+    uint32_t next_event = 0;
+    // start near the wrap around of the millisecond counter
+    const uint32_t base = UINT32_MAX - 30000U;
+
+    app_telemetry_sched_t sched;
+    app_telemetry_sched_init(&sched, config, base);
+    uint32_t now = 0;
+    while (now < DURATION_MS) {
+        uint32_t wait_ms = app_telemetry_sched_wait_ms(&sched, base + now);
+        if (0 == wait_ms) {
+            uint32_t events = app_telemetry_sched_on_publish(&sched, base + now);
+            record_message(r, now, &last, &first, &next_unreported, events);
+            continue;
+        }
+        uint32_t event_at = (next_event < stream.count) ? stream.times_ms[next_event] : NO_EVENT;
+        if (event_at != NO_EVENT && event_at - now <= wait_ms) {
+            // ulTaskNotifyTake() returns early on a detection
+            now = event_at;
+            uint32_t count = 0;
+            while (next_event < stream.count && stream.times_ms[next_event] == now) {
+                next_event++;
+                count++;
+            }
+            app_telemetry_sched_on_events(&sched, count, base + now);
+        } else {
+            now += wait_ms;
+        }
+    }
+}
+
+static void print_result(const char *name, const result_t *r) {
+    printf("    %-14s messages %6u  detections reported %5u  latency ms: mean %7.1f  max %5u  gap ms: min %5u  max %5u\n",
+        name, r->messages, r->events_reported,
+        r->events_reported ? (double) r->latency_sum_ms / r->events_reported : 0.0, r->latency_max_ms,
+        r->gap_min_ms == UINT32_MAX ? 0U : r->gap_min_ms, r->gap_max_ms);
+}
+
+static bool check(const result_t *r, const app_telemetry_sched_config_t *config) {
+    bool ok = true;
+    // detections in the last moments of the run may not be published yet
+    uint32_t published_window = DURATION_MS - config->coalesce_ms - config->min_interval_ms;
+    uint32_t expected = 0;
+    while (expected < stream.count && stream.times_ms[expected] < published_window) {
+        expected++;
+    }
+    if (r->events_reported < expected || r->events_reported > stream.count) {
+        printf("    FAIL: %u detections reported, expected %u to %u\n", r->events_reported, expected, stream.count);
+        ok = false;
+    }
+    if (r->messages > 1 && r->gap_min_ms < config->min_interval_ms) {
+        printf("    FAIL: messages %u ms apart, minimum interval is %u ms\n", r->gap_min_ms, config->min_interval_ms);
+        ok = false;
+    }
+    if (r->gap_max_ms > config->heartbeat_ms) {
+        printf("    FAIL: messages %u ms apart, heartbeat is %u ms\n", r->gap_max_ms, config->heartbeat_ms);
+        ok = false;
+    }
+    if (r->latency_max_ms > config->coalesce_ms + config->min_interval_ms) {
+        printf("    FAIL: a detection waited %u ms\n", r->latency_max_ms);
+        ok = false;
+    }
+    return ok;
+}
+
+int main(void) {
+    static const app_telemetry_sched_config_t configs[] = {
+        {.heartbeat_ms = APP_TELEMETRY_HEARTBEAT_MS, .min_interval_ms = APP_TELEMETRY_MIN_INTERVAL_MS, .coalesce_ms = APP_TELEMETRY_COALESCE_MS},
+        {.heartbeat_ms = 2000U, .min_interval_ms = 0U, .coalesce_ms = 0U},
+        {.heartbeat_ms = 30000U, .min_interval_ms = 1000U, .coalesce_ms = 200U},
+    };
+    static const char *const names[] = {"idle", "sparse", "burst"};
+    bool ok = true;
+
+    srand(1);
+    printf("Telemetry over %u s, fixed interval %u ms vs event driven (heartbeat/min interval/coalesce ms)\n",
+        DURATION_MS / 1000U, FIXED_INTERVAL_MS);
+    for (uint32_t kind = 0; kind < 3; kind++) {
+        make_stream(names[kind], kind);
+        printf("%s: %u detections\n", stream.name, stream.count);
+        result_t r;
+        run_fixed(&r);
+        print_result("fixed", &r);
+        for (uint32_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++) {
+            char name[32];
+            snprintf(name, sizeof(name), "%u/%u/%u", configs[c].heartbeat_ms, configs[c].min_interval_ms, configs[c].coalesce_ms);
+            run_sched(&r, &configs[c]);
+            print_result(name, &r);
+            ok = check(&r, &configs[c]) && ok;
+        }
+    }
+    printf("telemetry_bench %s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
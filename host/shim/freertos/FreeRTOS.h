@@ -0,0 +1,35 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Minimal stand-in for the FreeRTOS kernel, for host builds of modules that only
+ * notify tasks and use critical sections. Only what those modules use is provided. */
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#define pdFALSE ((BaseType_t) 0)
+#define pdTRUE  ((BaseType_t) 1)
+#define pdPASS  pdTRUE
+
+#define portYIELD_FROM_ISR(x) ((void) (x))
+
+#if defined(HOST_THREADED_CRITICAL)
+// Multi-threaded host programs provide these, see shim/pdl/host_cores.h
+void host_enter_critical(void);
+void host_exit_critical(void);
+#define taskENTER_CRITICAL()    host_enter_critical()
+#define taskEXIT_CRITICAL()     host_exit_critical()
+#else
+// Host programs using these stubs are single threaded
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+#endif
+
+#endif // HOST_FREERTOS_H
@@ -0,0 +1,57 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Host stand-in for FreeRTOS task notifications and delays: a task is just its notification
+ * value, which the host program inspects and takes itself. */
+
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include <time.h>
+
+#include "FreeRTOS.h"
+
+struct tskTaskControlBlock {
+    uint32_t notify_value;
+};
+
+typedef struct tskTaskControlBlock *TaskHandle_t;
+
+typedef uint32_t TickType_t;
+
+// One tick per millisecond, on the host monotonic clock
+#define pdMS_TO_TICKS(ms)   ((TickType_t) (ms))
+
+static inline TickType_t xTaskGetTickCount(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (TickType_t) ((uint64_t) ts.tv_sec * 1000U + (uint64_t) ts.tv_nsec / 1000000U);
+}
+
+static inline void vTaskDelay(TickType_t ticks) {
+    struct timespec ts = {.tv_sec = (time_t) (ticks / 1000U), .tv_nsec = (long) (ticks % 1000U) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+
+static inline BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    task->notify_value++;
+    return pdPASS;
+}
+
+static inline void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higher_priority_task_woken) {
+    task->notify_value++;
+    if (higher_priority_task_woken) {
+        *higher_priority_task_woken = pdTRUE;
+    }
+}
+
+// ulTaskNotifyTake(pdTRUE, 0) of the calling task
+static inline uint32_t host_task_notify_take(TaskHandle_t task) {
+    uint32_t value = task->notify_value;
+    task->notify_value = 0;
+    return value;
+}
+
+#endif // HOST_FREERTOS_TASK_H
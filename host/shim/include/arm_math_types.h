@@ -0,0 +1,55 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Host (x86/Linux) stand-in for the CMSIS-DSP arm_math_types.h.
+ * Only the types and constants used by the radar preprocessing code are provided.
+ */
+
+#ifndef HOST_ARM_MATH_TYPES_H
+#define HOST_ARM_MATH_TYPES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef PI
+#define PI               3.14159265358979f
+#endif
+
+typedef float float32_t;
+typedef double float64_t;
+
+typedef enum {
+    ARM_MATH_SUCCESS        =  0,
+    ARM_MATH_ARGUMENT_ERROR = -1,
+    ARM_MATH_LENGTH_ERROR   = -2,
+    ARM_MATH_SIZE_MISMATCH  = -3,
+    ARM_MATH_NANINF         = -4,
+    ARM_MATH_SINGULAR       = -5,
+    ARM_MATH_TEST_FAILURE   = -6,
+    ARM_MATH_DECOMPOSITION_FAILURE = -7
+} arm_status;
+
+typedef struct {
+    uint16_t numRows;
+    uint16_t numCols;
+    float32_t *pData;
+} arm_matrix_instance_f32;
+
+typedef struct {
+    uint16_t fftLen;
+    const float32_t *pTwiddle;  /* exp(-j*2*pi*k/ARM_HOST_MAX_FFT_LEN) table */
+    uint16_t twidStride;        /* table stride for this length */
+} arm_cfft_instance_f32;
+
+typedef struct {
+    arm_cfft_instance_f32 Sint;
+    uint16_t fftLenRFFT;
+} arm_rfft_fast_instance_f32;
+
+#define ARM_HOST_MAX_FFT_LEN (4096U)
+
+#endif /* HOST_ARM_MATH_TYPES_H */
@@ -0,0 +1,13 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Host stand-in for CMSIS-DSP dsp/filtering_functions.h. See arm_math.h. */
+
+#ifndef HOST_DSP_FILTERING_FUNCTIONS_H
+#define HOST_DSP_FILTERING_FUNCTIONS_H
+
+#include "arm_math.h"
+
+#endif /* HOST_DSP_FILTERING_FUNCTIONS_H */
@@ -0,0 +1,46 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Host (x86/Linux) stand-in for the Infineon sensor-dsp library.
+ * Provides reference implementations of the range and Doppler FFT helpers
+ * with the same data layout and side effects as the target library.
+ */
+
+#ifndef HOST_IFX_SENSOR_DSP_H
+#define HOST_IFX_SENSOR_DSP_H
+
+#include <complex.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "arm_math.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IFX_SENSOR_DSP_STATUS_OK        (0)
+#define IFX_SENSOR_DSP_ARGUMENT_ERROR   (1)
+
+typedef float complex cfloat32_t;
+
+/* Real FFT of every chirp in `frame` (n_chirps x n_samples). Mean removal and
+ * windowing are applied to `frame` in place. Output is n_chirps x n_samples/2
+ * complex values in the arm_rfft_fast_f32 packed format. */
+int32_t ifx_range_fft_f32(float32_t *frame, cfloat32_t *range_fft, bool mean_removal,
+                          const float32_t *win_range, uint16_t num_samples_per_chirp,
+                          uint16_t num_chirps_per_frame);
+
+/* Complex FFT along slow time for every range bin of `range_fft`
+ * (n_chirps x n_range_bins). Output is n_range_bins x n_chirps. */
+int32_t ifx_doppler_cfft_f32(cfloat32_t *range_fft, cfloat32_t *doppler_fft, bool mean_removal,
+                             const float32_t *win_doppler, uint16_t num_range_bins,
+                             uint16_t num_chirps_per_frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_IFX_SENSOR_DSP_H */
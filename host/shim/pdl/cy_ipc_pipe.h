@@ -0,0 +1,86 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Host stand-in for the PDL IPC pipe driver, implemented by sim/ipc_host.c.
+ *
+ * As on the device, a message locks the channel of the receiving endpoint until the receiver's
+ * callback has run, and sending to a locked channel fails with CY_IPC_PIPE_ERROR_SEND_BUSY. The
+ * receiving endpoint's pipe ISR runs on the interrupt thread of its core, see ipc_host_run_isr().
+ * The release callback passed with a message runs in the sending endpoint's pipe ISR once the
+ * channel has been released. */
+
+#ifndef HOST_CY_IPC_PIPE_H
+#define HOST_CY_IPC_PIPE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CY_IPC_CH_MASK(chan)        ((uint32_t) (1UL << (chan)))
+#define CY_IPC_INTR_MASK(intr)      ((uint32_t) (1UL << (intr)))
+#define CY_IPC0_INTR_MUX(x)         (x)
+
+typedef enum {
+    CY_IPC_PIPE_SUCCESS = 0,
+    CY_IPC_PIPE_ERROR_NO_IPC,
+    CY_IPC_PIPE_ERROR_SEND_BUSY,
+    CY_IPC_PIPE_ERROR_BAD_CLIENT,
+    CY_IPC_PIPE_ERROR_BAD_HANDLE
+} cy_en_ipc_pipe_status_t;
+
+typedef void (*cy_ipc_pipe_callback_ptr_t)(uint32_t *msg_ptr);
+typedef void (*cy_ipc_pipe_relcallback_ptr_t)(void);
+typedef cy_ipc_pipe_callback_ptr_t *cy_ipc_pipe_callback_array_ptr_t;
+
+typedef struct {
+    uint32_t epChannel;
+    uint32_t epIntr;
+    uint32_t epIntrmask;
+} cy_stc_ipc_pipe_ep_cfg_t;
+
+typedef struct {
+    uint32_t ipcNotifierNumber;
+    uint32_t ipcNotifierPriority;
+    uint32_t ipcNotifierMuxNumber;
+    uint32_t epAddress;
+    cy_stc_ipc_pipe_ep_cfg_t epConfig;
+} cy_stc_ipc_pipe_ep_config_t;
+
+typedef struct {
+    cy_stc_ipc_pipe_ep_config_t ep0ConfigData;  // This core's (receiving) endpoint
+    cy_stc_ipc_pipe_ep_config_t ep1ConfigData;  // The other core's endpoint
+    uint32_t endpointClientsCount;
+    cy_ipc_pipe_callback_array_ptr_t endpointsCallbacksArray;
+    void (*userPipeIsrHandler)(void);
+} cy_stc_ipc_pipe_config_t;
+
+typedef struct {
+    uint32_t unused;
+} cy_stc_ipc_pipe_ep_t;
+
+void Cy_IPC_Pipe_Config(cy_stc_ipc_pipe_ep_t *the_ep_array);
+void Cy_IPC_Pipe_Init(cy_stc_ipc_pipe_config_t const *config);
+cy_en_ipc_pipe_status_t Cy_IPC_Pipe_RegisterCallback(uint32_t ep_addr, cy_ipc_pipe_callback_ptr_t callback, uint32_t client_id);
+cy_en_ipc_pipe_status_t Cy_IPC_Pipe_SendMessage(uint32_t to_addr, uint32_t from_addr, void *msg_ptr,
+    cy_ipc_pipe_relcallback_ptr_t release_callback);
+void Cy_IPC_Pipe_ExecuteCallback(uint32_t ep_addr);
+
+/* Simulator control */
+
+// Runs the pipe ISR of the endpoint on the calling thread whenever a message arrives, until
+// ipc_host_stop_isr(). The thread should belong to the endpoint's core.
+void ipc_host_run_isr(uint32_t ep_addr);
+void ipc_host_stop_isr(uint32_t ep_addr);
+
+// Keeps the channel of the endpoint locked for delay_us after each receive callback
+void ipc_host_set_release_delay(uint32_t ep_addr, uint32_t delay_us);
+
+typedef struct {
+    uint32_t messages;      // Messages delivered
+    uint32_t busy;          // Sends rejected because the channel was still locked
+} ipc_host_pipe_stats_t;
+
+void ipc_host_get_pipe_stats(uint32_t ep_addr, ipc_host_pipe_stats_t *stats);
+
+#endif // HOST_CY_IPC_PIPE_H
@@ -0,0 +1,36 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Host stand-in for the parts of the PDL used by the IPC modules in shared/.
+ * Interrupt masking is emulated per simulated core, see host_cores.h. */
+
+#ifndef HOST_CY_PDL_H
+#define HOST_CY_PDL_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "host_cores.h"
+
+#define __STATIC_INLINE         static inline
+#define CY_SECTION_SHAREDMEM
+#define CY_ASSERT(x)            assert(x)
+#define __disable_irq()         ((void) 0)
+
+static inline uint32_t Cy_SysLib_EnterCriticalSection(void) {
+    host_mask_interrupts();
+    return 0;
+}
+
+static inline void Cy_SysLib_ExitCriticalSection(uint32_t saved_intr_status) {
+    (void) saved_intr_status;
+    host_unmask_interrupts();
+}
+
+#include "cy_ipc_pipe.h"
+
+#endif // HOST_CY_PDL_H
@@ -0,0 +1,13 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Host stand-in for the BSP, only pulls in the PDL stand-in. */
+
+#ifndef HOST_CYBSP_H
+#define HOST_CYBSP_H
+
+#include "cy_pdl.h"
+
+#endif // HOST_CYBSP_H
@@ -0,0 +1,44 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Emulation of the two cores for host simulators. Every thread belongs to a core, either as a
+ * task or as that core's interrupt handler. Per core:
+ *
+ *  - host_mask_interrupts() masks all interrupts (PRIMASK, Cy_SysLib_EnterCriticalSection()):
+ *    the interrupt thread of the core does not run an ISR while a task holds it.
+ *  - host_enter_critical() is taskENTER_CRITICAL() (BASEPRI): it serializes the tasks of the core,
+ *    but only holds off ISRs whose priority is below configMAX_SYSCALL_INTERRUPT_PRIORITY, as set
+ *    with host_core_set_isr_maskable().
+ *
+ * Both nest, like their firmware counterparts.
+ */
+
+#ifndef HOST_CORES_H
+#define HOST_CORES_H
+
+#include <stdbool.h>
+
+typedef enum {
+    HOST_CORE_CM33,
+    HOST_CORE_CM55,
+    HOST_CORE_COUNT
+} host_core_t;
+
+// Sets the core of the calling thread
+void host_core_set(host_core_t core);
+host_core_t host_core_get(void);
+
+// Whether taskENTER_CRITICAL() on the core holds off its interrupts
+void host_core_set_isr_maskable(host_core_t core, bool maskable);
+
+void host_mask_interrupts(void);
+void host_unmask_interrupts(void);
+void host_enter_critical(void);
+void host_exit_critical(void);
+
+// Runs isr() as an interrupt of the calling thread's core
+void host_core_run_isr(void (*isr)(void));
+
+#endif // HOST_CORES_H
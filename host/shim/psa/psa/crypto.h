@@ -0,0 +1,116 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Host stand-in for the part of the PSA Crypto API that the CM33 application uses outside of mbedtls:
+ * HKDF-SHA-256 from the HUK into volatile AES keys, AES-GCM and random numbers. It runs on OpenSSL.
+ * The HUK is a built-in key with the same ID as on the device, its value set by host_psa_set_huk().
+ * Values of the constants follow the PSA Crypto API 1.1 specification.
+ */
+
+#ifndef HOST_PSA_CRYPTO_H
+#define HOST_PSA_CRYPTO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int32_t psa_status_t;
+typedef uint32_t psa_key_id_t;
+typedef uint32_t psa_algorithm_t;
+typedef uint16_t psa_key_type_t;
+typedef uint32_t psa_key_usage_t;
+typedef uint32_t psa_key_lifetime_t;
+typedef uint16_t psa_key_derivation_step_t;
+
+#define PSA_SUCCESS                     ((psa_status_t) 0)
+#define PSA_ERROR_GENERIC_ERROR         ((psa_status_t) -132)
+#define PSA_ERROR_NOT_SUPPORTED         ((psa_status_t) -134)
+#define PSA_ERROR_INVALID_ARGUMENT      ((psa_status_t) -135)
+#define PSA_ERROR_INVALID_HANDLE        ((psa_status_t) -136)
+#define PSA_ERROR_BAD_STATE             ((psa_status_t) -137)
+#define PSA_ERROR_BUFFER_TOO_SMALL      ((psa_status_t) -138)
+#define PSA_ERROR_DOES_NOT_EXIST        ((psa_status_t) -140)
+#define PSA_ERROR_INSUFFICIENT_STORAGE  ((psa_status_t) -142)
+#define PSA_ERROR_INVALID_SIGNATURE     ((psa_status_t) -149)
+#define PSA_ERROR_DATA_CORRUPT          ((psa_status_t) -152)
+
+#define PSA_KEY_ID_NULL                 ((psa_key_id_t) 0)
+#define PSA_ALG_SHA_256                 ((psa_algorithm_t) 0x02000009)
+#define PSA_ALG_HKDF(hash_alg)          ((psa_algorithm_t) (0x08000100 | ((hash_alg) & 0x000000ff)))
+#define PSA_ALG_GCM                     ((psa_algorithm_t) 0x05500200)
+#define PSA_KEY_TYPE_AES                ((psa_key_type_t) 0x2400)
+#define PSA_KEY_USAGE_ENCRYPT           ((psa_key_usage_t) 0x00000100)
+#define PSA_KEY_USAGE_DECRYPT           ((psa_key_usage_t) 0x00000200)
+#define PSA_KEY_LIFETIME_VOLATILE       ((psa_key_lifetime_t) 0x00000000)
+#define PSA_KEY_DERIVATION_INPUT_SECRET ((psa_key_derivation_step_t) 0x0101)
+#define PSA_KEY_DERIVATION_INPUT_INFO   ((psa_key_derivation_step_t) 0x0203)
+
+// The die-unique key of the device
+#define HOST_PSA_HUK_KEY_ID             ((psa_key_id_t) 0x7FFF0000U)
+#define HOST_PSA_HUK_SIZE               32
+
+typedef struct {
+    psa_key_type_t type;
+    size_t bits;
+    psa_key_usage_t usage;
+    psa_algorithm_t alg;
+    psa_key_lifetime_t lifetime;
+} psa_key_attributes_t;
+
+#define PSA_KEY_ATTRIBUTES_INIT         {0, 0, 0, 0, 0}
+
+typedef struct {
+    psa_algorithm_t alg;
+    int has_secret;
+    uint8_t secret[HOST_PSA_HUK_SIZE];
+    uint8_t info[128];
+    size_t info_len;
+} psa_key_derivation_operation_t;
+
+#define PSA_KEY_DERIVATION_OPERATION_INIT   {0, 0, {0}, {0}, 0}
+
+static inline void psa_set_key_type(psa_key_attributes_t* attributes, psa_key_type_t type) {
+    attributes->type = type;
+}
+
+static inline void psa_set_key_bits(psa_key_attributes_t* attributes, size_t bits) {
+    attributes->bits = bits;
+}
+
+static inline void psa_set_key_usage_flags(psa_key_attributes_t* attributes, psa_key_usage_t usage) {
+    attributes->usage = usage;
+}
+
+static inline void psa_set_key_algorithm(psa_key_attributes_t* attributes, psa_algorithm_t alg) {
+    attributes->alg = alg;
+}
+
+static inline void psa_set_key_lifetime(psa_key_attributes_t* attributes, psa_key_lifetime_t lifetime) {
+    attributes->lifetime = lifetime;
+}
+
+psa_status_t psa_crypto_init(void);
+psa_status_t psa_generate_random(uint8_t* output, size_t output_size);
+psa_status_t psa_destroy_key(psa_key_id_t key);
+
+psa_status_t psa_key_derivation_setup(psa_key_derivation_operation_t* operation, psa_algorithm_t alg);
+psa_status_t psa_key_derivation_input_key(psa_key_derivation_operation_t* operation, psa_key_derivation_step_t step,
+    psa_key_id_t key);
+psa_status_t psa_key_derivation_input_bytes(psa_key_derivation_operation_t* operation, psa_key_derivation_step_t step,
+    const uint8_t* data, size_t data_length);
+psa_status_t psa_key_derivation_output_key(const psa_key_attributes_t* attributes,
+    psa_key_derivation_operation_t* operation, psa_key_id_t* key);
+psa_status_t psa_key_derivation_abort(psa_key_derivation_operation_t* operation);
+
+psa_status_t psa_aead_encrypt(psa_key_id_t key, psa_algorithm_t alg, const uint8_t* nonce, size_t nonce_length,
+    const uint8_t* additional_data, size_t additional_data_length, const uint8_t* plaintext, size_t plaintext_length,
+    uint8_t* ciphertext, size_t ciphertext_size, size_t* ciphertext_length);
+psa_status_t psa_aead_decrypt(psa_key_id_t key, psa_algorithm_t alg, const uint8_t* nonce, size_t nonce_length,
+    const uint8_t* additional_data, size_t additional_data_length, const uint8_t* ciphertext, size_t ciphertext_length,
+    uint8_t* plaintext, size_t plaintext_size, size_t* plaintext_length);
+
+// Sets the value of the HUK, as if running on another device
+void host_psa_set_huk(const uint8_t huk[HOST_PSA_HUK_SIZE]);
+
+#endif // HOST_PSA_CRYPTO_H
@@ -0,0 +1,43 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Host stand-in for PSA Internal Trusted Storage 1.0, kept in memory. A get may ask for more than is
+ * stored and returns what there is, as TF-M does. Counts the writes and lets the tools change stored
+ * bytes to simulate corruption.
+ */
+
+#ifndef HOST_PSA_ITS_H
+#define HOST_PSA_ITS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "psa/crypto.h"
+
+typedef uint64_t psa_storage_uid_t;
+typedef uint32_t psa_storage_create_flags_t;
+
+#define PSA_STORAGE_FLAG_NONE           ((psa_storage_create_flags_t) 0)
+
+#define HOST_ITS_ENTRIES                16
+// ITS_MAX_ASSET_SIZE of TF-M, which proj_cm33_s keeps at its default. A larger entry is refused as on the device
+#define HOST_ITS_ASSET_MAX              512
+
+psa_status_t psa_its_set(psa_storage_uid_t uid, size_t data_length, const void* p_data,
+    psa_storage_create_flags_t create_flags);
+psa_status_t psa_its_get(psa_storage_uid_t uid, size_t data_offset, size_t data_length, void* p_data,
+    size_t* p_data_length);
+psa_status_t psa_its_remove(psa_storage_uid_t uid);
+
+// Writes done by psa_its_set() so far
+uint32_t host_its_writes(void);
+// Size of the entry, 0 if there is none
+size_t host_its_size(psa_storage_uid_t uid);
+// Flips the bits of mask in the byte at offset of the entry
+void host_its_corrupt(psa_storage_uid_t uid, size_t offset, uint8_t mask);
+// Removes every entry, as a factory reset would
+void host_its_clear(void);
+
+#endif // HOST_PSA_ITS_H
@@ -0,0 +1,290 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* The PSA Crypto and ITS stand-ins of psa/crypto.h and psa/internal_trusted_storage.h, on OpenSSL */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <openssl/core_names.h>
+#include <openssl/evp.h>
+#include <openssl/kdf.h>
+#include <openssl/rand.h>
+
+#include "psa/crypto.h"
+#include "psa/internal_trusted_storage.h"
+
+#define KEY_SLOTS   8
+#define KEY_MAX     32
+#define GCM_TAG     16
+
+typedef struct {
+    bool used;
+    psa_key_attributes_t attrs;
+    uint8_t value[KEY_MAX];
+} key_slot_t;
+
+typedef struct {
+    bool used;
+    psa_storage_uid_t uid;
+    size_t size;
+    uint8_t data[HOST_ITS_ASSET_MAX];
+} its_entry_t;
+
+static uint8_t huk[HOST_PSA_HUK_SIZE] = {
+    0x48, 0x55, 0x4b, 0x20, 0x6f, 0x66, 0x20, 0x74, 0x68, 0x65, 0x20, 0x68, 0x6f, 0x73, 0x74, 0x20,
+    0x73, 0x74, 0x61, 0x6e, 0x64, 0x2d, 0x69, 0x6e, 0x20, 0x64, 0x65, 0x76, 0x69, 0x63, 0x65, 0x21
+};
+static key_slot_t keys[KEY_SLOTS];
+static its_entry_t its[HOST_ITS_ENTRIES];
+static uint32_t its_writes;
+
+void host_psa_set_huk(const uint8_t value[HOST_PSA_HUK_SIZE]) {
+    memcpy(huk, value, sizeof(huk));
+}
+
+psa_status_t psa_crypto_init(void) {
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_generate_random(uint8_t* output, size_t output_size) {
+    return (1 == RAND_bytes(output, (int) output_size)) ? PSA_SUCCESS : PSA_ERROR_GENERIC_ERROR;
+}
+
+static key_slot_t* get_key(psa_key_id_t key, psa_algorithm_t alg, psa_key_usage_t usage) {
+    if (key < 1 || key > KEY_SLOTS || !keys[key - 1].used) {
+        return NULL;
+    }
+    key_slot_t* slot = &keys[key - 1];
+    return (slot->attrs.alg == alg && (slot->attrs.usage & usage) == usage) ? slot : NULL;
+}
+
+psa_status_t psa_destroy_key(psa_key_id_t key) {
+    if (key < 1 || key > KEY_SLOTS || !keys[key - 1].used) {
+        return PSA_ERROR_INVALID_HANDLE;
+    }
+    memset(&keys[key - 1], 0, sizeof(keys[key - 1]));
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_key_derivation_setup(psa_key_derivation_operation_t* operation, psa_algorithm_t alg) {
+    if (alg != PSA_ALG_HKDF(PSA_ALG_SHA_256)) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+    memset(operation, 0, sizeof(*operation));
+    operation->alg = alg;
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_key_derivation_input_key(psa_key_derivation_operation_t* operation, psa_key_derivation_step_t step,
+        psa_key_id_t key) {
+    if (step != PSA_KEY_DERIVATION_INPUT_SECRET || 0 == operation->alg) {
+        return PSA_ERROR_BAD_STATE;
+    }
+    if (key != HOST_PSA_HUK_KEY_ID) {
+        return PSA_ERROR_INVALID_HANDLE;
+    }
+    memcpy(operation->secret, huk, sizeof(operation->secret));
+    operation->has_secret = 1;
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_key_derivation_input_bytes(psa_key_derivation_operation_t* operation, psa_key_derivation_step_t step,
+        const uint8_t* data, size_t data_length) {
+    if (step != PSA_KEY_DERIVATION_INPUT_INFO || !operation->has_secret) {
+        return PSA_ERROR_BAD_STATE;
+    }
+    if (data_length > sizeof(operation->info)) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+    memcpy(operation->info, data, data_length);
+    operation->info_len = data_length;
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_key_derivation_output_key(const psa_key_attributes_t* attributes,
+        psa_key_derivation_operation_t* operation, psa_key_id_t* key) {
+    if (!operation->has_secret) {
+        return PSA_ERROR_BAD_STATE;
+    }
+    if (attributes->type != PSA_KEY_TYPE_AES || attributes->bits != 8 * KEY_MAX) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+    uint32_t i = 0;
+    while (i < KEY_SLOTS && keys[i].used) {
+        i++;
+    }
+    if (i == KEY_SLOTS) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+
+    // HKDF without a salt, as PSA does when the salt step is left out
+    EVP_KDF* kdf = EVP_KDF_fetch(NULL, "HKDF", NULL);
+    EVP_KDF_CTX* ctx = kdf ? EVP_KDF_CTX_new(kdf) : NULL;
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_utf8_string(OSSL_KDF_PARAM_DIGEST, "SHA256", 0),
+        OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_KEY, operation->secret, sizeof(operation->secret)),
+        OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_INFO, operation->info, operation->info_len),
+        OSSL_PARAM_construct_end()
+    };
+    int ok = ctx && 1 == EVP_KDF_derive(ctx, keys[i].value, KEY_MAX, params);
+    EVP_KDF_CTX_free(ctx);
+    EVP_KDF_free(kdf);
+    if (!ok) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+    keys[i].used = true;
+    keys[i].attrs = *attributes;
+    *key = i + 1;
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_key_derivation_abort(psa_key_derivation_operation_t* operation) {
+    memset(operation, 0, sizeof(*operation));
+    return PSA_SUCCESS;
+}
+
+static psa_status_t gcm(bool encrypt, const key_slot_t* slot, const uint8_t* nonce, size_t nonce_length,
+        const uint8_t* aad, size_t aad_length, const uint8_t* in, size_t in_length, uint8_t* out, uint8_t* tag) {
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    int len = 0;
+    int ok = ctx
+        && 1 == EVP_CipherInit_ex(ctx, EVP_aes_256_gcm(), NULL, NULL, NULL, encrypt)
+        && 1 == EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN, (int) nonce_length, NULL)
+        && 1 == EVP_CipherInit_ex(ctx, NULL, NULL, slot->value, nonce, encrypt)
+        && 1 == EVP_CipherUpdate(ctx, NULL, &len, aad, (int) aad_length)
+        && 1 == EVP_CipherUpdate(ctx, out, &len, in, (int) in_length)
+        && (encrypt || 1 == EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, GCM_TAG, tag));
+    psa_status_t status = ok ? PSA_SUCCESS : PSA_ERROR_GENERIC_ERROR;
+    if (ok && 1 != EVP_CipherFinal_ex(ctx, out + len, &len)) {
+        status = encrypt ? PSA_ERROR_GENERIC_ERROR : PSA_ERROR_INVALID_SIGNATURE;
+    }
+    if (PSA_SUCCESS == status && encrypt && 1 != EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, GCM_TAG, tag)) {
+        status = PSA_ERROR_GENERIC_ERROR;
+    }
+    EVP_CIPHER_CTX_free(ctx);
+    return status;
+}
+
+psa_status_t psa_aead_encrypt(psa_key_id_t key, psa_algorithm_t alg, const uint8_t* nonce, size_t nonce_length,
+        const uint8_t* additional_data, size_t additional_data_length, const uint8_t* plaintext, size_t plaintext_length,
+        uint8_t* ciphertext, size_t ciphertext_size, size_t* ciphertext_length) {
+    const key_slot_t* slot = get_key(key, alg, PSA_KEY_USAGE_ENCRYPT);
+    if (NULL == slot) {
+        return PSA_ERROR_INVALID_HANDLE;
+    }
+    if (ciphertext_size < plaintext_length + GCM_TAG) {
+        return PSA_ERROR_BUFFER_TOO_SMALL;
+    }
+    psa_status_t status = gcm(true, slot, nonce, nonce_length, additional_data, additional_data_length,
+        plaintext, plaintext_length, ciphertext, ciphertext + plaintext_length);
+    *ciphertext_length = (PSA_SUCCESS == status) ? plaintext_length + GCM_TAG : 0;
+    return status;
+}
+
+psa_status_t psa_aead_decrypt(psa_key_id_t key, psa_algorithm_t alg, const uint8_t* nonce, size_t nonce_length,
+        const uint8_t* additional_data, size_t additional_data_length, const uint8_t* ciphertext, size_t ciphertext_length,
+        uint8_t* plaintext, size_t plaintext_size, size_t* plaintext_length) {
+    const key_slot_t* slot = get_key(key, alg, PSA_KEY_USAGE_DECRYPT);
+    if (NULL == slot) {
+        return PSA_ERROR_INVALID_HANDLE;
+    }
+    if (ciphertext_length < GCM_TAG) {
+        return PSA_ERROR_INVALID_SIGNATURE;
+    }
+    size_t length = ciphertext_length - GCM_TAG;
+    if (plaintext_size < length) {
+        return PSA_ERROR_BUFFER_TOO_SMALL;
+    }
+    uint8_t tag[GCM_TAG];
+    memcpy(tag, ciphertext + length, sizeof(tag));
+    psa_status_t status = gcm(false, slot, nonce, nonce_length, additional_data, additional_data_length,
+        ciphertext, length, plaintext, tag);
+    if (PSA_SUCCESS != status) {
+        memset(plaintext, 0, length);
+        length = 0;
+    }
+    *plaintext_length = length;
+    return status;
+}
+
+static its_entry_t* find_entry(psa_storage_uid_t uid) {
+    for (uint32_t i = 0; i < HOST_ITS_ENTRIES; i++) {
+        if (its[i].used && its[i].uid == uid) {
+            return &its[i];
+        }
+    }
+    return NULL;
+}
+
+psa_status_t psa_its_set(psa_storage_uid_t uid, size_t data_length, const void* p_data,
+        psa_storage_create_flags_t create_flags) {
+    (void) create_flags;
+    if (data_length > HOST_ITS_ASSET_MAX) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+    its_entry_t* entry = find_entry(uid);
+    for (uint32_t i = 0; NULL == entry && i < HOST_ITS_ENTRIES; i++) {
+        if (!its[i].used) {
+            entry = &its[i];
+        }
+    }
+    if (NULL == entry) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+    entry->used = true;
+    entry->uid = uid;
+    entry->size = data_length;
+    memcpy(entry->data, p_data, data_length);
+    its_writes++;
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_its_get(psa_storage_uid_t uid, size_t data_offset, size_t data_length, void* p_data,
+        size_t* p_data_length) {
+    const its_entry_t* entry = find_entry(uid);
+    if (NULL == entry) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+    if (data_offset > entry->size) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+    size_t length = entry->size - data_offset;
+    if (length > data_length) {
+        length = data_length;
+    }
+    memcpy(p_data, entry->data + data_offset, length);
+    *p_data_length = length;
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_its_remove(psa_storage_uid_t uid) {
+    its_entry_t* entry = find_entry(uid);
+    if (NULL == entry) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+    memset(entry, 0, sizeof(*entry));
+    return PSA_SUCCESS;
+}
+
+uint32_t host_its_writes(void) {
+    return its_writes;
+}
+
+size_t host_its_size(psa_storage_uid_t uid) {
+    const its_entry_t* entry = find_entry(uid);
+    return entry ? entry->size : 0;
+}
+
+void host_its_corrupt(psa_storage_uid_t uid, size_t offset, uint8_t mask) {
+    its_entry_t* entry = find_entry(uid);
+    if (entry && offset < entry->size) {
+        entry->data[offset] ^= mask;
+    }
+}
+
+void host_its_clear(void) {
+    memset(its, 0, sizeof(its));
+}
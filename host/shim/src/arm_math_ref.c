@@ -0,0 +1,265 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Plain C reference implementations of the CMSIS-DSP functions used by the
+ * radar preprocessing code, for host builds only. */
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "arm_math.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// basic math
+
+void arm_scale_f32(const float32_t *pSrc, float32_t scale, float32_t *pDst, uint32_t blockSize) {
+    for (uint32_t i = 0; i < blockSize; i++) {
+        pDst[i] = pSrc[i] * scale;
+    }
+}
+
+void arm_mult_f32(const float32_t *pSrcA, const float32_t *pSrcB, float32_t *pDst, uint32_t blockSize) {
+    for (uint32_t i = 0; i < blockSize; i++) {
+        pDst[i] = pSrcA[i] * pSrcB[i];
+    }
+}
+
+void arm_offset_f32(const float32_t *pSrc, float32_t offset, float32_t *pDst, uint32_t blockSize) {
+    for (uint32_t i = 0; i < blockSize; i++) {
+        pDst[i] = pSrc[i] + offset;
+    }
+}
+
+void arm_add_f32(const float32_t *pSrcA, const float32_t *pSrcB, float32_t *pDst, uint32_t blockSize) {
+    for (uint32_t i = 0; i < blockSize; i++) {
+        pDst[i] = pSrcA[i] + pSrcB[i];
+    }
+}
+
+void arm_sub_f32(const float32_t *pSrcA, const float32_t *pSrcB, float32_t *pDst, uint32_t blockSize) {
+    for (uint32_t i = 0; i < blockSize; i++) {
+        pDst[i] = pSrcA[i] - pSrcB[i];
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// complex math
+
+void arm_cmplx_mag_f32(const float32_t *pSrc, float32_t *pDst, uint32_t numSamples) {
+    for (uint32_t i = 0; i < numSamples; i++) {
+        float32_t re = pSrc[2 * i];
+        float32_t im = pSrc[2 * i + 1];
+        pDst[i] = sqrtf(re * re + im * im);
+    }
+}
+
+void arm_cmplx_mult_real_f32(const float32_t *pSrcCmplx, const float32_t *pSrcReal, float32_t *pCmplxDst,
+                             uint32_t numSamples) {
+    for (uint32_t i = 0; i < numSamples; i++) {
+        pCmplxDst[2 * i] = pSrcCmplx[2 * i] * pSrcReal[i];
+        pCmplxDst[2 * i + 1] = pSrcCmplx[2 * i + 1] * pSrcReal[i];
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// fast math
+
+arm_status arm_atan2_f32(float32_t y, float32_t x, float32_t *result) {
+    if (x == 0.0f && y == 0.0f) {
+        *result = 0.0f;
+        return ARM_MATH_NANINF;
+    }
+    *result = atan2f(y, x);
+    return ARM_MATH_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// matrix
+
+arm_status arm_mat_cmplx_trans_f32(const arm_matrix_instance_f32 *pSrc, arm_matrix_instance_f32 *pDst) {
+    // Same as CMSIS-DSP without ARM_MATH_MATRIX_CHECK: source dimensions drive the transpose
+    uint16_t n_rows = pSrc->numRows;
+    uint16_t n_cols = pSrc->numCols;
+    for (uint16_t r = 0; r < n_rows; r++) {
+        for (uint16_t c = 0; c < n_cols; c++) {
+            pDst->pData[2 * (c * n_rows + r)] = pSrc->pData[2 * (r * n_cols + c)];
+            pDst->pData[2 * (c * n_rows + r) + 1] = pSrc->pData[2 * (r * n_cols + c) + 1];
+        }
+    }
+    return ARM_MATH_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// statistics and support
+
+void arm_max_f32(const float32_t *pSrc, uint32_t blockSize, float32_t *pResult, uint32_t *pIndex) {
+    float32_t max_val = pSrc[0];
+    uint32_t max_idx = 0;
+    for (uint32_t i = 1; i < blockSize; i++) {
+        if (pSrc[i] > max_val) {
+            max_val = pSrc[i];
+            max_idx = i;
+        }
+    }
+    *pResult = max_val;
+    *pIndex = max_idx;
+}
+
+void arm_mean_f32(const float32_t *pSrc, uint32_t blockSize, float32_t *pResult) {
+    float32_t sum = 0.0f;
+    for (uint32_t i = 0; i < blockSize; i++) {
+        sum += pSrc[i];
+    }
+    *pResult = sum / (float32_t) blockSize;
+}
+
+void arm_fill_f32(float32_t value, float32_t *pDst, uint32_t blockSize) {
+    for (uint32_t i = 0; i < blockSize; i++) {
+        pDst[i] = value;
+    }
+}
+
+void arm_copy_f32(const float32_t *pSrc, float32_t *pDst, uint32_t blockSize) {
+    memmove(pDst, pSrc, blockSize * sizeof(float32_t));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// filtering
+
+void arm_conv_f32(const float32_t *pSrcA, uint32_t srcALen, const float32_t *pSrcB, uint32_t srcBLen, float32_t *pDst) {
+    uint32_t out_len = srcALen + srcBLen - 1;
+    for (uint32_t n = 0; n < out_len; n++) {
+        float32_t sum = 0.0f;
+        uint32_t k_min = (n >= srcBLen - 1) ? n - (srcBLen - 1) : 0;
+        uint32_t k_max = (n < srcALen - 1) ? n : srcALen - 1;
+        for (uint32_t k = k_min; k <= k_max; k++) {
+            sum += pSrcA[k] * pSrcB[n - k];
+        }
+        pDst[n] = sum;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// transforms
+
+// exp(-j*2*pi*k/ARM_HOST_MAX_FFT_LEN) for k in [0, ARM_HOST_MAX_FFT_LEN/2), interleaved re/im
+static float32_t twiddle_table[ARM_HOST_MAX_FFT_LEN];
+static bool twiddle_table_ready = false;
+
+static bool is_supported_fft_len(uint16_t len) {
+    return len >= 16 && len <= ARM_HOST_MAX_FFT_LEN && (len & (len - 1)) == 0;
+}
+
+arm_status arm_cfft_init_f32(arm_cfft_instance_f32 *S, uint16_t fftLen) {
+    if (!is_supported_fft_len(fftLen)) {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    if (!twiddle_table_ready) {
+        for (uint32_t k = 0; k < ARM_HOST_MAX_FFT_LEN / 2; k++) {
+            double phi = -2.0 * M_PI * (double) k / (double) ARM_HOST_MAX_FFT_LEN;
+            twiddle_table[2 * k] = (float32_t) cos(phi);
+            twiddle_table[2 * k + 1] = (float32_t) sin(phi);
+        }
+        twiddle_table_ready = true;
+    }
+    S->fftLen = fftLen;
+    S->pTwiddle = twiddle_table;
+    S->twidStride = (uint16_t) (ARM_HOST_MAX_FFT_LEN / fftLen);
+    return ARM_MATH_SUCCESS;
+}
+
+static void bit_reverse_cf32(float32_t *p, uint16_t n) {
+    uint32_t j = 0;
+    for (uint32_t i = 0; i < n - 1U; i++) {
+        if (i < j) {
+            float32_t re = p[2 * i];
+            float32_t im = p[2 * i + 1];
+            p[2 * i] = p[2 * j];
+            p[2 * i + 1] = p[2 * j + 1];
+            p[2 * j] = re;
+            p[2 * j + 1] = im;
+        }
+        uint32_t bit = n >> 1;
+        while (j & bit) {
+            j ^= bit;
+            bit >>= 1;
+        }
+        j |= bit;
+    }
+}
+
+void arm_cfft_f32(const arm_cfft_instance_f32 *S, float32_t *p1, uint8_t ifftFlag, uint8_t bitReverseFlag) {
+    uint16_t n = S->fftLen;
+    float32_t sign = ifftFlag ? -1.0f : 1.0f;
+
+    // Iterative radix-2 decimation in time: bit-reverse first, then butterflies
+    bit_reverse_cf32(p1, n);
+    for (uint32_t len = 2; len <= n; len <<= 1) {
+        uint32_t half = len >> 1;
+        uint32_t step = (uint32_t) S->twidStride * (n / len);
+        for (uint32_t start = 0; start < n; start += len) {
+            for (uint32_t k = 0; k < half; k++) {
+                float32_t wr = S->pTwiddle[2 * k * step];
+                float32_t wi = sign * S->pTwiddle[2 * k * step + 1];
+                float32_t *a = p1 + 2 * (start + k);
+                float32_t *b = p1 + 2 * (start + k + half);
+                float32_t tr = b[0] * wr - b[1] * wi;
+                float32_t ti = b[0] * wi + b[1] * wr;
+                b[0] = a[0] - tr;
+                b[1] = a[1] - ti;
+                a[0] += tr;
+                a[1] += ti;
+            }
+        }
+    }
+    if (ifftFlag) {
+        arm_scale_f32(p1, 1.0f / (float32_t) n, p1, 2U * n);
+    }
+    if (!bitReverseFlag) {
+        // CMSIS leaves the output in bit-reversed order when not asked to reorder
+        bit_reverse_cf32(p1, n);
+    }
+}
+
+arm_status arm_rfft_fast_init_f32(arm_rfft_fast_instance_f32 *S, uint16_t fftLen) {
+    if (fftLen < 32 || !is_supported_fft_len(fftLen)) {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    S->fftLenRFFT = fftLen;
+    return arm_cfft_init_f32(&S->Sint, fftLen);
+}
+
+void arm_rfft_fast_f32(const arm_rfft_fast_instance_f32 *S, float32_t *p, float32_t *pOut, uint8_t ifftFlag) {
+    uint16_t n = S->fftLenRFFT;
+    float32_t buf[2 * ARM_HOST_MAX_FFT_LEN];
+
+    if (!ifftFlag) {
+        for (uint16_t i = 0; i < n; i++) {
+            buf[2 * i] = p[i];
+            buf[2 * i + 1] = 0.0f;
+        }
+        arm_cfft_f32(&S->Sint, buf, 0, 1);
+        // Packed format: [X0.re, X(N/2).re, X1.re, X1.im, ... X(N/2-1).re, X(N/2-1).im]
+        pOut[0] = buf[0];
+        pOut[1] = buf[n];
+        memcpy(pOut + 2, buf + 2, (size_t) (n - 2) * sizeof(float32_t));
+    } else {
+        buf[0] = p[0];
+        buf[1] = 0.0f;
+        buf[n] = p[1];
+        buf[n + 1] = 0.0f;
+        for (uint16_t k = 1; k < n / 2; k++) {
+            buf[2 * k] = p[2 * k];
+            buf[2 * k + 1] = p[2 * k + 1];
+            buf[2 * (n - k)] = p[2 * k];
+            buf[2 * (n - k) + 1] = -p[2 * k + 1];
+        }
+        arm_cfft_f32(&S->Sint, buf, 1, 1);
+        for (uint16_t i = 0; i < n; i++) {
+            pOut[i] = buf[2 * i];
+        }
+    }
+}
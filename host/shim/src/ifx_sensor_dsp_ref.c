@@ -0,0 +1,67 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Reference implementation of the sensor-dsp range/Doppler helpers, for host builds only. */
+
+#include "ifx_sensor_dsp.h"
+
+int32_t ifx_range_fft_f32(float32_t *frame, cfloat32_t *range_fft, bool mean_removal,
+                          const float32_t *win_range, uint16_t num_samples_per_chirp,
+                          uint16_t num_chirps_per_frame) {
+    arm_rfft_fast_instance_f32 rfft;
+    if (NULL == frame || NULL == range_fft ||
+        ARM_MATH_SUCCESS != arm_rfft_fast_init_f32(&rfft, num_samples_per_chirp)) {
+        return IFX_SENSOR_DSP_ARGUMENT_ERROR;
+    }
+
+    for (uint16_t chirp = 0; chirp < num_chirps_per_frame; chirp++) {
+        if (mean_removal) {
+            float32_t mean;
+            arm_mean_f32(frame, num_samples_per_chirp, &mean);
+            arm_offset_f32(frame, -mean, frame, num_samples_per_chirp);
+        }
+        if (NULL != win_range) {
+            arm_mult_f32(frame, win_range, frame, num_samples_per_chirp);
+        }
+        arm_rfft_fast_f32(&rfft, frame, (float32_t *) range_fft, 0);
+        frame += num_samples_per_chirp;
+        range_fft += num_samples_per_chirp / 2;
+    }
+    return IFX_SENSOR_DSP_STATUS_OK;
+}
+
+int32_t ifx_doppler_cfft_f32(cfloat32_t *range_fft, cfloat32_t *doppler_fft, bool mean_removal,
+                             const float32_t *win_doppler, uint16_t num_range_bins,
+                             uint16_t num_chirps_per_frame) {
+    arm_cfft_instance_f32 cfft;
+    if (NULL == range_fft || NULL == doppler_fft ||
+        ARM_MATH_SUCCESS != arm_cfft_init_f32(&cfft, num_chirps_per_frame)) {
+        return IFX_SENSOR_DSP_ARGUMENT_ERROR;
+    }
+
+    for (uint16_t bin = 0; bin < num_range_bins; bin++) {
+        cfloat32_t *out = doppler_fft + bin * num_chirps_per_frame;
+        for (uint16_t chirp = 0; chirp < num_chirps_per_frame; chirp++) {
+            out[chirp] = range_fft[chirp * num_range_bins + bin];
+        }
+        if (mean_removal) {
+            cfloat32_t mean = 0.0f;
+            for (uint16_t chirp = 0; chirp < num_chirps_per_frame; chirp++) {
+                mean += out[chirp];
+            }
+            mean /= (float32_t) num_chirps_per_frame;
+            for (uint16_t chirp = 0; chirp < num_chirps_per_frame; chirp++) {
+                out[chirp] -= mean;
+            }
+        }
+        if (NULL != win_doppler) {
+            for (uint16_t chirp = 0; chirp < num_chirps_per_frame; chirp++) {
+                out[chirp] *= win_doppler[chirp];
+            }
+        }
+        arm_cfft_f32(&cfft, (float32_t *) out, 0, 1);
+    }
+    return IFX_SENSOR_DSP_STATUS_OK;
+}
@@ -0,0 +1,234 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Host implementation of the emulated cores (shim/pdl/host_cores.h) and of the IPC pipe driver
+ * (shim/pdl/cy_ipc_pipe.h) that the shared/ IPC modules are built against in the simulators. */
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <time.h>
+
+#include "host_cores.h"
+#include "cy_ipc_pipe.h"
+
+#define HOST_IPC_MAX_ENDPOINTS  (8U)
+
+typedef struct {
+    pthread_mutex_t primask;
+    pthread_mutex_t basepri;
+    bool isr_maskable;
+} host_core_state_t;
+
+static host_core_state_t cores[HOST_CORE_COUNT] = {
+    [HOST_CORE_CM33] = {PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP, PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP, false},
+    [HOST_CORE_CM55] = {PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP, PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP, false},
+};
+
+static __thread host_core_t thread_core = HOST_CORE_CM33;
+
+void host_core_set(host_core_t core) {
+    thread_core = core;
+}
+
+host_core_t host_core_get(void) {
+    return thread_core;
+}
+
+void host_core_set_isr_maskable(host_core_t core, bool maskable) {
+    cores[core].isr_maskable = maskable;
+}
+
+void host_mask_interrupts(void) {
+    pthread_mutex_lock(&cores[thread_core].primask);
+}
+
+void host_unmask_interrupts(void) {
+    pthread_mutex_unlock(&cores[thread_core].primask);
+}
+
+void host_enter_critical(void) {
+    pthread_mutex_lock(&cores[thread_core].basepri);
+}
+
+void host_exit_critical(void) {
+    pthread_mutex_unlock(&cores[thread_core].basepri);
+}
+
+// Same lock order as a task that nests Cy_SysLib_EnterCriticalSection() in taskENTER_CRITICAL()
+void host_core_run_isr(void (*isr)(void)) {
+    host_core_state_t *core = &cores[thread_core];
+    bool maskable = core->isr_maskable;
+    if (maskable) {
+        pthread_mutex_lock(&core->basepri);
+    }
+    pthread_mutex_lock(&core->primask);
+    isr();
+    pthread_mutex_unlock(&core->primask);
+    if (maskable) {
+        pthread_mutex_unlock(&core->basepri);
+    }
+}
+
+typedef struct {
+    cy_ipc_pipe_callback_ptr_t *callbacks;
+    uint32_t clients;
+    void (*isr)(void);
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    atomic_bool channel_locked;
+    void *msg;
+    uint32_t from_addr;
+    bool pending;
+    bool stop;
+    atomic_uint release_delay_us;
+
+    // Sender side: called in this endpoint's pipe ISR once the receiver released the channel
+    cy_ipc_pipe_relcallback_ptr_t release_callback;
+    bool release_pending;
+
+    atomic_uint messages;
+    atomic_uint busy;
+} host_endpoint_t;
+
+static host_endpoint_t endpoints[HOST_IPC_MAX_ENDPOINTS];
+
+static host_endpoint_t *get_endpoint(uint32_t ep_addr) {
+    return (ep_addr < HOST_IPC_MAX_ENDPOINTS) ? &endpoints[ep_addr] : NULL;
+}
+
+void Cy_IPC_Pipe_Config(cy_stc_ipc_pipe_ep_t *the_ep_array) {
+    (void) the_ep_array;
+}
+
+void Cy_IPC_Pipe_Init(cy_stc_ipc_pipe_config_t const *config) {
+    host_endpoint_t *ep = get_endpoint(config->ep0ConfigData.epAddress);
+    ep->callbacks = config->endpointsCallbacksArray;
+    ep->clients = config->endpointClientsCount;
+    ep->isr = config->userPipeIsrHandler;
+    pthread_mutex_init(&ep->lock, NULL);
+    pthread_cond_init(&ep->cond, NULL);
+}
+
+cy_en_ipc_pipe_status_t Cy_IPC_Pipe_RegisterCallback(uint32_t ep_addr, cy_ipc_pipe_callback_ptr_t callback, uint32_t client_id) {
+    host_endpoint_t *ep = get_endpoint(ep_addr);
+    if (NULL == ep || NULL == ep->callbacks) {
+        return CY_IPC_PIPE_ERROR_BAD_HANDLE;
+    }
+    if (client_id >= ep->clients) {
+        return CY_IPC_PIPE_ERROR_BAD_CLIENT;
+    }
+    ep->callbacks[client_id] = callback;
+    return CY_IPC_PIPE_SUCCESS;
+}
+
+cy_en_ipc_pipe_status_t Cy_IPC_Pipe_SendMessage(uint32_t to_addr, uint32_t from_addr, void *msg_ptr,
+        cy_ipc_pipe_relcallback_ptr_t release_callback) {
+    host_endpoint_t *ep = get_endpoint(to_addr);
+    host_endpoint_t *from = get_endpoint(from_addr);
+    if (NULL == ep || NULL == ep->isr || NULL == from) {
+        return CY_IPC_PIPE_ERROR_BAD_HANDLE;
+    }
+    if (atomic_exchange(&ep->channel_locked, true)) {
+        atomic_fetch_add(&ep->busy, 1);
+        // Let the receiving core make progress, as it would on the device
+        sched_yield();
+        return CY_IPC_PIPE_ERROR_SEND_BUSY;
+    }
+    pthread_mutex_lock(&from->lock);
+    from->release_callback = release_callback;
+    pthread_mutex_unlock(&from->lock);
+    pthread_mutex_lock(&ep->lock);
+    ep->msg = msg_ptr;
+    ep->from_addr = from_addr;
+    ep->pending = true;
+    pthread_cond_signal(&ep->cond);
+    pthread_mutex_unlock(&ep->lock);
+    return CY_IPC_PIPE_SUCCESS;
+}
+
+void Cy_IPC_Pipe_ExecuteCallback(uint32_t ep_addr) {
+    host_endpoint_t *ep = get_endpoint(ep_addr);
+    pthread_mutex_lock(&ep->lock);
+    void *msg = ep->pending ? ep->msg : NULL;
+    uint32_t from_addr = ep->from_addr;
+    cy_ipc_pipe_relcallback_ptr_t release_callback = ep->release_pending ? ep->release_callback : NULL;
+    ep->release_pending = false;
+    pthread_mutex_unlock(&ep->lock);
+
+    // The release interrupt of a message this endpoint sent
+    if (NULL != release_callback) {
+        release_callback();
+    }
+    if (NULL == msg) {
+        return;
+    }
+
+    // The client id is the first byte of every message
+    uint8_t client_id = *(uint8_t *) msg;
+    if (client_id < ep->clients && NULL != ep->callbacks[client_id]) {
+        ep->callbacks[client_id]((uint32_t *) msg);
+    }
+    atomic_fetch_add(&ep->messages, 1);
+
+    // Time between the end of the callback and the release, e.g. other interrupts on the device
+    uint32_t delay_us = atomic_load(&ep->release_delay_us);
+    if (delay_us) {
+        struct timespec ts = {.tv_sec = delay_us / 1000000U, .tv_nsec = (long) (delay_us % 1000000U) * 1000L};
+        nanosleep(&ts, NULL);
+    }
+
+    pthread_mutex_lock(&ep->lock);
+    ep->pending = false;
+    pthread_mutex_unlock(&ep->lock);
+    // Release the channel for the next message
+    atomic_store(&ep->channel_locked, false);
+
+    // Raise the release interrupt of the sender if it asked for one
+    host_endpoint_t *from = get_endpoint(from_addr);
+    pthread_mutex_lock(&from->lock);
+    if (NULL != from->release_callback && NULL != from->isr) {
+        from->release_pending = true;
+        pthread_cond_signal(&from->cond);
+    }
+    pthread_mutex_unlock(&from->lock);
+}
+
+void ipc_host_run_isr(uint32_t ep_addr) {
+    host_endpoint_t *ep = get_endpoint(ep_addr);
+    for (;;) {
+        pthread_mutex_lock(&ep->lock);
+        while (!ep->pending && !ep->release_pending && !ep->stop) {
+            pthread_cond_wait(&ep->cond, &ep->lock);
+        }
+        bool stop = ep->stop && !ep->pending && !ep->release_pending;
+        pthread_mutex_unlock(&ep->lock);
+        if (stop) {
+            break;
+        }
+        host_core_run_isr(ep->isr);
+    }
+}
+
+void ipc_host_stop_isr(uint32_t ep_addr) {
+    host_endpoint_t *ep = get_endpoint(ep_addr);
+    pthread_mutex_lock(&ep->lock);
+    ep->stop = true;
+    pthread_cond_signal(&ep->cond);
+    pthread_mutex_unlock(&ep->lock);
+}
+
+void ipc_host_set_release_delay(uint32_t ep_addr, uint32_t delay_us) {
+    atomic_store(&get_endpoint(ep_addr)->release_delay_us, delay_us);
+}
+
+void ipc_host_get_pipe_stats(uint32_t ep_addr, ipc_host_pipe_stats_t *stats) {
+    host_endpoint_t *ep = get_endpoint(ep_addr);
+    stats->messages = atomic_load(&ep->messages);
+    stats->busy = atomic_load(&ep->busy);
+}
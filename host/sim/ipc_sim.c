@@ -0,0 +1,491 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Stress test of the CM55 -> CM33 result IPC (shared/source/COMPONENT_CM55/cm55_ipc_communication.c
+ * and shared/source/COMPONENT_CM33/cm33_ipc_communication.c, built unmodified against the host pipe
+ * driver in ipc_host.c). Threads stand in for the two cores:
+ *
+ *   CM55 producer tasks - send results with cm55_ipc_send_to_cm33(), either as fast as possible
+ *                         (burst) or at a fixed rate (paced)
+ *   CM33 pipe ISR       - runs cm33_msg_callback() for every doorbell
+ *   CM33 app task       - keeps reading the cached results and taking the detection window like
+ *                         app_task.c does
+ *   CM55 pipe ISR and model task - take control requests from CM33 and apply them once per frame
+ *
+ * Every result carries its producer, a per-producer counter, the send time and a checksum in its
+ * scores, so the result handler checks order and integrity of every record and measures latency,
+ * and the app task detects torn copies. Reports results per second, drops, doorbells and latency
+ * percentiles, and the round trip time of control requests. Exits with a non-zero status if a
+ * record is corrupted, reordered or lost without being counted, if the app task reads a torn
+ * result, if the detection windows miss a detection, if the paced run drops results, or if a
+ * control request gets the wrong response.
+ */
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ipc_communication.h"
+#include "host_cores.h"
+
+#include "../bench/bench_util.h"
+
+#define MAX_PRODUCERS           (8U)
+#define DEFAULT_PRODUCERS       (2U)
+#define DEFAULT_BURST_RESULTS   (50000U)
+#define DEFAULT_PACED_RESULTS   (1000U)
+#define DEFAULT_PACED_RATE      (1000U)
+// Longer than the interval of the paced results, so that doorbells find the channel busy
+#define SLOW_RELEASE_US         (1500U)
+#define DRAIN_TIMEOUT_MS        (1000U)
+#define CONTROL_REQUESTS        (200U)
+#define CONTROL_TIMEOUT_MS      (1000U)
+#define MODEL_FRAME_US          (1000U)
+
+#define SCORE_PRODUCER          (0U)
+#define SCORE_COUNTER           (1U)    // 2 entries
+#define SCORE_SENT_NS           (3U)    // 4 entries
+#define SCORE_CHECKSUM          (7U)
+#define SCORE_COUNT             (8U)
+
+typedef struct {
+    uint32_t results;
+    uint32_t rate;                      // Results per second per producer, 0 for as fast as possible
+    uint32_t release_delay_us;          // Time CM33 holds the channel after draining the ring
+} phase_cfg_t;
+
+typedef struct {
+    uint32_t id;
+    const phase_cfg_t *cfg;
+    uint32_t dropped;
+} producer_t;
+
+/* Written by the CM33 ISR thread only, read after it has stopped */
+static struct {
+    uint32_t received;
+    uint32_t detections;
+    uint32_t corrupt;
+    uint32_t reordered;
+    uint32_t gaps;
+    uint32_t next_counter[MAX_PRODUCERS];
+    uint32_t next_sequence;
+    bool have_sequence;
+    uint32_t *latency_ns;
+    uint32_t latency_start;             // rx.received when the phase started
+    uint32_t latency_capacity;
+} rx;
+
+static atomic_bool model_task_stop;
+static atomic_bool app_task_stop;
+static atomic_uint app_task_reads;
+static atomic_uint app_task_torn;
+static atomic_uint app_task_bad_label;
+static atomic_uint app_task_window_detections;
+static atomic_uint app_task_bad_window;
+
+static void put_u32(int16_t *dst, uint32_t value) {
+    dst[0] = (int16_t) (value & 0xFFFFU);
+    dst[1] = (int16_t) (value >> 16);
+}
+
+static uint32_t get_u32(const int16_t *src) {
+    return (uint32_t) (uint16_t) src[0] | ((uint32_t) (uint16_t) src[1] << 16);
+}
+
+static int16_t checksum(const ipc_payload_t *payload) {
+    uint16_t sum = 0x5A5AU ^ payload->label_id;
+    for (uint32_t i = 0; i < SCORE_CHECKSUM; i++) {
+        sum = (uint16_t) ((sum << 1 | sum >> 15) ^ (uint16_t) payload->scores[i]);
+    }
+    return (int16_t) sum;
+}
+
+static bool payload_valid(const ipc_payload_t *payload) {
+    return payload->num_scores == SCORE_COUNT && payload->scores[SCORE_CHECKSUM] == checksum(payload);
+}
+
+static void make_payload(ipc_payload_t *payload, uint32_t producer, uint32_t counter) {
+    uint64_t now = bench_now_ns();
+    memset(payload, 0, sizeof(*payload));
+    payload->label_id = (counter % 4U == 0U) ? 1U : 0U;
+    payload->timestamp_ms = (uint32_t) (now / 1000000U);
+    payload->scores[SCORE_PRODUCER] = (int16_t) producer;
+    put_u32(&payload->scores[SCORE_COUNTER], counter);
+    put_u32(&payload->scores[SCORE_SENT_NS], (uint32_t) now);
+    put_u32(&payload->scores[SCORE_SENT_NS + 2], (uint32_t) (now >> 32));
+    payload->num_scores = SCORE_COUNT;
+    payload->scores[SCORE_CHECKSUM] = checksum(payload);
+}
+
+/* Runs in the CM33 IPC interrupt for every record */
+static void on_result(const ipc_payload_t *payload) {
+    uint64_t now = bench_now_ns();
+    rx.received++;
+    if (!payload_valid(payload) || (uint32_t) payload->scores[SCORE_PRODUCER] >= MAX_PRODUCERS) {
+        rx.corrupt++;
+        return;
+    }
+    if (payload->label_id != 0) {
+        rx.detections++;
+    }
+
+    // Sequence numbers are global and dropped results leave a gap
+    if (rx.have_sequence && (int32_t) (payload->sequence - rx.next_sequence) < 0) {
+        rx.reordered++;
+    }
+    rx.next_sequence = payload->sequence + 1;
+    rx.have_sequence = true;
+
+    uint32_t producer = (uint32_t) payload->scores[SCORE_PRODUCER];
+    uint32_t counter = get_u32(&payload->scores[SCORE_COUNTER]);
+    if (counter < rx.next_counter[producer]) {
+        rx.reordered++;
+    } else {
+        rx.gaps += counter - rx.next_counter[producer];
+        rx.next_counter[producer] = counter + 1;
+    }
+
+    uint64_t sent = (uint64_t) get_u32(&payload->scores[SCORE_SENT_NS])
+        | ((uint64_t) get_u32(&payload->scores[SCORE_SENT_NS + 2]) << 32);
+    uint32_t index = rx.received - 1 - rx.latency_start;
+    if (index < rx.latency_capacity) {
+        rx.latency_ns[index] = (uint32_t) (now - sent);
+    }
+}
+
+static void *cm33_isr_thread(void *arg) {
+    (void) arg;
+    host_core_set(HOST_CORE_CM33);
+    ipc_host_run_isr(CM33_IPC_PIPE_EP_ADDR);
+    return NULL;
+}
+
+/* Takes the detection window the way app_task.c does and checks that it is consistent */
+static void take_detection_window(void) {
+    static ipc_detection_window_t window;
+    char summary[128];
+    if (!cm33_ipc_take_detection_window(&window)) {
+        return;
+    }
+    bool consistent = window.detections == window.labels[1].count && window.detections <= window.results
+        && payload_valid(&window.last_detection) && window.last_detection.label_id == 1;
+    cm33_ipc_format_detection_window(&window, summary, sizeof(summary));
+    if (!consistent || 0 != strncmp(summary, "event:", strlen("event:"))) {
+        atomic_fetch_add(&app_task_bad_window, 1);
+    }
+    atomic_fetch_add(&app_task_window_detections, window.detections);
+}
+
+/* Reads the cached results the way app_task.c does, as often as it can */
+static void *cm33_app_task(void *arg) {
+    (void) arg;
+    host_core_set(HOST_CORE_CM33);
+    while (!atomic_load(&app_task_stop)) {
+        ipc_payload_t payload;
+        bool detection = cm33_ipc_safe_get_and_clear_cached_detection(&payload);
+        if (payload.num_scores != 0 && !payload_valid(&payload)) {
+            atomic_fetch_add(&app_task_torn, 1);
+        } else if (detection && 0 != strcmp(cm33_ipc_get_label(&payload), "event")) {
+            atomic_fetch_add(&app_task_bad_label, 1);
+        }
+        cm33_ipc_safe_copy_last_payload(&payload);
+        if (payload.num_scores != 0 && !payload_valid(&payload)) {
+            atomic_fetch_add(&app_task_torn, 1);
+        }
+        (void) cm33_ipc_has_received_message();
+        if (atomic_load(&app_task_reads) % 64U == 0U) {
+            take_detection_window();
+        }
+        atomic_fetch_add(&app_task_reads, 1);
+        sched_yield();
+    }
+    return NULL;
+}
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *) a;
+    uint32_t y = *(const uint32_t *) b;
+    return (x > y) - (x < y);
+}
+
+static double percentile_us(const uint32_t *sorted, uint32_t n, double p) {
+    if (n == 0) {
+        return 0.0;
+    }
+    uint32_t index = (uint32_t) (p * (double) (n - 1));
+    return sorted[index] / 1000.0;
+}
+
+static void *cm55_isr_thread(void *arg) {
+    (void) arg;
+    host_core_set(HOST_CORE_CM55);
+    ipc_host_run_isr(CM55_IPC_PIPE_EP_ADDR);
+    return NULL;
+}
+
+/* Applies control requests once per frame, like the model tasks do */
+static void *cm55_model_task(void *arg) {
+    (void) arg;
+    host_core_set(HOST_CORE_CM55);
+    while (!atomic_load(&model_task_stop)) {
+        ipc_control_request_t request;
+        if (cm55_ipc_get_control_request(&request)) {
+            ipc_control_status_e status = IPC_CONTROL_STATUS_UNSUPPORTED;
+            if (IPC_CONTROL_SET_SENSITIVITY == request.command) {
+                bool valid = request.confidence >= 0.0f && request.confidence <= 1.0f;
+                status = valid ? IPC_CONTROL_STATUS_OK : IPC_CONTROL_STATUS_INVALID;
+            } else if (IPC_CONTROL_ENABLE_MODEL == request.command) {
+                status = IPC_CONTROL_STATUS_OK;
+            }
+            cm55_ipc_complete_control_request(status);
+        }
+        struct timespec ts = {.tv_sec = 0, .tv_nsec = MODEL_FRAME_US * 1000L};
+        nanosleep(&ts, NULL);
+    }
+    return NULL;
+}
+
+/* Sends control requests from the CM33 side and checks the responses */
+static bool run_control(void) {
+    static const struct {
+        ipc_control_request_t request;
+        ipc_control_status_e expected;
+    } cases[] = {
+        {{.command = IPC_CONTROL_SET_SENSITIVITY, .confidence = 0.6f, .average = 1, .subsequent = 1, .pool = 1, .pool_selection = 1}, IPC_CONTROL_STATUS_OK},
+        {{.command = IPC_CONTROL_SET_SENSITIVITY, .confidence = 2.0f}, IPC_CONTROL_STATUS_INVALID},
+        {{.command = IPC_CONTROL_ENABLE_MODEL, .enabled = 0}, IPC_CONTROL_STATUS_OK},
+        {{.command = IPC_CONTROL_SET_MIN_RANGE_BIN, .min_range_bin = 5}, IPC_CONTROL_STATUS_UNSUPPORTED},
+    };
+    const uint32_t num_cases = sizeof(cases) / sizeof(cases[0]);
+    uint32_t *round_trip_ns = calloc(CONTROL_REQUESTS, sizeof(uint32_t));
+    uint32_t wrong = 0;
+
+    for (uint32_t i = 0; i < CONTROL_REQUESTS; i++) {
+        uint64_t t0 = bench_now_ns();
+        ipc_control_status_e status = cm33_ipc_send_control(&cases[i % num_cases].request, CONTROL_TIMEOUT_MS);
+        round_trip_ns[i] = (uint32_t) (bench_now_ns() - t0);
+        if (status != cases[i % num_cases].expected) {
+            wrong++;
+        }
+    }
+    qsort(round_trip_ns, CONTROL_REQUESTS, sizeof(uint32_t), compare_u32);
+    printf("control: %u requests, model frame %u us, wrong responses %u\n", CONTROL_REQUESTS, MODEL_FRAME_US, wrong);
+    printf("    round trip us: p50 %.1f  p90 %.1f  max %.1f\n",
+        percentile_us(round_trip_ns, CONTROL_REQUESTS, 0.50), percentile_us(round_trip_ns, CONTROL_REQUESTS, 0.90),
+        percentile_us(round_trip_ns, CONTROL_REQUESTS, 1.0));
+    free(round_trip_ns);
+    return wrong == 0;
+}
+
+static void *cm55_producer_task(void *arg) {
+    producer_t *producer = arg;
+    host_core_set(HOST_CORE_CM55);
+    uint64_t start = bench_now_ns();
+    for (uint32_t i = 0; i < producer->cfg->results; i++) {
+        if (producer->cfg->rate) {
+            // Absolute schedule, so that slow sends do not lower the rate
+            uint64_t due = start + (uint64_t) i * 1000000000ULL / producer->cfg->rate;
+            struct timespec ts = {.tv_sec = (time_t) (due / 1000000000ULL), .tv_nsec = (long) (due % 1000000000ULL)};
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        }
+        ipc_payload_t payload;
+        make_payload(&payload, producer->id, i);
+        if (!cm55_ipc_send_to_cm33(&payload)) {
+            producer->dropped++;
+            // The cores run in parallel on the device, let CM33 catch up on a single host CPU
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static bool run_phase(const char *name, const phase_cfg_t *cfg, uint32_t num_producers, bool expect_no_drops) {
+    static ipc_result_stats_t base_stats;
+    static ipc_host_pipe_stats_t base_pipe;
+    ipc_result_stats_t stats;
+    ipc_host_pipe_stats_t pipe;
+
+    cm33_ipc_get_stats(&base_stats);
+    ipc_host_get_pipe_stats(CM33_IPC_PIPE_EP_ADDR, &base_pipe);
+    uint32_t base_received = rx.received;
+    uint32_t base_gaps = rx.gaps;
+    memset(rx.next_counter, 0, sizeof(rx.next_counter));
+
+    rx.latency_capacity = cfg->results * num_producers;
+    rx.latency_ns = calloc(rx.latency_capacity, sizeof(uint32_t));
+    rx.latency_start = base_received;
+
+    producer_t producers[MAX_PRODUCERS];
+    pthread_t threads[MAX_PRODUCERS];
+    ipc_host_set_release_delay(CM33_IPC_PIPE_EP_ADDR, cfg->release_delay_us);
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t p = 0; p < num_producers; p++) {
+        producers[p] = (producer_t) {.id = p, .cfg = cfg};
+        pthread_create(&threads[p], NULL, cm55_producer_task, &producers[p]);
+    }
+    uint32_t dropped = 0;
+    for (uint32_t p = 0; p < num_producers; p++) {
+        pthread_join(threads[p], NULL);
+        dropped += producers[p].dropped;
+    }
+
+    // Wait for CM33 to drain the ring. A doorbell that found the channel busy is sent again when
+    // CM33 releases it, so no result may stay in the ring.
+    uint64_t deadline = bench_now_ns() + DRAIN_TIMEOUT_MS * 1000000ULL;
+    do {
+        cm33_ipc_get_stats(&stats);
+        if (stats.received == stats.published) {
+            break;
+        }
+        sched_yield();
+    } while (bench_now_ns() < deadline);
+    uint64_t elapsed_ns = bench_now_ns() - t0;
+    ipc_host_get_pipe_stats(CM33_IPC_PIPE_EP_ADDR, &pipe);
+
+    uint32_t sent = cfg->results * num_producers;
+    uint32_t published = stats.published - base_stats.published;
+    uint32_t ring_dropped = stats.dropped - base_stats.dropped;
+    uint32_t doorbells = stats.doorbells - base_stats.doorbells;
+    uint32_t received = stats.received - base_stats.received;
+    uint32_t stranded = published - received;
+    // Drops after a producer's last received result do not show up as gaps
+    uint32_t tail_drops = 0;
+    for (uint32_t p = 0; p < num_producers; p++) {
+        tail_drops += cfg->results - rx.next_counter[p];
+    }
+    uint32_t gaps = rx.gaps - base_gaps + tail_drops;
+
+    uint32_t n_latency = received;
+    qsort(rx.latency_ns, n_latency, sizeof(uint32_t), compare_u32);
+
+    printf("%s: %u producers x %u results", name, num_producers, cfg->results);
+    if (cfg->rate) {
+        printf(" at %u/s", cfg->rate);
+    }
+    if (cfg->release_delay_us) {
+        printf(", channel released %u us after draining", cfg->release_delay_us);
+    }
+    printf("\n");
+    printf("    received %u of %u, %.0f results/s, dropped %u (ring full), stranded %u\n",
+        received, sent, received * 1e9 / (double) elapsed_ns, ring_dropped, stranded);
+    printf("    doorbells %u (%.3f per result), busy channel %u\n",
+        doorbells, published ? (double) doorbells / published : 0.0, pipe.busy - base_pipe.busy);
+    printf("    latency us: p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n",
+        percentile_us(rx.latency_ns, n_latency, 0.50), percentile_us(rx.latency_ns, n_latency, 0.90),
+        percentile_us(rx.latency_ns, n_latency, 0.99), percentile_us(rx.latency_ns, n_latency, 1.0));
+
+    bool ok = true;
+    if (published + ring_dropped != sent || dropped != ring_dropped) {
+        printf("    FAIL: producers sent %u, ring published %u and dropped %u, producers saw %u drops\n",
+            sent, published, ring_dropped, dropped);
+        ok = false;
+    }
+    if (gaps != ring_dropped + stranded) {
+        printf("    FAIL: %u results missing on CM33, %u dropped and %u stranded\n", gaps, ring_dropped, stranded);
+        ok = false;
+    }
+    if (stranded != 0) {
+        printf("    FAIL: %u results left in the ring without a doorbell\n", stranded);
+        ok = false;
+    }
+    if (expect_no_drops && ring_dropped != 0) {
+        printf("    FAIL: results lost at this rate\n");
+        ok = false;
+    }
+
+    free(rx.latency_ns);
+    rx.latency_ns = NULL;
+    rx.latency_capacity = 0;
+    return ok;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "Usage: %s [-p producers] [-n burst results] [-r paced rate/s] [-u]\n", argv0);
+    fprintf(stderr, "    -u  taskENTER_CRITICAL() on CM33 does not hold off the IPC interrupt\n");
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t num_producers = DEFAULT_PRODUCERS;
+    phase_cfg_t burst = {.results = DEFAULT_BURST_RESULTS, .rate = 0};
+    phase_cfg_t paced = {.results = DEFAULT_PACED_RESULTS, .rate = DEFAULT_PACED_RATE};
+    bool maskable = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (0 == strcmp(argv[i], "-p") && i + 1 < argc) {
+            num_producers = (uint32_t) atoi(argv[++i]);
+        } else if (0 == strcmp(argv[i], "-n") && i + 1 < argc) {
+            burst.results = (uint32_t) atoi(argv[++i]);
+        } else if (0 == strcmp(argv[i], "-r") && i + 1 < argc) {
+            paced.rate = (uint32_t) atoi(argv[++i]);
+        } else if (0 == strcmp(argv[i], "-u")) {
+            maskable = false;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (num_producers == 0 || num_producers > MAX_PRODUCERS || burst.results == 0 || paced.rate == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // Same order as the firmware: CM55 sets up its pipe and ring first, CM33 registers its callback
+    host_core_set_isr_maskable(HOST_CORE_CM33, maskable);
+    host_core_set(HOST_CORE_CM55);
+    cm55_ipc_communication_setup();
+    static const char *const labels[] = {"none", "event"};
+    cm55_ipc_set_labels(IPC_MODEL_NONE, labels, 2);
+    host_core_set(HOST_CORE_CM33);
+    cm33_ipc_communication_setup();
+    cm33_ipc_set_result_handler(on_result);
+
+    pthread_t isr_thread;
+    pthread_t app_thread;
+    pthread_t cm55_isr;
+    pthread_t model_thread;
+    pthread_create(&isr_thread, NULL, cm33_isr_thread, NULL);
+    pthread_create(&app_thread, NULL, cm33_app_task, NULL);
+    pthread_create(&cm55_isr, NULL, cm55_isr_thread, NULL);
+    pthread_create(&model_thread, NULL, cm55_model_task, NULL);
+
+    printf("IPC result ring: %lu records of %zu bytes\n", (unsigned long) IPC_RESULT_RING_SIZE, sizeof(ipc_payload_t));
+    bool ok = run_phase("burst", &burst, num_producers, false);
+    ok = run_phase("paced", &paced, num_producers, true) && ok;
+    phase_cfg_t slow_release = paced;
+    slow_release.results = paced.rate / 5U;
+    slow_release.release_delay_us = SLOW_RELEASE_US;
+    ok = run_phase("slow release", &slow_release, num_producers, true) && ok;
+    ok = run_control() && ok;
+
+    atomic_store(&app_task_stop, true);
+    pthread_join(app_thread, NULL);
+    ipc_host_stop_isr(CM33_IPC_PIPE_EP_ADDR);
+    pthread_join(isr_thread, NULL);
+    take_detection_window();
+    atomic_store(&model_task_stop, true);
+    pthread_join(model_thread, NULL);
+    ipc_host_stop_isr(CM55_IPC_PIPE_EP_ADDR);
+    pthread_join(cm55_isr, NULL);
+
+    printf("records corrupt %u, reordered %u; app task reads %u, torn %u, wrong label %u\n",
+        rx.corrupt, rx.reordered, atomic_load(&app_task_reads), atomic_load(&app_task_torn),
+        atomic_load(&app_task_bad_label));
+    printf("detections received %u, counted in detection windows %u, inconsistent windows %u\n",
+        rx.detections, atomic_load(&app_task_window_detections), atomic_load(&app_task_bad_window));
+    if (rx.corrupt || rx.reordered || atomic_load(&app_task_torn) || atomic_load(&app_task_bad_label)
+            || rx.detections != atomic_load(&app_task_window_detections) || atomic_load(&app_task_bad_window)) {
+        ok = false;
+    }
+
+    printf("ipc_sim %s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
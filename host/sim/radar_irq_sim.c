@@ -0,0 +1,471 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Simulates the radar acquisition path of proj_cm55/source/radar.c with host threads:
+ *
+ *   sensor thread      - fills a fake FIFO one chunk at a time at the radar frame rate and
+ *                        raises an edge-triggered "interrupt" when the FIFO reaches the threshold
+ *   acquisition thread - notify: blocks on a task notification and drains one chunk per
+ *                        interrupt with radar_fifo_reader (what radar.c does now)
+ *                        poll:   spins on a flag set by a whole-frame interrupt and reads the
+ *                        whole frame at once (what radar.c did before)
+ *   processing thread  - takes frames from the ring of frame slots (drop-oldest when full),
+ *                        checks them and simulates the gesture processing time
+ *
+ * Every sample encodes its position in the stream, so torn or reordered frames are detected.
+ * Reports the CPU time used by the acquisition thread, drops, FIFO overflows and latency.
+ * Exits with a non-zero status if the notify mode loses or tears frames.
+ */
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "radar_fifo_reader.h"
+
+#include "../bench/bench_util.h"
+
+#define FRAME_SAMPLES           (64U * 32U * 3U)
+#define FIFO_CAPACITY           (8192U)
+#define FRAME_SLOTS             (3U)
+// Largest power of two dividing FRAME_SAMPLES
+#define FRAME_START_ALIGN       (FRAME_SAMPLES & (0U - FRAME_SAMPLES))
+
+#define DEFAULT_FRAMES          (60U)
+#define DEFAULT_CHUNKS          (4U)
+#define DEFAULT_FRAME_PERIOD_MS (30U)
+#define DEFAULT_PROCESSING_MS   (12U)
+
+typedef enum {
+    SIM_NOTIFY,
+    SIM_POLL
+} sim_mode_t;
+
+/* Counting notification, the equivalent of a FreeRTOS task notification used with ulTaskNotifyTake(pdFALSE) */
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t value;
+} sim_notify_t;
+
+typedef struct {
+    uint16_t fifo[FRAME_SAMPLES];
+    uint64_t acquired_ns;
+} sim_slot_t;
+
+typedef struct {
+    /* configuration */
+    sim_mode_t mode;
+    uint32_t n_frames;
+    uint32_t chunk_samples;
+    uint32_t frame_period_ms;
+    uint32_t processing_ms;
+
+    /* sensor FIFO */
+    pthread_mutex_t fifo_lock;
+    uint16_t fifo[FIFO_CAPACITY];
+    uint32_t fifo_head;
+    uint32_t fifo_count;
+    uint32_t irq_threshold;
+    bool irq_line;
+    uint32_t fifo_overflows;
+    volatile bool sensor_done;
+
+    /* interrupt -> acquisition */
+    sim_notify_t notify;
+    volatile bool data_available;
+
+    /* frame slot ring */
+    pthread_mutex_t slots_lock;
+    pthread_cond_t slots_cond;
+    sim_slot_t slots[FRAME_SLOTS];
+    uint8_t free_slots[FRAME_SLOTS];
+    uint32_t n_free;
+    uint8_t ready_slots[FRAME_SLOTS];
+    uint32_t ready_head;
+    uint32_t n_ready;
+    bool acquisition_done;
+
+    /* results */
+    uint32_t frames_acquired;
+    uint32_t frames_dropped;
+    uint32_t frames_processed;
+    uint32_t frames_torn;
+    uint32_t frames_out_of_order;
+    uint32_t interrupts;
+    uint64_t latency_sum_ns;
+    uint64_t latency_max_ns;
+    uint64_t acquisition_cpu_ns;
+} sim_t;
+
+static void notify_init(sim_notify_t *n) {
+    pthread_mutex_init(&n->lock, NULL);
+    pthread_cond_init(&n->cond, NULL);
+    n->value = 0;
+}
+
+static void notify_give(sim_notify_t *n) {
+    pthread_mutex_lock(&n->lock);
+    n->value++;
+    pthread_cond_signal(&n->cond);
+    pthread_mutex_unlock(&n->lock);
+}
+
+static void notify_take(sim_notify_t *n) {
+    pthread_mutex_lock(&n->lock);
+    while (n->value == 0) {
+        pthread_cond_wait(&n->cond, &n->lock);
+    }
+    n->value--;
+    pthread_mutex_unlock(&n->lock);
+}
+
+// Gives a notification unless one is already pending, as radar.c does with ulTaskNotifyValueClear()
+static void notify_give_if_clear(sim_notify_t *n) {
+    pthread_mutex_lock(&n->lock);
+    if (n->value == 0) {
+        n->value++;
+        pthread_cond_signal(&n->cond);
+    }
+    pthread_mutex_unlock(&n->lock);
+}
+
+static void sleep_ns(uint64_t ns) {
+    struct timespec ts = {.tv_sec = (time_t) (ns / 1000000000ULL), .tv_nsec = (long) (ns % 1000000000ULL)};
+    nanosleep(&ts, NULL);
+}
+
+static uint64_t thread_cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+// Updates the interrupt line from the FIFO level, fires on the rising edge. Called with fifo_lock held.
+static void sensor_update_irq(sim_t *sim) {
+    bool line = sim->fifo_count >= sim->irq_threshold;
+    if (line && !sim->irq_line) {
+        sim->interrupts++;
+        if (sim->mode == SIM_NOTIFY) {
+            notify_give(&sim->notify);
+        } else {
+            sim->data_available = true;
+        }
+    }
+    sim->irq_line = line;
+}
+
+static void *sensor_thread(void *arg) {
+    sim_t *sim = arg;
+    uint32_t chunks_per_frame = FRAME_SAMPLES / sim->chunk_samples;
+    uint64_t chunk_period_ns = (uint64_t) sim->frame_period_ms * 1000000ULL / chunks_per_frame;
+    uint64_t next_ns = bench_now_ns();
+    uint16_t sample = 0;
+
+    for (uint32_t fr = 0; fr < sim->n_frames; fr++) {
+        for (uint32_t c = 0; c < chunks_per_frame; c++) {
+            next_ns += chunk_period_ns;
+            uint64_t now = bench_now_ns();
+            if (next_ns > now) {
+                sleep_ns(next_ns - now);
+            }
+            pthread_mutex_lock(&sim->fifo_lock);
+            if (sim->fifo_count + sim->chunk_samples > FIFO_CAPACITY) {
+                // The chunk is lost, the frame it belongs to is torn
+                sim->fifo_overflows++;
+                sample += (uint16_t) sim->chunk_samples;
+            } else {
+                for (uint32_t i = 0; i < sim->chunk_samples; i++) {
+                    sim->fifo[(sim->fifo_head + sim->fifo_count) % FIFO_CAPACITY] = sample++;
+                    sim->fifo_count++;
+                }
+            }
+            sensor_update_irq(sim);
+            pthread_mutex_unlock(&sim->fifo_lock);
+        }
+    }
+    sim->sensor_done = true;
+    // Wake up the acquisition thread so it can see the end of the stream
+    notify_give(&sim->notify);
+    sim->data_available = true;
+    return NULL;
+}
+
+// The radar_fifo_read_fn of the fake FIFO, the equivalent of xensiv_bgt60trxx_get_fifo_data()
+static int32_t sim_fifo_read(void *ctx, uint16_t *data, uint32_t num_samples) {
+    sim_t *sim = ctx;
+    pthread_mutex_lock(&sim->fifo_lock);
+    if (sim->fifo_count < num_samples) {
+        pthread_mutex_unlock(&sim->fifo_lock);
+        return -1;
+    }
+    for (uint32_t i = 0; i < num_samples; i++) {
+        data[i] = sim->fifo[sim->fifo_head];
+        sim->fifo_head = (sim->fifo_head + 1) % FIFO_CAPACITY;
+    }
+    sim->fifo_count -= num_samples;
+    sensor_update_irq(sim);
+    pthread_mutex_unlock(&sim->fifo_lock);
+    return 0;
+}
+
+static bool sim_irq_line(sim_t *sim) {
+    pthread_mutex_lock(&sim->fifo_lock);
+    bool line = sim->irq_line;
+    pthread_mutex_unlock(&sim->fifo_lock);
+    return line;
+}
+
+static uint32_t sim_fifo_level(sim_t *sim) {
+    pthread_mutex_lock(&sim->fifo_lock);
+    uint32_t level = sim->fifo_count;
+    pthread_mutex_unlock(&sim->fifo_lock);
+    return level;
+}
+
+// Same policy as acquire_frame_slot() in radar.c: a free slot, else the oldest unprocessed frame
+static uint8_t sim_acquire_slot(sim_t *sim) {
+    uint8_t slot;
+    pthread_mutex_lock(&sim->slots_lock);
+    if (sim->n_free > 0) {
+        slot = sim->free_slots[--sim->n_free];
+    } else {
+        slot = sim->ready_slots[sim->ready_head];
+        sim->ready_head = (sim->ready_head + 1) % FRAME_SLOTS;
+        sim->n_ready--;
+        sim->frames_dropped++;
+    }
+    pthread_mutex_unlock(&sim->slots_lock);
+    return slot;
+}
+
+static void sim_queue_ready(sim_t *sim, uint8_t slot) {
+    pthread_mutex_lock(&sim->slots_lock);
+    sim->slots[slot].acquired_ns = bench_now_ns();
+    sim->ready_slots[(sim->ready_head + sim->n_ready) % FRAME_SLOTS] = slot;
+    sim->n_ready++;
+    sim->frames_acquired++;
+    pthread_cond_signal(&sim->slots_cond);
+    pthread_mutex_unlock(&sim->slots_lock);
+}
+
+static void sim_release_slot(sim_t *sim, uint8_t slot) {
+    pthread_mutex_lock(&sim->slots_lock);
+    sim->free_slots[sim->n_free++] = slot;
+    pthread_mutex_unlock(&sim->slots_lock);
+}
+
+static void acquisition_notify(sim_t *sim) {
+    radar_fifo_reader_t reader;
+    uint8_t slot = 0;
+
+    if (!radar_fifo_reader_init(&reader, sim_fifo_read, sim, FRAME_SAMPLES, sim->chunk_samples)) {
+        abort();
+    }
+    for (;;) {
+        notify_take(&sim->notify);
+        if (sim->sensor_done && sim_fifo_level(sim) < sim->chunk_samples) {
+            break;
+        }
+        if (radar_fifo_reader_at_frame_start(&reader)) {
+            slot = sim_acquire_slot(sim);
+        }
+        int32_t result = radar_fifo_reader_read_chunk(&reader, sim->slots[slot].fifo);
+        if (result != RADAR_FIFO_READ_ERROR && sim_irq_line(sim)) {
+            notify_give_if_clear(&sim->notify);
+        }
+        if (result == RADAR_FIFO_FRAME_COMPLETE) {
+            sim_queue_ready(sim, slot);
+        } else if (result == RADAR_FIFO_READ_ERROR) {
+            sim_release_slot(sim, slot);
+        }
+    }
+}
+
+static void acquisition_poll(sim_t *sim) {
+    for (;;) {
+        while (!sim->data_available && !sim->sensor_done) {
+            // busy wait, as the old radar_task loop did
+        }
+        sim->data_available = false;
+        if (sim_fifo_level(sim) < FRAME_SAMPLES) {
+            if (sim->sensor_done) {
+                break;
+            }
+            continue;
+        }
+        uint8_t slot = sim_acquire_slot(sim);
+        if (0 == sim_fifo_read(sim, sim->slots[slot].fifo, FRAME_SAMPLES)) {
+            sim_queue_ready(sim, slot);
+        } else {
+            sim_release_slot(sim, slot);
+        }
+    }
+}
+
+static void *acquisition_thread(void *arg) {
+    sim_t *sim = arg;
+    uint64_t cpu0 = thread_cpu_ns();
+    if (sim->mode == SIM_NOTIFY) {
+        acquisition_notify(sim);
+    } else {
+        acquisition_poll(sim);
+    }
+    sim->acquisition_cpu_ns = thread_cpu_ns() - cpu0;
+
+    pthread_mutex_lock(&sim->slots_lock);
+    sim->acquisition_done = true;
+    pthread_cond_signal(&sim->slots_cond);
+    pthread_mutex_unlock(&sim->slots_lock);
+    return NULL;
+}
+
+static void *processing_thread(void *arg) {
+    sim_t *sim = arg;
+    bool have_last = false;
+    uint16_t last_first = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&sim->slots_lock);
+        while (sim->n_ready == 0 && !sim->acquisition_done) {
+            pthread_cond_wait(&sim->slots_cond, &sim->slots_lock);
+        }
+        if (sim->n_ready == 0) {
+            pthread_mutex_unlock(&sim->slots_lock);
+            break;
+        }
+        uint8_t slot = sim->ready_slots[sim->ready_head];
+        sim->ready_head = (sim->ready_head + 1) % FRAME_SLOTS;
+        sim->n_ready--;
+        pthread_mutex_unlock(&sim->slots_lock);
+
+        const sim_slot_t *s = &sim->slots[slot];
+        uint64_t latency = bench_now_ns() - s->acquired_ns;
+        sim->latency_sum_ns += latency;
+        if (latency > sim->latency_max_ns) {
+            sim->latency_max_ns = latency;
+        }
+
+        // Untorn frames are one contiguous run of the sample stream, starting on a frame boundary.
+        // Frame starts wrap around with the 16 bit samples, they are multiples of FRAME_START_ALIGN.
+        bool torn = (s->fifo[0] % FRAME_START_ALIGN) != 0;
+        for (uint32_t i = 1; i < FRAME_SAMPLES && !torn; i++) {
+            torn = s->fifo[i] != (uint16_t) (s->fifo[0] + i);
+        }
+        uint16_t first = s->fifo[0];
+        if (torn) {
+            sim->frames_torn++;
+        } else if (have_last && (int16_t) (first - last_first) <= 0) {
+            sim->frames_out_of_order++;
+        }
+        have_last = true;
+        last_first = first;
+        sim->frames_processed++;
+        sim_release_slot(sim, slot);
+
+        sleep_ns((uint64_t) sim->processing_ms * 1000000ULL);
+    }
+    return NULL;
+}
+
+static bool run_sim(sim_mode_t mode, uint32_t n_frames, uint32_t n_chunks, uint32_t frame_period_ms,
+                    uint32_t processing_ms) {
+    sim_t *sim = calloc(1, sizeof(sim_t));
+    if (!sim) {
+        abort();
+    }
+    sim->mode = mode;
+    sim->n_frames = n_frames;
+    sim->chunk_samples = mode == SIM_NOTIFY ? FRAME_SAMPLES / n_chunks : FRAME_SAMPLES;
+    sim->irq_threshold = sim->chunk_samples;
+    sim->frame_period_ms = frame_period_ms;
+    sim->processing_ms = processing_ms;
+    pthread_mutex_init(&sim->fifo_lock, NULL);
+    pthread_mutex_init(&sim->slots_lock, NULL);
+    pthread_cond_init(&sim->slots_cond, NULL);
+    notify_init(&sim->notify);
+    for (uint32_t i = 0; i < FRAME_SLOTS; i++) {
+        sim->free_slots[sim->n_free++] = (uint8_t) i;
+    }
+
+    pthread_t sensor, acquisition, processing;
+    uint64_t t0 = bench_now_ns();
+    pthread_create(&processing, NULL, processing_thread, sim);
+    pthread_create(&acquisition, NULL, acquisition_thread, sim);
+    pthread_create(&sensor, NULL, sensor_thread, sim);
+    pthread_join(sensor, NULL);
+    pthread_join(acquisition, NULL);
+    pthread_join(processing, NULL);
+    uint64_t wall_ns = bench_now_ns() - t0;
+
+    printf("%-6s: %u frames in %u chunks, %u interrupts, acquisition CPU %.1f ms of %.1f ms wall (%.1f%%)\n",
+        mode == SIM_NOTIFY ? "notify" : "poll", sim->frames_acquired, FRAME_SAMPLES / sim->chunk_samples,
+        sim->interrupts, sim->acquisition_cpu_ns / 1e6, wall_ns / 1e6,
+        wall_ns ? 100.0 * (double) sim->acquisition_cpu_ns / (double) wall_ns : 0.0);
+    printf("        processed %u, dropped %u, torn %u, out of order %u, FIFO overflows %u, "
+           "latency avg %.2f ms max %.2f ms\n",
+        sim->frames_processed, sim->frames_dropped, sim->frames_torn, sim->frames_out_of_order,
+        sim->fifo_overflows,
+        sim->frames_processed ? sim->latency_sum_ns / 1e6 / sim->frames_processed : 0.0,
+        sim->latency_max_ns / 1e6);
+
+    bool ok = sim->frames_acquired == n_frames && sim->frames_torn == 0 && sim->frames_out_of_order == 0
+              && sim->fifo_overflows == 0 && sim->frames_processed + sim->frames_dropped == n_frames;
+    free(sim);
+    return ok;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Usage: %s [-f frames] [-c chunks_per_frame] [-t frame_period_ms] [-p processing_ms] "
+        "[-m notify|poll|both]\n",
+        prog);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t n_frames = DEFAULT_FRAMES;
+    uint32_t n_chunks = DEFAULT_CHUNKS;
+    uint32_t frame_period_ms = DEFAULT_FRAME_PERIOD_MS;
+    uint32_t processing_ms = DEFAULT_PROCESSING_MS;
+    const char *mode = "both";
+
+    for (int i = 1; i < argc; i++) {
+        if (0 == strcmp(argv[i], "-f") && i + 1 < argc) {
+            n_frames = (uint32_t) atoi(argv[++i]);
+        } else if (0 == strcmp(argv[i], "-c") && i + 1 < argc) {
+            n_chunks = (uint32_t) atoi(argv[++i]);
+        } else if (0 == strcmp(argv[i], "-t") && i + 1 < argc) {
+            frame_period_ms = (uint32_t) atoi(argv[++i]);
+        } else if (0 == strcmp(argv[i], "-p") && i + 1 < argc) {
+            processing_ms = (uint32_t) atoi(argv[++i]);
+        } else if (0 == strcmp(argv[i], "-m") && i + 1 < argc) {
+            mode = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (n_frames == 0 || n_chunks == 0 || (FRAME_SAMPLES % n_chunks) != 0 || frame_period_ms == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    bool all = (0 == strcmp(mode, "both"));
+    bool ok = true;
+    if (all || 0 == strcmp(mode, "notify")) {
+        ok = run_sim(SIM_NOTIFY, n_frames, n_chunks, frame_period_ms, processing_ms);
+        printf("notify mode %s\n", ok ? "OK" : "FAILED");
+    }
+    if (all || 0 == strcmp(mode, "poll")) {
+        // Informational only, the polling loop is the baseline
+        (void) run_sim(SIM_POLL, n_frames, n_chunks, frame_period_ms, processing_ms);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,405 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Runs the store-and-forward telemetry queue of app_task (app_telemetry_queue.c) on a simulated
+ * NOR flash with a fake MQTT connection, in simulated time.
+ *
+ * The flash has the geometry of the firmware region (3 sectors of 256 KB, 512 byte slots). It starts
+ * with random content, erases to 0xFF and counts every byte programmed twice between two erases.
+ * It can cut the power in the middle of a program or an erase, leaving a random part of it done,
+ * after which the queue is started again from the flash content, as after a reset.
+ * The loop mirrors app_task: a telemetry record every 10 s, published when connected and stored
+ * otherwise, and replay while connected. Records without detections are stored as app_task stores
+ * them, thinned out by app_telemetry_queue_push_idle(). The fake connection fails 1 in 100 replayed
+ * messages.
+ *
+ * Scenarios: outages that fit in the queue, outages with a detection in every record that overflow
+ * it, idle outages, outages with power cuts and a month of outages for wear.
+ * Exits with a non-zero status if a stored record is lost (other than the oldest ones of an outage
+ * that overflows the queue, or one being stored when the power was cut), corrupted, replayed out of
+ * order or more than once outside a power cut, if replay goes over its batch size or rate, if a byte
+ * is programmed twice or if the erase counts of the sectors differ by more than one.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "app_telemetry_queue.h"
+
+#include "../bench/bench_util.h"
+
+#define SECTOR_SIZE         (256U * 1024U)
+#define SECTOR_COUNT        (3U)
+#define SLOT_SIZE           (512U)
+#define RECORD_MS           (10000U)
+#define TICK_MS             (100U)
+#define DRAIN_MS            (3600000U)
+#define HOUR_MS             (3600000U)
+#define MAX_RECORDS         (1U << 19)
+
+typedef struct {
+    uint8_t mem[SECTOR_COUNT * SECTOR_SIZE];
+    uint32_t erase_count[SECTOR_COUNT];
+    uint32_t double_programs;
+    uint32_t cut_every;     // mean program and erase operations between power cuts, 0 for none
+    uint32_t cut_in;
+    bool cut;               // the power is off until the next boot
+} sim_flash_t;
+
+typedef struct {
+    uint32_t seq;
+    uint32_t taken_ms;
+    uint8_t data[208];      // about the size of telemetry_record_t
+} sim_record_t;
+
+enum {
+    REC_NONE = 0,
+    REC_LIVE,               // published right away
+    REC_STORED,
+    REC_NOT_STORED,         // the power was cut while it was stored
+    REC_SKIPPED             // a heartbeat without detections that was not stored
+};
+
+typedef struct {
+    const char *name;
+    uint32_t duration_ms;
+    uint32_t online_ms;     // online first, then offline, repeated until duration_ms
+    uint32_t offline_ms;
+    uint32_t cut_every;
+    uint32_t busy_every;    // every busy_every-th record has detections, 0 for none
+    bool overflows;
+} scenario_t;
+
+typedef struct {
+    bool online;
+    uint32_t now_ms;
+    uint32_t last_seq;      // last record replayed since boot
+    uint32_t replayed;
+    uint32_t duplicates;
+    uint32_t out_of_order;
+    uint32_t corrupt;
+    uint32_t failed;        // messages the connection dropped
+} sim_sink_t;
+
+static sim_flash_t flash;
+static app_telemetry_queue_t queue;
+static uint8_t state[MAX_RECORDS];
+static uint8_t delivered[MAX_RECORDS];
+
+// True if the power goes off during this operation
+static bool power_cut_now(void) {
+    if (0 == flash.cut_every || --flash.cut_in > 0) {
+        return false;
+    }
+    flash.cut = true;
+    return true;
+}
+
+static int flash_read(void *ctx, uint32_t offset, void *data, uint32_t len) {
+    (void) ctx;
+    if (flash.cut || offset + len > sizeof(flash.mem)) {
+        return -1;
+    }
+    memcpy(data, &flash.mem[offset], len);
+    return 0;
+}
+
+static int flash_program(void *ctx, uint32_t offset, const void *data, uint32_t len) {
+    (void) ctx;
+    if (flash.cut || offset + len > sizeof(flash.mem)) {
+        return -1;
+    }
+    bool cut = power_cut_now();
+    const uint8_t *src = (const uint8_t *) data;
+    for (uint32_t i = 0; i < len; i++) {
+        if (cut && bench_rand_below(2U)) {
+            continue;
+        }
+        if (flash.mem[offset + i] != 0xFF) {
+            flash.double_programs++;
+        }
+        // NOR programming only clears bits
+        flash.mem[offset + i] &= src[i];
+    }
+    return cut ? -1 : 0;
+}
+
+static int flash_erase(void *ctx, uint32_t offset) {
+    (void) ctx;
+    if (flash.cut || offset % SECTOR_SIZE != 0 || offset >= sizeof(flash.mem)) {
+        return -1;
+    }
+    bool cut = power_cut_now();
+    flash.erase_count[offset / SECTOR_SIZE]++;
+    for (uint32_t i = 0; i < SECTOR_SIZE; i++) {
+        if (!cut || bench_rand_below(2U)) {
+            flash.mem[offset + i] = 0xFF;
+        }
+    }
+    return cut ? -1 : 0;
+}
+
+static const app_telemetry_queue_flash_t sim_flash = {
+    .read = flash_read,
+    .program = flash_program,
+    .erase = flash_erase,
+    .ctx = NULL,
+    .sector_size = SECTOR_SIZE,
+    .sector_count = SECTOR_COUNT,
+    .slot_size = SLOT_SIZE
+};
+
+static void make_record(sim_record_t *record, uint32_t seq, uint32_t now_ms) {
+    record->seq = seq;
+    record->taken_ms = now_ms;
+    for (uint32_t i = 0; i < sizeof(record->data); i++) {
+        record->data[i] = (uint8_t) (seq * 31U + i);
+    }
+}
+
+// The fake MQTT connection
+static bool publish(const void *data, uint32_t len, void *ctx) {
+    sim_sink_t *sink = (sim_sink_t *) ctx;
+    if (!sink->online) {
+        return false;
+    }
+    if (0 == bench_rand_below(100U)) {
+        sink->failed++;
+        return false;
+    }
+    sim_record_t record;
+    sim_record_t expected;
+    memcpy(&record, data, sizeof(record) < len ? sizeof(record) : len);
+    make_record(&expected, record.seq, record.taken_ms);
+    if (len != sizeof(record) || record.seq >= MAX_RECORDS || REC_STORED != state[record.seq]
+            || 0 != memcmp(&record, &expected, sizeof(record))) {
+        sink->corrupt++;
+        return true;
+    }
+    if (record.seq <= sink->last_seq) {
+        sink->out_of_order++;
+    }
+    sink->last_seq = record.seq;
+    if (delivered[record.seq]++ > 0) {
+        sink->duplicates++;
+    }
+    sink->replayed++;
+    return true;
+}
+
+static bool run(const scenario_t *sc) {
+    bool ok = true;
+    sim_sink_t sink;
+    memset(&sink, 0, sizeof(sink));
+    memset(state, 0, sizeof(state));
+    memset(delivered, 0, sizeof(delivered));
+    memset(&flash, 0, sizeof(flash));
+    // a region that was never used holds anything
+    for (uint32_t i = 0; i < sizeof(flash.mem); i++) {
+        flash.mem[i] = (uint8_t) rand();
+    }
+    flash.cut_every = sc->cut_every;
+    flash.cut_in = sc->cut_every ? 1U + bench_rand_below(2U * sc->cut_every) : 0U;
+
+    if (!app_telemetry_queue_init(&queue, &sim_flash)) {
+        printf("    FAIL: the queue did not start\n");
+        return false;
+    }
+
+    uint32_t seq = 0;
+    uint32_t live = 0;
+    uint32_t stored = 0;
+    uint32_t not_stored = 0;
+    uint32_t skipped = 0;
+    uint32_t last_stored_ms = 0;
+    uint32_t stored_gap_max = 0;
+    uint32_t boots = 1;
+    uint32_t max_pending = 0;
+    uint32_t batch_max = 0;
+    uint32_t batch_gap_min = UINT32_MAX;
+    uint32_t last_batch_ms = 0;
+    bool has_batch = false;
+    uint32_t online_since = 0;
+    uint32_t drain_max_ms = 0;
+    bool was_online = false;
+    sim_record_t record;
+    const uint32_t period = sc->online_ms + sc->offline_ms;
+
+    for (uint32_t now = 0; now < sc->duration_ms + DRAIN_MS; now += TICK_MS) {
+        sink.now_ms = now;
+        sink.online = now >= sc->duration_ms || (now % period) < sc->online_ms;
+        if (sink.online && !was_online) {
+            online_since = now;
+        }
+        if (!sink.online && was_online) {
+            last_stored_ms = now;
+        }
+        was_online = sink.online;
+
+        if (0 == now % RECORD_MS && seq + 1 < MAX_RECORDS) {
+            seq++;
+            make_record(&record, seq, now);
+            bool busy = 0 != sc->busy_every && 0 == seq % sc->busy_every;
+            uint32_t pushed = queue.stats.pushed;
+            if (sink.online) {
+                state[seq] = REC_LIVE;
+                live++;
+            } else if (busy ? app_telemetry_queue_push(&queue, &record, sizeof(record))
+                    : app_telemetry_queue_push_idle(&queue, &record, sizeof(record), now)) {
+                if (pushed == queue.stats.pushed) {
+                    state[seq] = REC_SKIPPED;
+                    skipped++;
+                } else {
+                    state[seq] = REC_STORED;
+                    stored++;
+                    if (now - last_stored_ms > stored_gap_max) {
+                        stored_gap_max = now - last_stored_ms;
+                    }
+                    last_stored_ms = now;
+                }
+            } else {
+                state[seq] = REC_NOT_STORED;
+                not_stored++;
+            }
+        }
+        uint32_t pending = app_telemetry_queue_pending(&queue);
+        if (pending > max_pending) {
+            max_pending = pending;
+        }
+
+        if (sink.online && pending > 0) {
+            uint32_t count = app_telemetry_queue_replay(&queue, now, publish, &sink);
+            if (count > 0) {
+                if (count > batch_max) {
+                    batch_max = count;
+                }
+                if (has_batch && now - last_batch_ms < batch_gap_min) {
+                    batch_gap_min = now - last_batch_ms;
+                }
+                has_batch = true;
+                last_batch_ms = now;
+            }
+            if (0 == app_telemetry_queue_pending(&queue) && now - online_since > drain_max_ms) {
+                drain_max_ms = now - online_since;
+            }
+        }
+
+        if (flash.cut) {
+            // reset: the queue starts over from what made it to flash
+            flash.cut = false;
+            flash.cut_in = 1U + bench_rand_below(2U * sc->cut_every);
+            boots++;
+            sink.last_seq = 0;
+            has_batch = false;
+            if (!app_telemetry_queue_init(&queue, &sim_flash)) {
+                printf("    FAIL: the queue did not start after a power cut\n");
+                return false;
+            }
+        }
+    }
+
+    // every stored record is replayed, except the oldest ones of an outage that overflowed
+    uint32_t lost = 0;
+    uint32_t holes = 0;
+    bool run_delivered = false;
+    for (uint32_t i = 1; i <= seq; i++) {
+        if (REC_STORED != state[i]) {
+            run_delivered = false;
+            continue;
+        }
+        if (delivered[i] > 0) {
+            run_delivered = true;
+        } else {
+            lost++;
+            if (run_delivered) {
+                holes++;
+            }
+        }
+    }
+    uint32_t erase_min = UINT32_MAX;
+    uint32_t erase_max = 0;
+    for (uint32_t s = 0; s < SECTOR_COUNT; s++) {
+        erase_min = flash.erase_count[s] < erase_min ? flash.erase_count[s] : erase_min;
+        erase_max = flash.erase_count[s] > erase_max ? flash.erase_count[s] : erase_max;
+    }
+
+    printf("%s: %u records, %u live, %u stored, %u idle not stored, %u replayed, %u not stored (power cut), %u boots\n",
+        sc->name, seq, live, stored, skipped, sink.replayed, not_stored, boots);
+    printf("    lost %u  duplicates %u  dropped by the connection %u  most waiting %u  longest drain %.1f s\n",
+        lost, sink.duplicates, sink.failed, max_pending, drain_max_ms / 1000.0);
+    printf("    largest batch %u  shortest time between batches %u ms  erases per sector %u to %u"
+        "  longest gap between stored records %u s\n", batch_max, batch_gap_min == UINT32_MAX ? 0U : batch_gap_min,
+        erase_min, erase_max, stored_gap_max / 1000U);
+
+    if (sink.corrupt || sink.out_of_order) {
+        printf("    FAIL: %u corrupt and %u out of order records replayed\n", sink.corrupt, sink.out_of_order);
+        ok = false;
+    }
+    if (flash.double_programs) {
+        printf("    FAIL: %u bytes programmed twice without an erase\n", flash.double_programs);
+        ok = false;
+    }
+    if ((!sc->overflows && lost > 0) || holes > 0) {
+        printf("    FAIL: %u stored records lost, %u of them after a newer one was replayed\n", lost, holes);
+        ok = false;
+    }
+    if (sc->overflows && 0 == lost) {
+        printf("    FAIL: the outage was expected to overflow the queue\n");
+        ok = false;
+    }
+    if (sink.duplicates > (boots - 1U) * APP_TELEMETRY_REPLAY_BATCH) {
+        printf("    FAIL: %u records replayed twice after %u power cuts\n", sink.duplicates, boots - 1U);
+        ok = false;
+    }
+    if (batch_max > APP_TELEMETRY_REPLAY_BATCH || (batch_gap_min != UINT32_MAX && batch_gap_min < APP_TELEMETRY_REPLAY_INTERVAL_MS)) {
+        printf("    FAIL: replay went over %u records per %u ms\n", APP_TELEMETRY_REPLAY_BATCH, APP_TELEMETRY_REPLAY_INTERVAL_MS);
+        ok = false;
+    }
+    // the first idle heartbeat of an outage and then one per interval are stored
+    if (stored_gap_max > APP_TELEMETRY_OFFLINE_HEARTBEAT_MS + RECORD_MS) {
+        printf("    FAIL: no record stored for %u s while offline\n", stored_gap_max / 1000U);
+        ok = false;
+    }
+    if (app_telemetry_queue_pending(&queue) > 0) {
+        printf("    FAIL: %u records still waiting after %u s online\n", app_telemetry_queue_pending(&queue), DRAIN_MS / 1000U);
+        ok = false;
+    }
+    // a power cut in an erase costs that sector one more erase
+    if (0 == sc->cut_every && erase_max - erase_min > 1U) {
+        printf("    FAIL: sectors worn unevenly\n");
+        ok = false;
+    }
+    return ok;
+}
+
+int main(void) {
+    static const scenario_t scenarios[] = {
+        {.name = "2 h outages", .duration_ms = 12U * HOUR_MS, .online_ms = 1U * HOUR_MS, .offline_ms = 2U * HOUR_MS,
+            .busy_every = 1U},
+        {.name = "8 h busy outages", .duration_ms = 27U * HOUR_MS, .online_ms = 1U * HOUR_MS, .offline_ms = 8U * HOUR_MS,
+            .busy_every = 1U, .overflows = true},
+        {.name = "8 h outages", .duration_ms = 27U * HOUR_MS, .online_ms = 1U * HOUR_MS, .offline_ms = 8U * HOUR_MS,
+            .busy_every = 30U},
+        {.name = "6 day idle outage", .duration_ms = 145U * HOUR_MS, .online_ms = 1U * HOUR_MS, .offline_ms = 144U * HOUR_MS},
+        {.name = "power cuts", .duration_ms = 48U * HOUR_MS, .online_ms = HOUR_MS / 2U, .offline_ms = 2U * HOUR_MS,
+            .cut_every = 300U, .busy_every = 1U},
+        {.name = "30 days", .duration_ms = 720U * HOUR_MS, .online_ms = 2U * HOUR_MS, .offline_ms = 1U * HOUR_MS,
+            .busy_every = 1U},
+    };
+    bool ok = true;
+
+    srand(1);
+    printf("Telemetry queue: %u sectors of %u KB, %u byte slots, a record every %u s, replay %u per %u ms\n",
+        SECTOR_COUNT, SECTOR_SIZE / 1024U, SLOT_SIZE, RECORD_MS / 1000U, APP_TELEMETRY_REPLAY_BATCH,
+        APP_TELEMETRY_REPLAY_INTERVAL_MS);
+    for (uint32_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        ok = run(&scenarios[i]) && ok;
+    }
+    printf("telemetry_queue_sim %s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
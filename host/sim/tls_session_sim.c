@@ -0,0 +1,473 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Runs the TLS session cache of the CM33 application (app_tls_session.c) against a local stand-in for
+ * the MQTT broker: an OpenSSL TLS 1.2 server on the loopback interface that requires a client
+ * certificate, with a P-256 ECDSA certificate on both ends as with the device, and that resumes sessions
+ * by session ID. The PSA calls run on the stand-in in shim/psa, with ITS kept in memory and entries
+ * limited to the ITS_MAX_ASSET_SIZE of TF-M.
+ *
+ * The client does what app_tls_session_mbedtls.c does around the mbedtls handshake, with OpenSSL:
+ * set the stored session before the handshake, tell a resumed handshake by the master secret of the
+ * stored session, and store the session after it. The broker counts the client certificates it verifies,
+ * which happens only in full handshakes.
+ * OpenSSL keeps the whole peer certificate in the session, mbedtls only its digest
+ * (MBEDTLS_SSL_KEEP_PEER_CERTIFICATE is off), so the client leaves it out of the stored session. An
+ * OpenSSL ticket holds the whole session of the broker, client certificate included, and does not fit
+ * in an entry, hence the session IDs.
+ *
+ * Scenarios: reconnects, a reset that keeps ITS, an entry that was tampered with, an entry from another
+ * device, a broker restart that forgets its sessions and ticket keys, and two hosts and then a third
+ * one sharing the slots.
+ * Reports the handshake time of full and resumed handshakes and the ITS writes.
+ * Exits with a non-zero status if a handshake fails, if a handshake that should resume does not, if
+ * the two ways of telling a resumed handshake disagree or if unchanged sessions are written again.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+#include "../bench/bench_util.h"
+#include "psa/crypto.h"
+#include "psa/internal_trusted_storage.h"
+#include "app_tls_session.h"
+
+#define BROKER_HOST     "broker.local"
+#define DISCOVERY_HOST  "discovery.local"
+#define OTHER_HOST      "other.local"
+#define RECONNECTS      50
+
+typedef struct {
+    int listen_fd;
+    uint16_t port;
+    pthread_mutex_t lock;
+    SSL_CTX* ctx;           // replaced by a broker restart
+    bool stop;
+    uint32_t client_certs_verified;     // connections that verified one, only the broker thread writes it
+    bool verified;                      // in the current connection
+    EVP_PKEY* key;
+    X509* cert;
+} broker_t;
+
+typedef struct {
+    SSL_CTX* ctx;
+    EVP_PKEY* key;
+    X509* cert;
+} client_t;
+
+typedef struct {
+    bool ok;
+    bool offered;
+    bool resumed;           // same master secret as the stored session
+    bool reused;            // what OpenSSL says
+    uint64_t handshake_ns;
+} connect_result_t;
+
+static broker_t broker;
+static client_t client;
+static uint64_t full_ns;
+static uint64_t resumed_ns;
+static uint32_t full_count;
+static uint32_t resumed_count;
+static bool all_ok = true;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        printf("FAIL: %s\n", what);
+        all_ok = false;
+    }
+}
+
+static X509* make_cert(EVP_PKEY* key, const char* cn) {
+    X509* cert = X509_new();
+    X509_set_version(cert, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 3600L * 24 * 365);
+    X509_set_pubkey(cert, key);
+    X509_NAME* name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char*) cn, -1, -1, 0);
+    X509_set_issuer_name(cert, name);
+    X509_sign(cert, key, EVP_sha256());
+    return cert;
+}
+
+// The broker accepts the self-signed certificate of any device, as /IOTCONNECT does for a registered one.
+// Called more than once for a chain
+static int verify_client(int preverify_ok, X509_STORE_CTX* store) {
+    (void) preverify_ok;
+    (void) store;
+    broker.verified = true;
+    return 1;
+}
+
+static SSL_CTX* make_broker_ctx(void) {
+    SSL_CTX* ctx = SSL_CTX_new(TLS_server_method());
+    SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+    SSL_CTX_set_max_proto_version(ctx, TLS1_2_VERSION);
+    SSL_CTX_set_cipher_list(ctx, "ECDHE-ECDSA-AES128-GCM-SHA256");
+    SSL_CTX_use_certificate(ctx, broker.cert);
+    SSL_CTX_use_PrivateKey(ctx, broker.key);
+    SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT, verify_client);
+    static const unsigned char sid_ctx[] = "mqtt";
+    SSL_CTX_set_session_id_context(ctx, sid_ctx, sizeof(sid_ctx) - 1);
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+    SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
+    return ctx;
+}
+
+static void restart_broker(void) {
+    SSL_CTX* ctx = make_broker_ctx();
+    pthread_mutex_lock(&broker.lock);
+    SSL_CTX* old = broker.ctx;
+    broker.ctx = ctx;
+    pthread_mutex_unlock(&broker.lock);
+    SSL_CTX_free(old);
+}
+
+// One connection at a time: handshake, answer a CONNECT-sized request with a CONNACK-sized reply, close
+static void* broker_thread(void* arg) {
+    (void) arg;
+    while (true) {
+        int fd = accept(broker.listen_fd, NULL, NULL);
+        pthread_mutex_lock(&broker.lock);
+        bool stop = broker.stop;
+        SSL_CTX* ctx = broker.ctx;
+        SSL_CTX_up_ref(ctx);
+        pthread_mutex_unlock(&broker.lock);
+        if (stop) {
+            SSL_CTX_free(ctx);
+            if (fd >= 0) {
+                close(fd);
+            }
+            break;
+        }
+        if (fd < 0) {
+            SSL_CTX_free(ctx);
+            continue;
+        }
+        SSL* ssl = SSL_new(ctx);
+        SSL_set_fd(ssl, fd);
+        broker.verified = false;
+        int accepted = SSL_accept(ssl);
+        if (broker.verified) {
+            __atomic_add_fetch(&broker.client_certs_verified, 1, __ATOMIC_RELAXED);
+        }
+        if (1 == accepted) {
+            uint8_t buf[64];
+            if (SSL_read(ssl, buf, sizeof(buf)) > 0) {
+                static const uint8_t connack[] = {0x20, 0x02, 0x00, 0x00};
+                SSL_write(ssl, connack, sizeof(connack));
+            }
+            SSL_shutdown(ssl);
+        }
+        SSL_free(ssl);
+        close(fd);
+        SSL_CTX_free(ctx);
+    }
+    return NULL;
+}
+
+static bool start_broker(pthread_t* thread) {
+    broker.key = EVP_EC_gen("P-256");
+    broker.cert = make_cert(broker.key, BROKER_HOST);
+    pthread_mutex_init(&broker.lock, NULL);
+    broker.ctx = make_broker_ctx();
+
+    broker.listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = 0, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    socklen_t addr_len = sizeof(addr);
+    if (broker.listen_fd < 0 || 0 != bind(broker.listen_fd, (struct sockaddr*) &addr, sizeof(addr))
+            || 0 != listen(broker.listen_fd, 4) || 0 != getsockname(broker.listen_fd, (struct sockaddr*) &addr, &addr_len)) {
+        return false;
+    }
+    broker.port = ntohs(addr.sin_port);
+    return 0 == pthread_create(thread, NULL, broker_thread, NULL);
+}
+
+static void stop_broker(pthread_t thread) {
+    pthread_mutex_lock(&broker.lock);
+    broker.stop = true;
+    pthread_mutex_unlock(&broker.lock);
+    // wake up accept()
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons(broker.port), .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    (void) connect(fd, (struct sockaddr*) &addr, sizeof(addr));
+    pthread_join(thread, NULL);
+    close(fd);
+    close(broker.listen_fd);
+    SSL_CTX_free(broker.ctx);
+}
+
+// Length of the DER element at p, header included, 0 if it is not one
+static size_t der_element_len(const uint8_t* p, size_t avail, size_t* header_len) {
+    if (avail < 2) {
+        return 0;
+    }
+    size_t len = p[1];
+    size_t hdr = 2;
+    if (len & 0x80) {
+        size_t n = len & 0x7f;
+        if (n == 0 || n > 2 || avail < 2 + n) {
+            return 0;
+        }
+        len = 0;
+        for (size_t i = 0; i < n; i++) {
+            len = (len << 8) | p[2 + i];
+        }
+        hdr += n;
+    }
+    if (hdr + len > avail) {
+        return 0;
+    }
+    *header_len = hdr;
+    return hdr + len;
+}
+
+// Removes the peer certificate, the [3] element of the session SEQUENCE, in place. Returns the new length
+static size_t strip_peer_certificate(uint8_t* der, size_t len) {
+    size_t hdr;
+    if (len == 0 || der[0] != 0x30 || der_element_len(der, len, &hdr) != len) {
+        return len;
+    }
+    static uint8_t body[APP_TLS_SESSION_DATA_MAX * 4];
+    size_t body_len = 0;
+    for (size_t off = hdr; off < len;) {
+        size_t element_hdr;
+        size_t element_len = der_element_len(der + off, len - off, &element_hdr);
+        if (element_len == 0) {
+            return len;
+        }
+        if (der[off] != 0xa3) {
+            memcpy(body + body_len, der + off, element_len);
+            body_len += element_len;
+        }
+        off += element_len;
+    }
+    size_t out = 0;
+    der[out++] = 0x30;
+    if (body_len < 0x80) {
+        der[out++] = (uint8_t) body_len;
+    } else if (body_len < 0x100) {
+        der[out++] = 0x81;
+        der[out++] = (uint8_t) body_len;
+    } else {
+        der[out++] = 0x82;
+        der[out++] = (uint8_t) (body_len >> 8);
+        der[out++] = (uint8_t) body_len;
+    }
+    memcpy(der + out, body, body_len);
+    return out + body_len;
+}
+
+// What the link-time hook around mbedtls_ssl_handshake() does on the device, on an OpenSSL connection
+static connect_result_t connect_once(const char* host) {
+    connect_result_t result = {0};
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons(broker.port), .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    if (fd < 0 || 0 != connect(fd, (struct sockaddr*) &addr, sizeof(addr))) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return result;
+    }
+    SSL* ssl = SSL_new(client.ctx);
+    SSL_set_fd(ssl, fd);
+    SSL_set_tlsext_host_name(ssl, host);
+
+    uint64_t start = bench_now_ns();
+    static uint8_t session_buf[APP_TLS_SESSION_DATA_MAX];
+    static uint8_t der[APP_TLS_SESSION_DATA_MAX * 4];
+    uint8_t stored_master[SSL_MAX_MASTER_KEY_LENGTH];
+    size_t stored_master_len = 0;
+    size_t len = 0;
+    if (app_tls_session_load(host, session_buf, sizeof(session_buf), &len)) {
+        const unsigned char* p = session_buf;
+        SSL_SESSION* session = d2i_SSL_SESSION(NULL, &p, (long) len);
+        if (session && 1 == SSL_set_session(ssl, session)) {
+            stored_master_len = SSL_SESSION_get_master_key(session, stored_master, sizeof(stored_master));
+            result.offered = true;
+        } else {
+            app_tls_session_forget(host);
+        }
+        SSL_SESSION_free(session);
+    }
+
+    int ret = SSL_connect(ssl);
+    if (1 != ret) {
+        app_tls_session_on_handshake_failed();
+        if (result.offered) {
+            app_tls_session_forget(host);
+        }
+    } else {
+        result.handshake_ns = bench_now_ns() - start;
+        SSL_SESSION* session = SSL_get1_session(ssl);
+        uint8_t master[SSL_MAX_MASTER_KEY_LENGTH];
+        size_t master_len = SSL_SESSION_get_master_key(session, master, sizeof(master));
+        result.resumed = result.offered && master_len == stored_master_len && 0 == memcmp(master, stored_master, master_len);
+        result.reused = 1 == SSL_session_reused(ssl);
+        int der_len = i2d_SSL_SESSION(session, NULL);
+        size_t stored_len = 0;
+        if (der_len > 0 && der_len <= (int) sizeof(der)) {
+            unsigned char* p = der;
+            i2d_SSL_SESSION(session, &p);
+            stored_len = strip_peer_certificate(der, (size_t) der_len);
+        }
+        if (stored_len > 0 && stored_len <= sizeof(session_buf)) {
+            memcpy(session_buf, der, stored_len);
+            check(app_tls_session_save(host, session_buf, stored_len), "a session was not stored");
+        } else {
+            printf("    session of %d bytes does not fit\n", der_len);
+            check(false, "a session does not fit in an ITS entry");
+        }
+        SSL_SESSION_free(session);
+        app_tls_session_on_handshake((uint32_t) (result.handshake_ns / 1000000U), result.resumed);
+
+        static const uint8_t connect_packet[] = {0x10, 0x0c, 0x00, 0x04, 'M', 'Q', 'T', 'T', 0x04, 0x02, 0x00, 0x3c, 0x00, 0x00};
+        uint8_t connack[4];
+        result.ok = SSL_write(ssl, connect_packet, sizeof(connect_packet)) > 0 && SSL_read(ssl, connack, sizeof(connack)) == 4;
+        SSL_shutdown(ssl);
+    }
+    SSL_free(ssl);
+    close(fd);
+
+    if (result.ok) {
+        if (result.resumed) {
+            resumed_ns += result.handshake_ns;
+            resumed_count++;
+        } else {
+            full_ns += result.handshake_ns;
+            full_count++;
+        }
+    }
+    check(result.ok, "handshake failed");
+    check(result.resumed == result.reused, "the master secret and OpenSSL disagree about resumption");
+    return result;
+}
+
+static void reset_device(void) {
+    app_tls_session_deinit();
+    check(app_tls_session_init(), "the sealing key was not derived");
+}
+
+int main(void) {
+    pthread_t thread;
+    if (!start_broker(&thread)) {
+        printf("FAIL: the broker did not start\n");
+        return 1;
+    }
+    client.key = EVP_EC_gen("P-256");
+    client.cert = make_cert(client.key, "device");
+    client.ctx = SSL_CTX_new(TLS_client_method());
+    SSL_CTX_set_min_proto_version(client.ctx, TLS1_2_VERSION);
+    SSL_CTX_set_max_proto_version(client.ctx, TLS1_2_VERSION);
+    SSL_CTX_use_certificate(client.ctx, client.cert);
+    SSL_CTX_use_PrivateKey(client.ctx, client.key);
+    // the sessions are kept by app_tls_session.c only
+    SSL_CTX_set_session_cache_mode(client.ctx, SSL_SESS_CACHE_OFF);
+    check(app_tls_session_init(), "the sealing key was not derived");
+    printf("Broker stand-in on 127.0.0.1:%u\n", broker.port);
+
+    // first connection after a factory reset, then reconnects
+    connect_result_t r = connect_once(BROKER_HOST);
+    check(!r.offered && !r.resumed, "the first handshake found a session");
+    uint32_t writes = host_its_writes();
+    uint32_t reconnects_resumed = 0;
+    for (uint32_t i = 0; i < RECONNECTS; i++) {
+        reconnects_resumed += connect_once(BROKER_HOST).resumed ? 1 : 0;
+    }
+    printf("Reconnects: %u of %u resumed, %u ITS writes, entry of %zu bytes\n", reconnects_resumed, RECONNECTS,
+        host_its_writes() - writes, host_its_size(APP_TLS_SESSION_ITS_UID));
+    check(reconnects_resumed == RECONNECTS, "a reconnect did not resume");
+    check(host_its_writes() == writes, "an unchanged session was written again");
+
+    // a reset keeps ITS and derives the same key
+    reset_device();
+    check(connect_once(BROKER_HOST).resumed, "no resumption after a reset");
+
+    // an entry that was changed does not open, is removed and replaced after a full handshake
+    uint32_t load_failures = app_tls_session_get_stats()->load_failures;
+    host_its_corrupt(APP_TLS_SESSION_ITS_UID, host_its_size(APP_TLS_SESSION_ITS_UID) - 20, 0x01);
+    r = connect_once(BROKER_HOST);
+    check(!r.offered && !r.resumed, "a tampered session was used");
+    check(app_tls_session_get_stats()->load_failures == load_failures + 1, "a tampered session was not reported");
+    check(connect_once(BROKER_HOST).resumed, "no resumption after replacing a tampered session");
+
+    // the host name is authenticated too
+    host_its_corrupt(APP_TLS_SESSION_ITS_UID, 24, 0x20);
+    check(!connect_once(BROKER_HOST).offered, "a session stored for another host was used");
+    check(connect_once(BROKER_HOST).resumed, "no resumption after a host name change");
+
+    // ITS copied to another device, or a new HUK
+    uint8_t other_huk[HOST_PSA_HUK_SIZE];
+    memset(other_huk, 0x5a, sizeof(other_huk));
+    host_psa_set_huk(other_huk);
+    reset_device();
+    check(!connect_once(BROKER_HOST).offered, "a session of another device opened");
+    check(connect_once(BROKER_HOST).resumed, "no resumption on the other device");
+
+    // the broker restarts with new ticket keys and an empty session cache: a full handshake that
+    // replaces the stored session
+    restart_broker();
+    r = connect_once(BROKER_HOST);
+    check(r.offered && !r.resumed, "a session of the previous broker resumed");
+    check(connect_once(BROKER_HOST).resumed, "no resumption after a broker restart");
+
+    // the discovery server gets the other slot, a third host replaces the oldest entry
+    uint32_t alternating_resumed = 0;
+    (void) connect_once(DISCOVERY_HOST);
+    for (uint32_t i = 0; i < 10; i++) {
+        alternating_resumed += connect_once(BROKER_HOST).resumed ? 1 : 0;
+        alternating_resumed += connect_once(DISCOVERY_HOST).resumed ? 1 : 0;
+    }
+    check(alternating_resumed == 20, "two hosts do not both resume");
+    (void) connect_once(OTHER_HOST);
+    check(connect_once(DISCOVERY_HOST).resumed, "the newer entry was replaced");
+    check(!connect_once(BROKER_HOST).resumed, "the oldest entry was kept");
+
+    // the largest session for the longest host name fits in one ITS entry, a larger session is not kept
+    static uint8_t largest[APP_TLS_SESSION_DATA_MAX + 1];
+    char long_host[APP_TLS_SESSION_HOST_MAX];
+    memset(largest, 0xa5, sizeof(largest));
+    memset(long_host, 'h', sizeof(long_host) - 1);
+    long_host[sizeof(long_host) - 1] = '\0';
+    check(app_tls_session_save(long_host, largest, APP_TLS_SESSION_DATA_MAX), "the largest session was not stored");
+    check(!app_tls_session_save(OTHER_HOST, largest, sizeof(largest)), "a session larger than an entry was stored");
+    app_tls_session_forget(long_host);
+
+    const app_tls_session_stats_t* stats = app_tls_session_get_stats();
+    stop_broker(thread);
+    const uint32_t verified = broker.client_certs_verified;
+
+    printf("Handshakes: %u full, %u resumed, %u failed, %u client certificates verified by the broker\n",
+        stats->full, stats->resumed, stats->failed, verified);
+    const double full_ms = full_count ? (double) full_ns / full_count / 1e6 : 0.0;
+    const double resumed_ms = resumed_count ? (double) resumed_ns / resumed_count / 1e6 : 0.0;
+    printf("    full      %7.3f ms per handshake\n", full_ms);
+    printf("    resumed   %7.3f ms per handshake, %.1fx faster\n", resumed_ms, resumed_ms > 0 ? full_ms / resumed_ms : 0.0);
+    printf("    ITS: %u sessions written, %u entries removed\n", stats->saved, stats->load_failures);
+    check(stats->full == full_count && stats->resumed == resumed_count && 0 == stats->failed, "wrong handshake counts");
+    check(verified == full_count, "the client certificate was verified in a resumed handshake");
+    check(resumed_ms < full_ms, "resumed handshakes are not faster");
+
+    SSL_CTX_free(client.ctx);
+    printf("tls_session_sim %s\n", all_ok ? "OK" : "FAILED");
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+#include <stdio.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "event_groups.h"
+
+#include "app_boot.h"
+
+typedef struct {
+    app_boot_stage_t stage;
+    uint32_t after_bits;
+    void (*stage_fn)(void);
+} stage_task_t;
+
+static const char* const stage_names[APP_BOOT_STAGE_COUNT] = {
+    [APP_BOOT_PSA] = "psa",
+    [APP_BOOT_CM55] = "cm55",
+    [APP_BOOT_STORAGE] = "storage",
+    [APP_BOOT_WIFI] = "wifi",
+    [APP_BOOT_TIME] = "time",
+    [APP_BOOT_SDK] = "sdk",
+    [APP_BOOT_CONNECT] = "connect",
+};
+
+static EventGroupHandle_t stages_done;
+static StaticEventGroup_t stages_done_buffer;
+static TickType_t start_ticks[APP_BOOT_STAGE_COUNT];
+static TickType_t end_ticks[APP_BOOT_STAGE_COUNT];
+static stage_task_t stage_tasks[APP_BOOT_STAGE_COUNT];
+
+static uint32_t ticks_to_ms(TickType_t ticks) {
+    return (uint32_t) (ticks * portTICK_PERIOD_MS);
+}
+
+void app_boot_init(void) {
+    stages_done = xEventGroupCreateStatic(&stages_done_buffer);
+}
+
+void app_boot_stage_start(app_boot_stage_t stage) {
+    start_ticks[stage] = xTaskGetTickCount();
+}
+
+void app_boot_stage_done(app_boot_stage_t stage) {
+    end_ticks[stage] = xTaskGetTickCount();
+    (void) xEventGroupSetBits(stages_done, APP_BOOT_BIT(stage));
+}
+
+bool app_boot_stage_is_done(app_boot_stage_t stage) {
+    return 0 != (xEventGroupGetBits(stages_done) & APP_BOOT_BIT(stage));
+}
+
+void app_boot_wait(uint32_t stage_bits) {
+    while ((xEventGroupWaitBits(stages_done, stage_bits, pdFALSE, pdTRUE, portMAX_DELAY) & stage_bits) != stage_bits) {
+    }
+}
+
+static void run_stage(const stage_task_t* task) {
+    if (task->after_bits) {
+        app_boot_wait(task->after_bits);
+    }
+    app_boot_stage_start(task->stage);
+    task->stage_fn();
+    app_boot_stage_done(task->stage);
+}
+
+static void stage_task(void* param) {
+    run_stage((const stage_task_t*) param);
+    vTaskDelete(NULL);
+}
+
+bool app_boot_run(app_boot_stage_t stage, uint32_t after_bits, void (*stage_fn)(void), const char* name,
+        uint32_t stack_size) {
+    stage_tasks[stage].stage = stage;
+    stage_tasks[stage].after_bits = after_bits;
+    stage_tasks[stage].stage_fn = stage_fn;
+    if (pdPASS != xTaskCreate(stage_task, name, stack_size, &stage_tasks[stage], APP_BOOT_STAGE_TASK_PRIORITY, NULL)) {
+        printf("ERROR: Failed to create the %s boot stage task. Running it in place.\n", stage_names[stage]);
+        run_stage(&stage_tasks[stage]);
+        return false;
+    }
+    return true;
+}
+
+int app_boot_format_report(char* buf, size_t size, uint32_t now_ms) {
+    const EventBits_t done = xEventGroupGetBits(stages_done);
+    size_t len = 0;
+    buf[0] = '\0';
+    for (uint32_t i = 0; i < APP_BOOT_STAGE_COUNT && len < size; i++) {
+        if (0 == (done & APP_BOOT_BIT(i))) {
+            continue;
+        }
+        int n = snprintf(&buf[len], size - len, "%s:%lu-%lu,", stage_names[i],
+            (unsigned long) ticks_to_ms(start_ticks[i]), (unsigned long) ticks_to_ms(end_ticks[i]));
+        if (n < 0) {
+            break;
+        }
+        len += (size_t) n;
+    }
+    if (len < size) {
+        int n = snprintf(&buf[len], size - len, "first:%lu", (unsigned long) now_ms);
+        if (n > 0) {
+            len += (size_t) n;
+        }
+    }
+    return (int) ((len < size) ? len : size - 1);
+}
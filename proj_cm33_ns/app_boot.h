@@ -0,0 +1,57 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+#ifndef APP_BOOT_H_
+#define APP_BOOT_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Boot stages of the CM33 application. Stages that do not depend on each other run at the same time,
+// in tasks of their own, and a stage waits for the ones it depends on with app_boot_wait().
+// The start and the end of every stage are recorded in milliseconds from the start of the scheduler,
+// for the boot report in the first telemetry message.
+
+typedef enum {
+    APP_BOOT_PSA = 0,       // HUK-derived client key, device certificate and TLS session key
+    APP_BOOT_CM55,          // first IPC message from CM55
+    APP_BOOT_STORAGE,       // OTA image validation and the telemetry store, after CM55 is up
+    APP_BOOT_WIFI,
+    APP_BOOT_TIME,          // SNTP, after Wi-Fi
+    APP_BOOT_SDK,           // discovery and identity, after PSA, Wi-Fi and time
+    APP_BOOT_CONNECT,       // first MQTT connection
+    APP_BOOT_STAGE_COUNT
+} app_boot_stage_t;
+
+#define APP_BOOT_BIT(stage)     (1UL << (stage))
+
+// Longest boot report, as formatted by app_boot_format_report()
+#define APP_BOOT_REPORT_MAX     192
+
+#ifndef APP_BOOT_STAGE_TASK_PRIORITY
+#define APP_BOOT_STAGE_TASK_PRIORITY    (2U)
+#endif
+
+// Call before the scheduler starts, before any other call below
+void app_boot_init(void);
+
+void app_boot_stage_start(app_boot_stage_t stage);
+// Wakes up the tasks waiting for the stage
+void app_boot_stage_done(app_boot_stage_t stage);
+bool app_boot_stage_is_done(app_boot_stage_t stage);
+
+// Blocks until every stage in stage_bits, a combination of APP_BOOT_BIT() values, is done
+void app_boot_wait(uint32_t stage_bits);
+
+// Runs the stage in a task of its own, once the stages in after_bits are done. The task ends when the
+// stage is done. The stack size is in words, as for xTaskCreate()
+bool app_boot_run(app_boot_stage_t stage, uint32_t after_bits, void (*stage_fn)(void), const char* name,
+    uint32_t stack_size);
+
+// Writes "stage:start-end" for every stage that is done, comma separated, followed by "first:" and now_ms,
+// the time of the first telemetry message. All in ms. Returns the length of the report
+int app_boot_format_report(char* buf, size_t size, uint32_t now_ms);
+
+#endif // APP_BOOT_H_
@@ -18,6 +18,7 @@
 #include "iotcl_dra_json_config.h"
 #include "app_its_config.h"
 #include "app_psa_mqtt.h"
+#include "app_boot.h"
 #include "app_io.h"
 #include "app_configurator_task.h"
 #include "app_config.h"
@@ -28,6 +29,8 @@ static volatile bool s_configurator_in_progress = false;
 
 // Prints the header intro
 static void print_device_intro(void) {
+    // the certificate is generated by a boot stage of app_task
+    app_boot_wait(APP_BOOT_BIT(APP_BOOT_PSA));
     const char* psa_cert = app_psa_mqtt_get_certificate();
     if (psa_cert && strlen(psa_cert) > 0) {
         app_io_write_str_crlf("This device certificate:");
@@ -5,10 +5,12 @@
 
 #include "cybsp.h"
 #include <string.h>
+#include <time.h>
 
 #include "cy_syslib.h" // for Cy_SysLib_GetUniqueId
 
 #include "FreeRTOS.h"
+#include "task.h"
 
 #include "retarget_io_init.h"
 #include "ipc_communication.h"
@@ -23,6 +25,11 @@
 #include "app_psa_mqtt.h"
 #include "app_its_config.h"
 #include "app_config.h"
+#include "app_telemetry_sched.h"
+#include "app_telemetry_queue.h"
+#include "app_telemetry_flash.h"
+#include "app_tls_session.h"
+#include "app_boot.h"
 
 
 /////////////////////////////////////////////////////////////////////////////
@@ -48,12 +55,87 @@
 #define APP_VERSION ("?-" APP_VERSION_BASE)
 #endif
 
+// How long a model command waits for CM55. Slow model tasks only look for requests about once a second
+#define MODEL_CONTROL_TIMEOUT_MS 2000
+
+// Longest time between two checks for inbound MQTT messages while waiting for a detection
+#define INBOUND_POLL_INTERVAL_MS 100
+#define INBOUND_POLL_TIMEOUT_MS 1
+
+// Room for the per-label detection summary of one message, longer summaries are cut short
+#define DETECTIONS_SUMMARY_LEN 256
+
+// QoS of all MQTT messages, telemetry included
+#define MQTT_QOS 1
+
+// How often app_task checks whether CM55 is up while the other boot stages run
+#define CM55_POLL_INTERVAL_MS 10
+
+// Stack sizes of the boot stage tasks, in words. The tasks end when their stage is done
+#define BOOT_PSA_STACK_SIZE (1024 * 2)
+#define BOOT_WIFI_STACK_SIZE (1024 * 2)
+#define BOOT_TIME_STACK_SIZE (1024 * 1)
+
+// Delay before trying to connect again after a failure, doubled after every failure up to the maximum
+#define RECONNECT_DELAY_MIN_MS 5000
+#define RECONNECT_DELAY_MAX_MS 300000
+
+// What one telemetry message reports. Stored in flash as is while offline
+typedef struct {
+    uint32_t captured_s;            // Unix time the record was taken
+    ipc_detection_window_t window;  // without detections, last_detection holds the current state
+} telemetry_record_t;
+
+// The fields of one telemetry message
+typedef struct {
+    bool replayed;
+    uint32_t event_id;
+    const char* event;
+    bool event_detected;
+    uint32_t event_count;
+    const char* detections;
+    const char* captured_at;    // NULL leaves the field out
+    const char* boot;           // NULL leaves the field out
+    int32_t random;
+} telemetry_fields_t;
+
 static bool is_demo_mode = false;
-static int reporting_interval = 2000;
 static bool is_downloading = false;
+static TaskHandle_t app_task_handle = NULL;
+static app_telemetry_sched_t telemetry_sched;
+static app_telemetry_sched_config_t telemetry_config = {
+    .heartbeat_ms = APP_TELEMETRY_HEARTBEAT_MS,
+    .min_interval_ms = APP_TELEMETRY_MIN_INTERVAL_MS,
+    .coalesce_ms = APP_TELEMETRY_COALESCE_MS
+};
+static app_telemetry_queue_t telemetry_queue;
 
 /////////////////////////////////////////////////////////////////////////////
 
+static uint32_t app_now_ms(void) {
+    return (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+// Called from the IPC interrupt for every result from CM55. Wakes the app task on a detection
+static void on_ipc_result(const ipc_payload_t* payload) {
+    if (payload->label_id != 0 && app_task_handle != NULL) {
+        BaseType_t higher_priority_task_woken = pdFALSE;
+        vTaskNotifyGiveFromISR(app_task_handle, &higher_priority_task_woken);
+        portYIELD_FROM_ISR(higher_priority_task_woken);
+    }
+}
+
+// Full handshakes sign with the HUK-derived key, resumed ones do not. Compare the averages of both
+static void print_connect_time(uint32_t connect_ms) {
+    const app_tls_session_stats_t* tls = app_tls_session_get_stats();
+    printf("Connected in %lu ms, TLS handshake %lu ms (%s).\n", (unsigned long) connect_ms,
+        (unsigned long) tls->last_ms, tls->last_resumed ? "resumed" : "full");
+    printf("TLS handshakes: %lu full, average %lu ms. %lu resumed, average %lu ms. %lu failed.\n",
+        (unsigned long) tls->full, (unsigned long) (tls->full ? tls->full_ms_total / tls->full : 0),
+        (unsigned long) tls->resumed, (unsigned long) (tls->resumed ? tls->resumed_ms_total / tls->resumed : 0),
+        (unsigned long) tls->failed);
+}
+
 static void on_connection_status(IotConnectConnectionStatus status) {
     // Add your own status handling
     switch (status) {
@@ -154,10 +236,39 @@ static bool parse_on_off_command(const char* command, const char* name, bool *ar
     return false;
 }
 
+// Forwards a model command to CM55 and waits for it to be applied
+static bool send_model_control(const ipc_control_request_t* request, const char** message) {
+    ipc_control_status_e status = cm33_ipc_send_control(request, MODEL_CONTROL_TIMEOUT_MS);
+    switch (status) {
+        case IPC_CONTROL_STATUS_OK:
+            *message = "Model updated";
+            return true;
+        case IPC_CONTROL_STATUS_UNSUPPORTED:
+            *message = "Not supported by the running model";
+            break;
+        case IPC_CONTROL_STATUS_INVALID:
+            *message = "Rejected by the model";
+            break;
+        case IPC_CONTROL_STATUS_BUSY:
+            *message = "Model is busy with a previous command";
+            break;
+        default:
+            *message = "Model did not respond";
+            break;
+    }
+    printf("Model command failed: %s\n", *message);
+    return false;
+}
+
 static void on_command(IotclC2dEventData data) {
     const char * const BOARD_STATUS_LED = "board-user-led";
     const char * const DEMO_MODE_CMD = "demo-mode";
     const char * const SET_REPORTING_INTERVAL = "set-reporting-interval "; // with a space
+    const char * const SET_TELEMETRY_LIMITS = "set-telemetry-limits "; // with a space
+    const char * const MODEL_ENABLE_CMD = "model-enable";
+    const char * const SET_SENSITIVITY = "set-sensitivity "; // with a space
+    const char * const RESET_SENSITIVITY = "reset-sensitivity";
+    const char * const SET_MIN_RANGE_BIN = "set-min-range-bin "; // with a space
 
     bool command_success = false;
     const char * message = NULL;
@@ -170,6 +281,7 @@ static void on_command(IotclC2dEventData data) {
         printf("Command %s received with %s ACK ID\n", command, ack_id ? ack_id : "no");
         // could be a command without acknowledgment, so ackID can be null
         bool led_on;
+        bool model_on;
         if (parse_on_off_command(command, BOARD_STATUS_LED, &arg_parsing_success, &led_on, &message)) {
             command_success = arg_parsing_success;
             if (arg_parsing_success) {
@@ -186,11 +298,60 @@ static void on_command(IotclC2dEventData data) {
         	if (0 == value) {
                 message = "Argument parsing error";
         	} else {
-        		reporting_interval = value;
+        		telemetry_config.heartbeat_ms = value;
+        		app_telemetry_sched_configure(&telemetry_sched, &telemetry_config);
         		printf("Reporting interval set to %d\n", value);
         		message = "Reporting interval set";
         		command_success =  true;
         	}
+        } else if (0 == strncmp(SET_TELEMETRY_LIMITS, command, strlen(SET_TELEMETRY_LIMITS))) {
+            // minimum interval between messages and the detection coalescing window, in milliseconds
+            unsigned int min_interval, coalesce;
+            if (2 != sscanf(&command[strlen(SET_TELEMETRY_LIMITS)], "%u %u", &min_interval, &coalesce)) {
+                message = "Argument parsing error";
+            } else {
+                telemetry_config.min_interval_ms = min_interval;
+                telemetry_config.coalesce_ms = coalesce;
+                app_telemetry_sched_configure(&telemetry_sched, &telemetry_config);
+                printf("Telemetry minimum interval set to %u, coalescing to %u\n", min_interval, coalesce);
+                message = "Telemetry limits set";
+                command_success = true;
+            }
+        } else if (parse_on_off_command(command, MODEL_ENABLE_CMD, &arg_parsing_success, &model_on, &message)) {
+            if (arg_parsing_success) {
+                ipc_control_request_t request = {.command = IPC_CONTROL_ENABLE_MODEL, .enabled = model_on};
+                command_success = send_model_control(&request, &message);
+            }
+        } else if (0 == strncmp(SET_SENSITIVITY, command, strlen(SET_SENSITIVITY))) {
+            // confidence, average, subsequent, pool and pool selection, as in the model's PP_config_t
+            float confidence;
+            unsigned int average, subsequent, pool, pool_selection;
+            if (5 != sscanf(&command[strlen(SET_SENSITIVITY)], "%f %u %u %u %u",
+                    &confidence, &average, &subsequent, &pool, &pool_selection)
+                    || average > UINT8_MAX || subsequent > UINT8_MAX || pool > UINT8_MAX || pool_selection > UINT8_MAX) {
+                message = "Argument parsing error";
+            } else {
+                ipc_control_request_t request = {
+                    .command = IPC_CONTROL_SET_SENSITIVITY,
+                    .confidence = confidence,
+                    .average = (uint8_t) average,
+                    .subsequent = (uint8_t) subsequent,
+                    .pool = (uint8_t) pool,
+                    .pool_selection = (uint8_t) pool_selection
+                };
+                command_success = send_model_control(&request, &message);
+            }
+        } else if (0 == strcmp(RESET_SENSITIVITY, command)) {
+            ipc_control_request_t request = {.command = IPC_CONTROL_RESET_SENSITIVITY};
+            command_success = send_model_control(&request, &message);
+        } else if (0 == strncmp(SET_MIN_RANGE_BIN, command, strlen(SET_MIN_RANGE_BIN))) {
+            unsigned int value;
+            if (1 != sscanf(&command[strlen(SET_MIN_RANGE_BIN)], "%u", &value) || value > UINT16_MAX) {
+                message = "Argument parsing error";
+            } else {
+                ipc_control_request_t request = {.command = IPC_CONTROL_SET_MIN_RANGE_BIN, .min_range_bin = (uint16_t) value};
+                command_success = send_model_control(&request, &message);
+            }
         } else {
             printf("Unknown command \"%s\"\n", command);
             message = "Unknown command";
@@ -214,34 +375,150 @@ static void on_command(IotclC2dEventData data) {
     }
 }
 
-static cy_rslt_t publish_telemetry(void) {
-    ipc_payload_t payload;
-    // useful fro debugging - making sure we have te latest data:
-    // printf("Has IPC Data: %s\n", cm33_ipc_has_received_message() ? "true" : "false");
-    cm33_ipc_safe_get_and_clear_cached_detection(&payload);
+// Takes the detections since the previous message
+static void take_telemetry_record(telemetry_record_t* record) {
+    record->captured_s = (uint32_t) time(NULL);
+    if (!cm33_ipc_take_detection_window(&record->window)) {
+        // no detection, report the current state
+        cm33_ipc_safe_copy_last_payload(&record->window.last_detection);
+    }
+}
+
+// Sends the telemetry message through iotcl, which adds what the library puts in every message, such as "dt"
+static cy_rslt_t send_telemetry(const telemetry_fields_t* fields) {
     IotclMessageHandle msg = iotcl_telemetry_create();
+    if (NULL == msg) {
+        return CY_RSLT_TYPE_ERROR;
+    }
     iotcl_telemetry_set_string(msg, "version", APP_VERSION);
-    iotcl_telemetry_set_number(msg, "random", rand() % 100); // test some random numbers
-    iotcl_telemetry_set_number(msg, "event_id", payload.label_id);
-    iotcl_telemetry_set_string(msg, "event", payload.label);
-	iotcl_telemetry_set_bool(msg, "event_detected", payload.label_id > 0);
+    iotcl_telemetry_set_bool(msg, "replayed", fields->replayed);
+    iotcl_telemetry_set_number(msg, "event_id", fields->event_id);
+    iotcl_telemetry_set_string(msg, "event", fields->event);
+	iotcl_telemetry_set_bool(msg, "event_detected", fields->event_detected);
+    iotcl_telemetry_set_number(msg, "event_count", fields->event_count);
+    iotcl_telemetry_set_string(msg, "detections", fields->detections);
+    if (fields->captured_at) {
+        iotcl_telemetry_set_string(msg, "captured_at", fields->captured_at);
+    }
+    if (fields->boot) {
+        iotcl_telemetry_set_string(msg, "boot", fields->boot);
+    }
+    iotcl_telemetry_set_number(msg, "random", fields->random);
 
-    iotcl_mqtt_send_telemetry(msg, false);
+    int status = iotcl_mqtt_send_telemetry(msg, false);
     iotcl_telemetry_destroy(msg);
-    return CY_RSLT_SUCCESS;
+    return (IOTCL_SUCCESS == status) ? CY_RSLT_SUCCESS : CY_RSLT_TYPE_ERROR;
+}
+
+// Reports the last detection of the record as event, and per label
+// "label:count:first ms:last ms" in detections.
+// A record replayed from flash also carries the time it was taken in captured_at
+// The first message sent live after the boot also carries the boot report of app_boot.c in boot
+static cy_rslt_t publish_telemetry(const telemetry_record_t* record, bool replayed) {
+    static bool boot_reported = false;
+    static char boot_report[APP_BOOT_REPORT_MAX];
+    char detections[DETECTIONS_SUMMARY_LEN];
+    char captured_at[sizeof("YYYY-MM-DDTHH:MM:SSZ")];
+    const ipc_payload_t* payload = &record->window.last_detection;
+    // useful fro debugging - making sure we have te latest data:
+    // printf("Has IPC Data: %s\n", cm33_ipc_has_received_message() ? "true" : "false");
+    cm33_ipc_format_detection_window(&record->window, detections, sizeof(detections));
+    telemetry_fields_t fields = {
+        .replayed = replayed,
+        .event_id = payload->label_id,
+        .event = cm33_ipc_get_label(payload),
+        .event_detected = payload->label_id > 0,
+        .event_count = record->window.detections,
+        .detections = detections,
+        .captured_at = NULL,
+        .boot = NULL,
+        .random = rand() % 100 // test some random numbers
+    };
+    if (replayed) {
+        time_t captured = (time_t) record->captured_s;
+        struct tm tm;
+        strftime(captured_at, sizeof(captured_at), "%Y-%m-%dT%H:%M:%SZ", gmtime_r(&captured, &tm));
+        fields.captured_at = captured_at;
+    } else if (!boot_reported) {
+        app_boot_format_report(boot_report, sizeof(boot_report), app_now_ms());
+        fields.boot = boot_report;
+    }
+    cy_rslt_t ret = send_telemetry(&fields);
+    if (CY_RSLT_SUCCESS == ret && fields.boot) {
+        printf("Boot report (ms): %s\n", boot_report);
+        boot_reported = true;
+    }
+    return ret;
+}
+
+// Keeps the record in flash until it can be sent. Heartbeats without detections are thinned out
+static void store_telemetry(const telemetry_record_t* record) {
+    uint32_t pushed = telemetry_queue.stats.pushed;
+    bool stored = (0 == record->window.detections)
+        ? app_telemetry_queue_push_idle(&telemetry_queue, record, sizeof(*record), app_now_ms())
+        : app_telemetry_queue_push(&telemetry_queue, record, sizeof(*record));
+    if (!stored) {
+        printf("Failed to store telemetry, it is lost.\n");
+        return;
+    }
+    if (pushed == telemetry_queue.stats.pushed) {
+        return; // an idle heartbeat shortly after the last one stored
+    }
+    printf("Telemetry stored, %lu records waiting.\n", (unsigned long) app_telemetry_queue_pending(&telemetry_queue));
+}
+
+static bool replay_telemetry(const void* data, uint32_t len, void* ctx) {
+    static telemetry_record_t record;
+    (void) ctx;
+    if (len != sizeof(record)) {
+        return true; // stored by a firmware with another record layout, skip it
+    }
+    if (!iotconnect_sdk_is_connected()) {
+        return false;
+    }
+    memcpy(&record, data, sizeof(record));
+    return CY_RSLT_SUCCESS == publish_telemetry(&record, true);
+}
+
+// Boot stages that run in tasks of their own, next to the ones that app_task runs itself
+static void prepare_credentials(void) {
+    app_psa_mqtt_setup_huk();
+    app_tls_session_init();
+}
+
+static void connect_wifi(void) {
+    // This will not return if it fails
+    wifi_app_connect();
+}
+
+static void obtain_time(void) {
+    iotc_mtb_time_obtain(IOTCONNECT_SNTP_SERVER);
 }
 
 void app_task(void *pvParameters) {
     (void) pvParameters;
 
-    // DO NOT print anything before we receive a message to avoice garbled output
-    // we want to wait for CM33 to start receiving messages to prevent halts and errors below.
+    // Credentials, Wi-Fi and time do not need CM55, so they start right away while this task waits for it.
+    // The SDK needs all three and the first connection needs the SDK, see app_boot.h
+    app_boot_run(APP_BOOT_PSA, 0, prepare_credentials, "Boot PSA", BOOT_PSA_STACK_SIZE);
+    app_boot_run(APP_BOOT_WIFI, 0, connect_wifi, "Boot Wi-Fi", BOOT_WIFI_STACK_SIZE);
+    app_boot_run(APP_BOOT_TIME, APP_BOOT_BIT(APP_BOOT_WIFI), obtain_time, "Boot time", BOOT_TIME_STACK_SIZE);
+
+    // we want to wait for CM55 to start sending messages to prevent halts and errors below.
+    // The flash is not touched until then
+    app_boot_stage_start(APP_BOOT_CM55);
     while (!cm33_ipc_has_received_message()) {
-        taskYIELD(); // wait for CM55
+        vTaskDelay(pdMS_TO_TICKS(CM55_POLL_INTERVAL_MS)); // wait for CM55
     }
+    app_boot_stage_done(APP_BOOT_CM55);
 
     printf("App Task: CM55 IPC is ready. Resuming the application...\n");
 
+    // Detections wake the publish loop below
+    app_task_handle = xTaskGetCurrentTaskHandle();
+    cm33_ipc_set_result_handler(on_ipc_result);
+
+    app_boot_stage_start(APP_BOOT_STORAGE);
 #ifdef IOTC_OTA_SUPPORT
     iotc_ota_init();
 
@@ -249,6 +526,14 @@ void app_task(void *pvParameters) {
 	iotc_ota_storage_validated();
 #endif
 
+    app_telemetry_queue_flash_t telemetry_flash;
+    if (app_telemetry_flash_setup(&telemetry_flash) && app_telemetry_queue_init(&telemetry_queue, &telemetry_flash)) {
+        printf("Telemetry store: %lu records waiting to be sent.\n", (unsigned long) app_telemetry_queue_pending(&telemetry_queue));
+    } else {
+        printf("Telemetry store is not available. Telemetry will be lost while offline.\n");
+    }
+    app_boot_stage_done(APP_BOOT_STORAGE);
+
     char iotc_duid[IOTCL_CONFIG_DUID_MAX_LEN] = IOTCONNECT_DUID;
     if (0 == strlen(iotc_duid)) {
         uint64_t hwuid = Cy_SysLib_GetUniqueId();
@@ -260,13 +545,15 @@ void app_task(void *pvParameters) {
         printf("Generated device unique ID (DUID) is: %s\n", iotc_duid);
     }
 
+    app_boot_wait(APP_BOOT_BIT(APP_BOOT_PSA));
+
     IotConnectClientConfig config;
     iotconnect_sdk_init_config(&config);
     config.connection_type = app_its_config_get_platform(IOTCONNECT_CONNECTION_TYPE);
     config.cpid = app_its_config_get_cpid(IOTCONNECT_CPID);
     config.env =  app_its_config_get_env(IOTCONNECT_ENV);
     config.duid = app_its_config_get_duid(iotc_duid);
-    config.qos = 1;
+    config.qos = MQTT_QOS;
     config.verbose = true;
     config.callbacks.status_cb = on_connection_status;
     config.callbacks.cmd_cb = on_command;
@@ -287,43 +574,83 @@ void app_task(void *pvParameters) {
     printf("CPID: %s\n", config.cpid);
     printf("ENV: %s\n", config.env);
 
-    // This will not return if it fails
-    wifi_app_connect();
-
-    iotc_mtb_time_obtain(IOTCONNECT_SNTP_SERVER);
+    app_boot_wait(APP_BOOT_BIT(APP_BOOT_WIFI) | APP_BOOT_BIT(APP_BOOT_TIME));
 
+    app_boot_stage_start(APP_BOOT_SDK);
     cy_rslt_t ret = iotconnect_sdk_init(&config);
     if (CY_RSLT_SUCCESS != ret) {
         printf("Failed to initialize the IoTConnect SDK. Error code: %u\n", (unsigned int) ret);
         goto exit_cleanup;
     }
-
-    for (int i = 0; i < 10; i++) {
-        ret = iotconnect_sdk_connect();
-        if (CY_RSLT_SUCCESS != ret) {
-            printf("Failed to initialize the IoTConnect SDK. Error code: %u\n", (unsigned int) ret);
-            goto exit_cleanup;
-        }
-        
+    app_boot_stage_done(APP_BOOT_SDK);
+    // until the first connection succeeds, however many attempts it takes
+    app_boot_stage_start(APP_BOOT_CONNECT);
+
+    // Publish on detections as they arrive, rate limited, and a heartbeat otherwise.
+    // While offline, the same messages are stored and then replayed in batches after reconnecting.
+    // Reconnect attempts go on for as long as it takes, further apart after every failure.
+    static telemetry_record_t record;
+    bool connected = false;
+    int messages = 0;
+    uint32_t reconnect_delay_ms = RECONNECT_DELAY_MIN_MS;
+    uint32_t next_connect_ms = app_now_ms();
+    app_telemetry_sched_init(&telemetry_sched, &telemetry_config, app_now_ms());
+    while (1) {
         int max_messages = is_demo_mode ? 6000 : 300;
-        for (int j = 0; iotconnect_sdk_is_connected() && j < max_messages; j++) {
-            if (!is_downloading) {
-                cy_rslt_t result = publish_telemetry();
-                if (result != CY_RSLT_SUCCESS) {
-                    break;
+        if (connected && (!iotconnect_sdk_is_connected() || messages >= max_messages)) {
+            if (messages < max_messages) {
+                printf("Connection lost. Storing telemetry until it is back.\n");
+            }
+            iotconnect_sdk_disconnect();
+            connected = false;
+            next_connect_ms = app_now_ms();
+        }
+        if (!connected && (int32_t) (app_now_ms() - next_connect_ms) >= 0) {
+            uint32_t connect_start_ms = app_now_ms();
+            ret = iotconnect_sdk_connect();
+            if (CY_RSLT_SUCCESS == ret) {
+                if (!app_boot_stage_is_done(APP_BOOT_CONNECT)) {
+                    app_boot_stage_done(APP_BOOT_CONNECT);
                 }
+                print_connect_time(app_now_ms() - connect_start_ms);
+                connected = true;
+                messages = 0;
+                reconnect_delay_ms = RECONNECT_DELAY_MIN_MS;
+            } else {
+                printf("Failed to connect to IoTConnect. Error code: %u. Retrying in %lu s\n",
+                    (unsigned int) ret, (unsigned long) (reconnect_delay_ms / 1000));
+                next_connect_ms = app_now_ms() + reconnect_delay_ms;
+                reconnect_delay_ms = (reconnect_delay_ms * 2 > RECONNECT_DELAY_MAX_MS) ? RECONNECT_DELAY_MAX_MS : reconnect_delay_ms * 2;
             }
-            iotconnect_sdk_poll_inbound_mq(reporting_interval);
         }
-        iotconnect_sdk_disconnect();
-    }
-    iotconnect_sdk_deinit();
 
-    printf("\nAppTask Done.\n");
-    while (1) {
-        taskYIELD();
+        uint32_t wait_ms = app_telemetry_sched_wait_ms(&telemetry_sched, app_now_ms());
+        if (0 == wait_ms) {
+            (void) app_telemetry_sched_on_publish(&telemetry_sched, app_now_ms());
+            if (!is_downloading) {
+                take_telemetry_record(&record);
+                if (connected && iotconnect_sdk_is_connected()) {
+                    if (CY_RSLT_SUCCESS == publish_telemetry(&record, false)) {
+                        messages++;
+                    } else {
+                        store_telemetry(&record);
+                    }
+                } else {
+                    store_telemetry(&record);
+                }
+            }
+        } else {
+            if (wait_ms > INBOUND_POLL_INTERVAL_MS) {
+                wait_ms = INBOUND_POLL_INTERVAL_MS;
+            }
+            uint32_t event_count = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait_ms));
+            app_telemetry_sched_on_events(&telemetry_sched, event_count, app_now_ms());
+        }
+        if (connected) {
+            messages += (int) app_telemetry_queue_replay(&telemetry_queue, app_now_ms(), replay_telemetry, NULL);
+            iotconnect_sdk_poll_inbound_mq(INBOUND_POLL_TIMEOUT_MS);
+        }
     }
-    return;
 
     exit_cleanup:
     printf("\nError encountered. AppTask Done.\n");
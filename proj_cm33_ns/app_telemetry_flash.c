@@ -0,0 +1,53 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+#include <stdio.h>
+
+#include "cy_pdl.h"
+#include "cy_ota_flash.h"
+
+#include "app_telemetry_flash.h"
+
+// One cy_ota_mem_write() row, so that programming a record never rewrites another record
+#define APP_TELEMETRY_FLASH_SLOT_SIZE 512
+
+static int flash_read(void* ctx, uint32_t offset, void* data, uint32_t len) {
+    (void) ctx;
+    cy_rslt_t result = cy_ota_mem_read(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, APP_TELEMETRY_FLASH_OFFSET + offset, data, len);
+    return (CY_RSLT_SUCCESS == result) ? 0 : -1;
+}
+
+static int flash_program(void* ctx, uint32_t offset, const void* data, uint32_t len) {
+    (void) ctx;
+    cy_rslt_t result = cy_ota_mem_write(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, APP_TELEMETRY_FLASH_OFFSET + offset, (void *) data, len);
+    return (CY_RSLT_SUCCESS == result) ? 0 : -1;
+}
+
+static int flash_erase(void* ctx, uint32_t offset) {
+    size_t sector_size = cy_ota_mem_get_erase_size(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, APP_TELEMETRY_FLASH_OFFSET + offset);
+    (void) ctx;
+    cy_rslt_t result = cy_ota_mem_erase(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, APP_TELEMETRY_FLASH_OFFSET + offset, sector_size);
+    return (CY_RSLT_SUCCESS == result) ? 0 : -1;
+}
+
+bool app_telemetry_flash_setup(app_telemetry_queue_flash_t* flash) {
+    if (CY_RSLT_SUCCESS != cy_ota_mem_init()) {
+        return false;
+    }
+    size_t sector_size = cy_ota_mem_get_erase_size(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, APP_TELEMETRY_FLASH_OFFSET);
+    if (0 == sector_size || 0 != APP_TELEMETRY_FLASH_OFFSET % sector_size) {
+        printf("Telemetry store: region at 0x%08lx is not aligned to the %u byte erase sectors\n",
+            (unsigned long) APP_TELEMETRY_FLASH_OFFSET, (unsigned int) sector_size);
+        return false;
+    }
+    flash->read = flash_read;
+    flash->program = flash_program;
+    flash->erase = flash_erase;
+    flash->ctx = NULL;
+    flash->sector_size = (uint32_t) sector_size;
+    flash->sector_count = APP_TELEMETRY_FLASH_SIZE / sector_size;
+    flash->slot_size = APP_TELEMETRY_FLASH_SLOT_SIZE;
+    return flash->sector_count >= 2;
+}
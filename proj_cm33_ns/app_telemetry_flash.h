@@ -0,0 +1,30 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+#ifndef APP_TELEMETRY_FLASH_H_
+#define APP_TELEMETRY_FLASH_H_
+
+#include <stdbool.h>
+
+#include "app_telemetry_queue.h"
+
+// Region of the external SMIF flash holding the store-and-forward telemetry queue.
+// The default is in the first megabyte of the flash, which the memory map in design.modus leaves
+// unallocated. The MCUboot slots start at 0x100000. If the map changes, keep this region out of it.
+// 3 sectors of 256 KB have 1533 record slots. When the log wraps, the oldest sector is erased, so
+// between 1022 and 1533 records are kept: under 3 hours of outage if every 10 s record has detections.
+// Heartbeats without detections are stored once per APP_TELEMETRY_OFFLINE_HEARTBEAT_MS, 6 per hour,
+// so an outage without detections fills the region after about 7 days.
+#ifndef APP_TELEMETRY_FLASH_OFFSET
+#define APP_TELEMETRY_FLASH_OFFSET  0x00040000
+#endif
+#ifndef APP_TELEMETRY_FLASH_SIZE
+#define APP_TELEMETRY_FLASH_SIZE    0x000C0000
+#endif
+
+// Describes the region for app_telemetry_queue_init(), accessed through the cy_ota_mem_* functions
+// of cy_ota_flash.c. Returns false if the region does not hold at least 2 erase sectors
+bool app_telemetry_flash_setup(app_telemetry_queue_flash_t* flash);
+
+#endif // APP_TELEMETRY_FLASH_H_
@@ -0,0 +1,379 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "app_telemetry_queue.h"
+
+// Flash layout: the first slot of every sector holds a sector header, the other slots hold one
+// record each, with a slot header in front. Slots are programmed once between two erases.
+
+#define SECTOR_MAGIC        0x31535154UL // "TQS1"
+#define SLOT_MAGIC          0x5154U      // "TQ"
+
+#define SLOT_FREE           0xFF
+#define SLOT_INVALID        0
+#define SLOT_DATA           1
+#define SLOT_CHECKPOINT     2
+
+typedef struct {
+    uint32_t magic;
+    uint32_t sector_seq;    // one more than in the sector taken into use before
+    uint32_t erase_count;
+    uint32_t crc;
+} sector_header_t;
+
+typedef struct {
+    uint16_t magic;
+    uint8_t type;
+    uint8_t reserved;
+    uint16_t len;
+    uint16_t reserved2;
+    uint32_t seq;           // of the record, or of the last record replayed for a checkpoint
+    uint32_t crc;           // of the header up to here and of the record
+} slot_header_t;
+
+static uint32_t crc32_update(uint32_t crc, const void* data, uint32_t len) {
+    const uint8_t* p = (const uint8_t*) data;
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= p[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+static bool is_erased(const uint8_t* data, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) {
+        if (data[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint32_t slot_offset(const app_telemetry_queue_t* q, uint32_t sector, uint32_t slot) {
+    return sector * q->flash.sector_size + slot * q->flash.slot_size;
+}
+
+static bool read_sector_header(app_telemetry_queue_t* q, uint32_t sector, sector_header_t* header) {
+    if (0 != q->flash.read(q->flash.ctx, slot_offset(q, sector, 0), header, sizeof(*header))) {
+        q->stats.flash_errors++;
+        return false;
+    }
+    return SECTOR_MAGIC == header->magic && header->crc == crc32_update(0, header, offsetof(sector_header_t, crc));
+}
+
+// Reads the slot into q->buf and returns its type
+static int read_slot(app_telemetry_queue_t* q, uint32_t sector, uint32_t slot) {
+    slot_header_t header;
+    uint32_t offset = slot_offset(q, sector, slot);
+    if (0 != q->flash.read(q->flash.ctx, offset, q->buf, sizeof(header))) {
+        q->stats.flash_errors++;
+        return SLOT_INVALID;
+    }
+    if (is_erased(q->buf, sizeof(header))) {
+        return SLOT_FREE;
+    }
+    memcpy(&header, q->buf, sizeof(header));
+    if (SLOT_MAGIC != header.magic || header.len > q->flash.slot_size - sizeof(header)
+            || (SLOT_DATA != header.type && SLOT_CHECKPOINT != header.type)) {
+        return SLOT_INVALID;
+    }
+    if (header.len > 0 && 0 != q->flash.read(q->flash.ctx, offset + sizeof(header), q->buf + sizeof(header), header.len)) {
+        q->stats.flash_errors++;
+        return SLOT_INVALID;
+    }
+    uint32_t crc = crc32_update(0, q->buf, offsetof(slot_header_t, crc));
+    if (header.crc != crc32_update(crc, q->buf + sizeof(header), header.len)) {
+        return SLOT_INVALID; // torn by a reset while it was programmed
+    }
+    return header.type;
+}
+
+static bool is_slot_erased(app_telemetry_queue_t* q, uint32_t sector, uint32_t slot) {
+    if (0 != q->flash.read(q->flash.ctx, slot_offset(q, sector, slot), q->buf, q->flash.slot_size)) {
+        q->stats.flash_errors++;
+        return false;
+    }
+    return is_erased(q->buf, q->flash.slot_size);
+}
+
+// Moves the cursor to the start of the next sector in use
+static void next_sector(app_telemetry_queue_t* q, app_telemetry_queue_cursor_t* cursor) {
+    sector_header_t header;
+    do {
+        cursor->sector = (cursor->sector + 1) % q->flash.sector_count;
+    } while (cursor->sector != q->write_sector && !read_sector_header(q, cursor->sector, &header));
+    cursor->slot = 1;
+}
+
+// Erases the sector and makes it the one written to. Records in it that were not replayed are lost
+static bool start_sector(app_telemetry_queue_t* q, uint32_t sector) {
+    sector_header_t header;
+    uint32_t erase_count = read_sector_header(q, sector, &header) ? header.erase_count + 1 : 1;
+
+    // replay skips to the next sector, and counts what it missed when it gets there
+    if (q->ready && q->read.sector == sector) {
+        next_sector(q, &q->read);
+    }
+    if (q->ready && q->committed.sector == sector) {
+        next_sector(q, &q->committed);
+    }
+    if (0 != q->flash.erase(q->flash.ctx, slot_offset(q, sector, 0))) {
+        q->stats.flash_errors++;
+        return false;
+    }
+    q->stats.erases++;
+
+    header.magic = SECTOR_MAGIC;
+    header.sector_seq = q->sector_seq + 1;
+    header.erase_count = erase_count;
+    header.crc = crc32_update(0, &header, offsetof(sector_header_t, crc));
+    if (0 != q->flash.program(q->flash.ctx, slot_offset(q, sector, 0), &header, sizeof(header))) {
+        q->stats.flash_errors++;
+        return false;
+    }
+    q->sector_seq = header.sector_seq;
+    q->write_sector = sector;
+    q->write_slot = 1;
+    if (erase_count > q->stats.max_erase_count) {
+        q->stats.max_erase_count = erase_count;
+    }
+    return true;
+}
+
+static bool append(app_telemetry_queue_t* q, uint8_t type, uint32_t seq, const void* data, uint32_t len) {
+    if (q->write_slot >= q->slots && !start_sector(q, (q->write_sector + 1) % q->flash.sector_count)) {
+        return false;
+    }
+    slot_header_t header = {
+        .magic = SLOT_MAGIC,
+        .type = type,
+        .reserved = 0,
+        .len = (uint16_t) len,
+        .reserved2 = 0,
+        .seq = seq,
+        .crc = 0
+    };
+    memcpy(q->buf, &header, sizeof(header));
+    if (len > 0) {
+        memcpy(q->buf + sizeof(header), data, len);
+    }
+    header.crc = crc32_update(crc32_update(0, q->buf, offsetof(slot_header_t, crc)), data, len);
+    memcpy(q->buf, &header, sizeof(header));
+
+    uint32_t offset = slot_offset(q, q->write_sector, q->write_slot);
+    // a slot that failed to program is not erased any more, so it is not tried again either
+    q->write_slot++;
+    if (0 != q->flash.program(q->flash.ctx, offset, q->buf, sizeof(header) + len)) {
+        q->stats.flash_errors++;
+        return false;
+    }
+    return true;
+}
+
+bool app_telemetry_queue_init(app_telemetry_queue_t* q, const app_telemetry_queue_flash_t* flash) {
+    memset(q, 0, sizeof(*q));
+    q->flash = *flash;
+    if (flash->sector_count < 2 || flash->slot_size <= sizeof(slot_header_t) || flash->slot_size > APP_TELEMETRY_QUEUE_SLOT_MAX
+            || 0 != flash->sector_size % flash->slot_size || flash->sector_size / flash->slot_size < 2) {
+        return false;
+    }
+    q->slots = flash->sector_size / flash->slot_size;
+
+    // writing goes on in the sector taken into use last
+    bool found = false;
+    for (uint32_t s = 0; s < flash->sector_count; s++) {
+        sector_header_t header;
+        if (!read_sector_header(q, s, &header)) {
+            continue;
+        }
+        if (!found || (int32_t) (header.sector_seq - q->sector_seq) > 0) {
+            q->write_sector = s;
+            q->sector_seq = header.sector_seq;
+        }
+        if (header.erase_count > q->stats.max_erase_count) {
+            q->stats.max_erase_count = header.erase_count;
+        }
+        found = true;
+    }
+    if (q->stats.flash_errors > 0) {
+        return false; // do not start over on top of records that could not be read
+    }
+    if (!found) {
+        if (!start_sector(q, 0)) {
+            return false;
+        }
+        q->next_seq = 1;
+        q->read.sector = q->committed.sector = 0;
+        q->read.slot = q->committed.slot = 1;
+        q->ready = true;
+        return true;
+    }
+
+    // scan from the oldest sector to the newest one
+    bool has_data = false;
+    bool has_checkpoint = false;
+    bool has_oldest = false;
+    uint32_t min_seq = 0;
+    uint32_t max_seq = 0;
+    uint32_t checkpoint = 0;
+    q->write_slot = q->slots;
+    for (uint32_t i = 1; i <= flash->sector_count; i++) {
+        uint32_t s = (q->write_sector + i) % flash->sector_count;
+        sector_header_t header;
+        if (!read_sector_header(q, s, &header)) {
+            continue;
+        }
+        if (!has_oldest) {
+            q->read.sector = s;
+            has_oldest = true;
+        }
+        for (uint32_t slot = 1; slot < q->slots; slot++) {
+            int type = read_slot(q, s, slot);
+            if (SLOT_FREE == type && (s != q->write_sector || is_slot_erased(q, s, slot))) {
+                if (s == q->write_sector) {
+                    q->write_slot = slot;
+                }
+                break;
+            }
+            slot_header_t slot_header;
+            memcpy(&slot_header, q->buf, sizeof(slot_header));
+            if (SLOT_DATA == type) {
+                if (!has_data || slot_header.seq < min_seq) {
+                    min_seq = slot_header.seq;
+                }
+                if (!has_data || slot_header.seq > max_seq) {
+                    max_seq = slot_header.seq;
+                }
+                has_data = true;
+            } else if (SLOT_CHECKPOINT == type) {
+                if (!has_checkpoint || slot_header.seq > checkpoint) {
+                    checkpoint = slot_header.seq;
+                }
+                has_checkpoint = true;
+            }
+        }
+    }
+
+    q->next_seq = has_data ? max_seq + 1 : 1;
+    // records older than the ones left were replayed, or the sector holding their checkpoint
+    // would not have been erased
+    q->read.consumed_seq = has_data ? min_seq - 1 : 0;
+    if (has_checkpoint && checkpoint > q->read.consumed_seq) {
+        q->read.consumed_seq = (checkpoint < q->next_seq) ? checkpoint : q->next_seq - 1;
+    }
+    q->read.slot = 1;
+    q->committed = q->read;
+    q->ready = true;
+    return true;
+}
+
+bool app_telemetry_queue_push(app_telemetry_queue_t* q, const void* record, uint32_t len) {
+    if (!q->ready || len > q->flash.slot_size - sizeof(slot_header_t)) {
+        return false;
+    }
+    if (!append(q, SLOT_DATA, q->next_seq, record, len)) {
+        return false;
+    }
+    q->next_seq++;
+    q->stats.pushed++;
+    q->idle_stored = false;
+    return true;
+}
+
+bool app_telemetry_queue_push_idle(app_telemetry_queue_t* q, const void* record, uint32_t len, uint32_t now_ms) {
+    if (q->idle_stored && (now_ms - q->idle_stored_ms) < APP_TELEMETRY_OFFLINE_HEARTBEAT_MS) {
+        q->stats.idle_skipped++;
+        return true;
+    }
+    if (!app_telemetry_queue_push(q, record, len)) {
+        return false;
+    }
+    q->idle_stored = true;
+    q->idle_stored_ms = now_ms;
+    return true;
+}
+
+uint32_t app_telemetry_queue_pending(const app_telemetry_queue_t* q) {
+    return q->ready ? q->next_seq - 1 - q->read.consumed_seq : 0;
+}
+
+// Returns the next record to replay, in q->buf after its slot header, or NULL if there is none
+static const uint8_t* pop(app_telemetry_queue_t* q, uint32_t* len) {
+    while (q->read.consumed_seq + 1 < q->next_seq) {
+        if (q->read.sector == q->write_sector && q->read.slot >= q->write_slot) {
+            break;
+        }
+        if (q->read.slot >= q->slots) {
+            next_sector(q, &q->read);
+            continue;
+        }
+        int type = read_slot(q, q->read.sector, q->read.slot);
+        if (SLOT_FREE == type && q->read.sector != q->write_sector) {
+            next_sector(q, &q->read);
+            continue;
+        }
+        q->read.slot++;
+        if (SLOT_DATA == type) {
+            slot_header_t header;
+            memcpy(&header, q->buf, sizeof(header));
+            if (header.seq > q->read.consumed_seq) {
+                q->stats.dropped += header.seq - q->read.consumed_seq - 1;
+                q->read.consumed_seq = header.seq;
+                *len = header.len;
+                return q->buf + sizeof(header);
+            }
+        }
+    }
+    // whatever is left to replay was overwritten
+    q->stats.dropped += q->next_seq - 1 - q->read.consumed_seq;
+    q->read.consumed_seq = q->next_seq - 1;
+    return NULL;
+}
+
+static void commit(app_telemetry_queue_t* q) {
+    if (q->read.consumed_seq == q->committed.consumed_seq) {
+        return;
+    }
+    q->committed = q->read;
+    (void) append(q, SLOT_CHECKPOINT, q->read.consumed_seq, NULL, 0);
+}
+
+uint32_t app_telemetry_queue_replay(app_telemetry_queue_t* q, uint32_t now_ms, app_telemetry_queue_publish_t publish, void* ctx) {
+    if (0 == app_telemetry_queue_pending(q)) {
+        return 0;
+    }
+    if (q->replay_started && (now_ms - q->last_replay_ms) < APP_TELEMETRY_REPLAY_INTERVAL_MS) {
+        return 0;
+    }
+    q->replay_started = true;
+    q->last_replay_ms = now_ms;
+
+    uint32_t count = 0;
+    while (count < APP_TELEMETRY_REPLAY_BATCH) {
+        app_telemetry_queue_cursor_t before = q->read;
+        uint32_t dropped = q->stats.dropped;
+        uint32_t len = 0;
+        const uint8_t* record = pop(q, &len);
+        if (NULL == record) {
+            break;
+        }
+        if (!publish(record, len, ctx)) {
+            // try this one again with the next batch
+            q->read = before;
+            q->stats.dropped = dropped;
+            break;
+        }
+        count++;
+    }
+    q->stats.replayed += count;
+    commit(q);
+    return count;
+}
@@ -0,0 +1,108 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+#ifndef APP_TELEMETRY_QUEUE_H_
+#define APP_TELEMETRY_QUEUE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Store-and-forward queue for telemetry records that could not be published while MQTT was down.
+// Records are appended to NOR flash as a log, one slot per record, going round the sectors of the
+// region in order, so every sector is erased as often as the others. When the log catches up with
+// its oldest sector, that sector is erased and the records in it that were not replayed yet are
+// dropped, so the queue never grows beyond the region.
+// While offline, most records are heartbeats without detections. Storing every one of them would fill
+// the region in a few hours, so only one heartbeat is stored per APP_TELEMETRY_OFFLINE_HEARTBEAT_MS
+// (see app_telemetry_queue_push_idle()). Records with detections are always stored.
+// After a batch of records is replayed, a checkpoint record saves how far the replay got. At boot,
+// the log is scanned and replay continues after the newest checkpoint. A record that was published
+// but not checkpointed before a reset is published again.
+
+#ifndef APP_TELEMETRY_QUEUE_SLOT_MAX
+#define APP_TELEMETRY_QUEUE_SLOT_MAX        512
+#endif
+// Records replayed per batch after reconnecting, and the time between batches
+#ifndef APP_TELEMETRY_REPLAY_BATCH
+#define APP_TELEMETRY_REPLAY_BATCH          10
+#endif
+#ifndef APP_TELEMETRY_REPLAY_INTERVAL_MS
+#define APP_TELEMETRY_REPLAY_INTERVAL_MS    1000
+#endif
+// Shortest time between two stored heartbeats without detections
+#ifndef APP_TELEMETRY_OFFLINE_HEARTBEAT_MS
+#define APP_TELEMETRY_OFFLINE_HEARTBEAT_MS  600000
+#endif
+
+#define APP_TELEMETRY_QUEUE_SLOT_HEADER_SIZE 16
+#define APP_TELEMETRY_QUEUE_RECORD_MAX       (APP_TELEMETRY_QUEUE_SLOT_MAX - APP_TELEMETRY_QUEUE_SLOT_HEADER_SIZE)
+
+// The flash region of the queue. Offsets are relative to the start of the region.
+// Functions return 0 on success.
+typedef struct {
+    int (*read)(void* ctx, uint32_t offset, void* data, uint32_t len);
+    int (*program)(void* ctx, uint32_t offset, const void* data, uint32_t len); // into erased flash only
+    int (*erase)(void* ctx, uint32_t offset);                                   // the sector at offset
+    void* ctx;
+    uint32_t sector_size;
+    uint32_t sector_count;  // at least 2
+    uint32_t slot_size;     // bytes set aside for a record, divides sector_size. At most APP_TELEMETRY_QUEUE_SLOT_MAX
+} app_telemetry_queue_flash_t;
+
+typedef struct {
+    uint32_t sector;
+    uint32_t slot;
+    uint32_t consumed_seq;  // sequence number of the last record replayed
+} app_telemetry_queue_cursor_t;
+
+typedef struct {
+    uint32_t pushed;
+    uint32_t replayed;
+    uint32_t dropped;           // overwritten or corrupted before they were replayed
+    uint32_t idle_skipped;      // heartbeats without detections not stored, see app_telemetry_queue_push_idle()
+    uint32_t flash_errors;
+    uint32_t erases;            // since boot
+    uint32_t max_erase_count;   // of any sector of the region, over the life of the flash
+} app_telemetry_queue_stats_t;
+
+typedef struct {
+    app_telemetry_queue_flash_t flash;
+    bool ready;
+    uint32_t slots;             // per sector, including the sector header slot
+    uint32_t write_sector;
+    uint32_t write_slot;        // next free slot in write_sector
+    uint32_t sector_seq;        // of write_sector
+    uint32_t next_seq;          // of the next record pushed
+    app_telemetry_queue_cursor_t read;      // where replay goes on
+    app_telemetry_queue_cursor_t committed; // read, as saved by the last checkpoint
+    bool replay_started;
+    uint32_t last_replay_ms;
+    bool idle_stored;           // the last record pushed was a heartbeat without detections
+    uint32_t idle_stored_ms;    // when it was pushed
+    app_telemetry_queue_stats_t stats;
+    uint8_t buf[APP_TELEMETRY_QUEUE_SLOT_MAX];
+} app_telemetry_queue_t;
+
+// Publishes a replayed record. Returns false if it could not be sent, so it is kept for later
+typedef bool (*app_telemetry_queue_publish_t)(const void* record, uint32_t len, void* ctx);
+
+// Scans the region and resumes the queue found there, or starts a new one. Returns false if the
+// flash is unusable, in which case push() and replay() do nothing
+bool app_telemetry_queue_init(app_telemetry_queue_t* q, const app_telemetry_queue_flash_t* flash);
+
+// Appends a record of up to APP_TELEMETRY_QUEUE_RECORD_MAX bytes. May erase the oldest sector first
+bool app_telemetry_queue_push(app_telemetry_queue_t* q, const void* record, uint32_t len);
+
+// Appends a heartbeat without detections, unless the last record pushed was one too and was pushed
+// less than APP_TELEMETRY_OFFLINE_HEARTBEAT_MS before now_ms. Returns false only if storing it failed
+bool app_telemetry_queue_push_idle(app_telemetry_queue_t* q, const void* record, uint32_t len, uint32_t now_ms);
+
+// Records waiting to be replayed
+uint32_t app_telemetry_queue_pending(const app_telemetry_queue_t* q);
+
+// Publishes the next batch of at most APP_TELEMETRY_REPLAY_BATCH records, if the previous batch was
+// APP_TELEMETRY_REPLAY_INTERVAL_MS or more ago, then saves a checkpoint. Returns the records published
+uint32_t app_telemetry_queue_replay(app_telemetry_queue_t* q, uint32_t now_ms, app_telemetry_queue_publish_t publish, void* ctx);
+
+#endif // APP_TELEMETRY_QUEUE_H_
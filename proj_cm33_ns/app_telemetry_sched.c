@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+#include "app_telemetry_sched.h"
+
+void app_telemetry_sched_init(app_telemetry_sched_t* sched, const app_telemetry_sched_config_t* config, uint32_t now_ms) {
+    app_telemetry_sched_configure(sched, config);
+    sched->pending_events = 0;
+    sched->first_event_ms = now_ms;
+    // pretend the last message went out a full heartbeat ago
+    sched->last_publish_ms = now_ms - sched->config.heartbeat_ms;
+}
+
+void app_telemetry_sched_configure(app_telemetry_sched_t* sched, const app_telemetry_sched_config_t* config) {
+    sched->config = *config;
+    if (sched->config.heartbeat_ms < sched->config.min_interval_ms) {
+        sched->config.heartbeat_ms = sched->config.min_interval_ms;
+    }
+}
+
+void app_telemetry_sched_on_events(app_telemetry_sched_t* sched, uint32_t count, uint32_t now_ms) {
+    if (0 == count) {
+        return;
+    }
+    if (0 == sched->pending_events) {
+        sched->first_event_ms = now_ms;
+    }
+    sched->pending_events += count;
+}
+
+uint32_t app_telemetry_sched_wait_ms(const app_telemetry_sched_t* sched, uint32_t now_ms) {
+    // everything relative to the last message, so that wrap around does not matter
+    uint32_t elapsed = now_ms - sched->last_publish_ms;
+    uint32_t due = sched->config.heartbeat_ms;
+    if (sched->pending_events > 0) {
+        uint32_t event_due = (sched->first_event_ms - sched->last_publish_ms) + sched->config.coalesce_ms;
+        if (event_due < sched->config.min_interval_ms) {
+            event_due = sched->config.min_interval_ms;
+        }
+        if (event_due < due) {
+            due = event_due;
+        }
+    }
+    return (elapsed >= due) ? 0 : (due - elapsed);
+}
+
+uint32_t app_telemetry_sched_on_publish(app_telemetry_sched_t* sched, uint32_t now_ms) {
+    uint32_t events = sched->pending_events;
+    sched->pending_events = 0;
+    sched->last_publish_ms = now_ms;
+    return events;
+}
@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+#ifndef APP_TELEMETRY_SCHED_H_
+#define APP_TELEMETRY_SCHED_H_
+
+#include <stdint.h>
+
+// Decides when app_task publishes telemetry.
+// A detection from CM55 is published right away, but no sooner than min_interval_ms after the
+// previous message, and after waiting up to coalesce_ms for more detections to share the message.
+// Without detections, a heartbeat message is sent every heartbeat_ms.
+// Times are milliseconds of any free running clock and may wrap around.
+
+#ifndef APP_TELEMETRY_HEARTBEAT_MS
+#define APP_TELEMETRY_HEARTBEAT_MS      10000
+#endif
+#ifndef APP_TELEMETRY_MIN_INTERVAL_MS
+#define APP_TELEMETRY_MIN_INTERVAL_MS   500
+#endif
+#ifndef APP_TELEMETRY_COALESCE_MS
+#define APP_TELEMETRY_COALESCE_MS       20
+#endif
+
+typedef struct {
+    uint32_t heartbeat_ms;      // longest time between two messages
+    uint32_t min_interval_ms;   // shortest time between two messages
+    uint32_t coalesce_ms;       // how long a detection waits for more detections
+} app_telemetry_sched_config_t;
+
+typedef struct {
+    app_telemetry_sched_config_t config;
+    uint32_t last_publish_ms;
+    uint32_t first_event_ms;    // arrival of the oldest detection not published yet
+    uint32_t pending_events;    // detections not published yet
+} app_telemetry_sched_t;
+
+// The first message is due right away
+void app_telemetry_sched_init(app_telemetry_sched_t* sched, const app_telemetry_sched_config_t* config, uint32_t now_ms);
+
+// Changes the limits. Pending detections are kept. The heartbeat is raised to min_interval_ms if lower
+void app_telemetry_sched_configure(app_telemetry_sched_t* sched, const app_telemetry_sched_config_t* config);
+
+// Records count detections that arrived at now_ms
+void app_telemetry_sched_on_events(app_telemetry_sched_t* sched, uint32_t count, uint32_t now_ms);
+
+// Time until the next message is due, 0 if it is due now
+uint32_t app_telemetry_sched_wait_ms(const app_telemetry_sched_t* sched, uint32_t now_ms);
+
+// Records a message sent at now_ms. Returns the number of detections it covers
+uint32_t app_telemetry_sched_on_publish(app_telemetry_sched_t* sched, uint32_t now_ms);
+
+#endif // APP_TELEMETRY_SCHED_H_
@@ -0,0 +1,260 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "psa/crypto.h"
+#include "psa/internal_trusted_storage.h"
+
+#include "app_tls_session.h"
+
+// Same die-unique key that app_psa_mqtt.c derives the client key from
+#define HUK_KEY_ID              ((psa_key_id_t)0x7FFF0000U)
+#define KEY_DERIVATION_INPUT_DATA   "Avnet IoTConnect TLS Session Cache v1"
+
+#define ENTRY_MAGIC             0x31534C54U     // "TLS1"
+#define ENTRY_NONCE_SIZE        12
+#define ENTRY_TAG_SIZE          16
+
+// The header and the host name are authenticated, the session is encrypted
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;               // the entry with the lowest one is replaced first
+    uint16_t host_len;
+    uint16_t data_len;
+    uint8_t nonce[ENTRY_NONCE_SIZE];
+} entry_header_t;
+
+typedef struct {
+    entry_header_t hdr;
+    uint8_t buff[APP_TLS_SESSION_HOST_MAX + APP_TLS_SESSION_DATA_MAX + ENTRY_TAG_SIZE];
+} entry_t;
+
+_Static_assert(sizeof(entry_t) <= APP_TLS_SESSION_ITS_ASSET_MAX, "an entry must fit in one ITS asset");
+
+static psa_key_id_t key_id = PSA_KEY_ID_NULL;
+static app_tls_session_stats_t stats;
+// Of the session last loaded or saved in each slot, to avoid writing the same one again
+static uint32_t slot_hash[APP_TLS_SESSION_SLOTS];
+static bool slot_hash_valid[APP_TLS_SESSION_SLOTS];
+// Handshakes do not run concurrently, so one buffer is enough and keeps it off the task stacks
+static entry_t entry;
+
+static psa_storage_uid_t slot_uid(uint32_t slot) {
+    return (psa_storage_uid_t) (APP_TLS_SESSION_ITS_UID + slot);
+}
+
+static uint32_t fnv1a(const uint8_t* data, size_t len) {
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ data[i]) * 16777619U;
+    }
+    return hash;
+}
+
+// Reads the header and the host name of the entry in slot. Returns false if the slot is empty or invalid
+static bool read_header(uint32_t slot, entry_header_t* hdr, char* host) {
+    size_t got = 0;
+    uint8_t buf[sizeof(entry_header_t) + APP_TLS_SESSION_HOST_MAX];
+    psa_status_t status = psa_its_get(slot_uid(slot), 0, sizeof(buf), buf, &got);
+    // an entry with a short session may be shorter than buf
+    if (status != PSA_SUCCESS || got < sizeof(entry_header_t)) {
+        return false;
+    }
+    memcpy(hdr, buf, sizeof(*hdr));
+    if (hdr->magic != ENTRY_MAGIC || hdr->host_len == 0 || hdr->host_len >= APP_TLS_SESSION_HOST_MAX
+            || hdr->data_len > APP_TLS_SESSION_DATA_MAX || got < sizeof(entry_header_t) + hdr->host_len) {
+        return false;
+    }
+    memcpy(host, buf + sizeof(entry_header_t), hdr->host_len);
+    host[hdr->host_len] = '\0';
+    return true;
+}
+
+static int find_slot(const char* host) {
+    entry_header_t hdr;
+    char slot_host[APP_TLS_SESSION_HOST_MAX];
+    for (uint32_t slot = 0; slot < APP_TLS_SESSION_SLOTS; slot++) {
+        if (read_header(slot, &hdr, slot_host) && 0 == strcmp(slot_host, host)) {
+            return (int) slot;
+        }
+    }
+    return -1;
+}
+
+static void remove_slot(uint32_t slot) {
+    (void) psa_its_remove(slot_uid(slot));
+    slot_hash_valid[slot] = false;
+}
+
+bool app_tls_session_init(void) {
+    if (key_id != PSA_KEY_ID_NULL) {
+        return true;
+    }
+    psa_key_derivation_operation_t op = PSA_KEY_DERIVATION_OPERATION_INIT;
+    psa_status_t status = psa_key_derivation_setup(&op, PSA_ALG_HKDF(PSA_ALG_SHA_256));
+    if (status == PSA_SUCCESS) {
+        status = psa_key_derivation_input_key(&op, PSA_KEY_DERIVATION_INPUT_SECRET, HUK_KEY_ID);
+    }
+    if (status == PSA_SUCCESS) {
+        status = psa_key_derivation_input_bytes(&op, PSA_KEY_DERIVATION_INPUT_INFO,
+            (const uint8_t*) KEY_DERIVATION_INPUT_DATA, strlen(KEY_DERIVATION_INPUT_DATA));
+    }
+    if (status == PSA_SUCCESS) {
+        psa_key_attributes_t attrs = PSA_KEY_ATTRIBUTES_INIT;
+        psa_set_key_type(&attrs, PSA_KEY_TYPE_AES);
+        psa_set_key_bits(&attrs, 256);
+        psa_set_key_usage_flags(&attrs, PSA_KEY_USAGE_ENCRYPT | PSA_KEY_USAGE_DECRYPT);
+        psa_set_key_algorithm(&attrs, PSA_ALG_GCM);
+        psa_set_key_lifetime(&attrs, PSA_KEY_LIFETIME_VOLATILE);
+        status = psa_key_derivation_output_key(&attrs, &op, &key_id);
+    }
+    psa_key_derivation_abort(&op);
+    if (status != PSA_SUCCESS) {
+        printf("TLS session cache: key derivation failed: %d\n", (int) status);
+        key_id = PSA_KEY_ID_NULL;
+        return false;
+    }
+    return true;
+}
+
+void app_tls_session_deinit(void) {
+    if (key_id != PSA_KEY_ID_NULL) {
+        (void) psa_destroy_key(key_id);
+        key_id = PSA_KEY_ID_NULL;
+    }
+    memset(slot_hash_valid, 0, sizeof(slot_hash_valid));
+}
+
+bool app_tls_session_load(const char* host, uint8_t* buf, size_t size, size_t* len) {
+    size_t host_len = strlen(host);
+    if (key_id == PSA_KEY_ID_NULL || 0 == host_len || host_len >= APP_TLS_SESSION_HOST_MAX) {
+        return false;
+    }
+    int slot = find_slot(host);
+    if (slot < 0) {
+        return false;
+    }
+
+    size_t got = 0;
+    psa_status_t status = psa_its_get(slot_uid((uint32_t) slot), 0, sizeof(entry), &entry, &got);
+    const size_t sealed_len = (size_t) entry.hdr.data_len + ENTRY_TAG_SIZE;
+    if (status == PSA_SUCCESS && got == sizeof(entry_header_t) + host_len + sealed_len && entry.hdr.data_len <= size) {
+        status = psa_aead_decrypt(key_id, PSA_ALG_GCM, entry.hdr.nonce, sizeof(entry.hdr.nonce),
+            (const uint8_t*) &entry, sizeof(entry_header_t) + host_len,
+            entry.buff + host_len, sealed_len, buf, size, len);
+    } else if (status == PSA_SUCCESS) {
+        status = PSA_ERROR_DATA_CORRUPT;
+    }
+    if (status != PSA_SUCCESS) {
+        printf("TLS session cache: Removing the session for %s, it does not open: %d\n", host, (int) status);
+        remove_slot((uint32_t) slot);
+        stats.load_failures++;
+        return false;
+    }
+    slot_hash[slot] = fnv1a(buf, *len);
+    slot_hash_valid[slot] = true;
+    return true;
+}
+
+bool app_tls_session_save(const char* host, const uint8_t* data, size_t len) {
+    size_t host_len = strlen(host);
+    if (key_id == PSA_KEY_ID_NULL || 0 == host_len || host_len >= APP_TLS_SESSION_HOST_MAX
+            || 0 == len || len > APP_TLS_SESSION_DATA_MAX) {
+        return false;
+    }
+
+    // the same host, else a free slot, else the oldest entry
+    entry_header_t hdr;
+    char slot_host[APP_TLS_SESSION_HOST_MAX];
+    int slot = -1;
+    int free_slot = -1;
+    int oldest = 0;
+    uint32_t oldest_seq = UINT32_MAX;
+    uint32_t seq = 0;
+    for (uint32_t i = 0; i < APP_TLS_SESSION_SLOTS; i++) {
+        if (!read_header(i, &hdr, slot_host)) {
+            if (free_slot < 0) {
+                free_slot = (int) i;
+            }
+            continue;
+        }
+        if (0 == strcmp(slot_host, host)) {
+            slot = (int) i;
+        }
+        if (hdr.seq < oldest_seq) {
+            oldest_seq = hdr.seq;
+            oldest = (int) i;
+        }
+        if (hdr.seq >= seq) {
+            seq = hdr.seq + 1;
+        }
+    }
+    const uint32_t hash = fnv1a(data, len);
+    if (slot >= 0 && slot_hash_valid[slot] && slot_hash[slot] == hash) {
+        return true;
+    }
+    if (slot < 0) {
+        slot = (free_slot >= 0) ? free_slot : oldest;
+    }
+
+    memset(&entry.hdr, 0, sizeof(entry.hdr));
+    entry.hdr.magic = ENTRY_MAGIC;
+    entry.hdr.seq = seq;
+    entry.hdr.host_len = (uint16_t) host_len;
+    entry.hdr.data_len = (uint16_t) len;
+    memcpy(entry.buff, host, host_len);
+    size_t sealed_len = 0;
+    psa_status_t status = psa_generate_random(entry.hdr.nonce, sizeof(entry.hdr.nonce));
+    if (status == PSA_SUCCESS) {
+        status = psa_aead_encrypt(key_id, PSA_ALG_GCM, entry.hdr.nonce, sizeof(entry.hdr.nonce),
+            (const uint8_t*) &entry, sizeof(entry_header_t) + host_len,
+            data, len, entry.buff + host_len, sizeof(entry.buff) - host_len, &sealed_len);
+    }
+    if (status == PSA_SUCCESS) {
+        status = psa_its_set(slot_uid((uint32_t) slot), sizeof(entry_header_t) + host_len + sealed_len, &entry,
+            PSA_STORAGE_FLAG_NONE);
+    }
+    if (status != PSA_SUCCESS) {
+        printf("TLS session cache: Failed to store the session for %s: %d\n", host, (int) status);
+        slot_hash_valid[slot] = false;
+        return false;
+    }
+    slot_hash[slot] = hash;
+    slot_hash_valid[slot] = true;
+    stats.saved++;
+    return true;
+}
+
+void app_tls_session_forget(const char* host) {
+    for (uint32_t slot = 0; slot < APP_TLS_SESSION_SLOTS; slot++) {
+        entry_header_t hdr;
+        char slot_host[APP_TLS_SESSION_HOST_MAX];
+        if (NULL == host || (read_header(slot, &hdr, slot_host) && 0 == strcmp(slot_host, host))) {
+            remove_slot(slot);
+        }
+    }
+}
+
+void app_tls_session_on_handshake(uint32_t duration_ms, bool resumed) {
+    stats.last_ms = duration_ms;
+    stats.last_resumed = resumed;
+    if (resumed) {
+        stats.resumed++;
+        stats.resumed_ms_total += duration_ms;
+    } else {
+        stats.full++;
+        stats.full_ms_total += duration_ms;
+    }
+}
+
+void app_tls_session_on_handshake_failed(void) {
+    stats.failed++;
+}
+
+const app_tls_session_stats_t* app_tls_session_get_stats(void) {
+    return &stats;
+}
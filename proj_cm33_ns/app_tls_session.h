@@ -0,0 +1,76 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+#ifndef APP_TLS_SESSION_H_
+#define APP_TLS_SESSION_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Keeps TLS sessions in PSA ITS so that a reconnect, also after a reset, can resume the previous
+// session (session ID or session ticket) instead of doing a full handshake with the ECDSA signature
+// of the HUK-derived client key and the ECDHE key exchange.
+// The session is serialized by the TLS library and kept here as opaque bytes, one entry per server
+// host name. Every entry is sealed with AES-GCM under a key derived from the HUK, with the host name
+// as additional data, so an entry only opens on the device that stored it and for the host it was
+// stored for.
+// The TLS library hooks are in app_tls_session_mbedtls.c.
+
+// Ensure these do not conflict with APP_DEVICE_CONFIG_ITS_UID and APP_PSA_CERT_ITS_UID
+#ifndef APP_TLS_SESSION_ITS_UID
+#define APP_TLS_SESSION_ITS_UID     (9U)
+#endif
+// Entries use the UIDs from APP_TLS_SESSION_ITS_UID up. One for the MQTT broker and one for the
+// /IOTCONNECT discovery and identity HTTPS server
+#ifndef APP_TLS_SESSION_SLOTS
+#define APP_TLS_SESSION_SLOTS       2
+#endif
+// Largest ITS entry, ITS_MAX_ASSET_SIZE of TF-M. proj_cm33_s/ifx_tfm_config.h keeps the default
+#ifndef APP_TLS_SESSION_ITS_ASSET_MAX
+#define APP_TLS_SESSION_ITS_ASSET_MAX   512
+#endif
+#define APP_TLS_SESSION_HOST_MAX    64
+// Largest serialized session that is kept: what is left of an entry after the 24 byte header, the
+// longest host name and the 16 byte GCM tag. A session without the peer certificate takes about 150
+// bytes and the ticket of the server on top of that. A larger session is not kept and the next
+// handshake is a full one
+#define APP_TLS_SESSION_DATA_MAX    (APP_TLS_SESSION_ITS_ASSET_MAX - 24 - APP_TLS_SESSION_HOST_MAX - 16)
+
+typedef struct {
+    uint32_t full;              // handshakes that did not resume a session
+    uint32_t resumed;
+    uint32_t failed;
+    uint32_t last_ms;           // duration of the last handshake that completed
+    bool last_resumed;
+    uint64_t full_ms_total;
+    uint64_t resumed_ms_total;
+    uint32_t saved;             // sessions written to ITS
+    uint32_t load_failures;     // entries that did not open and were removed
+} app_tls_session_stats_t;
+
+// Derives the sealing key from the HUK. Call after psa_crypto_init(). Without it, or if it fails,
+// nothing is loaded or saved and every handshake is a full one
+bool app_tls_session_init(void);
+
+// Releases the sealing key. The entries stay in ITS
+void app_tls_session_deinit(void);
+
+// Copies the session stored for host into buf. Returns false if there is none or if it does not open,
+// in which case it is removed
+bool app_tls_session_load(const char* host, uint8_t* buf, size_t size, size_t* len);
+
+// Stores the session for host, in place of the one stored for it before or of the oldest entry.
+// A session identical to the one last loaded or saved for the host is not written again
+bool app_tls_session_save(const char* host, const uint8_t* data, size_t len);
+
+// Removes the session stored for host, or all sessions if host is NULL
+void app_tls_session_forget(const char* host);
+
+// Handshake instrumentation, filled in by the TLS library hooks
+void app_tls_session_on_handshake(uint32_t duration_ms, bool resumed);
+void app_tls_session_on_handshake_failed(void);
+const app_tls_session_stats_t* app_tls_session_get_stats(void);
+
+#endif // APP_TLS_SESSION_H_
@@ -0,0 +1,111 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+// TLS session resumption for the connections that the SDK makes through secure sockets.
+// The TLS context is created and driven inside the secure sockets library, so the hook is
+// mbedtls_ssl_handshake() itself, wrapped at link time (-Wl,--wrap=mbedtls_ssl_handshake in the Makefile).
+// Before the first handshake step of a client context, the session stored for its host name is set on
+// the context. When the handshake completes, the session is stored again, which keeps a renewed
+// ticket, and the duration is recorded. The handshake resumed the session if it ended up with the
+// master secret of the stored session.
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "mbedtls/ssl.h"
+#include "mbedtls/platform_util.h"
+#include "mbedtls/version.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "app_tls_session.h"
+
+typedef struct {
+    const mbedtls_ssl_context* ssl;     // NULL if no handshake is in progress
+    TickType_t start;
+    bool offered;                       // a stored session was set on the context
+    unsigned char master[48];
+} handshake_t;
+
+int __real_mbedtls_ssl_handshake(mbedtls_ssl_context* ssl);
+
+// Handshakes do not run concurrently. One that starts while another is in progress takes its place
+static handshake_t handshake;
+static uint8_t session_buf[APP_TLS_SESSION_DATA_MAX];
+
+static const char* get_hostname(mbedtls_ssl_context* ssl) {
+#if MBEDTLS_VERSION_NUMBER >= 0x03050000
+    return mbedtls_ssl_get_hostname(ssl);
+#else
+    return ssl->MBEDTLS_PRIVATE(hostname);
+#endif
+}
+
+static void start_handshake(mbedtls_ssl_context* ssl, const char* host) {
+    memset(&handshake, 0, sizeof(handshake));
+    handshake.ssl = ssl;
+    handshake.start = xTaskGetTickCount();
+
+    size_t len = 0;
+    if (!app_tls_session_load(host, session_buf, sizeof(session_buf), &len)) {
+        return;
+    }
+    mbedtls_ssl_session session;
+    mbedtls_ssl_session_init(&session);
+    // a session saved by another mbedtls version or configuration does not load
+    if (0 == mbedtls_ssl_session_load(&session, session_buf, len) && 0 == mbedtls_ssl_set_session(ssl, &session)) {
+        memcpy(handshake.master, session.MBEDTLS_PRIVATE(master), sizeof(handshake.master));
+        handshake.offered = true;
+    } else {
+        app_tls_session_forget(host);
+    }
+    mbedtls_ssl_session_free(&session);
+    mbedtls_platform_zeroize(session_buf, sizeof(session_buf));
+}
+
+static void finish_handshake(mbedtls_ssl_context* ssl, const char* host, int ret) {
+    if (ret != 0) {
+        app_tls_session_on_handshake_failed();
+        // the stored session may be what the server did not like
+        if (handshake.offered) {
+            app_tls_session_forget(host);
+        }
+    } else {
+        uint32_t duration_ms = (uint32_t) ((xTaskGetTickCount() - handshake.start) * portTICK_PERIOD_MS);
+        bool resumed = false;
+        mbedtls_ssl_session session;
+        mbedtls_ssl_session_init(&session);
+        if (0 == mbedtls_ssl_get_session(ssl, &session)) {
+            resumed = handshake.offered
+                && 0 == memcmp(handshake.master, session.MBEDTLS_PRIVATE(master), sizeof(handshake.master));
+            size_t len = 0;
+            if (0 == mbedtls_ssl_session_save(&session, session_buf, sizeof(session_buf), &len)) {
+                (void) app_tls_session_save(host, session_buf, len);
+            }
+        }
+        mbedtls_ssl_session_free(&session);
+        mbedtls_platform_zeroize(session_buf, sizeof(session_buf));
+        app_tls_session_on_handshake(duration_ms, resumed);
+    }
+    mbedtls_platform_zeroize(&handshake, sizeof(handshake));
+}
+
+int __wrap_mbedtls_ssl_handshake(mbedtls_ssl_context* ssl) {
+    const mbedtls_ssl_config* conf = ssl->MBEDTLS_PRIVATE(conf);
+    const char* host = get_hostname(ssl);
+    if (NULL != conf && MBEDTLS_SSL_IS_CLIENT == conf->MBEDTLS_PRIVATE(endpoint) && NULL != host
+            && MBEDTLS_SSL_HELLO_REQUEST == ssl->MBEDTLS_PRIVATE(state)) {
+        start_handshake(ssl, host);
+    }
+
+    int ret = __real_mbedtls_ssl_handshake(ssl);
+    if (handshake.ssl != ssl || MBEDTLS_ERR_SSL_WANT_READ == ret || MBEDTLS_ERR_SSL_WANT_WRITE == ret
+            || MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS == ret || MBEDTLS_ERR_SSL_CRYPTO_IN_PROGRESS == ret) {
+        return ret;
+    }
+    finish_handshake(ssl, host, ret);
+    return ret;
+}
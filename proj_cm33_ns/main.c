@@ -58,7 +58,7 @@
 #include "os_wrapper/common.h"
 
 #include "app_its_config.h"
-#include "app_psa_mqtt.h"
+#include "app_boot.h"
 #include "app_configurator_task.h"
 
 /******************************************************************************
@@ -241,8 +241,9 @@ int main(void)
     printf("PSOC Edge MCU: /IOTCONNECT Client\n");
     printf("===============================================================\n");
 
-    // do this before app_its_config_init to ensure cert is ready for printing
-    app_psa_mqtt_setup_huk();
+    // The HUK key and the certificate are set up by the first boot stage of app_task,
+    // while Wi-Fi connects and CM55 starts
+    app_boot_init();
 
     printf("CM33 /IOTCONNECT App Task Starting. Waiting for CM55 IPC to start...\n");
 
@@ -100,6 +100,14 @@
 #undef MBEDTLS_SSL_OUT_CONTENT_LEN
 #define MBEDTLS_SSL_OUT_CONTENT_LEN 4096
 
+// TLS session resumption (app_tls_session.c): reconnects resume the stored session with a session
+// ticket, or a session ID if the server does not issue tickets, and skip the asymmetric operations.
+// Without the peer certificate a session only keeps its digest, which keeps it small enough to store
+#define MBEDTLS_SSL_SESSION_TICKETS
+#ifndef MBEDTLS_SSL_PROTO_TLS1_3
+#undef MBEDTLS_SSL_KEEP_PEER_CERTIFICATE
+#endif
+
 // We may want more prints
 // #define MBEDTLS_DEBUG_C
 // #undef MBEDTLS_VERBOSE
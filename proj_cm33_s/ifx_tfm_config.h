@@ -24,7 +24,9 @@
 
 /*
  * ITS (Internal Trusted Storage) configuration
- * Uncomment and adjust if you need more storage assets or larger asset sizes
+ * Uncomment and adjust if you need more storage assets or larger asset sizes.
+ * APP_TLS_SESSION_ITS_ASSET_MAX in proj_cm33_ns/app_tls_session.h sizes the TLS session entries to
+ * ITS_MAX_ASSET_SIZE and has to follow it
  */
 /* #define ITS_MAX_ASSET_SIZE       512 */
 /* #define ITS_NUM_ASSETS           10 */
@@ -43,6 +43,7 @@
 #include "cy_pdl.h"
 #include "cybsp.h"
 #include "audio.h"
+#include "audio_frontend.h"
 #include "cy_syslib.h"
 #include <time.h>
 
@@ -99,8 +100,38 @@
  * PCM word length, see the A/D specific documentation for valid ranges. */
  #define AUIDO_BITS_PER_SAMPLE                  16
 
-/* Converts given audio sample into range [-1,1] */
-#define SAMPLE_NORMALIZE(sample)                (((float) (sample)) / (float) (1 << (AUIDO_BITS_PER_SAMPLE - 1)))
+/* Number of samples passed to IMAI_AED_enqueue() between two IMAI_AED_dequeue()
+ * checks. The audio libraries buffer exactly one input window of 512 samples,
+ * IMAI_AED_enqueue() drops samples while it is full and IMAI_AED_dequeue()
+ * advances by one model hop: 160 samples for the cough and baby cry models,
+ * 512 for the alarm model. A check has to fall on every sample count at which
+ * the buffer fills, so the hop must divide both the window and the model hop,
+ * and FRAME_SIZE. 1 checks after every sample as the library documentation
+ * requires. */
+#ifndef AUDIO_DEQUEUE_HOP
+#if defined(ALARM_MODEL)
+#define AUDIO_DEQUEUE_HOP                       (512u)
+#else
+#define AUDIO_DEQUEUE_HOP                       (32u)
+#endif
+#endif
+
+#if (FRAME_SIZE % AUDIO_DEQUEUE_HOP) != 0
+#error "AUDIO_DEQUEUE_HOP must divide FRAME_SIZE"
+#endif
+
+/* Frames between two reports of samples refused by IMAI_AED_enqueue(),
+ * about 10 s. The first drop is reported right away. */
+#define AUDIO_DROP_REPORT_FRAMES                (160u)
+
+/* Model reported to CM33 */
+#if defined(ALARM_MODEL)
+#define AUDIO_IPC_MODEL_ID                      IPC_MODEL_ALARM
+#elif defined(BABYCRY_MODEL)
+#define AUDIO_IPC_MODEL_ID                      IPC_MODEL_BABYCRY
+#else
+#define AUDIO_IPC_MODEL_ID                      IPC_MODEL_COUGH
+#endif
 
 /* PDM PCM interrupt configuration parameters */
 const cy_stc_sysint_t PDM_IRQ_cfg =
@@ -130,6 +161,9 @@ int16_t audio_buffer1[FRAME_SIZE] = {0};
 int16_t* active_rx_buffer;
 int16_t* full_rx_buffer;
 
+/* Model input of the buffer being processed */
+static float audio_block[FRAME_SIZE];
+
 /* Model Output variable */
 int data_out[IMAI_DATA_OUT_COUNT] = {0};
 static const char* LABELS[IMAI_DATA_OUT_COUNT] = IMAI_DATA_OUT_SYMBOLS;
@@ -137,6 +171,13 @@ static const char* LABELS[IMAI_DATA_OUT_COUNT] = IMAI_DATA_OUT_SYMBOLS;
 /* Task handler */
 static TaskHandle_t audio_task_handler;
 
+/* Cleared by a control request from CM33 to pause inference */
+static bool model_enabled = true;
+
+/* Samples refused by IMAI_AED_enqueue() since boot, non-zero when
+ * AUDIO_DEQUEUE_HOP does not suit the model */
+static uint32_t audio_samples_dropped = 0;
+
 /*******************************************************************************
 * Function Name: systick_isr1
 ********************************************************************************
@@ -177,6 +218,61 @@ void get_time_from_millisec_audio(unsigned long milliseconds, char* timeString)
 }
 
 
+/*******************************************************************************
+* Function Name: audio_handle_control_request
+********************************************************************************
+* Summary:
+*  Applies a pending control request from CM33, if any. Called between frames,
+*  so the model is never reconfigured in the middle of a window.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void audio_handle_control_request(void)
+{
+    ipc_control_request_t request;
+    ipc_control_status_e status = IPC_CONTROL_STATUS_OK;
+
+    if (!cm55_ipc_get_control_request(&request))
+    {
+        return;
+    }
+
+    switch (request.command)
+    {
+        case IPC_CONTROL_SET_SENSITIVITY:
+        {
+            PP_config_t config = {
+                .confidence = request.confidence,
+                .average = request.average,
+                .subsequent = request.subsequent,
+                .pool = request.pool,
+                .pool_selection = request.pool_selection
+            };
+            if (IMAI_RET_SUCCESS != IMAI_AED_sensitivity(config))
+            {
+                status = IPC_CONTROL_STATUS_INVALID;
+            }
+            break;
+        }
+        case IPC_CONTROL_RESET_SENSITIVITY:
+            IMAI_AED_sensitivity_reset();
+            break;
+        case IPC_CONTROL_ENABLE_MODEL:
+            model_enabled = (0 != request.enabled);
+            break;
+        default:
+            status = IPC_CONTROL_STATUS_UNSUPPORTED;
+            break;
+    }
+    cm55_ipc_complete_control_request(status);
+}
+
+
 /*******************************************************************************
 * Function Name: audio_init
 ********************************************************************************
@@ -275,9 +371,12 @@ void audio_task(void *pvParameters)
     int label_scores[IMAI_DATA_OUT_COUNT];
     static int prediction_count = 0;
     static int16_t success_flag = 0;
+    uint32_t drop_reported = 0;
+    uint32_t frames_since_report = AUDIO_DROP_REPORT_FRAMES;
     
     /* Initialize DEEPCRAFT pre-processing library */
     IMAI_AED_init();
+    cm55_ipc_set_labels(AUDIO_IPC_MODEL_ID, LABELS, IMAI_DATA_OUT_COUNT);
     
     result = audio_init();
     if(result != 0)
@@ -291,38 +390,40 @@ void audio_task(void *pvParameters)
     {
         /* Wait here until ISR notifies us */
         ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
-        
-        for (uint32_t index = 0; index < FRAME_SIZE; index++)
-        {
+        uint32_t capture_ms = (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
 
-            int16_t val_temp = full_rx_buffer[index];
+        audio_handle_control_request();
+        if (!model_enabled)
+        {
+            continue;
+        }
 
-            /*convert int to float*/
-            float data_in = SAMPLE_NORMALIZE(val_temp) * DIGITAL_BOOST_FACTOR;
+        /* Convert the whole buffer at once, before the ISR fills it again */
+        audio_pcm_to_float(full_rx_buffer, audio_block, FRAME_SIZE, DIGITAL_BOOST_FACTOR);
 
-            if (data_in > 1.0)
-            {
-                data_in = 1.0f;
-            }
-            else if (data_in < -1.0)
+        for (uint32_t index = 0; index < FRAME_SIZE; index += AUDIO_DEQUEUE_HOP)
+        {
+            /*pass audio samples for enqueue*/
+            for (uint32_t hop = 0; hop < AUDIO_DEQUEUE_HOP; hop++)
             {
-               data_in = -1.0f;
+                if (IMAI_RET_SUCCESS != IMAI_AED_enqueue(&audio_block[index + hop]))
+                {
+                    audio_samples_dropped++;
+                }
             }
 
-            /*pass audio sample for enqueue*/
-            result = IMAI_AED_enqueue(&data_in);
-
             switch(IMAI_AED_dequeue(label_scores))
             {
                 case IMAI_RET_SUCCESS:
-                    ipc_payload_t* payload = cm55_ipc_get_payload_ptr();
+                    ipc_payload_t payload = {0};
+                    payload.timestamp_ms = capture_ms;
+                    ipc_payload_set_scores(&payload, label_scores, IMAI_DATA_OUT_COUNT);
 
                     success_flag = 1;
                     prediction_count += 1;
                     if (label_scores[1] == 1)
                     {
-                        payload->label_id = 1;
-                        strcpy(payload->label, LABELS[1]);
+                        payload.label_id = 1;
 
                         /* New line when LED from off to on */
                         if ((led_off - CYBSP_LED_STATE_ON) > 0)
@@ -342,8 +443,7 @@ void audio_task(void *pvParameters)
                     }
                     else
                     {
-                        payload->label_id = 0;
-                        strcpy(payload->label, LABELS[0]);
+                        payload.label_id = 0;
 
                         /* Only print non-label class very 10 predictions */
                         if (prediction_count>DETECTCOUNT)
@@ -361,7 +461,7 @@ void audio_task(void *pvParameters)
                         led_off = 1;
                     }
 
-                    cm55_ipc_send_to_cm33();
+                    (void) cm55_ipc_send_to_cm33(&payload);
                     
                     break;
                     
@@ -379,6 +479,20 @@ void audio_task(void *pvParameters)
 
             }
         }
+
+        /* Report dropped samples, at most every AUDIO_DROP_REPORT_FRAMES frames */
+        if (frames_since_report < AUDIO_DROP_REPORT_FRAMES)
+        {
+            frames_since_report++;
+        }
+        if ((audio_samples_dropped != drop_reported) &&
+            (frames_since_report >= AUDIO_DROP_REPORT_FRAMES))
+        {
+            printf("Audio: %lu samples dropped by the model, check AUDIO_DEQUEUE_HOP\r\n",
+                   (unsigned long) audio_samples_dropped);
+            drop_reported = audio_samples_dropped;
+            frames_since_report = 0;
+        }
     }
 }
 
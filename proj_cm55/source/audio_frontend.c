@@ -0,0 +1,126 @@
+/******************************************************************************
+* File Name:   audio_frontend.c
+*
+* Description: This file converts blocks of PDM/PCM samples into the float
+*   input of the DEEPCRAFT audio models in one vectorized pass.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* (c) 2025, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+* 
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+#include "audio_frontend.h"
+
+#if defined(ARM_MATH_HELIUM)
+#include <arm_mve.h>
+#endif
+
+/* 16-bit PCM full scale */
+#define AUDIO_PCM_FULL_SCALE    (32768.0f)
+
+/*******************************************************************************
+* Function Name: audio_pcm_to_float_ref
+********************************************************************************
+* Summary:
+* Scalar reference of `audio_pcm_to_float()`.
+*
+* Parameters:
+*  pcm         : PCM samples.
+*  out         : Output samples in [-1,1].
+*  num_samples : Number of samples.
+*  gain        : Digital boost factor.
+*
+*******************************************************************************/
+void audio_pcm_to_float_ref(const int16_t *pcm, float *out, uint32_t num_samples, float gain)
+{
+    for (uint32_t i = 0; i < num_samples; i++)
+    {
+        float x = ((float)pcm[i] / AUDIO_PCM_FULL_SCALE) * gain;
+
+        if (x > 1.0f)
+        {
+            x = 1.0f;
+        }
+        else if (x < -1.0f)
+        {
+            x = -1.0f;
+        }
+        out[i] = x;
+    }
+}
+
+#if defined(ARM_MATH_HELIUM)
+/* Helium version of `audio_pcm_to_float_ref()`, four samples per vector.
+*  The halfword loads sign extend into 32-bit lanes. The scale is folded
+*  into a single multiply, so with a gain that is not a power of two the
+*  result can differ from the reference in the last bit. */
+static void _audio_pcm_to_float_mve(const int16_t *pcm, float *out, uint32_t num_samples, float gain)
+{
+    const float scale = gain / AUDIO_PCM_FULL_SCALE;
+    const float32x4_t lo = vdupq_n_f32(-1.0f);
+    const float32x4_t hi = vdupq_n_f32(1.0f);
+    uint32_t i = 0;
+
+    for (; i + 4 <= num_samples; i += 4)
+    {
+        float32x4_t x = vmulq_n_f32(vcvtq_f32_s32(vldrhq_s32(pcm + i)), scale);
+        vst1q_f32(out + i, vminnmq_f32(vmaxnmq_f32(x, lo), hi));
+    }
+    if (i < num_samples)
+    {
+        audio_pcm_to_float_ref(pcm + i, out + i, num_samples - i, gain);
+    }
+}
+#endif
+
+/*******************************************************************************
+* Function Name: audio_pcm_to_float
+********************************************************************************
+* Summary:
+* Converts a block of PCM samples into model input in one pass: int16 to
+* float, normalization to [-1,1), digital boost and clamping to [-1,1].
+* Uses Helium when available, `audio_pcm_to_float_ref()` otherwise.
+*
+* Parameters:
+*  pcm         : PCM samples.
+*  out         : Output samples in [-1,1].
+*  num_samples : Number of samples.
+*  gain        : Digital boost factor.
+*
+*******************************************************************************/
+void audio_pcm_to_float(const int16_t *pcm, float *out, uint32_t num_samples, float gain)
+{
+#if defined(ARM_MATH_HELIUM)
+    _audio_pcm_to_float_mve(pcm, out, num_samples, gain);
+#else
+    audio_pcm_to_float_ref(pcm, out, num_samples, gain);
+#endif
+}
@@ -0,0 +1,53 @@
+/******************************************************************************
+* File Name:   audio_frontend.h
+*
+* Description: This file contains the function prototypes of the block based
+*   audio front end in audio_frontend.c.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* (c) 2025, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+* 
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+
+#ifndef AUDIO_FRONTEND_H_
+#define AUDIO_FRONTEND_H_
+
+#include <stdint.h>
+
+/* Converts PCM samples into the [-1,1] float range expected by the DEEPCRAFT
+ * models: normalizes by the 16-bit full scale, multiplies by gain and clamps.
+ * Uses Helium when available. */
+void audio_pcm_to_float(const int16_t *pcm, float *out, uint32_t num_samples, float gain);
+
+/* Scalar reference of audio_pcm_to_float(), the per-sample conversion audio_task used to do */
+void audio_pcm_to_float_ref(const int16_t *pcm, float *out, uint32_t num_samples, float gain);
+
+#endif /* AUDIO_FRONTEND_H_ */
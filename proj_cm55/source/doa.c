@@ -63,6 +63,9 @@ volatile long tick1 = 0;
 /* DOA task handle */
 static TaskHandle_t doa_task_handle;
 
+/* Cleared by a control request from CM33 to pause inference */
+static bool model_enabled = true;
+
 
 /******************************************************************************
  * Macros
@@ -141,6 +144,60 @@ static void doa_init(void)
 }
 
 
+/*******************************************************************************
+ * Function Name: doa_handle_control_request
+ ********************************************************************************
+ * Summary:
+ *  Applies a pending control request from CM33, if any. Called between samples.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  None
+ *
+ *******************************************************************************/
+static void doa_handle_control_request(void)
+{
+    ipc_control_request_t request;
+    ipc_control_status_e status = IPC_CONTROL_STATUS_OK;
+
+    if (!cm55_ipc_get_control_request(&request))
+    {
+        return;
+    }
+
+    switch (request.command)
+    {
+        case IPC_CONTROL_SET_SENSITIVITY:
+        {
+            PP_config_t config = {
+                .confidence = request.confidence,
+                .average = request.average,
+                .subsequent = request.subsequent,
+                .pool = request.pool,
+                .pool_selection = request.pool_selection
+            };
+            if (IMAI_RET_SUCCESS != IMAI_DOA_sensitivity(config))
+            {
+                status = IPC_CONTROL_STATUS_INVALID;
+            }
+            break;
+        }
+        case IPC_CONTROL_RESET_SENSITIVITY:
+            IMAI_DOA_sensitivity_reset();
+            break;
+        case IPC_CONTROL_ENABLE_MODEL:
+            model_enabled = (0 != request.enabled);
+            break;
+        default:
+            status = IPC_CONTROL_STATUS_UNSUPPORTED;
+            break;
+    }
+    cm55_ipc_complete_control_request(status);
+}
+
+
 /*******************************************************************************
  * Function Name: doa_task
  ********************************************************************************
@@ -169,6 +226,7 @@ static void doa_task(void* pvParameters)
 
     unsigned long start_t = tick1;
     const char* class_map[] = IMAI_DATAOUT_SYMBOLS;
+    cm55_ipc_set_labels(IPC_MODEL_DIRECTION_OF_ARRIVAL, class_map, IMAI_DATAOUT_COUNT);
 
     for (;;)
     {
@@ -178,6 +236,12 @@ static void doa_task(void* pvParameters)
         
         for (int i = 0; i < num_rows; i++)
         {
+            doa_handle_control_request();
+            if (!model_enabled)
+            {
+                break;
+            }
+
             float data_in[4];
             for (int j = 0; j < row_size; j++)
             {
@@ -189,7 +253,9 @@ static void doa_task(void* pvParameters)
             {
                 static uint8_t success_flag;
                 case IMAI_RET_SUCCESS:
-                    ipc_payload_t* payload = cm55_ipc_get_payload_ptr();
+                    ipc_payload_t payload = {0};
+                    payload.timestamp_ms = (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+                    ipc_payload_set_scores(&payload, label_scores, IMAI_DATAOUT_COUNT);
 
                     success_flag = 1;
                     prediction_count += 1;
@@ -202,9 +268,8 @@ static void doa_task(void* pvParameters)
                         }
                     }
                     
-                    payload->label_id = pred_idx;
-                    strcpy(payload->label, class_map[pred_idx]);
-                    cm55_ipc_send_to_cm33();
+                    payload.label_id = pred_idx;
+                    (void) cm55_ipc_send_to_cm33(&payload);
 
                     if (pred_idx != 0)
                     {
@@ -254,6 +319,12 @@ static void doa_task(void* pvParameters)
 
             }
         }
+
+        if (!model_enabled)
+        {
+            /* Keep answering control requests while paused */
+            vTaskDelay(pdMS_TO_TICKS(DELAY_MS));
+        }
     }
 
 }
@@ -92,6 +92,9 @@ static mtb_bmi270_t bmi270;
 
 static const char* LABELS[IMAI_DATA_OUT_COUNT] = IMAI_SYMBOL_MAP;
 
+/* Cleared by a control request from CM33 to pause inference */
+static bool model_enabled = true;
+
 static cy_stc_sysint_t timer_irq_cfg =
 {
     .intrSrc = CYBSP_GENERAL_PURPOSE_TIMER_IRQ,
@@ -245,6 +248,43 @@ static cy_rslt_t motion_sensor_init(void)
     return result;
 }
 
+/*******************************************************************************
+ * Function Name: imu_handle_control_request
+ ********************************************************************************
+ * Summary:
+ *  Applies a pending control request from CM33, if any. Called between
+ *  samples.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  None
+ *
+ *******************************************************************************/
+static void imu_handle_control_request(void)
+{
+    ipc_control_request_t request;
+    ipc_control_status_e status = IPC_CONTROL_STATUS_OK;
+
+    if (!cm55_ipc_get_control_request(&request))
+    {
+        return;
+    }
+
+    switch (request.command)
+    {
+        case IPC_CONTROL_ENABLE_MODEL:
+            model_enabled = (0 != request.enabled);
+            break;
+        default:
+            /* The fall detection library has no sensitivity setting */
+            status = IPC_CONTROL_STATUS_UNSUPPORTED;
+            break;
+    }
+    cm55_ipc_complete_control_request(status);
+}
+
 /*******************************************************************************
  * Function Name: task_motion
  ********************************************************************************
@@ -271,6 +311,7 @@ static void task_motion(void* pvParameters)
 
     /* Initialize DEEPCRAFT pre-processing library */
     IMAI_FED_init();
+    cm55_ipc_set_labels(IPC_MODEL_FALL_DETECTION, LABELS, IMAI_DATA_OUT_COUNT);
 
     /* Initialize BMI270 motion sensor and suspend the task upon failure */
     result = motion_sensor_init();
@@ -289,9 +330,17 @@ static void task_motion(void* pvParameters)
         }
         
         IMU_FLAG = 0;
+
+        imu_handle_control_request();
+        if (!model_enabled)
+        {
+            continue;
+        }
+
         /* Get IMU data */        
         /* Read x, y, z components of acceleration */
         result =  mtb_bmi270_read(&bmi270, &bmi270_data);
+        uint32_t capture_ms = (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
         if (CY_RSLT_SUCCESS != result)
         {
              CY_ASSERT(0);
@@ -313,14 +362,15 @@ static void task_motion(void* pvParameters)
             switch(IMAI_FED_dequeue(label_scores))
             {
                 case IMAI_RET_SUCCESS:
-                    ipc_payload_t* payload = cm55_ipc_get_payload_ptr();
+                    ipc_payload_t payload = {0};
+                    payload.timestamp_ms = capture_ms;
+                    ipc_payload_set_scores(&payload, label_scores, IMAI_DATA_OUT_COUNT);
 
                     static int16_t success_flag = 1;
                     prediction_count += 1;
                     if (label_scores[1] == 1)
                     {
-                        payload->label_id = 1;
-                        strcpy(payload->label, LABELS[1]);
+                        payload.label_id = 1;
 
                         /* New line when LED from off to on */
                         if ((led_off - CYBSP_LED_STATE_ON) > 0)
@@ -341,8 +391,7 @@ static void task_motion(void* pvParameters)
                     }
                     else
                     {
-                        payload->label_id = 0;
-                        strcpy(payload->label, LABELS[0]);
+                        payload.label_id = 0;
 
                         /* Only print non-label class very 10 predictions */
                         if (prediction_count>DETECTCOUNT)
@@ -363,7 +412,7 @@ static void task_motion(void* pvParameters)
                         led_off = 1;
                     }
 
-                    cm55_ipc_send_to_cm33();
+                    (void) cm55_ipc_send_to_cm33(&payload);
                     
                     break;
 
@@ -70,14 +70,23 @@
 // This can be used for troubleshooting IPC issues
 void test_task(void * arg) {
     (void) arg;
+    static const char* const test_labels[] = {"none", "test"};
+    cm55_ipc_set_labels(IPC_MODEL_NONE, test_labels, 2);
     while(true) {
         // This works:
-        ipc_payload_t* payload = cm55_ipc_get_payload_ptr();
-        payload->label_id = 1;
-        strcpy(payload->label, "test");
+        ipc_payload_t payload = {0};
+        payload.label_id = 1;
+        payload.timestamp_ms = (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
         printf("Hello from CM55 test\n");
-        vTaskDelay(pdMS_TO_TICKS(5000));
-        cm55_ipc_send_to_cm33();
+        // Keep answering control requests while waiting. There is no model to configure
+        for (int i = 0; i < 50; i++) {
+            ipc_control_request_t request;
+            if (cm55_ipc_get_control_request(&request)) {
+                cm55_ipc_complete_control_request(IPC_CONTROL_STATUS_UNSUPPORTED);
+            }
+            vTaskDelay(pdMS_TO_TICKS(100));
+        }
+        (void) cm55_ipc_send_to_cm33(&payload);
     }
 }
 
@@ -67,6 +67,9 @@ static TaskHandle_t motion_sensor_task_handle;
 static mtb_bmi270_t bmi270;
 static mtb_bmi270_data_t bmi270_data;
 
+/* Cleared by a control request from CM33 to pause orientation updates */
+static bool model_enabled = true;
+
 /******************************************************************************
  * Macros
  ******************************************************************************/
@@ -157,7 +160,8 @@ static cy_rslt_t motion_sensor_init(void)
  *******************************************************************************/
 static cy_rslt_t motion_sensor_update_orientation(void)
 {
-    ipc_payload_t* payload = cm55_ipc_get_payload_ptr();
+    ipc_payload_t payload = {0};
+    payload.timestamp_ms = (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
     /* Status variable */
     cy_rslt_t result = CY_RSLT_SUCCESS;
     int16_t abs_x;
@@ -180,15 +184,13 @@ static cy_rslt_t motion_sensor_update_orientation(void)
         {
             /* Kit faces down (towards the ground) */
             printf("Orientation = ORIENTATION_DOWN\r\n");
-            payload->label_id = 1;
-            strcpy(payload->label, "down");
+            payload.label_id = 1;
         }
         else
         {
             /* Kit faces up (towards the sky/ceiling) */
             printf("Orientation = ORIENTATION_UP\r\n");
-            payload->label_id = 0;
-            strcpy(payload->label, "up");
+            payload.label_id = 0;
         }
     }
     /* Y axis (parallel with shorter edge of board) is most aligned with
@@ -200,16 +202,14 @@ static cy_rslt_t motion_sensor_update_orientation(void)
         {
             /* Kit has an inverted landscape orientation */
             printf("Orientation = ORIENTATION_BOTTOM_EDGE\r\n");
-            payload->label_id = 3;
-            strcpy(payload->label, "bottom");
+            payload.label_id = 3;
             
         }
         else
         {
             /* Kit has landscape orientation */
             printf("Orientation = ORIENTATION_TOP_EDGE\r\n");
-            payload->label_id = 2;
-            strcpy(payload->label, "top");
+            payload.label_id = 2;
         }
     }
     /* X axis (parallel with longer edge of board) is most aligned with
@@ -221,21 +221,56 @@ static cy_rslt_t motion_sensor_update_orientation(void)
         {
             /* Kit has an inverted portrait orientation */
             printf("Orientation = ORIENTATION_RIGHT_EDGE\r\n");
-            payload->label_id = 5;
-            strcpy(payload->label, "right_edge");
+            payload.label_id = 5;
         }
         else
         {
             /* Kit has portrait orientation */
             printf("Orientation = ORIENTATION_LEFT_EDGE\r\n");
-            payload->label_id = 4;
-            strcpy(payload->label, "left_edge");
+            payload.label_id = 4;
         }
     }
-    cm55_ipc_send_to_cm33();
+    (void) cm55_ipc_send_to_cm33(&payload);
     return result;
 }
 
+/*******************************************************************************
+ * Function Name: motion_handle_control_request
+ ********************************************************************************
+ * Summary:
+ *  Applies a pending control request from CM33, if any. Called between
+ *  updates.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  None
+ *
+ *******************************************************************************/
+static void motion_handle_control_request(void)
+{
+    ipc_control_request_t request;
+    ipc_control_status_e status = IPC_CONTROL_STATUS_OK;
+
+    if (!cm55_ipc_get_control_request(&request))
+    {
+        return;
+    }
+
+    switch (request.command)
+    {
+        case IPC_CONTROL_ENABLE_MODEL:
+            model_enabled = (0 != request.enabled);
+            break;
+        default:
+            /* Orientation detection has no sensitivity or range setting */
+            status = IPC_CONTROL_STATUS_UNSUPPORTED;
+            break;
+    }
+    cm55_ipc_complete_control_request(status);
+}
+
 /*******************************************************************************
  * Function Name: task_motion
  ********************************************************************************
@@ -274,12 +309,22 @@ static void task_motion(void* pvParameters)
     }
     printf("BMI270 Motion Sensor successfully initialized.\r\n");
 
+    /* Label of each orientation, indexed by the label id */
+    static const char* const orientation_labels[] = {"up", "down", "top", "bottom", "left_edge", "right_edge"};
+    cm55_ipc_set_labels(IPC_MODEL_MOTION_ORIENTATION, orientation_labels,
+                        sizeof(orientation_labels) / sizeof(orientation_labels[0]));
+
     printf("Change the orientation of the kit to observe different orientation values.\r\n\n");
 
     for(;;)
     {
+        motion_handle_control_request();
+
         /* Get current orientation */
-        motion_sensor_update_orientation();
+        if (model_enabled)
+        {
+            motion_sensor_update_orientation();
+        }
         vTaskDelay( DELAY_MS/portTICK_PERIOD_MS );
     }
 }
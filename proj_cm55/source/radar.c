@@ -52,6 +52,9 @@
 #include "timers.h"
 #endif
 
+#include "radar.h"
+#include "radar_fifo_reader.h"
+
 #include "resource_map.h"
 
 #include "xensiv_bgt60trxx_mtb.h"
@@ -106,15 +109,45 @@
 /* Interrupt priorities */
 #define GPIO_INTERRUPT_PRIORITY             (6)
 
+/* Number of raw frame slots between acquisition and processing. While the
+ * processing task works on one frame, the radar task can fill the others. */
+#define RADAR_FRAME_SLOTS                   (3U)
+
+/* The FIFO is drained in chunks: the sensor interrupts every time it holds
+ * another RADAR_FIFO_CHUNK_SAMPLES samples. Must divide NUM_SAMPLES_PER_FRAME. */
+#define RADAR_FIFO_CHUNKS_PER_FRAME         (4U)
+#define RADAR_FIFO_CHUNK_SAMPLES            (NUM_SAMPLES_PER_FRAME / RADAR_FIFO_CHUNKS_PER_FRAME)
+
+/* Print the pipeline counters every N acquired frames (0 to disable) */
+#ifndef RADAR_PIPELINE_STATS_PRINT_PERIOD
+#define RADAR_PIPELINE_STATS_PRINT_PERIOD   (0U)
+#endif
+
 #define GESTURE_HOLD_TIME                   (10) /* count value used to hold gesture before evaluating new one */
 #define GESTURE_DETECTION_THRESHOLD         (0)
 
 
+/*****************************************************************************
+ * Types
+ *****************************************************************************/
+/* Raw FIFO frame handed from the radar task to the processing task. A slot is
+ * owned by whoever last took its index out of a queue: the radar task while
+ * filling it, the processing task while deinterleaving it. */
+typedef struct
+{
+    uint16_t fifo[NUM_SAMPLES_PER_FRAME];
+    TickType_t acquired_tick;
+} radar_frame_slot_t;
+
 /*****************************************************************************
  * Function Prototypes
  *****************************************************************************/
 static void radar_task(void *pvParameters);
 static void processing_task(void *pvParameters);
+static void processing_handle_control_request(void);
+static bool acquire_frame_slot(uint8_t *slot);
+static int32_t read_fifo_chunk(void *ctx, uint16_t *data, uint32_t num_samples);
+static void update_latency_stats(TickType_t acquired_tick);
 static int32_t radar_init(void);
 void get_time_from_millisec_radar(unsigned long milliseconds, char* output);
 
@@ -125,15 +158,26 @@ void get_time_from_millisec_radar(unsigned long milliseconds, char* output);
 ********************************************************************************/
 cy_en_scb_spi_status_t init_status;
 cy_stc_scb_spi_context_t SPI_context;
-static volatile bool data_available = false;
 cy_stc_sysint_t irq_cfg;
 xensiv_bgt60trxx_mtb_t sensor;
 
+/* Drain buffer for FIFO data that cannot be queued for processing */
 static uint16_t bgt60_buffer[NUM_SAMPLES_PER_FRAME] __attribute__((aligned(2)));
 
+static radar_frame_slot_t frame_slots[RADAR_FRAME_SLOTS];
+/* Slot indices free for acquisition, and filled and waiting for processing */
+static QueueHandle_t free_slots_queue;
+static QueueHandle_t ready_slots_queue;
+static radar_pipeline_stats_t pipeline_stats;
+static radar_fifo_reader_t fifo_reader;
+
 static TaskHandle_t radar_task_handler;
 static TaskHandle_t processing_task_handler;
 
+/* Runtime configuration of the processing task, set through control requests from CM33 */
+static bool model_enabled = true;
+static uint16_t min_range_bin = 3;
+
 float32_t gesture_frame[NUM_SAMPLES_PER_CHIRP * NUM_CHIRPS_PER_FRAME * XENSIV_BGT60TRXX_CONF_NUM_RX_ANTENNAS];
 
 preproc_work_arrays work_arrays;
@@ -198,6 +242,8 @@ void systick_isr(void)
 ********************************************************************************
 * Summary:
 * This function de-interleaves multiple antennas data from single radar HW FIFO
+* and prepares it for the range FFT in the same pass: ADC normalization, chirp
+* mean removal and range windowing (see prepare_frame_u16()).
 *
 * Parameters:
 *  buffer_ptr - Pointer to the buffer containing radar raw data.
@@ -208,23 +254,106 @@ void systick_isr(void)
 *******************************************************************************/
 void deinterleave_antennas(uint16_t * buffer_ptr)
 {
-    uint8_t antenna = 0;
-    int32_t index = 0;
-    static const float norm_factor = 1.0f;
+    prepare_frame_u16(buffer_ptr, gesture_frame, &f_cfg, work_arrays.range_window, true);
+}
 
-    for (int i = 0; i < (NUM_SAMPLES_PER_CHIRP * NUM_CHIRPS_PER_FRAME * XENSIV_BGT60TRXX_CONF_NUM_RX_ANTENNAS); ++i)
+
+/*******************************************************************************
+* Function Name: acquire_frame_slot
+********************************************************************************
+* Summary:
+* Takes a frame slot for the next FIFO read. When all slots are in use, the
+* oldest frame still waiting for processing is dropped and its slot reused,
+* so that the processing task always gets the most recent frames.
+*
+* Parameters:
+*  slot - Index of the acquired slot.
+*
+* Return:
+*  false if no slot is available (all of them are being processed).
+*
+*******************************************************************************/
+static bool acquire_frame_slot(uint8_t *slot)
+{
+    if (xQueueReceive(free_slots_queue, slot, 0) == pdPASS)
     {
-        /* Normalise the data received from multiple antennas into a single buffer */
-        gesture_frame[index + antenna * NUM_SAMPLES_PER_CHIRP * NUM_CHIRPS_PER_FRAME] = buffer_ptr[i] * norm_factor;
-        antenna++;
-        if (antenna == XENSIV_BGT60TRXX_CONF_NUM_RX_ANTENNAS)
-        {
-            antenna = 0;
-            index++;
-        }
+        return true;
+    }
+    if (xQueueReceive(ready_slots_queue, slot, 0) == pdPASS)
+    {
+        pipeline_stats.frames_dropped++;
+        return true;
+    }
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: read_fifo_chunk
+********************************************************************************
+* Summary:
+* FIFO read callback of the radar FIFO reader.
+*
+* Parameters:
+*  ctx         - Sensor device.
+*  data        - Destination of the samples.
+*  num_samples - Number of samples to read.
+*
+* Return:
+*  0 on success.
+*
+*******************************************************************************/
+static int32_t read_fifo_chunk(void *ctx, uint16_t *data, uint32_t num_samples)
+{
+    xensiv_bgt60trxx_t *dev = (xensiv_bgt60trxx_t *)ctx;
+    return (xensiv_bgt60trxx_get_fifo_data(dev, data, num_samples) == XENSIV_BGT60TRXX_STATUS_OK) ? 0 : -1;
+}
+
+/*******************************************************************************
+* Function Name: update_latency_stats
+********************************************************************************
+* Summary:
+* Accounts a processed frame and its latency, from the FIFO read to the
+* inference result.
+*
+* Parameters:
+*  acquired_tick - RTOS tick at which the frame was read from the FIFO.
+*
+* Return:
+*  none
+*
+*******************************************************************************/
+static void update_latency_stats(TickType_t acquired_tick)
+{
+    uint32_t latency_ms = (uint32_t)((xTaskGetTickCount() - acquired_tick) * portTICK_PERIOD_MS);
+    pipeline_stats.frames_processed++;
+    pipeline_stats.latency_last_ms = latency_ms;
+    pipeline_stats.latency_sum_ms += latency_ms;
+    if (latency_ms > pipeline_stats.latency_max_ms)
+    {
+        pipeline_stats.latency_max_ms = latency_ms;
     }
 }
 
+/*******************************************************************************
+* Function Name: radar_get_pipeline_stats
+********************************************************************************
+* Summary:
+* Returns a snapshot of the acquisition/processing pipeline counters.
+*
+* Parameters:
+*  stats - Destination of the counters.
+*
+* Return:
+*  none
+*
+*******************************************************************************/
+void radar_get_pipeline_stats(radar_pipeline_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = pipeline_stats;
+    stats->queue_depth = (ready_slots_queue != NULL) ? uxQueueMessagesWaiting(ready_slots_queue) : 0;
+    taskEXIT_CRITICAL();
+}
 
 /*******************************************************************************
 * Function Name: radar_task
@@ -237,11 +366,9 @@ void deinterleave_antennas(uint16_t * buffer_ptr)
 *    4. Initializes the radar device
 *    5. Initializes gesture library
 *    6. In an infinite loop
-*       - Waits for interrupt from radar device indicating availability of data
-*       - Read from software buffer the raw radar frame
-*       - De-interleaves the radar data frame
-*       - Acknowledges the radar data manager the consumption of read data
-*       - Sends notification to processing task
+*       - Blocks until the radar device interrupt signals the next FIFO chunk
+*       - Reads the chunk into the frame slot being filled
+*       - Hands the slot over to the processing task once the frame is complete
 * Parameters:
 *  pvParameters: unused
 *
@@ -253,11 +380,25 @@ void radar_task(void *pvParameters)
 {
     (void)pvParameters;
     cy_rslt_t result = CY_RSLT_SUCCESS;
+    uint8_t frame_slot = 0;
+    bool frame_queued = false;
+    uint16_t *frame_fifo = bgt60_buffer;
 
     if (radar_init() != 0)
     {
         CY_ASSERT(0);
     }
+
+    free_slots_queue = xQueueCreate(RADAR_FRAME_SLOTS, sizeof(uint8_t));
+    ready_slots_queue = xQueueCreate(RADAR_FRAME_SLOTS, sizeof(uint8_t));
+    if ((free_slots_queue == NULL) || (ready_slots_queue == NULL))
+    {
+        CY_ASSERT(0);
+    }
+    for (uint8_t slot = 0; slot < RADAR_FRAME_SLOTS; slot++)
+    {
+        (void)xQueueSend(free_slots_queue, &slot, 0);
+    }
     
     if (xTaskCreate(processing_task, PROCESSING_TASK_NAME, PROCESSING_TASK_STACK_SIZE, NULL, PROCESSING_TASK_PRIORITY, &processing_task_handler) != pdPASS)
     {
@@ -268,11 +409,19 @@ void radar_task(void *pvParameters)
     
     /* Init preprocessing */
     work_arrays = new_preproc_work_arrays(&f_cfg);
+    /* Frames are normalized and windowed by deinterleave_antennas() */
+    work_arrays.frame_prepared = true;
 
     /* Inference time measurement */
     Cy_SysTick_Init(CY_SYSTICK_CLOCK_SOURCE_CLK_IMO , (8000000/1000)-1);
     Cy_SysTick_SetCallback(0, systick_isr);
 
+    if (!radar_fifo_reader_init(&fifo_reader, read_fifo_chunk, &sensor.dev,
+                                NUM_SAMPLES_PER_FRAME, RADAR_FIFO_CHUNK_SAMPLES))
+    {
+        CY_ASSERT(0);
+    }
+
     if (xensiv_bgt60trxx_start_frame(&sensor.dev, true) != XENSIV_BGT60TRXX_STATUS_OK)
     {
         CY_ASSERT(0);
@@ -280,26 +429,140 @@ void radar_task(void *pvParameters)
 
     for(;;)
     {
-        if (data_available == true)
+        /* Sleep until the sensor signals the next FIFO chunk. Every interrupt
+         * gives one notification, so chunks that arrive while this task is
+         * busy are not lost. */
+        (void)ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+
+        if (radar_fifo_reader_at_frame_start(&fifo_reader))
+        {
+            frame_queued = acquire_frame_slot(&frame_slot);
+            frame_fifo = frame_queued ? frame_slots[frame_slot].fifo : bgt60_buffer;
+        }
+
+        int32_t read_result = radar_fifo_reader_read_chunk(&fifo_reader, frame_fifo);
+        /* The interrupt is edge triggered: if another chunk was already waiting,
+         * the line stayed asserted and no new edge will come for it. Queue a
+         * read for it unless the interrupt already did. */
+        taskENTER_CRITICAL();
+        if ((read_result != RADAR_FIFO_READ_ERROR) &&
+            (Cy_GPIO_Read(CYBSP_RADAR_INT_PORT, CYBSP_RADAR_INT_PIN) != 0UL) &&
+            (ulTaskNotifyValueClear(NULL, 0UL) == 0UL))
         {
-            data_available = false;
-            if (xensiv_bgt60trxx_get_fifo_data(&sensor.dev, bgt60_buffer, NUM_SAMPLES_PER_FRAME) == XENSIV_BGT60TRXX_STATUS_OK)
+            xTaskNotifyGive(radar_task_handler);
+        }
+        taskEXIT_CRITICAL();
+        if (read_result == RADAR_FIFO_FRAME_COMPLETE)
+        {
+            pipeline_stats.frames_acquired++;
+            if (frame_queued)
             {
-                deinterleave_antennas(bgt60_buffer);
-                /* Tell processing task to take over */
-                xTaskNotifyGive(processing_task_handler);
+                /* Hand the slot over to the processing task */
+                frame_slots[frame_slot].acquired_tick = xTaskGetTickCount();
+                (void)xQueueSend(ready_slots_queue, &frame_slot, 0);
+                UBaseType_t depth = uxQueueMessagesWaiting(ready_slots_queue);
+                if (depth > pipeline_stats.queue_depth_max)
+                {
+                    pipeline_stats.queue_depth_max = depth;
+                }
             }
             else
             {
-                printf ("Radar error. Check SPI configuration \r\n");
-                  CY_ASSERT(0);
-            }    
+                pipeline_stats.frames_dropped++;
+            }
+#if (RADAR_PIPELINE_STATS_PRINT_PERIOD > 0)
+            if ((pipeline_stats.frames_acquired % RADAR_PIPELINE_STATS_PRINT_PERIOD) == 0)
+            {
+                printf("\r\nradar: %lu frames, %lu dropped, depth max %lu, latency avg %lu ms max %lu ms\r\n",
+                       (unsigned long)pipeline_stats.frames_acquired,
+                       (unsigned long)pipeline_stats.frames_dropped,
+                       (unsigned long)pipeline_stats.queue_depth_max,
+                       (unsigned long)(pipeline_stats.frames_processed ?
+                           pipeline_stats.latency_sum_ms / pipeline_stats.frames_processed : 0),
+                       (unsigned long)pipeline_stats.latency_max_ms);
+            }
+#endif
+        }
+        else if (read_result == RADAR_FIFO_READ_ERROR)
+        {
+            if (frame_queued)
+            {
+                (void)xQueueSend(free_slots_queue, &frame_slot, 0);
+            }
+            printf ("Radar error. Check SPI configuration \r\n");
+            CY_ASSERT(0);
         }
     }
 }
      
 
 
+/*******************************************************************************
+* Function Name: processing_handle_control_request
+********************************************************************************
+* Summary:
+*  Applies a pending control request from CM33, if any. Called between frames,
+*  so a frame is always processed with one configuration.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void processing_handle_control_request(void)
+{
+    ipc_control_request_t request;
+    ipc_control_status_e status = IPC_CONTROL_STATUS_OK;
+
+    if (!cm55_ipc_get_control_request(&request))
+    {
+        return;
+    }
+
+    switch (request.command)
+    {
+        case IPC_CONTROL_SET_SENSITIVITY:
+        {
+            PP_config_t config = {
+                .confidence = request.confidence,
+                .average = request.average,
+                .subsequent = request.subsequent,
+                .pool = request.pool,
+                .pool_selection = request.pool_selection
+            };
+            if (IMAI_RET_SUCCESS != IMAI_AED_sensitivity(config))
+            {
+                status = IPC_CONTROL_STATUS_INVALID;
+            }
+            break;
+        }
+        case IPC_CONTROL_RESET_SENSITIVITY:
+            IMAI_AED_sensitivity_reset();
+            break;
+        case IPC_CONTROL_ENABLE_MODEL:
+            model_enabled = (0 != request.enabled);
+            break;
+        case IPC_CONTROL_SET_MIN_RANGE_BIN:
+            /* At least one range bin must be left for the range profile */
+            if (request.min_range_bin >= f_cfg.n_range_bins)
+            {
+                status = IPC_CONTROL_STATUS_INVALID;
+            }
+            else
+            {
+                min_range_bin = request.min_range_bin;
+            }
+            break;
+        default:
+            status = IPC_CONTROL_STATUS_UNSUPPORTED;
+            break;
+    }
+    cm55_ipc_complete_control_request(status);
+}
+
+
 /*******************************************************************************
 * Function Name: processing_task
 ********************************************************************************
@@ -307,7 +570,8 @@ void radar_task(void *pvParameters)
 * This is the data processing task.
 *    1. It creates a console task to handle parameter configuration for the library
 *    2. In a loop
-*       - wait for the frame data available for process
+*       - wait for a frame slot filled by the radar task, de-interleave it
+*         and give the slot back
 *       - Runs the Gesture algorithm and provides the result
 *       - Interprets the results
 *
@@ -325,15 +589,26 @@ void processing_task(void *pvParameters)
     const char* class_map[] = IMAI_DATA_OUT_SYMBOLS;
     const float norm_mean[IMAI_DATA_OUT_COUNT] = {9.26814552650607, 4.391583164927378, 0.27332462978312866, -0.02838213175529301, 0.00026668613549266876};
     const float norm_scale[IMAI_DATA_OUT_COUNT] = {5.801363069954616, 7.547439540930497, 0.5629401789624862, 0.41502512890635995, 0.0007474111364241666};
+    cm55_ipc_set_labels(IPC_MODEL_GESTURE, class_map, IMAI_DATA_OUT_COUNT);
 
     for(;;)
     {
-        /* Wait for frame data available to process */
-        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
-        /* pass on the de-interleaved data on to Algorithmic kernel */
+        /* Wait for a frame to process, take it over from the radar task */
+        uint8_t slot;
+        (void)xQueueReceive(ready_slots_queue, &slot, portMAX_DELAY);
+        TickType_t acquired_tick = frame_slots[slot].acquired_tick;
+        deinterleave_antennas(frame_slots[slot].fifo);
+        /* The raw data is no longer needed, the radar task can refill the slot */
+        (void)xQueueSend(free_slots_queue, &slot, 0);
+
+        processing_handle_control_request();
+        if (!model_enabled)
+        {
+            continue;
+        }
 
+        /* pass on the de-interleaved data on to Algorithmic kernel */
         float model_in[IMAI_DATA_IN_COUNT];
-        uint16_t min_range_bin = 3;
         slim_algo_output res;
         slim_algo(&res, gesture_frame, &f_cfg, min_range_bin, &work_arrays);
         model_in[0] = ((float)res.detection.range_bin - norm_mean[0]) / norm_scale[0];
@@ -351,6 +626,7 @@ void processing_task(void *pvParameters)
 
         /* Get model results */
         int imai_result = IMAI_AED_dequeue(model_out);
+        update_latency_stats(acquired_tick);
         int pred_idx = 0;
         static int prediction_count = 0;
 
@@ -362,7 +638,9 @@ void processing_task(void *pvParameters)
         {
             static uint8_t success_flag;
             case IMAI_RET_SUCCESS:
-                ipc_payload_t* payload = cm55_ipc_get_payload_ptr();
+                ipc_payload_t payload = {0};
+                payload.timestamp_ms = (uint32_t) (acquired_tick * portTICK_PERIOD_MS);
+                ipc_payload_set_scores(&payload, model_out, IMAI_DATA_OUT_COUNT);
 
                 success_flag = 1;
                 prediction_count += 1;
@@ -375,9 +653,8 @@ void processing_task(void *pvParameters)
                     }
                 }
                 
-                payload->label_id = pred_idx;
-                strcpy(payload->label, class_map[pred_idx]);
-                cm55_ipc_send_to_cm33();
+                payload.label_id = pred_idx;
+                (void) cm55_ipc_send_to_cm33(&payload);
 
                 if (pred_idx != 0)
                 {
@@ -519,7 +796,8 @@ static int32_t radar_init(void)
     result = xensiv_bgt60trxx_mtb_init(&sensor, register_list, XENSIV_BGT60TRXX_CONF_NUM_REGS);
     CY_ASSERT(result == CY_RSLT_SUCCESS);
 
-    result = xensiv_bgt60trxx_mtb_interrupt_init(&sensor, NUM_SAMPLES_PER_FRAME);
+    /* Interrupt every time the FIFO holds another chunk */
+    result = xensiv_bgt60trxx_mtb_interrupt_init(&sensor, RADAR_FIFO_CHUNK_SAMPLES);
     CY_ASSERT(result == CY_RSLT_SUCCESS);
     
     Cy_SysInt_Init(&irq_cfg, xensiv_bgt60trxx_interrupt_handler);
@@ -542,7 +820,7 @@ static int32_t radar_init(void)
 * Summary:
 * This is the interrupt handler to react on sensor indicating the availability
 * of new data
-*    1. Triggers the radar data manager for buffering radar data into software buffer.
+*    1. Notifies the radar task that another FIFO chunk can be read.
 *
 * Parameters:
 *  void
@@ -553,9 +831,14 @@ static int32_t radar_init(void)
 *******************************************************************************/
 void xensiv_bgt60trxx_interrupt_handler(void)
 {
-    data_available = true;
+    BaseType_t higher_priority_task_woken = pdFALSE;
+
     Cy_GPIO_ClearInterrupt(CYBSP_RADAR_INT_PORT, CYBSP_RADAR_INT_NUM);
     NVIC_ClearPendingIRQ(irq_cfg.intrSrc);
+
+    /* Wake up the radar task to read the next FIFO chunk */
+    vTaskNotifyGiveFromISR(radar_task_handler, &higher_priority_task_woken);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
 }
 
 /*******************************************************************************
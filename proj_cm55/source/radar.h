@@ -44,9 +44,26 @@
 #include "cy_result.h"
 #include "stdio.h"
 
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Counters of the radar acquisition -> processing pipeline */
+typedef struct
+{
+    uint32_t frames_acquired;   /* frames read from the sensor FIFO */
+    uint32_t frames_dropped;    /* frames discarded before processing */
+    uint32_t frames_processed;  /* frames that went through inference */
+    uint32_t queue_depth;       /* frames currently waiting for processing */
+    uint32_t queue_depth_max;
+    uint32_t latency_last_ms;   /* FIFO read to inference result */
+    uint32_t latency_max_ms;
+    uint32_t latency_sum_ms;
+} radar_pipeline_stats_t;
+
 /*******************************************************************************
 * Function Prototypes
 ********************************************************************************/
 cy_rslt_t create_radar_task(void);
+void radar_get_pipeline_stats(radar_pipeline_stats_t *stats);
 
 #endif /* RADAR_H_ */
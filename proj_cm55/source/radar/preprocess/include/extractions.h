@@ -72,7 +72,8 @@ typedef struct {
 /*Structure to hold intermediate arrays for the slim_algo 
 * processing. Use `new_preproc_work_arrays()` to create an
 * instance, and `free_preproc_work_arrays()` to free up the
-* arrays. */
+* arrays. The FFT windows point to the shared normalized tables
+* of `get_normalized_window()` and are not freed. */
 typedef struct {
     /* Half frame (hfr): n_channels * n_chirps * n_range_bins */
     ifx_cf64_t *x_range;
@@ -91,6 +92,27 @@ typedef struct {
     ifx_f32_t *range_profile;
     /* Samples (smp): n_samples */
     ifx_f32_t *range_window;
+    /* Set when the input frames come from `prepare_frame_u16()` with
+    *  `range_window` and mean removal, i.e. are already normalized and
+    *  windowed. false after `new_preproc_work_arrays()`. */
+    bool frame_prepared;
+    /* Range-gated mode of `slim_algo`: when set, magnitudes, slow-time mean
+    *  removal and the range profile are only computed for range bins in
+    *  [min_range_bin, range_gate_end). false and n_range_bins after
+    *  `new_preproc_work_arrays()`. */
+    bool range_gated;
+    uint16_t range_gate_end;
+    /* Clutter map mode of `slim_algo` and `super_slim_algo`: when set, static
+    *  targets are suppressed with `clutter`, carried across frames (see
+    *  `remove_clutter_3d_cf64()`), instead of the slow-time mean of each
+    *  frame. `slim_algo` subtracts the map within the range FFTs. false, with
+    *  `CLUTTER_MAP_ALPHA` and an unseeded map, after
+    *  `new_preproc_work_arrays()`; ignored if `clutter.map` is NULL because
+    *  it could not be allocated. Range bins that enter the range gate are
+    *  seeded by their first frame. Call `reset_clutter_map()` to start over,
+    *  e.g. after a gap in the frames. */
+    bool use_clutter_map;
+    clutter_map clutter;
 } preproc_work_arrays;
 
 preproc_work_arrays
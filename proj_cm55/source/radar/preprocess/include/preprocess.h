@@ -41,6 +41,7 @@
 #define IFXGESTURE_PREPROCESS_H_
 
 #include "ifx_sensor_dsp.h"
+#include <stddef.h>
 #include <stdint.h>
 
 #define ADC_RESOLUTION (12ul)
@@ -49,6 +50,16 @@
 #define ANTENNA_DISTANCE (0.0025)
 #define C0 (299792458.0)
 
+/* Optional per-stage profiling hook used by the host benchmark (see host/).
+*  Each call marks the end of the named processing stage. Compiles to nothing
+*  unless PREPROC_PROFILE is defined. */
+#ifdef PREPROC_PROFILE
+void preproc_profile_stage(const char *stage_name);
+#define PREPROC_STAGE(name) preproc_profile_stage(name)
+#else
+#define PREPROC_STAGE(name)
+#endif
+
 typedef int32_t ifx_status;
 typedef float ifx_f32_t;
 
@@ -68,6 +79,14 @@ typedef struct {
     uint16_t n_samples;
     bool remove_mean;
     ifx_f32_t *window;
+    /* When set, the n_samples / 2 elements of `clutter_map` are subtracted
+    *  from the bins in [clutter_start, clutter_end) of every spectrum as it
+    *  comes out of the FFT, and the residuals are added to `clutter_sum`,
+    *  see `build_complex_range_image_clutter()` */
+    ifx_cf64_t *clutter_map;
+    ifx_cf64_t *clutter_sum;
+    uint16_t clutter_start;
+    uint16_t clutter_end;
 } range_transform_cfg;
 
 typedef struct {
@@ -77,6 +96,10 @@ typedef struct {
     bool doppler_remove_mean;
     ifx_f32_t *range_window;
     ifx_f32_t *doppler_window;
+    /* Optional scratch arrays of n_chirps * n_samples / 2 elements each.
+    *  When NULL, they are allocated (and freed) on every call. */
+    ifx_cf64_t *range_scratch;
+    ifx_cf64_t *doppler_scratch;
 } range_doppler_transform_cfg;
 
 typedef struct {
@@ -101,15 +124,88 @@ typedef struct {
     uint16_t doppler_bin;
     uint16_t range_bin;
     ifx_f32_t value;
+    /* Noise level of the cell, set by the CFAR detection modes only */
+    ifx_f32_t noise;
 } detection;
 
 typedef enum {
     DETECTION_MODE_CLOSEST,
-    DETECTION_MODE_FASTEST
-    /* TODO: implement the "STRONGEST" detection mode
-    * DETECTION_MODE_STRONGEST */
+    DETECTION_MODE_FASTEST,
+    DETECTION_MODE_STRONGEST,
+    /* CFAR modes test every cell of the search region against `threshold`
+    *  times the noise level of its training cells, see `cfar_cfg`, instead
+    *  of `threshold * bg_level`. The cell that passes the most above its
+    *  noise level is the hand.
+    *  Cell-averaging: mean of the training cells around the cell */
+    DETECTION_MODE_CA_CFAR,
+    /* Ordered-statistic: `os_rank` percentile of the training cells along
+    *  Doppler, robust to a second target among them */
+    DETECTION_MODE_OS_CFAR
 } detection_mode;
 
+/* Training cells of the CFAR detection modes. Around the cell under test,
+*  the guard cells on each side are left out and the training cells beyond
+*  them give the noise level. Masked (zero) cells and cells outside the
+*  frame are not counted. `DETECTION_MODE_OS_CFAR` uses the Doppler axis
+*  only: the clutter changes quickly with range, but little with Doppler. */
+typedef struct {
+    uint16_t guard_range;
+    uint16_t guard_doppler;
+    uint16_t train_range;
+    uint16_t train_doppler;
+    /* Percentile of the training cells taken by `DETECTION_MODE_OS_CFAR` */
+    uint8_t os_rank;
+} cfar_cfg;
+
+#define CFAR_CFG_DEFAULT { .guard_range = 1, .guard_doppler = 1, \
+    .train_range = 4, .train_doppler = 4, .os_rank = 75 }
+
+/* Estimators of the background level, the median of the positive cells of
+*  the masked mean RDI, see `estimate_background_level()`. */
+typedef enum {
+    /* Exact median by quickselect, same result as sorting the cells */
+    BG_LEVEL_EXACT,
+    /* Approximate median from a fixed-bin histogram of the cells */
+    BG_LEVEL_HISTOGRAM,
+    /* Median tracked across frames, one comparison per cell and frame */
+    BG_LEVEL_STREAMING
+} bg_level_mode;
+
+/* Bins of the `BG_LEVEL_HISTOGRAM` estimator */
+#define BG_LEVEL_HISTOGRAM_BINS (256u)
+/* Largest relative step of the `BG_LEVEL_STREAMING` level per frame */
+#define BG_LEVEL_STREAMING_RATE (0.25f)
+
+typedef struct {
+    bg_level_mode mode;
+    /* Level carried across frames by `BG_LEVEL_STREAMING`, seeded with the
+    *  exact median while it is 0.0 */
+    float level;
+    float rate;
+    /* `BG_LEVEL_HISTOGRAM_BINS` counts, used by `BG_LEVEL_HISTOGRAM` */
+    uint32_t *histogram;
+} bg_level_estimator;
+
+/* Weight of the current frame in a `clutter_map` */
+#define CLUTTER_MAP_ALPHA (0.1f)
+
+/* Static clutter of the range images, an exponentially weighted mean over
+*  frames, see `remove_clutter_3d_cf64()`. Use `new_clutter_map()` to create
+*  an instance and `free_clutter_map()` to free it. */
+typedef struct {
+    /* n_channels * n_range_bins, zero for the range bins that are not seeded */
+    ifx_cf64_t *map;
+    /* n_range_bins, slow-time sums of the residuals of one channel */
+    ifx_cf64_t *residual_sum;
+    /* n_range_bins, set for the range bins whose map holds the clutter. A
+    *  range bin is seeded with the slow-time mean of the first frame it is
+    *  processed in, and dropped from the map when a frame leaves it out. */
+    bool *seeded;
+    uint16_t n_channels;
+    uint16_t n_range_bins;
+    float alpha;
+} clutter_map;
+
 typedef struct {
     detection detection;
     float azimuth;
@@ -125,6 +221,44 @@ typedef struct {
     uint16_t upper_limit;
 } algo_output;
 
+/* Structure to hold intermediate arrays for the `algo` processing. All arrays
+*  are carved out of a single arena sized from the frame configuration, so
+*  that `algo` does no heap allocation per frame. Use `new_algo_workspace()`
+*  to allocate the arena on the heap and `free_algo_workspace()` to free it,
+*  or `init_algo_workspace()` to place it in caller-provided memory of
+*  `algo_workspace_size()` bytes. */
+typedef struct {
+    /* Frame (frm): n_channels * n_chirps * n_range_bins */
+    ifx_cf64_t *rdi;
+    ifx_f32_t *abs_rdi;
+    /* Image (img): n_chirps * n_range_bins */
+    ifx_f32_t *mean_abs_rdi;
+    ifx_f32_t *masked_mean_abs_rdi;
+    ifx_f32_t *bg_scratch;
+    /* Background level estimator, `BG_LEVEL_EXACT` after
+    *  `init_algo_workspace()`. Select the mode with `bg_level.mode`. */
+    bg_level_estimator bg_level;
+    /* CFAR detection modes, `CFAR_CFG_DEFAULT` after `init_algo_workspace()`.
+    *  The noise levels go to `bg_scratch`. */
+    cfar_cfg cfar;
+    ifx_f32_t *cfar_scratch;
+    ifx_cf64_t *range_scratch;
+    ifx_cf64_t *doppler_scratch;
+    /* Chirps (chr): n_chirps */
+    ifx_f32_t *doppler_profile;
+    uint16_t *peak_bin_clusters;
+    /* Peaks (pks): n_peaks, n_chirps for detections */
+    uint16_t *peaks;
+    uint16_t *cluster_elements;
+    peak_cluster *clusters;
+    detection *detections;
+    /* Shared normalized windows, see `get_normalized_window()` */
+    ifx_f32_t *range_window;
+    ifx_f32_t *doppler_window;
+    /* Arena owned by the workspace, NULL if provided by the caller */
+    void *arena;
+} algo_workspace;
+
 void slice_2d_row_cf64(
     ifx_cf64_t *src, ifx_cf64_t *dst, uint16_t row, uint16_t n_rows,
     uint16_t n_cols
@@ -145,6 +279,8 @@ void slice_3d_col_cf64(
     uint16_t n_rows, uint16_t n_cols
 );
 
+void init_preproc_tables(const frame_cfg *f_cfg);
+
 void rfft_f32(ifx_f32_t *x, ifx_cf64_t *out, uint16_t n_samples);
 
 void cfft_f32(ifx_cf64_t *x, uint16_t n_samples);
@@ -163,6 +299,26 @@ void build_complex_range_image(
     ifx_f32_t *raw_frame, ifx_cf64_t *out, frame_cfg *f_cfg, ifx_f32_t *window
 );
 
+void build_complex_range_image_prepared(
+    ifx_f32_t *frame, ifx_cf64_t *out, frame_cfg *f_cfg
+);
+
+void build_complex_range_image_clutter(
+    ifx_f32_t *frame, ifx_cf64_t *out, frame_cfg *f_cfg, ifx_f32_t *window,
+    bool prepared, clutter_map *clutter, uint16_t range_start,
+    uint16_t range_end
+);
+
+void prepare_frame_u16(
+    const uint16_t *fifo, ifx_f32_t *frame, const frame_cfg *f_cfg,
+    const ifx_f32_t *window, bool remove_mean
+);
+
+void prepare_frame_u16_ref(
+    const uint16_t *fifo, ifx_f32_t *frame, const frame_cfg *f_cfg,
+    const ifx_f32_t *window, bool remove_mean
+);
+
 void build_complex_rdi(
     ifx_f32_t *raw_frame, ifx_cf64_t *output_rdi, frame_cfg *f_cfg
 );
@@ -205,6 +361,15 @@ float get_background_level(
     const ifx_f32_t *masked_mean_abs_rdi, const frame_cfg *f_cfg
 );
 
+void init_bg_level_estimator(
+    bg_level_estimator *est, bg_level_mode mode, uint32_t *histogram
+);
+
+float estimate_background_level(
+    const ifx_f32_t *masked_mean_abs_rdi, const frame_cfg *f_cfg,
+    bg_level_estimator *est, ifx_f32_t *scratch
+);
+
 void make_doppler_profile(
     const ifx_f32_t *mean_abs_rdi, ifx_f32_t *profile,
     const region *search_region, const frame_cfg *f_cfg
@@ -215,7 +380,8 @@ void find_peaks(
 );
 
 void cluster_peaks(
-    const uint16_t *peaks, peak_cluster *clusters, uint16_t n_peaks
+    const uint16_t *peaks, peak_cluster *clusters, uint16_t n_peaks,
+    uint16_t *cluster_elements, uint16_t *bin_clusters, uint16_t n_elements
 );
 
 uint16_t suggest_hand_detections(
@@ -224,6 +390,20 @@ uint16_t suggest_hand_detections(
     const peak_cluster *clusters, float threshold, float bg_level
 );
 
+size_t cfar_scratch_len(const frame_cfg *f_cfg);
+
+void estimate_cfar_noise(
+    const ifx_f32_t *masked_mean_abs_rdi, ifx_f32_t *noise,
+    const frame_cfg *f_cfg, const region *search_region, const cfar_cfg *cfg,
+    detection_mode det_mode, ifx_f32_t *scratch
+);
+
+uint16_t suggest_cfar_detections(
+    const ifx_f32_t *masked_mean_abs_rdi, const ifx_f32_t *noise,
+    detection *detections, const frame_cfg *f_cfg, const region *search_region,
+    float threshold
+);
+
 ifx_status angle(ifx_f32_t re, ifx_f32_t im, float *out);
 
 detection detect_hand(
@@ -245,11 +425,41 @@ void remove_mean_3d_cf64(
     uint16_t n_cols
 );
 
+void remove_mean_3d_cols_cf64(
+    ifx_cf64_t *src, uint16_t n_ch, uint16_t n_rows, uint16_t n_cols,
+    uint16_t col_start, uint16_t col_end
+);
+
+bool new_clutter_map(
+    clutter_map *clutter, uint16_t n_channels, uint16_t n_range_bins,
+    float alpha
+);
+
+void free_clutter_map(clutter_map *clutter);
+
+void reset_clutter_map(clutter_map *clutter);
+
+void remove_clutter_3d_cf64(
+    ifx_cf64_t *src, clutter_map *clutter, uint16_t n_ch, uint16_t n_rows,
+    uint16_t n_cols, uint16_t col_start, uint16_t col_end
+);
+
+size_t algo_workspace_size(const frame_cfg *f_cfg);
+
+bool init_algo_workspace(
+    algo_workspace *ws, const frame_cfg *f_cfg, void *buffer, size_t size
+);
+
+algo_workspace new_algo_workspace(const frame_cfg *f_cfg);
+
+void free_algo_workspace(algo_workspace *ws);
+
 void algo(
     algo_output *out, ifx_f32_t *frame, frame_cfg *f_cfg,
     estimate_human_cfg *h_cfg, uint16_t band_min, uint16_t band_max,
     uint16_t band_offset, uint16_t range_min, uint16_t guard_range,
-    uint16_t guard_doppler, detection_mode det_mode, float threshold
+    uint16_t guard_doppler, detection_mode det_mode, float threshold,
+    algo_workspace *ws
 );
 
 #endif
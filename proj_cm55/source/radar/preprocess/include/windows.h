@@ -59,4 +59,6 @@ extern const namespace_windows WINDOWS;
 
 void get_window(const sized_windows *sw, ifx_f32_t *out, uint16_t size);
 
+ifx_f32_t *get_normalized_window(const sized_windows *sw, uint16_t size);
+
 #endif
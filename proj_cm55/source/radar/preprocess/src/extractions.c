@@ -40,6 +40,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -82,15 +83,22 @@ new_preproc_work_arrays(frame_cfg *f_cfg)
         .x_doppler = (ifx_cf64_t *)malloc(sz_c * len_cch),
         .x_doppler_abs = (ifx_f32_t *)malloc(sz_f * len_cch),
         .doppler_profile = (ifx_f32_t *)malloc(sz_f * f_cfg->n_chirps),
-        .doppler_window = (ifx_f32_t *)malloc(sz_f * f_cfg->n_chirps),
+        .doppler_window = NULL,
         .range_profile = (ifx_f32_t *)malloc(sz_f * f_cfg->n_range_bins),
-        .range_window = (ifx_f32_t *)malloc(sz_f * f_cfg->n_samples)
+        .range_window = get_normalized_window(&WINDOWS.hann, f_cfg->n_samples),
+        .frame_prepared = false,
+        .range_gated = false,
+        .range_gate_end = f_cfg->n_range_bins,
+        .use_clutter_map = false
     };
+    (void)new_clutter_map(
+        &arrays.clutter, f_cfg->n_channels, f_cfg->n_range_bins, CLUTTER_MAP_ALPHA
+    );
+    init_preproc_tables(f_cfg);
     if  (f_cfg->n_chirps>=16)
     {
-        get_window(&WINDOWS.kaiser_b25, arrays.doppler_window, f_cfg->n_chirps);
+        arrays.doppler_window = get_normalized_window(&WINDOWS.kaiser_b25, f_cfg->n_chirps);
     }
-    get_window(&WINDOWS.hann, arrays.range_window, f_cfg->n_samples);
     return arrays;
 }
 
@@ -106,12 +114,53 @@ void free_preproc_work_arrays(
     free(arrays->x_doppler);
     free(arrays->x_doppler_abs);
     free(arrays->doppler_profile);
-    free(arrays->doppler_window);
     free(arrays->range_profile);
-    free(arrays->range_window);
+    free_clutter_map(&arrays->clutter);
 }
 
 
+/*******************************************************************************
+* Function Name: _suppress_static_targets
+********************************************************************************
+* Summary:
+* Removes the static targets from the range images in `arr->x_range`, for the
+* range bins in [range_start, range_end): with the clutter map if
+* `arr->use_clutter_map` is set and the map could be allocated, with the
+* slow-time mean of the frame otherwise.
+*
+* Parameters:
+*  arr         : Intermediate working arrays.
+*  f_cfg       : Frame configuration.
+*  range_start : First range bin.
+*  range_end   : Range bin after the last one.
+*
+*******************************************************************************/
+static void _suppress_static_targets(
+    preproc_work_arrays *arr, frame_cfg *f_cfg, uint16_t range_start,
+    uint16_t range_end
+)
+{
+    if (arr->use_clutter_map && (arr->clutter.map != NULL)) {
+        remove_clutter_3d_cf64(
+            arr->x_range, &arr->clutter, f_cfg->n_channels, f_cfg->n_chirps,
+            f_cfg->n_range_bins, range_start, range_end
+        );
+        PREPROC_STAGE("clutter_map");
+        return;
+    }
+    if (range_start == 0 && range_end == f_cfg->n_range_bins) {
+        remove_mean_3d_cf64(
+            arr->x_range, 1, f_cfg->n_channels, f_cfg->n_chirps, f_cfg->n_range_bins
+        );
+    } else {
+        remove_mean_3d_cols_cf64(
+            arr->x_range, f_cfg->n_channels, f_cfg->n_chirps, f_cfg->n_range_bins,
+            range_start, range_end
+        );
+    }
+    PREPROC_STAGE("mean_removal");
+}
+
 /*******************************************************************************
 * Function Name: _get_range_profile
 ********************************************************************************
@@ -145,6 +194,42 @@ static void _get_range_profile(
     }
 }
 
+/*******************************************************************************
+* Function Name: _get_range_profile_gated
+********************************************************************************
+* Summary:
+* Range-gated version of `_get_range_profile`: magnitudes are only computed
+* for the range bins in [min_range_bin, arr->range_gate_end), one chirp row
+* segment at a time. Like `_get_range_profile`, the 1st chirp is ignored.
+*
+* Parameters:
+*  x_range       : Range images (per channel).
+*  arr           : Intermediate working arrays. Result of this function is
+*  stored in `arr->range_profile`.
+*  min_range_bin : First range bin of the gate.
+*
+*******************************************************************************/
+static void _get_range_profile_gated(
+    ifx_cf64_t *x_range, preproc_work_arrays *arr, frame_cfg *f_cfg,
+    uint16_t min_range_bin
+)
+{
+    uint16_t width = arr->range_gate_end - min_range_bin;
+    arm_fill_f32(0, arr->range_profile, width);
+    for (int idx_ch = 0; idx_ch < f_cfg->n_channels; ++idx_ch) {
+        for (int idx_chirp = 1; idx_chirp < f_cfg->n_chirps; ++idx_chirp) {
+            ifx_cf64_t *row = x_range +
+                (idx_ch * f_cfg->n_chirps + idx_chirp) * f_cfg->n_range_bins + min_range_bin;
+            arm_cmplx_mag_f32((float32_t *)row, (float32_t *)arr->x_range_abs, width);
+            arm_add_f32(arr->range_profile, arr->x_range_abs, arr->range_profile, width);
+        }
+    }
+    arm_scale_f32(
+        arr->range_profile, 1.0f / (f_cfg->n_channels * (f_cfg->n_chirps - 1)),
+        arr->range_profile, width
+    );
+}
+
 /*******************************************************************************
 * Function Name: _get_range_profile_super_slim
 ********************************************************************************
@@ -181,7 +266,8 @@ void _get_range_profile_super_slim(
 * Function Name: _get_single_range_bin_doppler
 ********************************************************************************
 * Summary:
-* Computes a doppler FFT on for a single range bin.
+* Computes a doppler FFT on for a single range bin, using the cached FFT
+* instance for `n_chirps`.
 *
 * Parameters:
 *  x_range       : Range images (per channel).
@@ -201,12 +287,18 @@ static void _get_single_range_bin_doppler(
         f_cfg->n_range_bins
     );
     for (uint16_t idx_ch = 0; idx_ch < f_cfg->n_channels; ++idx_ch) {
-        (void)ifx_doppler_cfft_f32(
-            (cfloat32_t *)(arr->x_range_slice + idx_ch * f_cfg->n_chirps),
-            (cfloat32_t *)(arr->x_doppler + idx_ch * f_cfg->n_chirps), false,
-            arr->doppler_window, 1, f_cfg->n_chirps
-        );
-        fftshift_cf64(arr->x_doppler + idx_ch * f_cfg->n_chirps, f_cfg->n_chirps);
+        ifx_cf64_t *slice = arr->x_range_slice + idx_ch * f_cfg->n_chirps;
+        ifx_cf64_t *doppler = arr->x_doppler + idx_ch * f_cfg->n_chirps;
+        if (arr->doppler_window != NULL) {
+            arm_cmplx_mult_real_f32(
+                (float32_t *)slice, (float32_t *)arr->doppler_window,
+                (float32_t *)doppler, f_cfg->n_chirps
+            );
+        } else {
+            memcpy(doppler, slice, sizeof(ifx_cf64_t) * f_cfg->n_chirps);
+        }
+        cfft_f32(doppler, f_cfg->n_chirps);
+        fftshift_cf64(doppler, f_cfg->n_chirps);
     }
 }
 
@@ -278,14 +370,17 @@ uint32_t filter_range_profile(ifx_f32_t *range_profile, int32_t len, uint32_t pe
 * Parameters:
 *  out           : out Preprocessing algorithm output containing detected hand
 *  features.
-*  x_frame       : Raw radar frame.
+*  x_frame       : Raw radar frame, or a frame prepared by
+*  `prepare_frame_u16()` if `arr->frame_prepared` is set.
 *  f_cfg         :  Frame configuration.
 *  min_range_bin : The closest range bin to use for hand detection. Closer
 /// ranges are ignored.
 *  arr           : Intermediate pre-allocated arrays. Use
 *  `new_preproc_work_arrays()` to create the instance of this
 *  struct with pre-allocated arrays. Reuse the same struct for processing all
-*  frames.
+*  frames. Set `arr->range_gated` and `arr->range_gate_end` to also ignore
+*  the ranges from `range_gate_end` on, and `arr->use_clutter_map` to
+*  suppress static targets across frames.
 *
 *******************************************************************************/
 void slim_algo(
@@ -293,24 +388,44 @@ void slim_algo(
     uint16_t min_range_bin, preproc_work_arrays *arr
 )
 {
-    /* Build range images, suppress static targets, compute a range profile */
-    build_complex_range_image(x_frame, arr->x_range, f_cfg, arr->range_window);
-    remove_mean_3d_cf64(
-        arr->x_range, 1, f_cfg->n_channels, f_cfg->n_chirps, f_cfg->n_range_bins
-    );
-    _get_range_profile(arr->x_range, arr, f_cfg, min_range_bin);
+    /* Build range images, suppress static targets, compute a range profile.
+    *  In range-gated mode only the bins of the gate are processed further */
+    uint16_t range_start = arr->range_gated ? min_range_bin : 0;
+    uint16_t range_end = arr->range_gated ? arr->range_gate_end : f_cfg->n_range_bins;
+    if (arr->use_clutter_map && (arr->clutter.map != NULL)) {
+        /* The clutter map is subtracted within the range FFTs */
+        build_complex_range_image_clutter(
+            x_frame, arr->x_range, f_cfg, arr->range_window, arr->frame_prepared,
+            &arr->clutter, range_start, range_end
+        );
+        PREPROC_STAGE("range_fft");
+    } else {
+        if (arr->frame_prepared) {
+            build_complex_range_image_prepared(x_frame, arr->x_range, f_cfg);
+        } else {
+            build_complex_range_image(x_frame, arr->x_range, f_cfg, arr->range_window);
+        }
+        PREPROC_STAGE("range_fft");
+        _suppress_static_targets(arr, f_cfg, range_start, range_end);
+    }
+    if (arr->range_gated) {
+        _get_range_profile_gated(arr->x_range, arr, f_cfg, min_range_bin);
+    } else {
+        _get_range_profile(arr->x_range, arr, f_cfg, min_range_bin);
+    }
 
     /* Find peak in the range profile - consider it as range to the hand */
     uint32_t idx_peak_range;
     ifx_f32_t val_peak_range;
     arm_max_f32(
-        arr->range_profile, f_cfg->n_range_bins - min_range_bin, &val_peak_range,
+        arr->range_profile, range_end - min_range_bin, &val_peak_range,
         &idx_peak_range
     );
 
-    idx_peak_range = filter_range_profile(arr->range_profile, f_cfg->n_range_bins-min_range_bin, idx_peak_range);
+    idx_peak_range = filter_range_profile(arr->range_profile, range_end - min_range_bin, idx_peak_range);
 
     idx_peak_range += min_range_bin;
+    PREPROC_STAGE("range_profile");
 
     /* Compute Doppler spectrum for the peak range bin (for each channel), then
     *   make a Doppler profile.*/
@@ -323,6 +438,7 @@ void slim_algo(
     arm_max_f32(
         arr->doppler_profile, f_cfg->n_chirps, &val_peak_doppler, &idx_peak_doppler
     );
+    PREPROC_STAGE("doppler");
 
     /* Extract phases from Doppler spectrum of each channel */
     float phases[3];
@@ -343,6 +459,7 @@ void slim_algo(
     /* Phase correction based on Signify measurements */
     azimuth = azimuth + deg2rad(8.0);
     elevation = elevation + deg2rad(24.0);
+    PREPROC_STAGE("angles");
 
     out->success = true;
     out->detection = (slim_algo_detection
@@ -362,11 +479,14 @@ void super_slim_algo(
 )
 {
     /* Build range images, suppress static targets, compute a range profile */
-    build_complex_range_image(x_frame, arr->x_range, f_cfg, arr->range_window);
+    if (arr->frame_prepared) {
+        build_complex_range_image_prepared(x_frame, arr->x_range, f_cfg);
+    } else {
+        build_complex_range_image(x_frame, arr->x_range, f_cfg, arr->range_window);
+    }
+    PREPROC_STAGE("range_fft");
     memcpy(arr->x_range_keep, arr->x_range, f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_range_bins *sizeof(ifx_cf64_t));
-    remove_mean_3d_cf64(
-        arr->x_range, 1, f_cfg->n_channels, f_cfg->n_chirps, f_cfg->n_range_bins
-    );
+    _suppress_static_targets(arr, f_cfg, 0, f_cfg->n_range_bins);
     _get_range_profile_super_slim(arr->x_range, arr, f_cfg, min_range_bin);
     /* Find peak in the range profile - consider it as range to the hand */
     uint32_t idx_peak_range;
@@ -380,6 +500,7 @@ void super_slim_algo(
                      );
 
     idx_peak_range += min_range_bin;
+    PREPROC_STAGE("range_profile");
     float** phases;
     phases = (float**)malloc(f_cfg->n_channels * sizeof(float*));
     for (int i = 0; i < f_cfg->n_channels; i++) {
@@ -418,6 +539,7 @@ void super_slim_algo(
         doppler += get_phase_difference(phases[a][1], phases[a][0]);
     }
     doppler = doppler / f_cfg->n_channels;
+    PREPROC_STAGE("phases");
 
     float azimuth = 0;
     float elevation = 0;
@@ -428,6 +550,7 @@ void super_slim_algo(
     }
     azimuth = azimuth / f_cfg->n_chirps;
     elevation = elevation / f_cfg->n_chirps;
+    PREPROC_STAGE("angles");
 
     out->success = true;
     out->detection = (super_slim_algo_detection
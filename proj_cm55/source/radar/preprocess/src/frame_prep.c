@@ -0,0 +1,180 @@
+/******************************************************************************
+* File Name:   frame_prep.c
+*
+* Description: This file converts raw BGT60 FIFO data into range FFT input
+*   frames: deinterleave, ADC normalization, chirp mean removal and windowing
+*   in a single pass.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* (c) 2021-2025, Infineon Technologies AG, or an affiliate of Infineon
+* Technologies AG. All rights reserved.
+* This software, associated documentation and materials ("Software") is
+* owned by Infineon Technologies AG or one of its affiliates ("Infineon")
+* and is protected by and subject to worldwide patent protection, worldwide
+* copyright laws, and international treaty provisions. Therefore, you may use
+* this Software only as provided in the license agreement accompanying the
+* software package from which you obtained this Software. If no license
+* agreement applies, then any use, reproduction, modification, translation, or
+* compilation of this Software is prohibited without the express written
+* permission of Infineon.
+* 
+* Disclaimer: UNLESS OTHERWISE EXPRESSLY AGREED WITH INFINEON, THIS SOFTWARE
+* IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING, BUT NOT LIMITED TO, ALL WARRANTIES OF NON-INFRINGEMENT OF
+* THIRD-PARTY RIGHTS AND IMPLIED WARRANTIES SUCH AS WARRANTIES OF FITNESS FOR A
+* SPECIFIC USE/PURPOSE OR MERCHANTABILITY.
+* Infineon reserves the right to make changes to the Software without notice.
+* You are responsible for properly designing, programming, and testing the
+* functionality and safety of your intended application of the Software, as
+* well as complying with any legal requirements related to its use. Infineon
+* does not guarantee that the Software will be free from intrusion, data theft
+* or loss, or other breaches ("Security Breaches"), and Infineon shall have
+* no liability arising out of any Security Breaches. Unless otherwise
+* explicitly approved by Infineon, the Software may not be used in any
+* application where a failure of the Product or any consequences of the use
+* thereof can reasonably be expected to result in personal injury.
+*******************************************************************************/
+#include "preprocess.h"
+
+#if defined(ARM_MATH_HELIUM)
+#include <arm_mve.h>
+#endif
+
+/*******************************************************************************
+* Function Name: prepare_frame_u16_ref
+********************************************************************************
+* Summary:
+* Scalar reference of `prepare_frame_u16()`. Produces the same frame as
+* deinterleaving the FIFO data, scaling it by 1/ADC_NORMALIZATION, removing
+* the mean of every chirp and multiplying every chirp by the range window.
+*
+* Parameters:
+*  fifo        : Raw FIFO data, antennas interleaved:
+*  [chirp][sample][channel].
+*  frame       : Output frame [channel][chirp][sample].
+*  f_cfg       : Frame configuration.
+*  window      : n_samples range window, NULL for no window.
+*  remove_mean : Remove the mean of every chirp.
+*
+*******************************************************************************/
+void prepare_frame_u16_ref(
+    const uint16_t *fifo, ifx_f32_t *frame, const frame_cfg *f_cfg,
+    const ifx_f32_t *window, bool remove_mean
+)
+{
+    const uint16_t n_ch = f_cfg->n_channels;
+    const uint16_t n_smp = f_cfg->n_samples;
+    const ifx_f32_t scale = 1.0f / (ifx_f32_t)ADC_NORMALIZATION;
+
+    for (uint16_t ch = 0; ch < n_ch; ++ch)
+    {
+        for (uint16_t chirp = 0; chirp < f_cfg->n_chirps; ++chirp)
+        {
+            const uint16_t *src = fifo + (uint32_t)chirp * n_smp * n_ch + ch;
+            ifx_f32_t *dst = frame + ((uint32_t)ch * f_cfg->n_chirps + chirp) * n_smp;
+            ifx_f32_t mean = 0.0f;
+            if (remove_mean)
+            {
+                uint32_t sum = 0;
+                for (uint16_t s = 0; s < n_smp; ++s)
+                {
+                    sum += src[s * n_ch];
+                }
+                mean = (ifx_f32_t)sum * scale / (ifx_f32_t)n_smp;
+            }
+            for (uint16_t s = 0; s < n_smp; ++s)
+            {
+                ifx_f32_t x = (ifx_f32_t)src[s * n_ch] * scale - mean;
+                dst[s] = (window != NULL) ? x * window[s] : x;
+            }
+        }
+    }
+}
+
+#if defined(ARM_MATH_HELIUM)
+/* Helium version of `prepare_frame_u16_ref()`. The samples of one antenna
+*  are picked out of the interleaved FIFO with halfword gather loads, four
+*  per vector. n_samples must be a multiple of 4. */
+static void _prepare_frame_u16_mve(
+    const uint16_t *fifo, ifx_f32_t *frame, const frame_cfg *f_cfg,
+    const ifx_f32_t *window, bool remove_mean
+)
+{
+    const uint16_t n_ch = f_cfg->n_channels;
+    const uint16_t n_smp = f_cfg->n_samples;
+    const ifx_f32_t scale = 1.0f / (ifx_f32_t)ADC_NORMALIZATION;
+    /* Halfword offsets of 4 consecutive samples of one antenna */
+    const uint32x4_t offsets = vmulq_n_u32(vidupq_n_u32(0, 1), n_ch);
+    const uint32_t step = 4u * n_ch;
+
+    for (uint16_t ch = 0; ch < n_ch; ++ch)
+    {
+        for (uint16_t chirp = 0; chirp < f_cfg->n_chirps; ++chirp)
+        {
+            const uint16_t *src = fifo + (uint32_t)chirp * n_smp * n_ch + ch;
+            ifx_f32_t *dst = frame + ((uint32_t)ch * f_cfg->n_chirps + chirp) * n_smp;
+            ifx_f32_t mean = 0.0f;
+            if (remove_mean)
+            {
+                uint32_t sum = 0;
+                const uint16_t *p = src;
+                for (uint16_t s = 0; s < n_smp; s += 4)
+                {
+                    sum = vaddvaq_u32(sum, vldrhq_gather_shifted_offset_u32(p, offsets));
+                    p += step;
+                }
+                mean = (ifx_f32_t)sum * scale / (ifx_f32_t)n_smp;
+            }
+            const uint16_t *p = src;
+            for (uint16_t s = 0; s < n_smp; s += 4)
+            {
+                uint32x4_t raw = vldrhq_gather_shifted_offset_u32(p, offsets);
+                float32x4_t x = vsubq_n_f32(vmulq_n_f32(vcvtq_f32_u32(raw), scale), mean);
+                if (window != NULL)
+                {
+                    x = vmulq_f32(x, vld1q_f32(window + s));
+                }
+                vst1q_f32(dst + s, x);
+                p += step;
+            }
+        }
+    }
+}
+#endif
+
+/*******************************************************************************
+* Function Name: prepare_frame_u16
+********************************************************************************
+* Summary:
+* Converts a raw FIFO frame into the range FFT input in one pass over the
+* data: deinterleaves the antennas, converts to float, normalizes by
+* ADC_NORMALIZATION, optionally removes the mean of every chirp and applies
+* the range window. Use `build_complex_range_image_prepared()` on the result.
+* Uses Helium when available, `prepare_frame_u16_ref()` otherwise.
+*
+* Parameters:
+*  fifo        : Raw FIFO data, antennas interleaved:
+*  [chirp][sample][channel].
+*  frame       : Output frame [channel][chirp][sample].
+*  f_cfg       : Frame configuration.
+*  window      : n_samples range window, NULL for no window.
+*  remove_mean : Remove the mean of every chirp.
+*
+*******************************************************************************/
+void prepare_frame_u16(
+    const uint16_t *fifo, ifx_f32_t *frame, const frame_cfg *f_cfg,
+    const ifx_f32_t *window, bool remove_mean
+)
+{
+#if defined(ARM_MATH_HELIUM)
+    if ((f_cfg->n_samples % 4) == 0)
+    {
+        _prepare_frame_u16_mve(fifo, frame, f_cfg, window, remove_mean);
+        return;
+    }
+#endif
+    prepare_frame_u16_ref(fifo, frame, f_cfg, window, remove_mean);
+}
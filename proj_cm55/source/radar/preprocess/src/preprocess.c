@@ -89,20 +89,93 @@ _Complex float  __divsc3(float a, float b, float c, float d) {
 #endif
 
 
+/* FFT plan cache: one instance per power-of-two length from 16 to 4096,
+*  initialized on first use and reused by every later transform. */
+#define FFT_PLAN_MIN_LOG2 (4u)
+#define FFT_PLAN_MAX_LOG2 (12u)
+#define FFT_PLAN_SLOTS (FFT_PLAN_MAX_LOG2 - FFT_PLAN_MIN_LOG2 + 1u)
+
+static arm_rfft_fast_instance_f32 rfft_plans[FFT_PLAN_SLOTS];
+static arm_cfft_instance_f32 cfft_plans[FFT_PLAN_SLOTS];
+static bool rfft_plan_ready[FFT_PLAN_SLOTS];
+static bool cfft_plan_ready[FFT_PLAN_SLOTS];
+
+/* Cache slot of an FFT length, aborts if the length is not supported */
+static uint16_t _fft_plan_slot(uint16_t n_samples)
+{
+    for (uint16_t log2n = FFT_PLAN_MIN_LOG2; log2n <= FFT_PLAN_MAX_LOG2; ++log2n)
+    {
+        if (n_samples == (1u << log2n))
+        {
+            return log2n - FFT_PLAN_MIN_LOG2;
+        }
+    }
+    abort();
+}
+
+static const arm_rfft_fast_instance_f32 *_get_rfft_plan(uint16_t n_samples)
+{
+    uint16_t slot = _fft_plan_slot(n_samples);
+    if (!rfft_plan_ready[slot])
+    {
+        if (arm_rfft_fast_init_f32(&rfft_plans[slot], n_samples) != ARM_MATH_SUCCESS)
+        {
+            abort();
+        }
+        rfft_plan_ready[slot] = true;
+    }
+    return &rfft_plans[slot];
+}
+
+static const arm_cfft_instance_f32 *_get_cfft_plan(uint16_t n_samples)
+{
+    uint16_t slot = _fft_plan_slot(n_samples);
+    if (!cfft_plan_ready[slot])
+    {
+        if (arm_cfft_init_f32(&cfft_plans[slot], n_samples) != ARM_MATH_SUCCESS)
+        {
+            abort();
+        }
+        cfft_plan_ready[slot] = true;
+    }
+    return &cfft_plans[slot];
+}
+
+/*******************************************************************************
+* Function Name: init_preproc_tables
+********************************************************************************
+* Summary:
+* Builds the FFT instances and normalized windows used for frames of the
+* given configuration, so that none of this setup happens while processing
+* frames. Called by `new_preproc_work_arrays()` and `init_algo_workspace()`.
+* The tables are shared by all users and are not thread safe to build; call
+* this before starting concurrent processing.
+*
+* Parameters:
+*  f_cfg  : Frame configuration.
+*
+*******************************************************************************/
+void init_preproc_tables(const frame_cfg *f_cfg)
+{
+    (void)_get_rfft_plan(f_cfg->n_samples);
+    (void)_get_cfft_plan(f_cfg->n_chirps);
+    (void)get_normalized_window(&WINDOWS.hann, f_cfg->n_samples);
+    if (f_cfg->n_chirps >= 16)
+    {
+        (void)get_normalized_window(&WINDOWS.kaiser_b25, f_cfg->n_chirps);
+    }
+}
+
 void rfft_f32(ifx_f32_t *x, ifx_cf64_t *out, uint16_t n_samples)
 {
     /* Real FFT. Input and output are different buffers. */ 
-    arm_rfft_fast_instance_f32 rfft = {0};
-    arm_rfft_fast_init_f32(&rfft, n_samples);
-    arm_rfft_fast_f32(&rfft, (float32_t *)x, (float32_t *)out, 0);
+    arm_rfft_fast_f32(_get_rfft_plan(n_samples), (float32_t *)x, (float32_t *)out, 0);
 }
 
 void cfft_f32(ifx_cf64_t *x, uint16_t n_samples)
 {
     // Complex FFT. Inplace
-    arm_cfft_instance_f32 cfft = {0};
-    arm_cfft_init_f32(&cfft, n_samples);
-    arm_cfft_f32(&cfft, (float32_t *)x, 0, 1);
+    arm_cfft_f32(_get_cfft_plan(n_samples), (float32_t *)x, 0, 1);
 }
 
 /*******************************************************************************
@@ -131,20 +204,64 @@ void fftshift_cf64(ifx_cf64_t *in, uint32_t len)
     }
 }
 
+/* Subtracts the clutter map from the range bins in [start, end) of one
+*  spectrum and adds the residuals to the slow-time sums */
+static void _subtract_clutter(
+    ifx_cf64_t *x, const ifx_cf64_t *map, ifx_cf64_t *sum, uint16_t start,
+    uint16_t end
+)
+{
+    /* Complex elements as interleaved float pairs */
+    uint32_t n_el = 2u * (uint32_t)(end - start);
+    float32_t *y = (float32_t *)(x + start);
+    float32_t *s = (float32_t *)(sum + start);
+    arm_sub_f32(y, (const float32_t *)(map + start), y, n_el);
+    arm_add_f32(s, y, s, n_el);
+}
+
+/*******************************************************************************
+* Function Name: range_transform
+********************************************************************************
+* Summary:
+* Range FFT of every chirp, same as `ifx_range_fft_f32()` but using the cached
+* FFT instance. Mean removal and windowing are done in place on `x`. The
+* Nyquist bin, packed into the imaginary part of the DC bin, is zeroed.
+* With `cfg->clutter_map`, the map is subtracted from each spectrum while it
+* is still in the cache.
+*
+* Parameters:
+*  x   : n_chirps * n_samples real samples.
+*  out : n_chirps * n_samples / 2 range bins.
+*  cfg : Transform configuration, `window` may be NULL.
+*
+*******************************************************************************/
 void range_transform(ifx_f32_t *x, ifx_cf64_t *out, range_transform_cfg *cfg)
 {
-    uint32_t status = ifx_range_fft_f32(
-                          (float32_t *)x, (cfloat32_t *)out, cfg->remove_mean,
-                          (float32_t *)cfg->window, cfg->n_samples, cfg->n_chirps
-                      );
-    if (status == IFX_SENSOR_DSP_ARGUMENT_ERROR)
-    {
-        abort();
-    }
+    const arm_rfft_fast_instance_f32 *rfft = _get_rfft_plan(cfg->n_samples);
 
     for (int chirp = 0; chirp < cfg->n_chirps; chirp++)
     {
-        ((ifx_cf64_t *)out + (chirp * cfg->n_samples / 2))->data[1] = 0.0;
+        float32_t *x_chirp = (float32_t *)x + (chirp * cfg->n_samples);
+        ifx_cf64_t *out_chirp = out + (chirp * cfg->n_samples / 2);
+        if (cfg->remove_mean)
+        {
+            float32_t mean;
+            arm_mean_f32(x_chirp, cfg->n_samples, &mean);
+            arm_offset_f32(x_chirp, -mean, x_chirp, cfg->n_samples);
+        }
+        if (cfg->window != NULL)
+        {
+            arm_mult_f32(x_chirp, (float32_t *)cfg->window, x_chirp, cfg->n_samples);
+        }
+        arm_rfft_fast_f32(rfft, x_chirp, (float32_t *)out_chirp, 0);
+        out_chirp->data[1] = 0.0;
+        if (cfg->clutter_map != NULL)
+        {
+            _subtract_clutter(
+                out_chirp, cfg->clutter_map, cfg->clutter_sum, cfg->clutter_start,
+                cfg->clutter_end
+            );
+        }
     }
 }
 
@@ -152,8 +269,15 @@ void range_doppler_transform(
     ifx_f32_t *x, ifx_cf64_t *out, range_doppler_transform_cfg *cfg
 )
 {
-    cfloat32_t* range_array = (cfloat32_t*)malloc(sizeof(cfloat32_t) * (cfg->n_chirps * cfg->n_samples / 2));
-    cfloat32_t* doppler_array = (cfloat32_t*)malloc(sizeof(cfloat32_t) * (cfg->n_chirps * cfg->n_samples / 2));
+    /* Use the caller's scratch arrays if provided, allocate otherwise */
+    bool own_scratch = (cfg->range_scratch == NULL) || (cfg->doppler_scratch == NULL);
+    cfloat32_t* range_array = (cfloat32_t*)cfg->range_scratch;
+    cfloat32_t* doppler_array = (cfloat32_t*)cfg->doppler_scratch;
+    if (own_scratch)
+    {
+        range_array = (cfloat32_t*)malloc(sizeof(cfloat32_t) * (cfg->n_chirps * cfg->n_samples / 2));
+        doppler_array = (cfloat32_t*)malloc(sizeof(cfloat32_t) * (cfg->n_chirps * cfg->n_samples / 2));
+    }
 
     range_transform_cfg range_cfg = {
         .n_samples = cfg->n_samples,
@@ -183,8 +307,11 @@ void range_doppler_transform(
     (void)arm_mat_cmplx_trans_f32(&doppler_matrix, &out_matrix);
     fftshift_cf64((ifx_cf64_t *)out, cfg->n_chirps * cfg->n_samples / 2);
 
-    free(range_array);
-    free(doppler_array);
+    if (own_scratch)
+    {
+        free(range_array);
+        free(doppler_array);
+    }
 }
 
 void build_complex_range_image(
@@ -201,7 +328,7 @@ void build_complex_range_image(
         .window = window
     };
 
-    uint16_t frame_size = f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_samples;
+    uint32_t frame_size = (uint32_t)f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_samples;
     arm_scale_f32(
         (float32_t *)raw_frame, 1.0 / (float32_t)ADC_NORMALIZATION,
         (float32_t *)raw_frame, frame_size
@@ -215,17 +342,186 @@ void build_complex_range_image(
     }
 }
 
-void build_complex_rdi(
-    ifx_f32_t *raw_frame, ifx_cf64_t *out, frame_cfg *f_cfg
+/*******************************************************************************
+* Function Name: build_complex_range_image_prepared
+********************************************************************************
+* Summary:
+* Same as `build_complex_range_image()` for a frame that is already
+* normalized, mean-removed and windowed by `prepare_frame_u16()`. Only the
+* range FFTs are computed.
+*
+* Parameters:
+*  frame : Prepared frame [channel][chirp][sample], overwritten.
+*  out   : Range images [channel][chirp][range_bin].
+*  f_cfg : Frame configuration.
+*
+*******************************************************************************/
+void build_complex_range_image_prepared(
+    ifx_f32_t *frame, ifx_cf64_t *out, frame_cfg *f_cfg
+)
+{
+    range_transform_cfg range_transf_cfg =
+    {
+        .n_chirps = f_cfg->n_chirps,
+        .n_samples = f_cfg->n_samples,
+        .remove_mean = false,
+        .window = NULL
+    };
+
+    for (int ch = 0; ch < f_cfg->n_channels; ++ch)
+    {
+        range_transform(
+            frame + ch * f_cfg->n_chirps * f_cfg->n_samples,
+            out + ch * f_cfg->n_chirps * f_cfg->n_range_bins, &range_transf_cfg
+        );
+    }
+}
+
+/* Moves the clutter map of one channel towards the slow-time mean of the
+*  frame, for the range bins in [start, end), from the residual sums. The
+*  residuals of the range bins that are not seeded were taken against a zero
+*  map: these are seeded with the slow-time mean and their residuals are
+*  taken again. */
+static void _update_clutter_channel(
+    ifx_cf64_t *img, ifx_cf64_t *map, ifx_cf64_t *sum, const clutter_map *clutter,
+    uint16_t n_chirps, uint16_t n_range_bins, uint16_t start, uint16_t end
+)
+{
+    float32_t update_scale = clutter->alpha / (float32_t)n_chirps;
+    uint16_t run_start = start;
+    while (run_start < end)
+    {
+        bool seeded = clutter->seeded[run_start];
+        uint16_t run_end = run_start + 1;
+        while ((run_end < end) && (clutter->seeded[run_end] == seeded))
+        {
+            ++run_end;
+        }
+        uint32_t n_el = 2u * (uint32_t)(run_end - run_start);
+        float32_t *m = (float32_t *)(map + run_start);
+        float32_t *s = (float32_t *)(sum + run_start);
+        if (!seeded)
+        {
+            arm_scale_f32(s, 1.0f / (float32_t)n_chirps, m, n_el);
+            memset(s, 0, sizeof(float32_t) * n_el);
+            for (int chirp = 0; chirp < n_chirps; ++chirp)
+            {
+                for (int bin = run_start; bin < run_end; ++bin)
+                {
+                    ifx_cf64_t *x = img + chirp * n_range_bins + bin;
+                    x->data[0] -= map[bin].data[0];
+                    x->data[1] -= map[bin].data[1];
+                    sum[bin].data[0] += x->data[0];
+                    sum[bin].data[1] += x->data[1];
+                }
+            }
+        }
+        /* map + alpha * mean(x - map) = (1 - alpha) * map + alpha * mean(x) */
+        arm_scale_f32(s, update_scale, s, n_el);
+        arm_add_f32(m, s, m, n_el);
+        run_start = run_end;
+    }
+}
+
+/* Marks the range bins in [start, end) as seeded and drops the others from
+*  the map, so that a range bin that comes back is seeded again instead of
+*  being subtracted with an outdated map */
+static void _mark_clutter_seeded(
+    clutter_map *clutter, uint16_t start, uint16_t end
+)
+{
+    for (uint16_t bin = 0; bin < clutter->n_range_bins; ++bin)
+    {
+        if ((bin >= start) && (bin < end))
+        {
+            clutter->seeded[bin] = true;
+        }
+        else if (clutter->seeded[bin])
+        {
+            clutter->seeded[bin] = false;
+            for (uint16_t ch = 0; ch < clutter->n_channels; ++ch)
+            {
+                memset(&clutter->map[ch * clutter->n_range_bins + bin], 0, sizeof(ifx_cf64_t));
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: build_complex_range_image_clutter
+********************************************************************************
+* Summary:
+* Same as `build_complex_range_image()`, or as
+* `build_complex_range_image_prepared()` with `prepared`, followed by
+* `remove_clutter_3d_cf64()` for the range bins in [range_start, range_end),
+* with the same results. The map is subtracted from each spectrum as it comes
+* out of the range FFT instead of in a separate pass over the images; only
+* the map update and the seeding of new range bins are done afterwards.
+*
+* Parameters:
+*  frame       : Raw frame, or prepared frame with `prepared`, overwritten.
+*  out         : Range images [channel][chirp][range_bin].
+*  f_cfg       : Frame configuration.
+*  window      : Range window, not used with `prepared`.
+*  prepared    : The frame comes from `prepare_frame_u16()`.
+*  clutter     : Clutter map of the same n_channels and n_range_bins.
+*  range_start : First range bin.
+*  range_end   : Range bin after the last one.
+*
+*******************************************************************************/
+void build_complex_range_image_clutter(
+    ifx_f32_t *frame, ifx_cf64_t *out, frame_cfg *f_cfg, ifx_f32_t *window,
+    bool prepared, clutter_map *clutter, uint16_t range_start,
+    uint16_t range_end
+)
+{
+    range_transform_cfg range_transf_cfg =
+    {
+        .n_chirps = f_cfg->n_chirps,
+        .n_samples = f_cfg->n_samples,
+        .remove_mean = !prepared,
+        .window = prepared ? NULL : window,
+        .clutter_sum = clutter->residual_sum,
+        .clutter_start = range_start,
+        .clutter_end = range_end
+    };
+
+    if (!prepared)
+    {
+        uint32_t frame_size = (uint32_t)f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_samples;
+        arm_scale_f32(
+            (float32_t *)frame, 1.0 / (float32_t)ADC_NORMALIZATION,
+            (float32_t *)frame, frame_size
+        );
+    }
+
+    for (int ch = 0; ch < f_cfg->n_channels; ++ch)
+    {
+        ifx_cf64_t *img = out + ch * f_cfg->n_chirps * f_cfg->n_range_bins;
+        range_transf_cfg.clutter_map = clutter->map + ch * f_cfg->n_range_bins;
+        memset(
+            clutter->residual_sum + range_start, 0,
+            sizeof(ifx_cf64_t) * (range_end - range_start)
+        );
+        range_transform(
+            frame + ch * f_cfg->n_chirps * f_cfg->n_samples, img, &range_transf_cfg
+        );
+        _update_clutter_channel(
+            img, range_transf_cfg.clutter_map, clutter->residual_sum, clutter,
+            f_cfg->n_chirps, f_cfg->n_range_bins, range_start, range_end
+        );
+    }
+    _mark_clutter_seeded(clutter, range_start, range_end);
+}
+
+static void _build_complex_rdi(
+    ifx_f32_t *raw_frame, ifx_cf64_t *out, frame_cfg *f_cfg,
+    ifx_f32_t *range_window, ifx_f32_t *doppler_window,
+    ifx_cf64_t *range_scratch, ifx_cf64_t *doppler_scratch
 )
 {
     uint16_t src_idx = 0;
     uint16_t dst_idx = 0;
-    ifx_f32_t *range_window = (ifx_f32_t*) malloc(sizeof(ifx_f32_t) * f_cfg->n_samples);
-    get_window(&WINDOWS.hann, range_window, f_cfg->n_samples);
-    ifx_f32_t *doppler_window = (ifx_f32_t*) malloc(sizeof(ifx_f32_t) * f_cfg->n_chirps);
-    get_window(&WINDOWS.kaiser_b25, doppler_window, f_cfg->n_chirps);
-    
     range_doppler_transform_cfg rd_cfg =
     {
         .n_chirps = f_cfg->n_chirps,
@@ -233,9 +529,11 @@ void build_complex_rdi(
         .range_remove_mean = true,
         .doppler_remove_mean = true,
         .range_window = range_window,
-        .doppler_window = doppler_window
+        .doppler_window = doppler_window,
+        .range_scratch = range_scratch,
+        .doppler_scratch = doppler_scratch
     };
-    uint16_t frame_size = f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_samples;
+    uint32_t frame_size = (uint32_t)f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_samples;
     arm_scale_f32(
         (float32_t *)raw_frame, 1.0 / (float32_t)ADC_NORMALIZATION,
         (float32_t *)raw_frame, frame_size
@@ -247,9 +545,16 @@ void build_complex_rdi(
         src_idx += f_cfg->n_chirps * f_cfg->n_samples;
         dst_idx += f_cfg->n_chirps * f_cfg->n_range_bins;
     }
+}
 
-    free(range_window);
-    free(doppler_window);
+void build_complex_rdi(
+    ifx_f32_t *raw_frame, ifx_cf64_t *out, frame_cfg *f_cfg
+)
+{
+    _build_complex_rdi(
+        raw_frame, out, f_cfg, get_normalized_window(&WINDOWS.hann, f_cfg->n_samples),
+        get_normalized_window(&WINDOWS.kaiser_b25, f_cfg->n_chirps), NULL, NULL
+    );
 }
 
 void estimate_human(
@@ -434,58 +739,277 @@ void mask_hand_roi(
     }
 }
 
-int compare_ifx_f32(const void *a, const void *b)
+/* Rearranges `x` so that `x[k]` is the k-th smallest of the `n` elements,
+*  with no larger element before it and no smaller element after it. */
+static void _select_f32(ifx_f32_t *x, int32_t n, int32_t k)
 {
-    if (*(ifx_f32_t *)a > *(ifx_f32_t *)b)
-        return 1;
-    if (*(ifx_f32_t *)a < *(ifx_f32_t *)b)
-        return -1;
-    return 0;
-};
+    int32_t lo = 0;
+    int32_t hi = n - 1;
+    while (lo < hi)
+    {
+        /* Median of three pivot, keeps sorted and constant inputs linear */
+        int32_t mid = lo + (hi - lo) / 2;
+        ifx_f32_t a = x[lo];
+        ifx_f32_t b = x[mid];
+        ifx_f32_t c = x[hi];
+        ifx_f32_t pivot = (a < b) ? ((b < c) ? b : ((a < c) ? c : a))
+                                  : ((a < c) ? a : ((b < c) ? c : b));
+        int32_t i = lo;
+        int32_t j = hi;
+        while (i <= j)
+        {
+            while (x[i] < pivot)
+            {
+                i++;
+            }
+            while (x[j] > pivot)
+            {
+                j--;
+            }
+            if (i <= j)
+            {
+                ifx_f32_t t = x[i];
+                x[i] = x[j];
+                x[j] = t;
+                i++;
+                j--;
+            }
+        }
+        /* x[lo..j] <= pivot, x[i..hi] >= pivot, anything between equals it */
+        if (k <= j)
+        {
+            hi = j;
+        }
+        else if (k >= i)
+        {
+            lo = i;
+        }
+        else
+        {
+            return;
+        }
+    }
+}
 
-float get_background_level(
-    const ifx_f32_t *masked_mean_abs_rdi, const frame_cfg *f_cfg
+/* Exact median of the positive elements, compacted into `tmp` which must fit
+*  n_chirps * n_range_bins elements. Same result as sorting the elements. */
+static float _get_background_level(
+    const ifx_f32_t *masked_mean_abs_rdi, const frame_cfg *f_cfg, ifx_f32_t *tmp
 )
 {
-    /* Compute median of positive (non-zero in an absolute rdi) elements in the
-    * region of interest. */
-    int len = f_cfg->n_chirps * f_cfg->n_range_bins;
-    ifx_f32_t* tmp = (ifx_f32_t*)malloc(sizeof(ifx_f32_t) * len);
-    memcpy(tmp, masked_mean_abs_rdi, len * sizeof(ifx_f32_t));
-    qsort((void *)tmp, len, sizeof(ifx_f32_t), compare_ifx_f32);
-    /* Find index of first element greater than 0.0 */
-    int idx;
-    for (idx = 0; idx < len; ++idx)
+    int32_t len = f_cfg->n_chirps * f_cfg->n_range_bins;
+    int32_t n_nonzero = 0;
+    for (int32_t i = 0; i < len; ++i)
     {
-        if (tmp[idx] > 0.0)
+        if (masked_mean_abs_rdi[i] > 0.0f)
         {
-            break;
+            tmp[n_nonzero++] = masked_mean_abs_rdi[i];
         }
     }
-    if (idx == len)
+    if (n_nonzero == 0)
     {
-        free(tmp);
         /* No elements greater than 0.0 => return background_level == 0.0 */
         return 0.0;
     }
-    /* Median of non-zero elements */
-    int n_nonzero = len - idx;
+    int32_t k = n_nonzero / 2;
+    _select_f32(tmp, n_nonzero, k);
     if (n_nonzero % 2 == 0)
     {
-        float ret = (tmp[idx + n_nonzero / 2 - 1] + tmp[idx + n_nonzero / 2]) / 2;
-        
-        free(tmp);
+        /* The other middle element is the largest one before x[k] */
+        ifx_f32_t lower = tmp[0];
+        for (int32_t i = 1; i < k; ++i)
+        {
+            lower = (tmp[i] > lower) ? tmp[i] : lower;
+        }
+        return (lower + tmp[k]) / 2;
+    }
+    return tmp[k];
+}
+
+/* Order preserving integer key of a positive float */
+static inline uint32_t _f32_key(ifx_f32_t v)
+{
+    uint32_t key;
+    memcpy(&key, &v, sizeof(key));
+    return key;
+}
+
+static inline ifx_f32_t _f32_from_key(uint32_t key)
+{
+    ifx_f32_t v;
+    memcpy(&v, &key, sizeof(v));
+    return v;
+}
+
+/* Approximate median of the positive elements. The histogram spans the
+*  float bit patterns between the smallest and the largest element, so the
+*  bins are roughly logarithmic in value. The median is interpolated within
+*  its bin. */
+static float _get_background_level_histogram(
+    const ifx_f32_t *masked_mean_abs_rdi, const frame_cfg *f_cfg,
+    uint32_t *histogram
+)
+{
+    uint32_t len = (uint32_t)f_cfg->n_chirps * f_cfg->n_range_bins;
+    uint32_t key_min = UINT32_MAX;
+    uint32_t key_max = 0;
+    uint32_t n_nonzero = 0;
+    for (uint32_t i = 0; i < len; ++i)
+    {
+        if (masked_mean_abs_rdi[i] > 0.0f)
+        {
+            uint32_t key = _f32_key(masked_mean_abs_rdi[i]);
+            key_min = (key < key_min) ? key : key_min;
+            key_max = (key > key_max) ? key : key_max;
+            n_nonzero++;
+        }
+    }
+    if (n_nonzero == 0)
+    {
+        return 0.0;
+    }
+    if (key_min == key_max)
+    {
+        return _f32_from_key(key_min);
+    }
 
-        return ret;
+    uint64_t span = (uint64_t)(key_max - key_min) + 1u;
+    memset(histogram, 0, sizeof(uint32_t) * BG_LEVEL_HISTOGRAM_BINS);
+    for (uint32_t i = 0; i < len; ++i)
+    {
+        if (masked_mean_abs_rdi[i] > 0.0f)
+        {
+            uint64_t offset = _f32_key(masked_mean_abs_rdi[i]) - key_min;
+            histogram[(offset * BG_LEVEL_HISTOGRAM_BINS) / span]++;
+        }
     }
 
-    float ret_val = tmp[idx + n_nonzero / 2];
+    /* Fractional rank of the median, between the two middle elements when
+    *  the count is even */
+    float rank = 0.5f * (float)(n_nonzero - 1u);
+    uint32_t below = 0;
+    uint32_t bin = 0;
+    while ((bin < BG_LEVEL_HISTOGRAM_BINS - 1u) &&
+            ((float)(below + histogram[bin]) <= rank))
+    {
+        below += histogram[bin];
+        bin++;
+    }
+    float pos = ((float)bin + (rank - (float)below + 0.5f) / (float)histogram[bin]) /
+                (float)BG_LEVEL_HISTOGRAM_BINS;
+    uint32_t key = key_min + (uint32_t)(pos * (float)span);
+    key = (key > key_max) ? key_max : key;
+    return _f32_from_key(key);
+}
 
-    free(tmp);
+/* Moves the tracked median towards the positive elements by at most `rate`
+*  of its value: up when more elements lie above it, down when more lie
+*  below. One comparison per element and no writes. */
+static float _get_background_level_streaming(
+    const ifx_f32_t *masked_mean_abs_rdi, const frame_cfg *f_cfg,
+    bg_level_estimator *est, ifx_f32_t *tmp
+)
+{
+    if (est->level <= 0.0f)
+    {
+        est->level = _get_background_level(masked_mean_abs_rdi, f_cfg, tmp);
+        return est->level;
+    }
+    uint32_t len = (uint32_t)f_cfg->n_chirps * f_cfg->n_range_bins;
+    int32_t n_nonzero = 0;
+    int32_t above = 0;
+    int32_t below = 0;
+    for (uint32_t i = 0; i < len; ++i)
+    {
+        ifx_f32_t v = masked_mean_abs_rdi[i];
+        n_nonzero += (v > 0.0f);
+        above += (v > est->level);
+        below += (v > 0.0f) && (v < est->level);
+    }
+    if (n_nonzero == 0)
+    {
+        /* Keep the level for the next frame with background */
+        return 0.0;
+    }
+    est->level *= 1.0f + est->rate * (float)(above - below) / (float)n_nonzero;
+    return est->level;
+}
 
+float get_background_level(
+    const ifx_f32_t *masked_mean_abs_rdi, const frame_cfg *f_cfg
+)
+{
+    int len = f_cfg->n_chirps * f_cfg->n_range_bins;
+    ifx_f32_t* tmp = (ifx_f32_t*)malloc(sizeof(ifx_f32_t) * len);
+    float ret_val = _get_background_level(masked_mean_abs_rdi, f_cfg, tmp);
+    free(tmp);
     return ret_val;
 }
 
+/*******************************************************************************
+* Function Name: init_bg_level_estimator
+********************************************************************************
+* Summary:
+* Selects the background level estimator and clears the level carried across
+* frames.
+*
+* Parameters:
+*  est       : Estimator to initialize.
+*  mode      : Estimator, see `bg_level_mode`.
+*  histogram : `BG_LEVEL_HISTOGRAM_BINS` counts, only used by
+*              `BG_LEVEL_HISTOGRAM`.
+*
+*******************************************************************************/
+void init_bg_level_estimator(
+    bg_level_estimator *est, bg_level_mode mode, uint32_t *histogram
+)
+{
+    est->mode = mode;
+    est->level = 0.0f;
+    est->rate = BG_LEVEL_STREAMING_RATE;
+    est->histogram = histogram;
+}
+
+/*******************************************************************************
+* Function Name: estimate_background_level
+********************************************************************************
+* Summary:
+* Background level of the masked mean RDI, the median of its positive cells,
+* in linear time and without heap allocation:
+*  - `BG_LEVEL_EXACT`: quickselect, bit-identical to sorting the cells.
+*  - `BG_LEVEL_HISTOGRAM`: two passes over the cells, no writes to `scratch`.
+*  - `BG_LEVEL_STREAMING`: one pass, moves the level of the previous frame
+*    towards the median of this one. Follows a slowly changing background
+*    and smooths it across frames.
+*
+* Parameters:
+*  masked_mean_abs_rdi : n_chirps * n_range_bins cells, 0.0 outside the
+*                        region of interest.
+*  f_cfg               : Frame configuration.
+*  est                 : Estimator, see `init_bg_level_estimator()`.
+*  scratch             : n_chirps * n_range_bins elements.
+*
+* Return:
+* Background level, 0.0 if no cell is positive.
+*
+*******************************************************************************/
+float estimate_background_level(
+    const ifx_f32_t *masked_mean_abs_rdi, const frame_cfg *f_cfg,
+    bg_level_estimator *est, ifx_f32_t *scratch
+)
+{
+    switch (est->mode)
+    {
+        case BG_LEVEL_HISTOGRAM:
+            return _get_background_level_histogram(masked_mean_abs_rdi, f_cfg, est->histogram);
+        case BG_LEVEL_STREAMING:
+            return _get_background_level_streaming(masked_mean_abs_rdi, f_cfg, est, scratch);
+        case BG_LEVEL_EXACT:
+        default:
+            return _get_background_level(masked_mean_abs_rdi, f_cfg, scratch);
+    }
+}
+
 void make_doppler_profile(
     const ifx_f32_t *mean_abs_rdi, ifx_f32_t *profile,
     const region *search_region, const frame_cfg *f_cfg
@@ -511,94 +1035,152 @@ void make_doppler_profile(
     );
 }
 
-typedef struct
+/* Peak `a` ranks before peak `b`: the larger value first, equal values by
+*  the higher index */
+static inline bool _peak_before(const ifx_f32_t *in, uint16_t a, uint16_t b)
 {
-    void *el;
-    uint16_t idx;
-} argsort_tuple;
+    return (in[a] > in[b]) || ((in[a] == in[b]) && (a > b));
+}
 
-int compare_argsort_tuples_ifx_f32_t(const void *a, const void *b)
+/* Restores the heap below `heap[i]`, with the weakest peak at the root */
+static void _peak_heap_sift_down(
+    const ifx_f32_t *in, uint16_t *heap, uint16_t n, uint16_t i
+)
 {
-    ifx_f32_t aa = *((ifx_f32_t *)(((argsort_tuple *)a)->el));
-    ifx_f32_t bb = *((ifx_f32_t *)(((argsort_tuple *)b)->el));
-    if (aa > bb)
+    for (;;)
     {
-        return 1;
-    }
-    if (aa < bb)
-    {
-        return -1;
+        uint16_t weakest = i;
+        uint16_t left = 2 * i + 1;
+        uint16_t right = left + 1;
+        if ((left < n) && _peak_before(in, heap[weakest], heap[left]))
+        {
+            weakest = left;
+        }
+        if ((right < n) && _peak_before(in, heap[weakest], heap[right]))
+        {
+            weakest = right;
+        }
+        if (weakest == i)
+        {
+            return;
+        }
+        uint16_t t = heap[i];
+        heap[i] = heap[weakest];
+        heap[weakest] = t;
+        i = weakest;
     }
-    return 0;
 }
 
+/*******************************************************************************
+* Function Name: find_peaks
+********************************************************************************
+* Summary:
+* Indices of the `n_peaks` largest elements, largest first. Keeps a heap of
+* the largest elements seen so far in `idx` itself, so it needs no scratch
+* and takes O(n_elements * log(n_peaks)).
+*
+* Parameters:
+*  in         : n_elements values.
+*  idx        : n_peaks indices, output.
+*  n_elements : Number of values, at least n_peaks.
+*  n_peaks    : Number of indices to find.
+*
+*******************************************************************************/
 void find_peaks(
     const ifx_f32_t *in, uint16_t *idx, uint16_t n_elements, uint16_t n_peaks
 )
 {
-    /* `idx` array must be preallocated to fit `n_peaks` indices */
-
-    argsort_tuple* indexed = (argsort_tuple*)malloc(sizeof(argsort_tuple) * n_elements);
-    
-    for (int i = 0; i < n_elements; ++i)
+    if (n_peaks == 0)
     {
-        indexed[i].el = (void *)(in + i);
-        indexed[i].idx = i;
+        return;
     }
-    qsort(
-        indexed, n_elements, sizeof(argsort_tuple), compare_argsort_tuples_ifx_f32_t
-    );
-    for (int i = 0; i < n_peaks; ++i)
+    for (uint16_t i = 0; i < n_peaks; ++i)
     {
-        idx[i] = indexed[n_elements - i - 1].idx;
+        idx[i] = i;
+    }
+    for (uint16_t i = n_peaks / 2; i-- > 0;)
+    {
+        _peak_heap_sift_down(in, idx, n_peaks, i);
+    }
+    for (uint16_t i = n_peaks; i < n_elements; ++i)
+    {
+        if (_peak_before(in, i, idx[0]))
+        {
+            idx[0] = i;
+            _peak_heap_sift_down(in, idx, n_peaks, 0);
+        }
+    }
+    /* Moving the weakest peak to the back leaves the largest first */
+    for (uint16_t n = n_peaks - 1; n > 0; --n)
+    {
+        uint16_t t = idx[0];
+        idx[0] = idx[n];
+        idx[n] = t;
+        _peak_heap_sift_down(in, idx, n, 0);
     }
-
-    free(indexed);
 }
 
+/*******************************************************************************
+* Function Name: cluster_peaks
+********************************************************************************
+* Summary:
+* Groups peaks in adjacent Doppler bins. The peaks are taken strongest first:
+* a peak next to an already clustered peak joins the first founded of their
+* clusters, otherwise it founds the cluster at its own index. A founded
+* cluster starts with its founding peak, the others are empty.
+* The cluster of every Doppler bin is kept in `bin_clusters`, so each peak is
+* clustered in constant time.
+*
+* Parameters:
+*  peaks            : n_peaks Doppler bins, strongest first, see `find_peaks()`.
+*  clusters         : n_peaks clusters, output.
+*  n_peaks          : Number of peaks.
+*  cluster_elements : n_peaks elements, shared by the clusters.
+*  bin_clusters     : n_elements scratch.
+*  n_elements       : Number of Doppler bins.
+*
+*******************************************************************************/
 void cluster_peaks(
-    const uint16_t *peaks, peak_cluster *clusters, uint16_t n_peaks
+    const uint16_t *peaks, peak_cluster *clusters, uint16_t n_peaks,
+    uint16_t *cluster_elements, uint16_t *bin_clusters, uint16_t n_elements
 )
 {
-    for (int i = 0; i < n_peaks; ++i)
+    memset(bin_clusters, 0xFF, sizeof(uint16_t) * n_elements);
+    for (uint16_t i = 0; i < n_peaks; ++i)
     {
         clusters[i].n_elements = 0;
     }
 
-    bool peak_assigned;
-    uint16_t el;
-    uint16_t n_el;
-
-    for (int peak_idx = 0; peak_idx < n_peaks; ++peak_idx)
+    /* Cluster of every peak and the size of every cluster */
+    for (uint16_t i = 0; i < n_peaks; ++i)
     {
-        peak_assigned = false;
-        for (int cluster_idx = 0; cluster_idx < n_peaks; ++cluster_idx)
+        uint16_t bin = peaks[i];
+        uint16_t cluster = i;
+        if ((bin > 0) && (bin_clusters[bin - 1] < cluster))
         {
-            for (int el_idx = 0; el_idx < clusters[cluster_idx].n_elements;
-                    ++el_idx)
-                {
-                el = clusters[cluster_idx].elements[el_idx];
-                if (peaks[peak_idx] - el != 1 && peaks[peak_idx] - el != -1)
-                {
-                    continue; /* check the next element in the cluster */
-                }
-                n_el = clusters[cluster_idx].n_elements;
-                clusters[cluster_idx].elements[n_el] = peaks[peak_idx];
-                clusters[cluster_idx].n_elements += 1;
-                peak_assigned = true;
-                break; /* stop checking elements of the cluster */
-            }
-            if (peak_assigned)
-            {
-                break; /* stop checking other clusters */
-            }
+            cluster = bin_clusters[bin - 1];
         }
-        if (!peak_assigned)
+        if ((bin + 1 < n_elements) && (bin_clusters[bin + 1] < cluster))
         {
-            /* Peak was not assigned to any cluster => initialize a new cluster. */
-            clusters[peak_idx].elements[0] = peaks[peak_idx];
-            clusters[peak_idx].n_elements = 1;
+            cluster = bin_clusters[bin + 1];
         }
+        bin_clusters[bin] = cluster;
+        clusters[cluster].n_elements += 1;
+    }
+
+    /* Pack the elements of the clusters, in the order they joined */
+    uint16_t offset = 0;
+    for (uint16_t i = 0; i < n_peaks; ++i)
+    {
+        clusters[i].elements = cluster_elements + offset;
+        offset += clusters[i].n_elements;
+        clusters[i].n_elements = 0;
+    }
+    for (uint16_t i = 0; i < n_peaks; ++i)
+    {
+        peak_cluster *cluster = &clusters[bin_clusters[peaks[i]]];
+        cluster->elements[cluster->n_elements] = peaks[i];
+        cluster->n_elements += 1;
     }
 }
 
@@ -637,6 +1219,301 @@ uint16_t suggest_hand_detections(
             detections[n_detections].doppler_bin = doppler_bin;
             detections[n_detections].value =
                 masked_mean_abs_rdi[doppler_bin * f_cfg->n_range_bins + range_bin];
+            detections[n_detections].noise = 0.0f;
+            n_detections += 1;
+        }
+    }
+    return n_detections;
+}
+
+/* Scratch values needed by `estimate_cfar_noise()` */
+size_t cfar_scratch_len(const frame_cfg *f_cfg)
+{
+    return 4u * ((size_t)f_cfg->n_chirps + 1u) * f_cfg->n_range_bins;
+}
+
+/* Sums of every row of `in` and counts of its positive elements over the
+*  `half` elements on each side of every element, clipped at the row ends.
+*  A running sum: one element enters and one leaves the window per step. */
+static void _cfar_row_sums(
+    const ifx_f32_t *in, ifx_f32_t *sums, ifx_f32_t *counts, uint16_t n_rows,
+    uint16_t n_cols, uint16_t half
+)
+{
+    for (uint32_t row = 0; row < n_rows; ++row)
+    {
+        const ifx_f32_t *x = in + row * n_cols;
+        ifx_f32_t *s = sums + row * n_cols;
+        ifx_f32_t *n = counts + row * n_cols;
+        ifx_f32_t sum = 0.0f;
+        ifx_f32_t count = 0.0f;
+        for (int32_t col = 0; (col < n_cols) && (col <= half); ++col)
+        {
+            sum += x[col];
+            count += (x[col] > 0.0f) ? 1.0f : 0.0f;
+        }
+        for (int32_t col = 0; col < n_cols; ++col)
+        {
+            s[col] = sum;
+            n[col] = count;
+            int32_t enter = col + half + 1;
+            int32_t leave = col - half;
+            if (enter < n_cols)
+            {
+                sum += x[enter];
+                count += (x[enter] > 0.0f) ? 1.0f : 0.0f;
+            }
+            if (leave >= 0)
+            {
+                sum -= x[leave];
+                count -= (x[leave] > 0.0f) ? 1.0f : 0.0f;
+            }
+        }
+    }
+}
+
+/* Adds (sign > 0) or subtracts row `row` of `rows` to `acc` if it exists */
+static void _cfar_accumulate_row(
+    ifx_f32_t *acc, const ifx_f32_t *rows, int32_t row, uint16_t n_rows,
+    uint16_t n_cols, int sign
+)
+{
+    if ((row < 0) || (row >= n_rows))
+    {
+        return;
+    }
+    if (sign > 0)
+    {
+        arm_add_f32(acc, rows + row * n_cols, acc, n_cols);
+    }
+    else
+    {
+        arm_sub_f32(acc, rows + row * n_cols, acc, n_cols);
+    }
+}
+
+/* Cell-averaging noise of every cell. The row sums over the full and the
+*  guard window along range are summed along Doppler with running row
+*  vectors, so the cost does not depend on the window sizes and every step
+*  is a vector add or subtract. */
+static void _cfar_ca_noise(
+    const ifx_f32_t *in, ifx_f32_t *noise, uint16_t n_rows, uint16_t n_cols,
+    const cfar_cfg *cfg, ifx_f32_t *scratch
+)
+{
+    uint32_t len = (uint32_t)n_rows * n_cols;
+    ifx_f32_t *outer_sums = scratch;
+    ifx_f32_t *outer_counts = outer_sums + len;
+    ifx_f32_t *guard_sums = outer_counts + len;
+    ifx_f32_t *guard_counts = guard_sums + len;
+    ifx_f32_t *acc_outer_sum = guard_counts + len;
+    ifx_f32_t *acc_outer_count = acc_outer_sum + n_cols;
+    ifx_f32_t *acc_guard_sum = acc_outer_count + n_cols;
+    ifx_f32_t *acc_guard_count = acc_guard_sum + n_cols;
+    int32_t outer_half = cfg->guard_doppler + cfg->train_doppler;
+    int32_t guard_half = cfg->guard_doppler;
+
+    _cfar_row_sums(in, outer_sums, outer_counts, n_rows, n_cols, cfg->guard_range + cfg->train_range);
+    _cfar_row_sums(in, guard_sums, guard_counts, n_rows, n_cols, cfg->guard_range);
+
+    arm_fill_f32(0.0f, acc_outer_sum, 4u * n_cols);
+    for (int32_t row = 0; row <= outer_half; ++row)
+    {
+        _cfar_accumulate_row(acc_outer_sum, outer_sums, row, n_rows, n_cols, 1);
+        _cfar_accumulate_row(acc_outer_count, outer_counts, row, n_rows, n_cols, 1);
+    }
+    for (int32_t row = 0; row <= guard_half; ++row)
+    {
+        _cfar_accumulate_row(acc_guard_sum, guard_sums, row, n_rows, n_cols, 1);
+        _cfar_accumulate_row(acc_guard_count, guard_counts, row, n_rows, n_cols, 1);
+    }
+    for (int32_t row = 0; row < n_rows; ++row)
+    {
+        ifx_f32_t *out = noise + row * n_cols;
+        for (uint32_t col = 0; col < n_cols; ++col)
+        {
+            ifx_f32_t count = acc_outer_count[col] - acc_guard_count[col];
+            out[col] = (count > 0.0f) ?
+                       (acc_outer_sum[col] - acc_guard_sum[col]) / count : 0.0f;
+        }
+        _cfar_accumulate_row(acc_outer_sum, outer_sums, row + outer_half + 1, n_rows, n_cols, 1);
+        _cfar_accumulate_row(acc_outer_count, outer_counts, row + outer_half + 1, n_rows, n_cols, 1);
+        _cfar_accumulate_row(acc_outer_sum, outer_sums, row - outer_half, n_rows, n_cols, -1);
+        _cfar_accumulate_row(acc_outer_count, outer_counts, row - outer_half, n_rows, n_cols, -1);
+        _cfar_accumulate_row(acc_guard_sum, guard_sums, row + guard_half + 1, n_rows, n_cols, 1);
+        _cfar_accumulate_row(acc_guard_count, guard_counts, row + guard_half + 1, n_rows, n_cols, 1);
+        _cfar_accumulate_row(acc_guard_sum, guard_sums, row - guard_half, n_rows, n_cols, -1);
+        _cfar_accumulate_row(acc_guard_count, guard_counts, row - guard_half, n_rows, n_cols, -1);
+    }
+}
+
+/* Inserts `v` into the ascending `window` of `*n` values if it is positive */
+static void _cfar_window_insert(ifx_f32_t *window, uint16_t *n, ifx_f32_t v)
+{
+    if (!(v > 0.0f))
+    {
+        return;
+    }
+    uint16_t i = *n;
+    while ((i > 0) && (window[i - 1] > v))
+    {
+        window[i] = window[i - 1];
+        --i;
+    }
+    window[i] = v;
+    *n += 1;
+}
+
+/* Removes one `v` from the ascending `window` of `*n` values if positive */
+static void _cfar_window_remove(ifx_f32_t *window, uint16_t *n, ifx_f32_t v)
+{
+    if (!(v > 0.0f))
+    {
+        return;
+    }
+    uint16_t i = 0;
+    while ((i < *n) && (window[i] != v))
+    {
+        ++i;
+    }
+    for (; i + 1 < *n; ++i)
+    {
+        window[i] = window[i + 1];
+    }
+    *n -= (i < *n) ? 1 : 0;
+}
+
+/* Ordered-statistic noise of the cells [first, end) of a line of `n` cells
+*  `stride` apart. The training cells are kept sorted in `window`; moving to
+*  the next cell takes two cells out of the window and two in. */
+static void _cfar_os_line(
+    const ifx_f32_t *x, ifx_f32_t *noise, uint32_t stride, int32_t n,
+    int32_t first, int32_t end, int32_t guard, int32_t train, uint8_t os_rank,
+    ifx_f32_t *window
+)
+{
+    uint16_t n_window = 0;
+    for (int32_t i = first - guard - train; i <= first + guard + train; ++i)
+    {
+        if ((i >= 0) && (i < n) && ((i < first - guard) || (i > first + guard)))
+        {
+            _cfar_window_insert(window, &n_window, x[i * stride]);
+        }
+    }
+    for (int32_t i = first; i < end; ++i)
+    {
+        uint32_t rank = ((uint32_t)n_window * os_rank) / 100u;
+        rank = (rank < n_window) ? rank : (uint32_t)n_window - 1u;
+        noise[i * stride] = (n_window > 0) ? window[rank] : 0.0f;
+        /* Slide the lagging and the leading training cells to i + 1 */
+        int32_t lag_out = i - guard - train;
+        int32_t lag_in = i - guard;
+        int32_t lead_out = i + guard + 1;
+        int32_t lead_in = i + guard + train + 1;
+        if (lag_out >= 0)
+        {
+            _cfar_window_remove(window, &n_window, x[lag_out * stride]);
+        }
+        if ((lag_in >= 0) && (lag_in < n))
+        {
+            _cfar_window_insert(window, &n_window, x[lag_in * stride]);
+        }
+        if (lead_out < n)
+        {
+            _cfar_window_remove(window, &n_window, x[lead_out * stride]);
+        }
+        if (lead_in < n)
+        {
+            _cfar_window_insert(window, &n_window, x[lead_in * stride]);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: estimate_cfar_noise
+********************************************************************************
+* Summary:
+* Noise level of the cells of the masked mean RDI for the CFAR detection
+* modes, from the training cells around each cell, see `cfar_cfg`. Only
+* positive cells are training cells. Takes O(cells) for
+* `DETECTION_MODE_CA_CFAR` and O(cells * train_doppler) for
+* `DETECTION_MODE_OS_CFAR`.
+*
+* Parameters:
+*  masked_mean_abs_rdi : n_chirps * n_range_bins cells.
+*  noise               : n_chirps * n_range_bins noise levels, output. Set
+*                        for all cells by `DETECTION_MODE_CA_CFAR`, for the
+*                        search region by `DETECTION_MODE_OS_CFAR`. 0.0 where
+*                        there are no training cells.
+*  f_cfg               : Frame configuration.
+*  search_region       : Cells under test.
+*  cfg                 : Guard and training cells.
+*  det_mode            : `DETECTION_MODE_CA_CFAR` or `DETECTION_MODE_OS_CFAR`.
+*  scratch             : `cfar_scratch_len(f_cfg)` values.
+*
+*******************************************************************************/
+void estimate_cfar_noise(
+    const ifx_f32_t *masked_mean_abs_rdi, ifx_f32_t *noise,
+    const frame_cfg *f_cfg, const region *search_region, const cfar_cfg *cfg,
+    detection_mode det_mode, ifx_f32_t *scratch
+)
+{
+    if (det_mode == DETECTION_MODE_OS_CFAR)
+    {
+        /* Along Doppler, in every range bin of the search region */
+        uint16_t n_cols = f_cfg->n_range_bins;
+        for (uint16_t col = search_region->col_start; col < search_region->col_end; ++col)
+        {
+            _cfar_os_line(
+                masked_mean_abs_rdi + col, noise + col, n_cols, f_cfg->n_chirps,
+                search_region->row_start, search_region->row_end, cfg->guard_doppler,
+                cfg->train_doppler, cfg->os_rank, scratch
+            );
+        }
+    }
+    else
+    {
+        _cfar_ca_noise(
+            masked_mean_abs_rdi, noise, f_cfg->n_chirps, f_cfg->n_range_bins, cfg,
+            scratch
+        );
+    }
+}
+
+/* The cell of every Doppler bin in the search region the most above
+*  `threshold` times its noise level. Returns the number of detections,
+*  at most one per Doppler bin. */
+uint16_t suggest_cfar_detections(
+    const ifx_f32_t *masked_mean_abs_rdi, const ifx_f32_t *noise,
+    detection *detections, const frame_cfg *f_cfg, const region *search_region,
+    float threshold
+)
+{
+    uint16_t n_detections = 0;
+    for (uint16_t row = search_region->row_start; row < search_region->row_end; ++row)
+    {
+        const ifx_f32_t *x = masked_mean_abs_rdi + row * f_cfg->n_range_bins;
+        const ifx_f32_t *level = noise + row * f_cfg->n_range_bins;
+        /* Compares x / level with the best ratio without dividing */
+        ifx_f32_t best_value = 0.0f;
+        ifx_f32_t best_level = 1.0f;
+        uint16_t best_col = UINT16_MAX;
+        for (uint16_t col = search_region->col_start; col < search_region->col_end; ++col)
+        {
+            if ((level[col] > 0.0f) && (x[col] > threshold * level[col]) &&
+                    (x[col] * best_level > best_value * level[col]))
+            {
+                best_value = x[col];
+                best_level = level[col];
+                best_col = col;
+            }
+        }
+        if (best_col != UINT16_MAX)
+        {
+            detections[n_detections].doppler_bin = row;
+            detections[n_detections].range_bin = best_col;
+            detections[n_detections].value = best_value;
+            detections[n_detections].noise = best_level;
             n_detections += 1;
         }
     }
@@ -672,6 +1549,35 @@ const detection *pick_fastest_detection(
     return res;
 }
 
+const detection *
+pick_strongest_detection(const detection *detections, uint16_t n_detections)
+{
+    const detection *res = detections;
+    for (int i = 1; i < n_detections; ++i)
+    {
+        if (detections[i].value > res->value)
+        {
+            res = detections + i;
+        }
+    }
+    return res;
+}
+
+/* The detection the most above its noise level */
+const detection *
+pick_cfar_detection(const detection *detections, uint16_t n_detections)
+{
+    const detection *res = detections;
+    for (int i = 1; i < n_detections; ++i)
+    {
+        if (detections[i].value * res->noise > res->value * detections[i].noise)
+        {
+            res = detections + i;
+        }
+    }
+    return res;
+}
+
 const detection *pick_best_hand_detection(
     const detection *detections, uint16_t n_detections, const frame_cfg *f_cfg,
     detection_mode mode
@@ -686,56 +1592,134 @@ const detection *pick_best_hand_detection(
         return pick_closest_detection(detections, n_detections);
     case DETECTION_MODE_FASTEST:
         return pick_fastest_detection(detections, n_detections, f_cfg);
+    case DETECTION_MODE_STRONGEST:
+        return pick_strongest_detection(detections, n_detections);
+    case DETECTION_MODE_CA_CFAR:
+    case DETECTION_MODE_OS_CFAR:
+        return pick_cfar_detection(detections, n_detections);
     default:
         assert("Unkown detection mode");
     }
     return NULL;
 }
 
-detection detect_hand(
+/* Number of Doppler profile peaks considered for hand detection */
+static uint16_t _detect_hand_n_peaks(uint16_t n_elements)
+{
+    return (uint16_t)(0.2 * n_elements);
+}
+
+static bool _is_cfar_mode(detection_mode det_mode)
+{
+    return (det_mode == DETECTION_MODE_CA_CFAR) || (det_mode == DETECTION_MODE_OS_CFAR);
+}
+
+/*******************************************************************************
+* Function Name: _detect_hand
+********************************************************************************
+* Summary:
+* `detect_hand` on caller-provided scratch arrays.
+*
+* Parameters:
+*  profile, bin_clusters : n_elements values each.
+*  peaks, cluster_elements,
+*  clusters              : n_peaks elements each.
+*  detections            : n_elements detections.
+*  cfar                  : Training cells of the CFAR modes.
+*  noise                 : n_chirps * n_range_bins values, CFAR modes only.
+*  cfar_scratch          : `cfar_scratch_len()` values, CFAR modes only.
+*
+*******************************************************************************/
+static detection _detect_hand(
     const ifx_f32_t *masked_mean_abs_rdi, const region *search_region,
     const frame_cfg *f_cfg, float bg_level, detection_mode det_mode,
-    float threshold
+    float threshold, ifx_f32_t *profile, uint16_t *bin_clusters,
+    uint16_t *peaks, uint16_t *cluster_elements, peak_cluster *clusters,
+    detection *detections, const cfar_cfg *cfar, ifx_f32_t *noise,
+    ifx_f32_t *cfar_scratch
 )
 {
-    uint16_t n_elements = search_region->row_end - search_region->row_start;
-    ifx_f32_t* profile = (ifx_f32_t*)malloc(sizeof(ifx_f32_t) * n_elements);
-    uint16_t n_peaks = (uint16_t)(0.2 * n_elements);
-    uint16_t* peaks = (uint16_t*)malloc(sizeof(uint16_t) * n_peaks);
-    uint16_t* cluster_elements = (uint16_t*)malloc(sizeof(uint16_t) * (n_peaks* n_peaks));
-    peak_cluster *clusters = (peak_cluster*)malloc(sizeof(peak_cluster) * n_peaks);
-    for (int i = 0; i < n_peaks; ++i) {
-        clusters[i].elements = cluster_elements + i * n_peaks;
-    }
-    detection* detections = (detection*)malloc(sizeof(detection) * n_peaks);
-    make_doppler_profile(masked_mean_abs_rdi, profile, search_region, f_cfg);
-    find_peaks(profile, peaks, n_elements, n_peaks);
-    cluster_peaks(peaks, clusters, n_peaks);
-    uint16_t n_detections = suggest_hand_detections(
-                                masked_mean_abs_rdi, n_peaks, detections, f_cfg, search_region, clusters,
-                                threshold, bg_level
-                            );
+    uint16_t n_detections;
+    if (_is_cfar_mode(det_mode))
+    {
+        estimate_cfar_noise(
+            masked_mean_abs_rdi, noise, f_cfg, search_region, cfar, det_mode,
+            cfar_scratch
+        );
+        n_detections = suggest_cfar_detections(
+                           masked_mean_abs_rdi, noise, detections, f_cfg, search_region,
+                           threshold
+                       );
+    }
+    else
+    {
+        uint16_t n_elements = search_region->row_end - search_region->row_start;
+        uint16_t n_peaks = _detect_hand_n_peaks(n_elements);
+        make_doppler_profile(masked_mean_abs_rdi, profile, search_region, f_cfg);
+        find_peaks(profile, peaks, n_elements, n_peaks);
+        cluster_peaks(
+            peaks, clusters, n_peaks, cluster_elements, bin_clusters, n_elements
+        );
+        n_detections = suggest_hand_detections(
+                           masked_mean_abs_rdi, n_peaks, detections, f_cfg, search_region, clusters,
+                           threshold, bg_level
+                       );
+    }
     detection ret_d;
     if (n_detections == 0)
     {
         ret_d = (detection)
         {
-            .doppler_bin = -1, .range_bin = -1, .value = -1
+            .doppler_bin = -1, .range_bin = -1, .value = -1, .noise = 0
         };
     }
     else
     {
         ret_d = *pick_best_hand_detection(detections, n_detections, f_cfg, det_mode);
     }
+    return ret_d;
+}
+
+/* The CFAR modes use `CFAR_CFG_DEFAULT` and ignore `bg_level` */
+detection detect_hand(
+    const ifx_f32_t *masked_mean_abs_rdi, const region *search_region,
+    const frame_cfg *f_cfg, float bg_level, detection_mode det_mode,
+    float threshold
+)
+{
+    static const cfar_cfg cfar = CFAR_CFG_DEFAULT;
+    uint16_t n_elements = search_region->row_end - search_region->row_start;
+    uint16_t n_peaks = _detect_hand_n_peaks(n_elements);
+    ifx_f32_t* profile = (ifx_f32_t*)malloc(sizeof(ifx_f32_t) * n_elements);
+    uint16_t* bin_clusters = (uint16_t*)malloc(sizeof(uint16_t) * n_elements);
+    uint16_t* peaks = (uint16_t*)malloc(sizeof(uint16_t) * n_peaks);
+    uint16_t* cluster_elements = (uint16_t*)malloc(sizeof(uint16_t) * n_peaks);
+    peak_cluster *clusters = (peak_cluster*)malloc(sizeof(peak_cluster) * n_peaks);
+    detection* detections = (detection*)malloc(sizeof(detection) * n_elements);
+    ifx_f32_t* noise = NULL;
+    ifx_f32_t* cfar_scratch = NULL;
+    if (_is_cfar_mode(det_mode))
+    {
+        noise = (ifx_f32_t*)malloc(sizeof(ifx_f32_t) * f_cfg->n_chirps * f_cfg->n_range_bins);
+        cfar_scratch = (ifx_f32_t*)malloc(sizeof(ifx_f32_t) * cfar_scratch_len(f_cfg));
+    }
+
+    detection ret_d = _detect_hand(
+                          masked_mean_abs_rdi, search_region, f_cfg, bg_level, det_mode,
+                          threshold, profile, bin_clusters, peaks, cluster_elements,
+                          clusters, detections, &cfar, noise, cfar_scratch
+                      );
 
     free(profile);
+    free(bin_clusters);
     free(peaks);
     free(cluster_elements);
     free(clusters);
     free(detections);
+    free(noise);
+    free(cfar_scratch);
 
     return ret_d;
- 
 }
 
 ifx_status angle(ifx_f32_t re, ifx_f32_t im, float *out)
@@ -823,23 +1807,286 @@ void remove_mean_3d_cf64(
     }
 }
 
+/*******************************************************************************
+* Function Name: remove_mean_3d_cols_cf64
+********************************************************************************
+* Summary:
+* Same as `remove_mean_3d_cf64()` along axis 1 (rows), restricted to the
+* columns in [col_start, col_end). Other columns are left untouched.
+*
+* Parameters:
+*  src       : Input array [n_ch][n_rows][n_cols], modified in place.
+*  col_start : First column.
+*  col_end   : Column after the last one.
+*
+*******************************************************************************/
+void remove_mean_3d_cols_cf64(
+    ifx_cf64_t *src, uint16_t n_ch, uint16_t n_rows, uint16_t n_cols,
+    uint16_t col_start, uint16_t col_end
+)
+{
+    cfloat32_t *arr = (cfloat32_t *)src;
+    for (int ch = 0; ch < n_ch; ++ch)
+    {
+        for (int col = col_start; col < col_end; ++col)
+        {
+            remove_mean_cf64(arr + ch * n_rows * n_cols + col, n_rows, n_cols);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: new_clutter_map
+********************************************************************************
+* Summary:
+* Allocates a clutter map with no range bin seeded. Each range bin is seeded
+* by the first call to `remove_clutter_3d_cf64()` that processes it.
+*
+* Parameters:
+*  clutter      : Clutter map to initialize.
+*  n_channels   : Number of channels.
+*  n_range_bins : Number of range bins.
+*  alpha        : Weight of the current frame, in (0, 1].
+*
+* Return:
+* false if allocation failed, in which case the arrays are NULL.
+*
+*******************************************************************************/
+bool new_clutter_map(
+    clutter_map *clutter, uint16_t n_channels, uint16_t n_range_bins,
+    float alpha
+)
+{
+    clutter->map = (ifx_cf64_t *)calloc((size_t)n_channels * n_range_bins, sizeof(ifx_cf64_t));
+    clutter->residual_sum = (ifx_cf64_t *)calloc(n_range_bins, sizeof(ifx_cf64_t));
+    clutter->seeded = (bool *)calloc(n_range_bins, sizeof(bool));
+    clutter->n_channels = n_channels;
+    clutter->n_range_bins = n_range_bins;
+    clutter->alpha = alpha;
+    if ((clutter->map == NULL) || (clutter->residual_sum == NULL) || (clutter->seeded == NULL))
+    {
+        free_clutter_map(clutter);
+        return false;
+    }
+    return true;
+}
+
+/* Frees the arrays allocated by `new_clutter_map()`. */
+void free_clutter_map(clutter_map *clutter)
+{
+    free(clutter->map);
+    free(clutter->residual_sum);
+    free(clutter->seeded);
+    clutter->map = NULL;
+    clutter->residual_sum = NULL;
+    clutter->seeded = NULL;
+}
+
+/* Starts the clutter map over, e.g. after a gap in the frames: every range
+*  bin is seeded again by the next frame. */
+void reset_clutter_map(clutter_map *clutter)
+{
+    memset(clutter->map, 0, sizeof(ifx_cf64_t) * clutter->n_channels * clutter->n_range_bins);
+    memset(clutter->seeded, 0, sizeof(bool) * clutter->n_range_bins);
+}
+
+/*******************************************************************************
+* Function Name: remove_clutter_3d_cf64
+********************************************************************************
+* Summary:
+* Suppresses static targets across frames: subtracts the clutter map from
+* every row (chirp) and then moves the map towards the slow-time mean of the
+* frame, map = (1 - alpha) * map + alpha * mean. Unlike
+* `remove_mean_3d_cf64()` along axis 1, targets that do not move within a
+* frame are kept while they move between frames. Rows are processed
+* contiguously, restricted to the columns in [col_start, col_end). Other
+* columns are left untouched and dropped from the map. The map of a column
+* that is not seeded is first set to the slow-time mean of the frame.
+* `build_complex_range_image_clutter()` does the same within the range FFTs.
+*
+* Parameters:
+*  src       : Input array [n_ch][n_rows][n_cols], modified in place.
+*  clutter   : Clutter map of the same n_ch and n_cols, see
+*              `new_clutter_map()`.
+*  col_start : First column.
+*  col_end   : Column after the last one.
+*
+*******************************************************************************/
+void remove_clutter_3d_cf64(
+    ifx_cf64_t *src, clutter_map *clutter, uint16_t n_ch, uint16_t n_rows,
+    uint16_t n_cols, uint16_t col_start, uint16_t col_end
+)
+{
+    for (int ch = 0; ch < n_ch; ++ch)
+    {
+        ifx_cf64_t *map = clutter->map + ch * n_cols;
+        ifx_cf64_t *img = src + ch * n_rows * n_cols;
+        memset(
+            clutter->residual_sum + col_start, 0,
+            sizeof(ifx_cf64_t) * (col_end - col_start)
+        );
+        for (int row = 0; row < n_rows; ++row)
+        {
+            _subtract_clutter(img + row * n_cols, map, clutter->residual_sum, col_start, col_end);
+        }
+        _update_clutter_channel(
+            img, map, clutter->residual_sum, clutter, n_rows, n_cols, col_start,
+            col_end
+        );
+    }
+    _mark_clutter_seeded(clutter, col_start, col_end);
+}
+
+/* Alignment of the arrays carved out of the `algo` workspace arena */
+#define ALGO_WORKSPACE_ALIGN (16u)
+
+/* Reserves `size` bytes at `*offset` in the arena. Returns the array pointer
+*  if `base` is provided, NULL when only computing the arena size. */
+static void *_arena_take(uint8_t *base, size_t *offset, size_t size)
+{
+    size_t start = (*offset + ALGO_WORKSPACE_ALIGN - 1) & ~((size_t)ALGO_WORKSPACE_ALIGN - 1);
+    *offset = start + size;
+    return (base != NULL) ? (void *)(base + start) : NULL;
+}
+
+/* Lays out the workspace arrays starting at `base` and returns the arena size.
+*  With `base == NULL` only the size is computed. */
+static size_t _algo_workspace_layout(
+    algo_workspace *ws, const frame_cfg *f_cfg, uint8_t *base
+)
+{
+    size_t len_frm = (size_t)f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_range_bins;
+    size_t len_img = (size_t)f_cfg->n_chirps * f_cfg->n_range_bins;
+    size_t len_chr = f_cfg->n_chirps;
+    size_t len_pks = _detect_hand_n_peaks(f_cfg->n_chirps);
+    size_t sz_f = sizeof(ifx_f32_t);
+    size_t sz_c = sizeof(ifx_cf64_t);
+    size_t offset = 0;
+
+    ws->rdi = (ifx_cf64_t *)_arena_take(base, &offset, sz_c * len_frm);
+    ws->abs_rdi = (ifx_f32_t *)_arena_take(base, &offset, sz_f * len_frm);
+    ws->mean_abs_rdi = (ifx_f32_t *)_arena_take(base, &offset, sz_f * len_img);
+    ws->masked_mean_abs_rdi = (ifx_f32_t *)_arena_take(base, &offset, sz_f * len_img);
+    ws->bg_scratch = (ifx_f32_t *)_arena_take(base, &offset, sz_f * len_img);
+    ws->bg_level.histogram = (uint32_t *)_arena_take(base, &offset, sizeof(uint32_t) * BG_LEVEL_HISTOGRAM_BINS);
+    ws->range_scratch = (ifx_cf64_t *)_arena_take(base, &offset, sz_c * len_img);
+    ws->doppler_scratch = (ifx_cf64_t *)_arena_take(base, &offset, sz_c * len_img);
+    ws->doppler_profile = (ifx_f32_t *)_arena_take(base, &offset, sz_f * len_chr);
+    ws->peak_bin_clusters = (uint16_t *)_arena_take(base, &offset, sizeof(uint16_t) * len_chr);
+    ws->peaks = (uint16_t *)_arena_take(base, &offset, sizeof(uint16_t) * len_pks);
+    ws->cluster_elements = (uint16_t *)_arena_take(base, &offset, sizeof(uint16_t) * len_pks);
+    ws->clusters = (peak_cluster *)_arena_take(base, &offset, sizeof(peak_cluster) * len_pks);
+    ws->detections = (detection *)_arena_take(base, &offset, sizeof(detection) * len_chr);
+    ws->cfar_scratch = (ifx_f32_t *)_arena_take(base, &offset, sz_f * cfar_scratch_len(f_cfg));
+
+    return offset + ALGO_WORKSPACE_ALIGN;
+}
+
+/* Size in bytes of the arena needed by `init_algo_workspace()` */
+size_t algo_workspace_size(const frame_cfg *f_cfg)
+{
+    algo_workspace ws;
+    return _algo_workspace_layout(&ws, f_cfg, NULL);
+}
+
+/*******************************************************************************
+* Function Name: init_algo_workspace
+********************************************************************************
+* Summary:
+* Places the `algo` intermediate arrays into caller-provided memory and
+* selects the shared normalized FFT windows. The memory must stay valid for
+* as long as the workspace is used.
+*
+* Parameters:
+*  ws     : Workspace to initialize.
+*  f_cfg  : Frame configuration.
+*  buffer : Arena memory, at least `algo_workspace_size(f_cfg)` bytes.
+*  size   : Size of `buffer` in bytes.
+*
+* Return:
+* false if the buffer is too small.
+*
+*******************************************************************************/
+bool init_algo_workspace(
+    algo_workspace *ws, const frame_cfg *f_cfg, void *buffer, size_t size
+)
+{
+    if ((buffer == NULL) || (size < algo_workspace_size(f_cfg)))
+    {
+        return false;
+    }
+    uint8_t *base = (uint8_t *)(((uintptr_t)buffer + ALGO_WORKSPACE_ALIGN - 1) &
+                                ~((uintptr_t)ALGO_WORKSPACE_ALIGN - 1));
+    (void)_algo_workspace_layout(ws, f_cfg, base);
+    init_bg_level_estimator(&ws->bg_level, BG_LEVEL_EXACT, ws->bg_level.histogram);
+    ws->cfar = (cfar_cfg)CFAR_CFG_DEFAULT;
+    ws->arena = NULL;
+    init_preproc_tables(f_cfg);
+    ws->range_window = get_normalized_window(&WINDOWS.hann, f_cfg->n_samples);
+    ws->doppler_window = get_normalized_window(&WINDOWS.kaiser_b25, f_cfg->n_chirps);
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: new_algo_workspace
+********************************************************************************
+* Summary:
+* Allocates the `algo` workspace arena on the heap with a single allocation.
+* Reuse the same workspace for processing all frames.
+*
+* Parameters:
+*  f_cfg  : Frame configuration.
+*
+* Return:
+* workspace with pre-allocated arrays, `arena` is NULL if allocation failed.
+*
+*******************************************************************************/
+algo_workspace new_algo_workspace(const frame_cfg *f_cfg)
+{
+    algo_workspace ws = {0};
+    size_t size = algo_workspace_size(f_cfg);
+    void *arena = malloc(size);
+    if ((arena != NULL) && init_algo_workspace(&ws, f_cfg, arena, size))
+    {
+        ws.arena = arena;
+    }
+    else
+    {
+        free(arena);
+    }
+    return ws;
+}
+
+/* Frees the `algo` workspace arena allocated by `new_algo_workspace()`. */
+void free_algo_workspace(algo_workspace *ws)
+{
+    free(ws->arena);
+    ws->arena = NULL;
+}
+
 void algo(
     algo_output *out, ifx_f32_t *frame, frame_cfg *f_cfg,
     estimate_human_cfg *h_cfg, uint16_t band_min, uint16_t band_max,
     uint16_t band_offset, uint16_t range_min, uint16_t guard_range,
-    uint16_t guard_doppler, detection_mode det_mode, float threshold
+    uint16_t guard_doppler, detection_mode det_mode, float threshold,
+    algo_workspace *ws
 )
 {
     uint16_t rdi_size = f_cfg->n_channels * f_cfg->n_chirps * f_cfg->n_range_bins;
     uint16_t mean_rdi_size = f_cfg->n_chirps * f_cfg->n_range_bins;
-    ifx_cf64_t *rdi = (ifx_cf64_t*)calloc(rdi_size, sizeof(ifx_cf64_t));
-    ifx_f32_t *abs_rdi = (ifx_f32_t*)malloc(sizeof(ifx_f32_t) * rdi_size);
-    ifx_f32_t *mean_abs_rdi = (ifx_f32_t*)malloc(sizeof(ifx_f32_t) * mean_rdi_size);
-    ifx_f32_t *masked_mean_abs_rdi = (ifx_f32_t*)malloc(sizeof(ifx_f32_t) * mean_rdi_size);
-
-    build_complex_rdi(frame, rdi, f_cfg);
+    ifx_cf64_t *rdi = ws->rdi;
+    ifx_f32_t *abs_rdi = ws->abs_rdi;
+    ifx_f32_t *mean_abs_rdi = ws->mean_abs_rdi;
+    ifx_f32_t *masked_mean_abs_rdi = ws->masked_mean_abs_rdi;
+
+    _build_complex_rdi(
+        frame, rdi, f_cfg, ws->range_window, ws->doppler_window,
+        ws->range_scratch, ws->doppler_scratch
+    );
+    PREPROC_STAGE("rdi");
     arm_cmplx_mag_f32((float32_t *)rdi, (float32_t *)abs_rdi, rdi_size);
     mean_rdi_channel_f32(abs_rdi, mean_abs_rdi, f_cfg);
+    PREPROC_STAGE("magnitude");
     estimate_human(mean_abs_rdi, f_cfg, h_cfg);
     uint16_t upper_limit = calculate_upper_range_limit(
                                h_cfg->position_current, band_min, band_offset, range_min
@@ -855,19 +2102,33 @@ void algo(
     mask_hand_roi(
         mean_abs_rdi, masked_mean_abs_rdi, f_cfg, &hand_search, &human_mask
     );
-    float bg_level = get_background_level(masked_mean_abs_rdi, f_cfg);
-    detection hand = detect_hand(
-                         masked_mean_abs_rdi, &hand_search, f_cfg, bg_level, det_mode, threshold
+    PREPROC_STAGE("roi");
+    /* The CFAR modes estimate the noise around every cell instead */
+    float bg_level = 0.0f;
+    if (!_is_cfar_mode(det_mode))
+    {
+        bg_level = estimate_background_level(
+                       masked_mean_abs_rdi, f_cfg, &ws->bg_level, ws->bg_scratch
+                   );
+    }
+    PREPROC_STAGE("background");
+    detection hand = _detect_hand(
+                         masked_mean_abs_rdi, &hand_search, f_cfg, bg_level, det_mode, threshold,
+                         ws->doppler_profile, ws->peak_bin_clusters, ws->peaks,
+                         ws->cluster_elements, ws->clusters, ws->detections, &ws->cfar,
+                         ws->bg_scratch, ws->cfar_scratch
                      );
+    PREPROC_STAGE("detect");
     if (hand.range_bin >= f_cfg->n_range_bins)
     {
         out->success = false;
-        free(rdi);
-        free(abs_rdi);
-        free(mean_abs_rdi);
-        free(masked_mean_abs_rdi);
         return;
     }
+    if (_is_cfar_mode(det_mode))
+    {
+        /* Noise level around the hand */
+        bg_level = hand.noise;
+    }
 
     uint16_t bin_idx[3];
     float phases[3];
@@ -879,10 +2140,6 @@ void algo(
         if (angle(rdi[bin_idx[i]].data[0], rdi[bin_idx[i]].data[1], phases + i) != ARM_MATH_SUCCESS)
         {
             out->success = false;
-            free(rdi);
-            free(abs_rdi);
-            free(mean_abs_rdi);
-            free(masked_mean_abs_rdi);
             return;
         }
     }
@@ -892,6 +2149,7 @@ void algo(
     /* Phase correction based on Signify measurements */
     azimuth = azimuth + deg2rad(8.0);
     elevation = elevation + deg2rad(24.0);
+    PREPROC_STAGE("angles");
 
     out->success = true;
     out->human_position = h_cfg->position_current;
@@ -904,10 +2162,4 @@ void algo(
     };
     out->lower_limit = lower_limit;
     out->upper_limit = upper_limit;
-
-    free(rdi);
-    free(abs_rdi);
-    free(mean_abs_rdi);
-    free(masked_mean_abs_rdi);
-
 }
@@ -39,6 +39,7 @@
 #include "windows.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 const namespace_windows WINDOWS =
 {
@@ -319,36 +320,91 @@ const namespace_windows WINDOWS =
     }
 };
 
-void get_window(const sized_windows *sw, ifx_f32_t *out, uint16_t size)
+/* Normalized copies of WINDOWS, each table filled on its first use */
+static namespace_windows normalized_windows;
+/* One bit per (window, size) table of `normalized_windows` */
+static uint16_t normalized_valid;
+
+/* Selects the table of `size` elements in `sw`, aborts on unsupported size */
+static ifx_f32_t *_select_window(const sized_windows *sw, uint16_t size, uint16_t *size_idx)
 {
-    const ifx_f32_t *window;
-    switch (size) 
+    switch (size)
     {
     case 16:
-        window = sw->s16;
-        break;
+        *size_idx = 0;
+        return (ifx_f32_t *)sw->s16;
     case 32:
-        window = sw->s32;
-        break;
+        *size_idx = 1;
+        return (ifx_f32_t *)sw->s32;
     case 64:
-        window = sw->s64;
-        break;
+        *size_idx = 2;
+        return (ifx_f32_t *)sw->s64;
     case 128:
-        window = sw->s128;
-        break;
+        *size_idx = 3;
+        return (ifx_f32_t *)sw->s128;
     case 256:
-        window = sw->s256;
-        break;
+        *size_idx = 4;
+        return (ifx_f32_t *)sw->s256;
     default:
         abort();
     }
+}
+
+/*******************************************************************************
+* Function Name: get_normalized_window
+********************************************************************************
+* Summary:
+* Returns a window table of `size` elements from `WINDOWS`, normalized to a
+* sum of 1. The table is normalized once, on the first call, and shared by
+* all later calls; callers must not modify it.
+*
+* Parameters:
+*  sw   : Window family, `&WINDOWS.hann` or `&WINDOWS.kaiser_b25`.
+*  size : Number of elements: 16, 32, 64, 128 or 256.
+*
+* Return:
+* pointer to the normalized window.
+*
+*******************************************************************************/
+ifx_f32_t *get_normalized_window(const sized_windows *sw, uint16_t size)
+{
+    sized_windows *normalized;
+    uint16_t family_idx;
+    if (sw == &WINDOWS.hann)
+    {
+        normalized = &normalized_windows.hann;
+        family_idx = 0;
+    }
+    else if (sw == &WINDOWS.kaiser_b25)
+    {
+        normalized = &normalized_windows.kaiser_b25;
+        family_idx = 1;
+    }
+    else
+    {
+        abort();
+    }
 
-    ifx_f32_t sum = 0;
-    for (int i = 0; i < size; ++i)
+    uint16_t size_idx;
+    const ifx_f32_t *window = _select_window(sw, size, &size_idx);
+    ifx_f32_t *out = _select_window(normalized, size, &size_idx);
+    uint16_t valid_bit = (uint16_t)(1u << (family_idx * 5u + size_idx));
+    if ((normalized_valid & valid_bit) == 0u)
     {
-        sum += window[i];
+        ifx_f32_t sum = 0;
+        for (int i = 0; i < size; ++i)
+        {
+            sum += window[i];
+        }
+        arm_scale_f32(
+            (float32_t *)window, 1.0 / (float32_t)sum, (float32_t *)out, size
+        );
+        normalized_valid |= valid_bit;
     }
-    arm_scale_f32(
-        (float32_t *)window, 1.0 / (float32_t)sum, (float32_t *)out, size
-    );
+    return out;
+}
+
+void get_window(const sized_windows *sw, ifx_f32_t *out, uint16_t size)
+{
+    memcpy(out, get_normalized_window(sw, size), sizeof(ifx_f32_t) * size);
 }
@@ -0,0 +1,45 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+#include <stddef.h>
+
+#include "radar_fifo_reader.h"
+
+bool radar_fifo_reader_init(radar_fifo_reader_t *reader, radar_fifo_read_fn read, void *read_ctx,
+                            uint32_t frame_samples, uint32_t chunk_samples)
+{
+    if ((NULL == read) || (0 == chunk_samples) || (0 == frame_samples) ||
+        ((frame_samples % chunk_samples) != 0))
+    {
+        return false;
+    }
+    reader->read = read;
+    reader->read_ctx = read_ctx;
+    reader->frame_samples = frame_samples;
+    reader->chunk_samples = chunk_samples;
+    reader->filled = 0;
+    reader->chunks_read = 0;
+    reader->frames_read = 0;
+    return true;
+}
+
+int32_t radar_fifo_reader_read_chunk(radar_fifo_reader_t *reader, uint16_t *frame)
+{
+    if (0 != reader->read(reader->read_ctx, frame + reader->filled, reader->chunk_samples))
+    {
+        /* The position within the frame is lost, start over with the next chunk */
+        reader->filled = 0;
+        return RADAR_FIFO_READ_ERROR;
+    }
+    reader->chunks_read++;
+    reader->filled += reader->chunk_samples;
+    if (reader->filled < reader->frame_samples)
+    {
+        return RADAR_FIFO_CHUNK_READ;
+    }
+    reader->filled = 0;
+    reader->frames_read++;
+    return RADAR_FIFO_FRAME_COMPLETE;
+}
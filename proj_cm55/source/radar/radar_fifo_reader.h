@@ -0,0 +1,52 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Assembles radar frames out of FIFO chunks. The sensor raises its interrupt
+ * every time the FIFO holds another chunk; the acquisition task reads exactly
+ * one chunk per interrupt, so it can block between interrupts instead of
+ * polling, and the FIFO never has to hold a whole frame.
+ */
+
+#ifndef RADAR_FIFO_READER_H_
+#define RADAR_FIFO_READER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* radar_fifo_reader_read_chunk() results */
+#define RADAR_FIFO_CHUNK_READ       (0)
+#define RADAR_FIFO_FRAME_COMPLETE   (1)
+#define RADAR_FIFO_READ_ERROR       (-1)
+
+/* Reads exactly num_samples samples from the sensor FIFO. Returns 0 on success. */
+typedef int32_t (*radar_fifo_read_fn)(void *ctx, uint16_t *data, uint32_t num_samples);
+
+typedef struct
+{
+    radar_fifo_read_fn read;
+    void *read_ctx;
+    uint32_t frame_samples;     /* samples in a full frame */
+    uint32_t chunk_samples;     /* samples read per interrupt */
+    uint32_t filled;            /* samples of the current frame read so far */
+    uint32_t chunks_read;
+    uint32_t frames_read;
+} radar_fifo_reader_t;
+
+/* chunk_samples must divide frame_samples. Returns false on invalid sizes. */
+bool radar_fifo_reader_init(radar_fifo_reader_t *reader, radar_fifo_read_fn read, void *read_ctx,
+                            uint32_t frame_samples, uint32_t chunk_samples);
+
+/* True if the next chunk starts a new frame, i.e. the caller has to provide a new frame buffer */
+static inline bool radar_fifo_reader_at_frame_start(const radar_fifo_reader_t *reader)
+{
+    return reader->filled == 0;
+}
+
+/* Reads one chunk into frame[filled..]. `frame` must be the same buffer for all chunks of a frame.
+ * Returns RADAR_FIFO_FRAME_COMPLETE when the frame is complete, RADAR_FIFO_CHUNK_READ if more
+ * chunks are needed, RADAR_FIFO_READ_ERROR if the FIFO read failed (the frame is restarted). */
+int32_t radar_fifo_reader_read_chunk(radar_fifo_reader_t *reader, uint16_t *frame);
+
+#endif /* RADAR_FIFO_READER_H_ */
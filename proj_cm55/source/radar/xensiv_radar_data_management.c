@@ -49,7 +49,6 @@
 
 
 //////////////////////////////////////////////////DECLARATION/////////////////////////////////////////////
-#ifdef FREERTOS_AWARE
 
 /*
  *\def typedef struct  subscribed_task_lists_s
@@ -58,13 +57,23 @@
  */
 typedef struct {
 
-    bool data_read; /*<<indicate and mark if task has read the data*/
+#ifdef FREERTOS_AWARE
+    volatile bool reading; /*<<subscriber holds a block returned by read, until it acknowledges it*/
+
+    bool notified; /*<<subscriber was notified about the block at its cursor*/
 
     TaskHandle_t suscriber_task_handle; /*<<The FREERTOS Task handle representing subscriber task*/
+#else
+    cb_radar_data_event cb; /*<<subscriber callback of type \ref cb_radar_data_event*/
+#endif
 
-}subscribers_task_lists_s;
+    radar_data_policy_e policy; /*<<what happens when the subscriber falls behind*/
 
-#endif
+    uint32_t consumed; /*<<read cursor: stream bytes consumed by the subscriber, compared with manager.written*/
+
+    radar_data_subscriber_stats_s stats; /*<<lag and overrun counters*/
+
+}subscribers_task_lists_s;
 
 
 /*
@@ -78,19 +87,21 @@ typedef struct {
 
     uint32_t buff_size; /*<< Total size of buffer in bytes FIFO buffer */
 
-    uint32_t samples; /*<< Total number of bytes in FIFO */
+    uint32_t samples; /*<< Number of bytes in FIFO retained for the slowest subscriber*/
+
+    uint32_t tail; /*<< write position in the FIFO, the buffer is used as a ring*/
 
-    uint32_t head,tail; /*<< front and back positions of the FIFO queue*/
+    uint32_t written; /*<< Total number of bytes written to the FIFO, wraps around*/
 
     uint32_t fill_level; /*<< FIFO water mark level in bytes*/
 
+    bool cursors_moved; /*<< a read cursor moved since the retained data was last recomputed*/
+
     uint8_t subscribers; /*<< Number of subscribers (task/callers)*/
 
-#ifdef FREERTOS_AWARE
-    subscribers_task_lists_s subscriptions[ACTIVE_SUBSCRIPTION_UB + 1]; /*<<list of all subscriber tasks of type \ref subscribers_task_lists_s*/
-#else
-    cb_radar_data_event subscriptions[ACTIVE_SUBSCRIPTION_UB + 1]; /*<<list of all subscriber tasks of type \ref cb_radar_data_event*/
-#endif
+    uint8_t active[ACTIVE_SUBSCRIPTION_UB]; /*<< subscription ids in use, the first subscribers entries are valid*/
+
+    subscribers_task_lists_s subscriptions[ACTIVE_SUBSCRIPTION_UB + 1]; /*<<list of all subscribers of type \ref subscribers_task_lists_s*/
 
     void* (*malloc_func)(size_t size); /*<<Hold reference to consumer supplied memory allocation*/
 
@@ -112,6 +123,117 @@ static radar_data_manager_s *manager_interface;
 
 //////////////////////////////////////////////////FUNCTIONAL DEFINITIONS/////////////////////////////////////////////
 
+/*
+ * check if a subscription slot is in use
+ */
+static inline bool
+radar_data_manager_is_subscribed(int32_t subscription_id)
+{
+#ifdef FREERTOS_AWARE
+    return (NULL != manager.subscriptions[subscription_id].suscriber_task_handle);
+#else
+    return (NULL != manager.subscriptions[subscription_id].cb);
+#endif
+}
+
+/*
+ * bytes written but not yet consumed by a subscriber.
+ * Negative while a new subscriber waits for the start of the next block.
+ */
+static inline int32_t
+radar_data_manager_pending(const subscribers_task_lists_s *sub)
+{
+    return (int32_t)(manager.written - sub->consumed);
+}
+
+/*
+ * split the fill level worth of data at a subscriber's cursor into
+ * the part up to the end of the buffer and the part wrapped around to its start
+ */
+static void
+radar_data_manager_get_spans(const subscribers_task_lists_s *sub, radar_data_span_s spans[2])
+{
+    uint32_t pending = (uint32_t)radar_data_manager_pending(sub);
+    uint32_t start = (manager.tail >= pending) ? (manager.tail - pending) : (manager.tail + manager.buff_size - pending);
+    uint32_t first = manager.buff_size - start;
+
+    if (first > manager.fill_level)
+    {
+        first = manager.fill_level;
+    }
+
+    spans[0].data = (uint16_t*) (manager.buffer + start);
+    spans[0].size = first;
+
+    spans[1].data = (uint16_t*) manager.buffer;
+    spans[1].size = manager.fill_level - first;
+}
+
+/*
+ * drop the oldest blocks of subscribers that must not hold up the writer and
+ * update the number of bytes retained for the slowest remaining subscriber
+ */
+static void
+radar_data_manager_release_space(void)
+{
+    uint32_t retained = 0;
+
+    for (uint8_t i = 0; i < manager.subscribers; i++)
+    {
+        subscribers_task_lists_s *s = &manager.subscriptions[manager.active[i]];
+
+#ifdef FREERTOS_AWARE
+        //a block being read stays in place until it is acknowledged
+        if ((s->policy != RDM_POLICY_BLOCK) && !s->reading)
+#else
+        if (s->policy != RDM_POLICY_BLOCK)
+#endif
+        {
+            //keep at least one block of free space for the writer
+            while ((radar_data_manager_pending(s) >= (int32_t)manager.fill_level) &&
+                   (radar_data_manager_pending(s) > (int32_t)(manager.buff_size - manager.fill_level)))
+            {
+                s->consumed += manager.fill_level;
+                s->stats.blocks_dropped++;
+            }
+        }
+
+        int32_t pending = radar_data_manager_pending(s);
+        if ((pending > 0) && ((uint32_t)pending > retained))
+        {
+            retained = (uint32_t)pending;
+        }
+    }
+
+    manager.samples = retained;
+
+    manager.cursors_moved = false;
+
+    //rewind an empty queue, so that the next data does not wrap around.
+    //Cursors are relative to the tail, nothing else has to move.
+    if (0 == manager.samples)
+    {
+        manager.tail = 0;
+    }
+}
+
+/*
+ * count a writer stall against the subscribers holding the oldest data
+ */
+static void
+radar_data_manager_count_stall(void)
+{
+    for (uint8_t i = 0; i < manager.subscribers; i++)
+    {
+        subscribers_task_lists_s *s = &manager.subscriptions[manager.active[i]];
+
+        if (radar_data_manager_pending(s) == (int32_t)manager.samples)
+        {
+            s->stats.writer_stalls++;
+        }
+    }
+}
+
 /*
  * subscribe to radar data
  */
@@ -144,7 +266,7 @@ radar_data_manager_subscribe(cb_radar_data_event cb)
             return subs;
         }
         #else
-        if (manager.subscriptions[subs] == cb)
+        if (manager.subscriptions[subs].cb == cb)
         {
             return subs;
         }
@@ -159,33 +281,27 @@ radar_data_manager_subscribe(cb_radar_data_event cb)
 
     for (uint8_t subs = 1; subs <= ACTIVE_SUBSCRIPTION_UB; subs++)
     {
-        #ifdef FREERTOS_AWARE
-        if (manager.subscriptions[subs].suscriber_task_handle == subscriber_task)
-        {
-            return subs;
-        }
-
-        if (NULL == manager.subscriptions[subs].suscriber_task_handle)
+        if (!radar_data_manager_is_subscribed(subs))
         {
-            manager.subscriptions[subs].data_read = false;
+            subscribers_task_lists_s *s = &manager.subscriptions[subs];
 
-            manager.subscriptions[subs].suscriber_task_handle = subscriber_task;
+            memset(s, 0, sizeof(*s));
 
-            manager.subscribers++;
+            s->policy = RDM_POLICY_BLOCK;
 
-            return subs;
-        }
-        #else /* ifdef FREERTOS_AWARE */
+            //blocks are aligned to the start of the stream, start reading with the next one
+            s->consumed = manager.written + ((manager.fill_level - (manager.written % manager.fill_level)) % manager.fill_level);
 
-        if (NULL == manager.subscriptions[subs])
-        {
-            manager.subscriptions[subs]= cb;
+            #ifdef FREERTOS_AWARE
+            s->suscriber_task_handle = subscriber_task;
+            #else
+            s->cb = cb;
+            #endif
 
-            manager.subscribers++;
+            manager.active[manager.subscribers++] = subs;
 
             return subs;
         }
-        #endif /* ifdef FREERTOS_AWARE */
     }
 
     //indicate failure in case none of the above conditions met
@@ -199,20 +315,72 @@ radar_data_manager_subscribe(cb_radar_data_event cb)
 void
 radar_data_manager_unsubscribe (int32_t subscription_id)
 {
-    if ((subscription_id <= 0) || (subscription_id > ACTIVE_SUBSCRIPTION_UB) || (manager.subscribers == 0))
+    if ((subscription_id <= 0) || (subscription_id > ACTIVE_SUBSCRIPTION_UB) || (manager.subscribers == 0) ||
+        !radar_data_manager_is_subscribed(subscription_id))
     {
         return;
     }
 
-#ifdef FREERTOS_AWARE
-    manager.subscriptions[subscription_id].data_read = false;
-    manager.subscriptions[subscription_id].suscriber_task_handle = NULL;
-#else
+    memset(&manager.subscriptions[subscription_id], 0, sizeof(subscribers_task_lists_s));
 
-    manager.subscriptions[subscription_id]= NULL;
-#endif
+    //move the last subscription in use into the place of the removed one
+    for (uint8_t i = 0; i < manager.subscribers; i++)
+    {
+        if (manager.active[i] == subscription_id)
+        {
+            manager.active[i] = manager.active[manager.subscribers - 1];
+            break;
+        }
+    }
 
     manager.subscribers--;
+
+    manager.cursors_moved = true;
+}
+
+
+/*
+ * set the overrun policy of a subscriber
+ */
+int32_t
+radar_data_manager_set_policy(int32_t subscription_id, radar_data_policy_e policy)
+{
+    if ((subscription_id <= 0) || (subscription_id > ACTIVE_SUBSCRIPTION_UB) ||
+        (policy > RDM_POLICY_LATEST_ONLY))
+    {
+        return -1;
+    }
+
+    if (!radar_data_manager_is_subscribed(subscription_id))
+    {
+        return -2;
+    }
+
+    manager.subscriptions[subscription_id].policy = policy;
+
+    return 0;
+}
+
+
+/*
+ * get the lag and overrun counters of a subscriber
+ */
+int32_t
+radar_data_manager_get_stats(int32_t subscription_id, radar_data_subscriber_stats_s *stats)
+{
+    if ((subscription_id <= 0) || (subscription_id > ACTIVE_SUBSCRIPTION_UB) || (NULL == stats))
+    {
+        return -1;
+    }
+
+    if (!radar_data_manager_is_subscribed(subscription_id))
+    {
+        return -2;
+    }
+
+    *stats = manager.subscriptions[subscription_id].stats;
+
+    return 0;
 }
 
 
@@ -229,19 +397,40 @@ radar_data_manager_run()
 {
     uint32_t samples;
 
-    if (manager.tail < manager.buff_size)
+    //without acknowledgements the retained data only grows by what is written below,
+    //so it is recomputed only when a cursor moved or a subscriber may have to drop a block
+    if (manager.cursors_moved || (manager.samples > (manager.buff_size - manager.fill_level)))
+    {
+        radar_data_manager_release_space();
+    }
+
+    //free space from tail up to the end of the buffer, once tail wraps around
+    //the space in front of the oldest retained data is filled by the next run
+    uint32_t contiguous = manager.buff_size - manager.tail;
+
+    if (contiguous > (manager.buff_size - manager.samples))
+    {
+        contiguous = manager.buff_size - manager.samples;
+    }
+
+    if (contiguous > 0)
     {
 
         int32_t result = manager_interface->in_read_radar_data((void*)(manager.buffer + manager.tail), &samples,
-                (manager.buff_size - manager.tail));
+                contiguous);
 
         if (result >= 0)
         {
-            if ( samples <= (manager.buff_size - manager.tail))
+            if ( samples <= contiguous)
             {
                 //This implies a successful read
                 manager.tail += samples;
-                manager.samples = manager.tail - manager.head;
+                if (manager.tail == manager.buff_size)
+                {
+                    manager.tail = 0;
+                }
+                manager.written += samples;
+                manager.samples += samples;
             }
             else
             {
@@ -253,126 +442,124 @@ radar_data_manager_run()
         }
 
     }
-
-    //now check if the fill level is attained
-    if (manager.samples >= manager.fill_level)
+    else
     {
-#ifdef FREERTOS_AWARE
-
-        //now inform all subscribers about available data
-        for (int sub = 1; sub <= ACTIVE_SUBSCRIPTION_UB; sub++)
-        {
-            if (NULL != manager.subscriptions[sub].suscriber_task_handle)
-            {
-
-                if (run_from_isr)
-                {
-                    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-
-                    vTaskNotifyGiveFromISR(manager.subscriptions[sub].suscriber_task_handle, &xHigherPriorityTaskWoken);
+        radar_data_manager_count_stall();
+    }
 
-                    /* Context switch needed? */
-                    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
-                }
-                else
-                {
-                    xTaskNotifyGive(manager.subscriptions[sub].suscriber_task_handle);
-                }
+    //only the subscriptions in use are visited, run() is called for every read from the sensor
+    for (uint8_t i = 0; i < manager.subscribers; i++)
+    {
+        subscribers_task_lists_s *s = &manager.subscriptions[manager.active[i]];
 
-            }
-        }
+        int32_t pending = radar_data_manager_pending(s);
 
-        // now adjust queue if all the subscribers tasks have consumed the data
-        bool adjust_queue = true;
-        for (int sub = 1; sub <= ACTIVE_SUBSCRIPTION_UB; sub++)
+        s->stats.lag = (pending > 0) ? (uint32_t)pending : 0;
+        if (s->stats.lag > s->stats.lag_max)
         {
-            if ((NULL != manager.subscriptions[sub].suscriber_task_handle) &&
-                (manager.subscriptions[sub].data_read == false))
-            {
-                adjust_queue = false;
-            }
+            s->stats.lag_max = s->stats.lag;
         }
 
-        if (adjust_queue == true)
+#ifdef FREERTOS_AWARE
+        //inform the subscriber once about the block at its cursor
+        if ((pending >= (int32_t)manager.fill_level) && !s->notified)
         {
-            // now adjust the queue by fill level
-            // considering reader has read all data till fill level
-            manager.head += manager.fill_level;
+            s->notified = true;
 
-            //move the buffer to front by amount data already read
-            if (manager.head >0)
+            if (run_from_isr)
             {
-                uint32_t sz = (manager.tail - manager.head);
-
-                //move the buffer for new data
-                memcpy(manager.buffer, (manager.buffer + manager.head), sz);
-
-                manager.tail = sz;
-
-                manager.head = 0;
+                BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
+                vTaskNotifyGiveFromISR(s->suscriber_task_handle, &xHigherPriorityTaskWoken);
 
+                /* Context switch needed? */
+                portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
             }
-            for (int sub = 1; sub <= ACTIVE_SUBSCRIPTION_UB; sub++)
+            else
             {
-
-                if (manager.subscriptions[sub].data_read == true )
-                {
-                    manager.subscriptions[sub].data_read = false;
-                }
+                xTaskNotifyGive(s->suscriber_task_handle);
             }
-
         }
-
 #else
-        //now inform all subscribers about available data
-        for (int sub = 1; sub <= ACTIVE_SUBSCRIPTION_UB; sub++)
+        //deliver all complete blocks, a wrapped block is delivered in two calls
+        while (radar_data_manager_pending(s) >= (int32_t)manager.fill_level)
         {
-            if (NULL != manager.subscriptions[sub])
+            radar_data_span_s spans[2];
+
+            radar_data_manager_get_spans(s, spans);
+
+            s->cb(spans[0].data, spans[0].size);
+
+            if (spans[1].size > 0)
             {
-                manager.subscriptions[sub](manager.buffer + manager.head, manager.fill_level);
+                s->cb(spans[1].data, spans[1].size);
             }
+
+            s->consumed += manager.fill_level;
+            s->stats.blocks_read++;
+            manager.cursors_moved = true;
         }
+#endif
+    }
+}
 
-        // now adjust the queue
-        manager.head += manager.fill_level;
 
-        //move the buffer to front by amount data already read
-        if (manager.head >0)
-        {
-            uint32_t sz = (manager.tail - manager.head);
+#ifdef FREERTOS_AWARE
+
+/*
+ * read from RDM data buffer as up to two spans
+ */
+int32_t
+radar_data_manager_read_buffer_spans(int32_t subscription_id, radar_data_span_s spans[2])
+{
+    int32_t result = 0;
 
-            //move the buffer for new data
-            memcpy(manager.buffer, (manager.buffer + manager.head), sz);
+    if ((subscription_id <= 0) || (subscription_id > ACTIVE_SUBSCRIPTION_UB) || (NULL == spans))
+    {
+        return -1;
+    }
+
+    if (!radar_data_manager_is_subscribed(subscription_id))
+    {
+        return -2;
+    }
 
-            manager.tail = sz;
+    subscribers_task_lists_s *s = &manager.subscriptions[subscription_id];
 
-            manager.head = 0;
+    //run() may be called from the radar ISR, keep the cursor and tail consistent
+    taskENTER_CRITICAL();
 
+    s->reading = true;
 
+    if (s->policy == RDM_POLICY_LATEST_ONLY)
+    {
+        //skip to the newest complete block
+        while (radar_data_manager_pending(s) >= (int32_t)(2 * manager.fill_level))
+        {
+            s->consumed += manager.fill_level;
+            s->stats.blocks_dropped++;
+            manager.cursors_moved = true;
         }
+    }
 
+    int32_t pending = radar_data_manager_pending(s);
 
+    s->stats.lag = (pending > 0) ? (uint32_t)pending : 0;
 
-#endif
-
+    if (pending < (int32_t)manager.fill_level)
+    {
+        s->reading = false;
+        result = -2;
     }
-    //finally validate the head and tail of queue
-    if ((manager.tail == manager.buff_size) && (manager.head == manager.tail))
+    else
     {
-        manager.tail = 0;
-        manager.head = 0;
-        manager.samples = 0;
-
-        //reset the buffer
-        memset((void*)manager.buffer,0,manager.buff_size);
-
+        radar_data_manager_get_spans(s, spans);
     }
 
-}
-
+    taskEXIT_CRITICAL();
 
-#ifdef FREERTOS_AWARE
+    return result;
+}
 
 /*
  * read from RDM data buffer
@@ -380,28 +567,33 @@ radar_data_manager_run()
 int32_t
 radar_data_manager_read_buffer(int32_t subscription_id, uint16_t **data_ptr, uint32_t *size)
 {
+    radar_data_span_s spans[2];
+
     if ((subscription_id <= 0) || (subscription_id > ACTIVE_SUBSCRIPTION_UB))
     {
         return -1;
     }
 
-    if (manager.samples < manager.fill_level)
-    {
-        return -2;
-    }
-
-    if (NULL != manager.subscriptions[subscription_id].suscriber_task_handle)
-    {
-        *data_ptr = (uint16_t*) (manager.buffer + manager.head);
+    bool was_reading = manager.subscriptions[subscription_id].reading;
 
-        *size = (manager.fill_level);
+    int32_t result = radar_data_manager_read_buffer_spans(subscription_id, spans);
 
+    if (0 != result)
+    {
+        return result;
     }
-    else
+
+    //the data wraps around the end of the buffer, it is not contiguous
+    if (spans[1].size > 0)
     {
+        manager.subscriptions[subscription_id].reading = was_reading;
         return -2;
     }
 
+    *data_ptr = spans[0].data;
+
+    *size = spans[0].size;
+
     return 0;
 }
 
@@ -411,13 +603,35 @@ radar_data_manager_read_buffer(int32_t subscription_id, uint16_t **data_ptr, uin
 void
 radar_data_manager_ack_data_read(int32_t subscription_id)
 {
-    if ((subscription_id <= 0) || (subscription_id > ACTIVE_SUBSCRIPTION_UB))
+    if ((subscription_id <= 0) || (subscription_id > ACTIVE_SUBSCRIPTION_UB) ||
+        !radar_data_manager_is_subscribed(subscription_id))
     {
         return;
     }
 
-    manager.subscriptions[subscription_id].data_read = true;
+    subscribers_task_lists_s *s = &manager.subscriptions[subscription_id];
+    bool notify = false;
 
+    taskENTER_CRITICAL();
+
+    if (s->reading)
+    {
+        s->consumed += manager.fill_level;
+        s->stats.blocks_read++;
+        s->reading = false;
+        manager.cursors_moved = true;
+    }
+
+    //more blocks may have been queued while this one was read
+    s->notified = (radar_data_manager_pending(s) >= (int32_t)manager.fill_level);
+    notify = s->notified;
+
+    taskEXIT_CRITICAL();
+
+    if (notify)
+    {
+        xTaskNotifyGive(s->suscriber_task_handle);
+    }
 }
 
 #endif
@@ -505,9 +719,12 @@ radar_data_manager_init(radar_data_manager_s* mgr_interface, uint32_t buffer_siz
 
     manager.subscribers = 0;
 
-    manager.head = 0;
     manager.tail = 0;
 
+    manager.written = 0;
+
+    manager.cursors_moved = false;
+
     mgr_interface->subscribe = radar_data_manager_subscribe;
 
     mgr_interface->unsubscribe = radar_data_manager_unsubscribe;
@@ -520,6 +737,12 @@ radar_data_manager_init(radar_data_manager_s* mgr_interface, uint32_t buffer_siz
 
     mgr_interface->read_from_buffer = radar_data_manager_read_buffer;
 
+    mgr_interface->read_from_buffer_spans = radar_data_manager_read_buffer_spans;
+
+    mgr_interface->set_policy = radar_data_manager_set_policy;
+
+    mgr_interface->get_subscriber_stats = radar_data_manager_get_stats;
+
     mgr_interface->ack_data_read = radar_data_manager_ack_data_read;
 
     manager_interface = mgr_interface;
@@ -84,6 +84,52 @@ typedef enum
 typedef void (*cb_radar_data_event)(void* data_ptr, uint32_t size);
 
 
+/*
+ * @def enum radar_data_policy_e
+ * What happens when a subscriber falls behind the radar data stream.
+ * Every subscriber has its own read cursor, so only blocking subscribers can hold up the stream.
+ */
+typedef enum
+{
+    RDM_POLICY_BLOCK = 0, /*<< default: data is kept until the subscriber has read it, a full buffer stops reading from the radar*/
+    RDM_POLICY_DROP_OLDEST = 1, /*<< the oldest unread blocks are dropped when the buffer runs out of space*/
+    RDM_POLICY_LATEST_ONLY = 2 /*<< like drop oldest, and each read skips to the newest complete block*/
+
+}radar_data_policy_e;
+
+
+/*
+ * @typedef typedef struct radar_data_subscriber_stats_s
+ * Per-subscriber counters, see \ref get_subscriber_stats.
+ */
+typedef struct {
+
+    uint32_t blocks_read; /*<< blocks acknowledged by the subscriber*/
+
+    uint32_t blocks_dropped; /*<< overruns: blocks skipped because of the subscriber's policy*/
+
+    uint32_t lag; /*<< bytes written but not yet read by the subscriber*/
+
+    uint32_t lag_max; /*<< largest lag seen*/
+
+    uint32_t writer_stalls; /*<< runs that could not read from the radar because this subscriber held the oldest data*/
+
+}radar_data_subscriber_stats_s;
+
+
+/*
+ * @typedef typedef struct radar_data_span_s
+ * Contiguous part of the radar data in the RDM ring buffer.
+ */
+typedef struct {
+
+    uint16_t *data; /*<< start of the span inside the RDM buffer*/
+
+    uint32_t size; /*<< size of the span in bytes, zero for an unused span*/
+
+}radar_data_span_s;
+
+
 /*
  * @typedef typedef struct  radar_data_manager_s
  * Radar Data Manager (RDM) interface .
@@ -116,7 +162,8 @@ int32_t (*in_read_radar_data) (uint16_t* data, uint32_t *num_samples, uint32_t s
  *
  * The radar data consumer tasks can register themselves before going to sleep through this
  * interface. Once the sufficient radar data is available the consumer task will be notified
- * by RDM
+ * by RDM. A new subscriber starts reading with the next block (fill level) of the stream,
+ * with the \ref RDM_POLICY_BLOCK policy.
  *
  * @param[in] subscriber_task FREERTOS task handle to the subscriber task
  *
@@ -144,15 +191,35 @@ int32_t (*subscribe)(TaskHandle_t subscriber_task);
  * @return function shall return zero (0) on successful completion of the readout of data.
  *         in case the parameters supplied are not valid it shall return -1 and in case if
  *         operation cannot be complete it shall return -2
+ * @note The internal buffer is a ring buffer. If the data wraps around its end, -2 is returned;
+ *       use \ref read_from_buffer_spans instead, or a buffer size that is a multiple of the fill level.
  */
 int32_t (*read_from_buffer)(int32_t subscription_id, uint16_t **data_ptr, uint32_t *size);
 
+/** @brief Provided interface:Read radar data from buffer without copying
+ *
+ * Same as \ref read_from_buffer, but returns the fill level worth of data as up to two spans
+ * of the internal ring buffer: the data up to the end of the buffer, and the remainder
+ * from its start. spans[1].size is zero if the data does not wrap around.
+ * The spans stay valid until the subscriber acknowledges the read with \ref ack_data_read.
+ *
+ * @param[in] subscription_id subscription id of the subscriber. This ID is provided by RDM on successful subscription
+ * @param[out] spans the two parts of the available data, in order
+ *
+ * @return function shall return zero (0) on successful completion of the readout of data.
+ *         in case the parameters supplied are not valid it shall return -1 and in case if
+ *         operation cannot be complete it shall return -2
+ */
+int32_t (*read_from_buffer_spans)(int32_t subscription_id, radar_data_span_s spans[2]);
+
 /** @brief Provided interface:Acknowledge to RDM that the subscriber has read the data from buffer
  *
  * Subscriber task shall notify RDM by calling this function, that it has finished reading the data from buffer
- * Once all subscribers finish reading data, RDM would then manage the internal queue accordingly.
- * @note The old data in the buffer will persist until all subscribers acknowledge their respective data reads
- *          However on arrival of new data
+ * This advances the subscriber's read cursor by the fill level. If another block is already available, the
+ * subscriber is notified again right away.
+ * @note Every subscriber reads at its own pace. The old data in the buffer persists until all blocking
+ *          subscribers acknowledge their respective data reads, see \ref set_policy. A block that was read
+ *          but not acknowledged is never dropped, so non-blocking subscribers shall acknowledge promptly.
  * @param[in] subscription_id subscribers' identifier
  *
  * @return Nothing
@@ -165,7 +232,7 @@ void (*ack_data_read)(int32_t subscription_id);
  * data reception ISR.
  * This function reads the available radar data by calling <b>in_read_radar_data</b> supplied interface
  * Manages the radar data buffering, and wakes up /notifies subscribers tasks when required amount of data
- * is available in buffer.
+ * is available in buffer. Each subscriber is notified once per block at its read cursor.
  *
  * @param[in] run_from_isr to be set to true if this function is being called from ISR, false otherwise.
  *
@@ -173,6 +240,28 @@ void (*ack_data_read)(int32_t subscription_id);
  */
 void (*run)(bool run_from_isr);
 
+/** @brief Provided interface:Set the overrun policy of a subscriber
+ *
+ * Subscribers start with \ref RDM_POLICY_BLOCK. A consumer that must not slow down the stream,
+ * e.g. logging or telemetry, can use \ref RDM_POLICY_DROP_OLDEST or \ref RDM_POLICY_LATEST_ONLY.
+ * Dropping needs a buffer of at least two blocks (fill levels).
+ *
+ * @param[in] subscription_id subscription id of the subscriber
+ * @param[in] policy one of \ref radar_data_policy_e
+ *
+ * @return zero (0) on success, -1 if the parameters are not valid, -2 if the subscription does not exist
+ */
+int32_t (*set_policy)(int32_t subscription_id, radar_data_policy_e policy);
+
+/** @brief Provided interface:Get the lag and overrun counters of a subscriber
+ *
+ * @param[in] subscription_id subscription id of the subscriber
+ * @param[out] stats the subscriber's counters
+ *
+ * @return zero (0) on success, -1 if the parameters are not valid, -2 if the subscription does not exist
+ */
+int32_t (*get_subscriber_stats)(int32_t subscription_id, radar_data_subscriber_stats_s *stats);
+
 /** @brief Provided interface:Un-subscribe to radar data buffer
  *
  * The radar data consumers can de-register themselves from radar data ready notifications.
@@ -240,7 +329,8 @@ void radar_data_manager_set_malloc_free(void* (*malloc_func)(size_t size),
  * and expects the provision of expected interfaces during the initialization.
  *
  * @param[in,out] manager manager interface type.
- * @param[in] buffer_size size of the buffer to be allocated by RDM in bytes
+ * @param[in] buffer_size size of the buffer to be allocated by RDM in bytes. With a multiple of
+ *   fill_level the data handed to subscribers never wraps around the end of the ring buffer.
  * @param[in] fill_level amount of data to be filled in buffer before RDM issues notifications
  *   to its consumer
  *
@@ -53,6 +53,8 @@
 #include "cybsp.h"
 #include "cy_pdl.h"
 #include "cy_ipc_pipe.h"
+#include "ipc_result_ring.h"
+#include "ipc_detection_window.h"
 
 /*******************************************************************************
 * Macros
@@ -69,7 +71,8 @@
 /* IPC Pipe Endpoint-1 config */
 #define CY_IPC_CYPIPE_CHAN_MASK_EP1     CY_IPC_CH_MASK(CY_IPC_CHAN_CYPIPE_EP1)
 #define CY_IPC_CYPIPE_INTR_MASK_EP1     CY_IPC_INTR_MASK(CY_IPC_INTR_CYPIPE_EP1)
-#define CY_IPC_INTR_CYPIPE_PRIOR_EP1    (1UL)
+/* Not above configMAX_SYSCALL_INTERRUPT_PRIORITY of CM33, so the callbacks can notify tasks */
+#define CY_IPC_INTR_CYPIPE_PRIOR_EP1    (2UL)
 #define CY_IPC_INTR_CYPIPE_MUX_EP1      (CY_IPC0_INTR_MUX(CY_IPC_INTR_CYPIPE_EP1))
 #define CM33_IPC_PIPE_EP_ADDR           (1UL)
 #define CM33_IPC_PIPE_CLIENT_ID         (3UL)
@@ -89,21 +92,59 @@
 * Enumeration
 *******************************************************************************/
 
-/* The actual payload being sent via IPC. This will vary between applications */
-typedef struct {
-    uint32_t    label_id;
-    char        label[256];
-} ipc_payload_t;
-
 /* IPC Message structure */
-/* Pointer to this structure will be shared through IPC Pipe */
+/* Pointer to this structure will be shared through IPC Pipe. It is only a doorbell:
+   the results themselves are passed through the ring it points to (see ipc_result_ring.h) */
 typedef struct
 {
-    uint8_t         client_id; /* This must be a part of the IPC structure */
-    uint16_t        intr_mask; /* This must be a part of the IPC structure */
-    ipc_payload_t   payload;
+    uint8_t             client_id; /* This must be a part of the IPC structure */
+    uint16_t            intr_mask; /* This must be a part of the IPC structure */
+    ipc_result_ring_t*  ring;
+    ipc_label_table_t*  labels;
 } ipc_msg_t;
 
+/* Control requests from CM33 to CM55. They are applied by the model task on CM55 */
+typedef enum
+{
+    IPC_CONTROL_SET_SENSITIVITY = 1,    /* Post-processing of the DEEPCRAFT model, see PP_config_t */
+    IPC_CONTROL_RESET_SENSITIVITY,      /* Back to the model's default post-processing */
+    IPC_CONTROL_ENABLE_MODEL,           /* Run or pause inference */
+    IPC_CONTROL_SET_MIN_RANGE_BIN       /* Radar range bins below this are ignored */
+} ipc_control_command_e;
+
+typedef enum
+{
+    IPC_CONTROL_STATUS_OK = 0,
+    IPC_CONTROL_STATUS_UNSUPPORTED,     /* The running model does not support the command */
+    IPC_CONTROL_STATUS_INVALID,         /* The model rejected the arguments */
+    IPC_CONTROL_STATUS_BUSY,            /* The previous request has not been applied yet */
+    IPC_CONTROL_STATUS_TIMEOUT          /* CM55 did not respond */
+} ipc_control_status_e;
+
+typedef struct
+{
+    uint8_t     command;                /* ipc_control_command_e */
+    uint8_t     enabled;                /* IPC_CONTROL_ENABLE_MODEL */
+    uint16_t    min_range_bin;          /* IPC_CONTROL_SET_MIN_RANGE_BIN */
+    /* IPC_CONTROL_SET_SENSITIVITY, same meaning as the PP_config_t fields */
+    float       confidence;
+    uint8_t     average;
+    uint8_t     subsequent;
+    uint8_t     pool;
+    uint8_t     pool_selection;
+} ipc_control_request_t;
+
+/* Control message, sent from CM33 to CM55 through the pipe. CM55 writes the response back into it */
+typedef struct __attribute__((aligned(IPC_RESULT_RING_LINE)))
+{
+    uint8_t                 client_id; /* This must be a part of the IPC structure */
+    uint16_t                intr_mask; /* This must be a part of the IPC structure */
+    uint32_t                request_id;
+    ipc_control_request_t   request;
+    /* request_id << 8 | ipc_control_status_e, written at once when the request was handled */
+    volatile uint32_t       response;
+} ipc_control_msg_t;
+
 /*******************************************************************************
 * Function prototypes
 *******************************************************************************/
@@ -122,8 +163,41 @@ void cm33_ipc_safe_copy_last_payload(ipc_payload_t* target);
    */
 bool cm33_ipc_safe_get_and_clear_cached_detection(ipc_payload_t* target);
 
+/* Called from the IPC interrupt for every result received, after the cached results above
+   are updated. Keep it short. Only the FromISR FreeRTOS APIs may be called from it. */
+typedef void (*cm33_ipc_result_handler_t)(const ipc_payload_t* payload);
+void cm33_ipc_set_result_handler(cm33_ipc_result_handler_t handler);
+
+/* Label of a result received from CM55, resolved with the label table CM55 sent at startup */
+const char* cm33_ipc_get_label(const ipc_payload_t* payload);
+
+/* Takes the per-label detection counts and times aggregated since the previous
+   call and starts a new window. Returns true if the window has a detection. */
+bool cm33_ipc_take_detection_window(ipc_detection_window_t* target);
+
+/* Summary of a window taken above with the label names, see ipc_detection_window_format() */
+int cm33_ipc_format_detection_window(const ipc_detection_window_t* window, char* buf, size_t size);
+
+/* Sends a control request to CM55 and waits up to timeout_ms for it to be applied.
+   Must not be called from more than one task at a time. */
+ipc_control_status_e cm33_ipc_send_control(const ipc_control_request_t* request, uint32_t timeout_ms);
+
+/* Result ring counters: published, dropped (ring full) and doorbells from CM55 and received by CM33 */
+void cm33_ipc_get_stats(ipc_result_stats_t* stats);
+
 /* App functions for cm55 */
-ipc_payload_t* cm55_ipc_get_payload_ptr(void);
-void cm55_ipc_send_to_cm33(void);
+/* Sets the model and its labels. Call once before the first cm55_ipc_send_to_cm33() */
+void cm55_ipc_set_labels(ipc_model_id_e model_id, const char* const* labels, uint32_t num_labels);
+
+/* Takes the pending control request from CM33, if any. The model task calls this when it is
+   safe to reconfigure the model, applies the request and then calls
+   cm55_ipc_complete_control_request() with the outcome. */
+bool cm55_ipc_get_control_request(ipc_control_request_t* request);
+void cm55_ipc_complete_control_request(ipc_control_status_e status);
+
+/* Queues a copy of the payload for CM33, with the model id and the next sequence number
+   filled in. Safe to call from several tasks.
+   Returns false if the result ring was full and the payload was dropped. */
+bool cm55_ipc_send_to_cm33(ipc_payload_t* payload);
 
 #endif /* SOURCE_IPC_COMMUNICATION_H */
@@ -0,0 +1,93 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Aggregate of the results received from CM55 over one reporting window.
+ *
+ * For every label the window keeps the number of detections and the CM55 timestamps of the
+ * first and the last one, so several detections, also of different classes, between two
+ * telemetry messages are all reported. Results with label_id 0 are counted as results but are
+ * not detections. No score is kept: the DEEPCRAFT models only give a 0/1 trigger flag per
+ * class, so the score of a detection is always 1.
+ *
+ * The window belongs to one model. A result from another model starts the window over.
+ */
+
+#ifndef IPC_DETECTION_WINDOW_H
+#define IPC_DETECTION_WINDOW_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ipc_result_ring.h"
+
+typedef struct {
+    uint32_t    count;                  /* Detections of the label */
+    uint32_t    first_ms;               /* CM55 timestamp of the first detection */
+    uint32_t    last_ms;                /* CM55 timestamp of the last detection */
+} ipc_label_window_t;
+
+typedef struct {
+    uint8_t             model_id;
+    uint32_t            results;        /* All results, with or without a detection */
+    uint32_t            detections;
+    uint32_t            first_ms;       /* CM55 timestamps of the first and the last result */
+    uint32_t            last_ms;
+    ipc_payload_t       last_detection; /* Valid if detections is not 0 */
+    ipc_label_window_t  labels[IPC_MAX_CLASSES];
+} ipc_detection_window_t;
+
+static inline void ipc_detection_window_reset(ipc_detection_window_t *window) {
+    memset(window, 0, sizeof(*window));
+}
+
+static inline void ipc_detection_window_add(ipc_detection_window_t *window, const ipc_payload_t *payload) {
+    if (window->results != 0 && payload->model_id != window->model_id) {
+        ipc_detection_window_reset(window);
+    }
+    if (0 == window->results) {
+        window->model_id = payload->model_id;
+        window->first_ms = payload->timestamp_ms;
+    }
+    window->results++;
+    window->last_ms = payload->timestamp_ms;
+
+    if (0 == payload->label_id || payload->label_id >= IPC_MAX_CLASSES) {
+        return;
+    }
+    ipc_label_window_t *label = &window->labels[payload->label_id];
+    if (0 == label->count) {
+        label->first_ms = payload->timestamp_ms;
+    }
+    label->count++;
+    label->last_ms = payload->timestamp_ms;
+    window->detections++;
+    memcpy(&window->last_detection, payload, sizeof(*payload));
+}
+
+/* Writes "label:count:first:last" for every detected label, separated by commas, with
+   first and last in milliseconds from the first result of the window. Returns the length the
+   text would have, like snprintf(). */
+static inline int ipc_detection_window_format(const ipc_detection_window_t *window, const ipc_label_table_t *table,
+        char *buf, size_t size) {
+    int len = 0;
+    if (size > 0) {
+        buf[0] = '\0';
+    }
+    for (uint32_t i = 1; i < IPC_MAX_CLASSES; i++) {
+        const ipc_label_window_t *label = &window->labels[i];
+        if (0 == label->count) {
+            continue;
+        }
+        size_t offset = ((size_t) len < size) ? (size_t) len : size;
+        len += snprintf(buf + offset, size - offset, "%s%s:%lu:%lu:%lu", (len > 0) ? "," : "",
+            ipc_label_table_get_name(table, window->model_id, (uint8_t) i), (unsigned long) label->count,
+            (unsigned long) (label->first_ms - window->first_ms), (unsigned long) (label->last_ms - window->first_ms));
+    }
+    return len;
+}
+
+#endif /* IPC_DETECTION_WINDOW_H */
@@ -0,0 +1,233 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2025 Avnet
+ * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
+ */
+
+/* Single producer (CM55) / single consumer (CM33) ring of inference results in shared memory.
+ *
+ * The producer copies each result into the next free record and then publishes it by advancing
+ * head, so the consumer never sees a record that is still being written, and a result is never
+ * overwritten before it has been read. When the ring is full the new result is dropped and counted
+ * instead. head and tail are free running counters, each written by one side only and kept in its
+ * own cache line, so no lock is needed between the cores.
+ *
+ * Records are a fixed 32 bytes, one cache line, and carry no strings: labels are resolved on CM33
+ * from an ipc_label_table_t that CM55 provides once at startup.
+ *
+ * ipc_result_ring_push() reports whether the ring was empty before the push. Only then does the
+ * consumer need an IPC doorbell, because it drains the ring until it is empty on every doorbell.
+ */
+
+#ifndef IPC_RESULT_RING_H
+#define IPC_RESULT_RING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Number of records, must be a power of two */
+#ifndef IPC_RESULT_RING_SIZE
+#define IPC_RESULT_RING_SIZE            (32UL)
+#endif
+
+#if (IPC_RESULT_RING_SIZE & (IPC_RESULT_RING_SIZE - 1UL)) != 0
+#error "IPC_RESULT_RING_SIZE must be a power of two"
+#endif
+
+/* D-cache line size of the CM55 */
+#define IPC_RESULT_RING_LINE            (32UL)
+
+/* The ring is not necessarily in non-cacheable memory, so the producer cleans what it writes
+ * and invalidates what the other core writes. This compiles out on cores without a D-cache. */
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+#define IPC_RESULT_RING_CLEAN(addr, size)       SCB_CleanDCache_by_Addr((volatile void *) (addr), (int32_t) (size))
+#define IPC_RESULT_RING_INVALIDATE(addr, size)  SCB_InvalidateDCache_by_Addr((volatile void *) (addr), (int32_t) (size))
+#else
+#define IPC_RESULT_RING_CLEAN(addr, size)       ((void) (addr), (void) (size))
+#define IPC_RESULT_RING_INVALIDATE(addr, size)  ((void) (addr), (void) (size))
+#endif
+
+#if defined(__ARM_ARCH)
+#define IPC_RESULT_RING_BARRIER()       __DMB()
+#else
+#define IPC_RESULT_RING_BARRIER()       __sync_synchronize()
+#endif
+
+/* Largest number of classes of the supported models and longest label, including the terminator */
+#define IPC_MAX_CLASSES                 (10U)
+#define IPC_LABEL_LEN                   (24U)
+
+/* Model that produced the results */
+typedef enum {
+    IPC_MODEL_NONE = 0,                 /* IPC test task */
+    IPC_MODEL_COUGH,
+    IPC_MODEL_BABYCRY,
+    IPC_MODEL_ALARM,
+    IPC_MODEL_GESTURE,
+    IPC_MODEL_FALL_DETECTION,
+    IPC_MODEL_DIRECTION_OF_ARRIVAL,
+    IPC_MODEL_MOTION_ORIENTATION
+} ipc_model_id_e;
+
+/* One inference result. This will vary between applications */
+typedef struct {
+    uint8_t     model_id;               /* ipc_model_id_e, filled in when sending */
+    uint8_t     label_id;               /* Index into the label table, 0 is no detection */
+    uint8_t     num_scores;             /* Valid entries of scores, 0 if the model has none */
+    uint8_t     reserved;
+    uint32_t    sequence;               /* Result number, filled in when sending. Gaps are drops */
+    uint32_t    timestamp_ms;           /* CM55 time the input was captured */
+    int16_t     scores[IPC_MAX_CLASSES]; /* Per-class model output */
+} ipc_payload_t;
+
+_Static_assert(sizeof(ipc_payload_t) == IPC_RESULT_RING_LINE, "ipc_payload_t must fill one cache line");
+
+/* Labels of the running model, sent once at startup */
+typedef struct {
+    uint8_t     model_id;
+    uint8_t     num_labels;
+    uint8_t     reserved[2];
+    char        labels[IPC_MAX_CLASSES][IPC_LABEL_LEN];
+} ipc_label_table_t;
+
+static inline void ipc_label_table_init(ipc_label_table_t *table, uint8_t model_id, const char *const *labels, uint32_t num_labels) {
+    memset(table, 0, sizeof(*table));
+    table->model_id = model_id;
+    table->num_labels = (uint8_t) (num_labels < IPC_MAX_CLASSES ? num_labels : IPC_MAX_CLASSES);
+    for (uint32_t i = 0; i < table->num_labels; i++) {
+        strncpy(table->labels[i], labels[i], IPC_LABEL_LEN - 1);
+    }
+}
+
+/* Label of a model's label id, or "unknown" if the table does not have it */
+static inline const char *ipc_label_table_get_name(const ipc_label_table_t *table, uint8_t model_id, uint8_t label_id) {
+    if (model_id != table->model_id || label_id >= table->num_labels) {
+        return "unknown";
+    }
+    return table->labels[label_id];
+}
+
+/* Label of a result, or "unknown" if the table does not have it */
+static inline const char *ipc_label_table_get(const ipc_label_table_t *table, const ipc_payload_t *payload) {
+    return ipc_label_table_get_name(table, payload->model_id, payload->label_id);
+}
+
+/* Copies the per-class model output into the result, saturated to int16_t */
+static inline void ipc_payload_set_scores(ipc_payload_t *payload, const int *scores, uint32_t count) {
+    if (count > IPC_MAX_CLASSES) {
+        count = IPC_MAX_CLASSES;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        int score = scores[i];
+        payload->scores[i] = (int16_t) (score > INT16_MAX ? INT16_MAX : (score < INT16_MIN ? INT16_MIN : score));
+    }
+    payload->num_scores = (uint8_t) count;
+}
+
+typedef struct __attribute__((aligned(IPC_RESULT_RING_LINE))) {
+    /* Written by the producer only */
+    volatile uint32_t head;         /* Records published */
+    volatile uint32_t dropped;      /* Records dropped because the ring was full */
+    volatile uint32_t doorbells;    /* Doorbells sent to the consumer */
+    uint8_t           reserved0[IPC_RESULT_RING_LINE - 3 * sizeof(uint32_t)];
+
+    /* Written by the consumer only */
+    volatile uint32_t tail;         /* Records consumed */
+    uint8_t           reserved1[IPC_RESULT_RING_LINE - sizeof(uint32_t)];
+
+    ipc_payload_t     records[IPC_RESULT_RING_SIZE];
+} ipc_result_ring_t;
+
+typedef enum {
+    IPC_RESULT_RING_PUSHED,         /* Published, the consumer has not drained the ring yet */
+    IPC_RESULT_RING_PUSHED_WAKE,    /* Published into an empty ring, ring the doorbell */
+    IPC_RESULT_RING_FULL            /* Dropped and counted */
+} ipc_result_ring_push_e;
+
+/* Counters of the producer and the consumer side */
+typedef struct {
+    uint32_t published;
+    uint32_t dropped;
+    uint32_t doorbells;
+    uint32_t received;
+} ipc_result_stats_t;
+
+/* Producer only, before the consumer is told about the ring */
+static inline void ipc_result_ring_init(ipc_result_ring_t *ring) {
+    memset((void *) ring, 0, sizeof(*ring));
+    IPC_RESULT_RING_CLEAN(ring, sizeof(*ring));
+}
+
+/* Producer only */
+static inline ipc_result_ring_push_e ipc_result_ring_push(ipc_result_ring_t *ring, const ipc_payload_t *record) {
+    uint32_t head = ring->head;
+
+    IPC_RESULT_RING_INVALIDATE(&ring->tail, IPC_RESULT_RING_LINE);
+    if (head - ring->tail >= IPC_RESULT_RING_SIZE) {
+        ring->dropped++;
+        IPC_RESULT_RING_CLEAN(&ring->head, IPC_RESULT_RING_LINE);
+        return IPC_RESULT_RING_FULL;
+    }
+
+    ipc_payload_t *slot = &ring->records[head & (IPC_RESULT_RING_SIZE - 1UL)];
+    memcpy(slot, record, sizeof(*slot));
+    IPC_RESULT_RING_CLEAN(slot, sizeof(*slot));
+
+    // The record must be visible before the head that publishes it
+    IPC_RESULT_RING_BARRIER();
+    ring->head = head + 1;
+    IPC_RESULT_RING_CLEAN(&ring->head, IPC_RESULT_RING_LINE);
+
+    // Publishing head must be ordered before reading tail, else the consumer may go to sleep
+    // after draining up to head while we see a stale tail and skip the doorbell
+    IPC_RESULT_RING_BARRIER();
+    IPC_RESULT_RING_INVALIDATE(&ring->tail, IPC_RESULT_RING_LINE);
+    return (ring->tail == head) ? IPC_RESULT_RING_PUSHED_WAKE : IPC_RESULT_RING_PUSHED;
+}
+
+/* Producer only. Counts a doorbell that was sent */
+static inline void ipc_result_ring_count_doorbell(ipc_result_ring_t *ring) {
+    ring->doorbells++;
+    IPC_RESULT_RING_CLEAN(&ring->head, IPC_RESULT_RING_LINE);
+}
+
+/* Producer only. Whether the consumer has not drained the ring yet */
+static inline bool ipc_result_ring_has_records(ipc_result_ring_t *ring) {
+    IPC_RESULT_RING_INVALIDATE(&ring->tail, IPC_RESULT_RING_LINE);
+    return ring->tail != ring->head;
+}
+
+/* Consumer only. Copies out the oldest record, returns false if the ring is empty */
+static inline bool ipc_result_ring_pop(ipc_result_ring_t *ring, ipc_payload_t *record) {
+    uint32_t tail = ring->tail;
+
+    IPC_RESULT_RING_INVALIDATE(&ring->head, IPC_RESULT_RING_LINE);
+    if (ring->head == tail) {
+        return false;
+    }
+
+    // Read the record only after head says it is complete
+    IPC_RESULT_RING_BARRIER();
+    const ipc_payload_t *slot = &ring->records[tail & (IPC_RESULT_RING_SIZE - 1UL)];
+    IPC_RESULT_RING_INVALIDATE(slot, sizeof(*slot));
+    memcpy(record, slot, sizeof(*record));
+
+    // Finish reading the record before handing the slot back, and publish tail before the
+    // next read of head (see ipc_result_ring_push)
+    IPC_RESULT_RING_BARRIER();
+    ring->tail = tail + 1;
+    IPC_RESULT_RING_CLEAN(&ring->tail, IPC_RESULT_RING_LINE);
+    IPC_RESULT_RING_BARRIER();
+    return true;
+}
+
+/* Either side. received is only known to the consumer and is left at 0 */
+static inline void ipc_result_ring_get_stats(ipc_result_ring_t *ring, ipc_result_stats_t *stats) {
+    IPC_RESULT_RING_INVALIDATE(&ring->head, IPC_RESULT_RING_LINE);
+    stats->published = ring->head;
+    stats->dropped = ring->dropped;
+    stats->doorbells = ring->doorbells;
+    stats->received = 0;
+}
+
+#endif /* IPC_RESULT_RING_H */
@@ -46,6 +46,7 @@
 #include <string.h>
 #include "cybsp.h"
 #include "FreeRTOS.h"
+#include "task.h"
 #include "retarget_io_init.h"
 #include "ipc_communication.h"
 
@@ -65,32 +66,59 @@ CY_SECTION_SHAREDMEM
 // TF-M will initialize the IPC semaphores, so not needed here unless TF-M is not used
 // static uint32_t ipc_sema_array[CY_IPC_SEMA_COUNT / CY_IPC_SEMA_PER_WORD];
 
-/* Local copy of the IPC message received
+/* Local copy of the last payload received
    This copy is not safe to be accessed from a task.
    A task must make its own copy of this structure
-   while guarding the copying with taskENTER_CRITICAL() and taskEXIT_CRITICAL()
+   while guarding the copying with Cy_SysLib_EnterCriticalSection(), which
+   does not depend on the IPC interrupt priority staying within
+   configMAX_SYSCALL_INTERRUPT_PRIORITY.
 */
-static ipc_msg_t ipc_recv_msg = {0};
+static ipc_payload_t ipc_recv_payload = {0};
+static ipc_result_ring_t* ipc_result_ring = NULL; // learned from the first doorbell
+static ipc_label_table_t ipc_label_table = {0}; // copied once from CM55
+static uint32_t ipc_received_count = 0;
+static cm33_ipc_result_handler_t ipc_result_handler = NULL;
 static ipc_payload_t ipc_last_detection_payload = {0};
+static ipc_detection_window_t ipc_detection_window = {0};
 static bool ipc_has_saved_detection = false; // will be set upon receipt. reset when value is checked
 static bool ipc_has_received_message = false; // will be set upon receipt. reset when value is checked
 
+/* Interval at which cm33_ipc_send_control() checks for the response */
+#define IPC_CONTROL_POLL_MS (5)
+
+/* Control request for CM55. CM55 writes the response into it */
+CY_SECTION_SHAREDMEM static ipc_control_msg_t ipc_control_msg;
+
 
 /*******************************************************************************
-* Function Name: cm33_ipc_pipe_isr
+* Function Name: cm33_msg_callback
 ********************************************************************************
-* Callback for receipt of message from cm55
+* Callback for receipt of a doorbell from cm55. CM55 only rings when the result
+* ring was empty, so drain it completely. Detections are latched until a task
+* picks them up, so a detection followed by other results is not lost, and
+* counted per label in the detection window.
 *******************************************************************************/
 static void cm33_msg_callback(uint32_t * msg_data)
 {
     if (msg_data != NULL) {
-        /* Copy the message received into our own copy IPC structure */
-        memcpy(&ipc_recv_msg, (void *) msg_data, sizeof(ipc_recv_msg));
-        if (ipc_recv_msg.payload.label_id != 0) {
-            memcpy(&ipc_last_detection_payload, &ipc_recv_msg.payload, sizeof(ipc_payload_t));
-            ipc_has_saved_detection = true;
+        ipc_msg_t *msg = (ipc_msg_t *) msg_data;
+        ipc_result_ring = msg->ring;
+        while (ipc_result_ring_pop(ipc_result_ring, &ipc_recv_payload)) {
+            if (ipc_recv_payload.model_id != ipc_label_table.model_id || 0 == ipc_label_table.num_labels) {
+                // First result, or CM55 switched models
+                memcpy(&ipc_label_table, msg->labels, sizeof(ipc_label_table));
+            }
+            if (ipc_recv_payload.label_id != 0) {
+                memcpy(&ipc_last_detection_payload, &ipc_recv_payload, sizeof(ipc_payload_t));
+                ipc_has_saved_detection = true;
+            }
+            ipc_detection_window_add(&ipc_detection_window, &ipc_recv_payload);
+            ipc_received_count++;
+            ipc_has_received_message = true;
+            if (ipc_result_handler != NULL) {
+                ipc_result_handler(&ipc_recv_payload);
+            }
         }
-        ipc_has_received_message = true;
     }
 }
 
@@ -180,32 +208,117 @@ void cm33_ipc_communication_setup(void)
 
 bool cm33_ipc_has_received_message(void)
 {
-    taskENTER_CRITICAL();
+    uint32_t intr_status = Cy_SysLib_EnterCriticalSection();
     bool ret = ipc_has_received_message;
     ipc_has_received_message = false;
-    taskEXIT_CRITICAL();
+    Cy_SysLib_ExitCriticalSection(intr_status);
     return ret;
 }
 
 void cm33_ipc_safe_copy_last_payload(ipc_payload_t* target)
 {
-    taskENTER_CRITICAL();
-    memcpy(target, &ipc_recv_msg.payload, sizeof(ipc_payload_t));
-    taskEXIT_CRITICAL();
+    uint32_t intr_status = Cy_SysLib_EnterCriticalSection();
+    memcpy(target, &ipc_recv_payload, sizeof(ipc_payload_t));
+    Cy_SysLib_ExitCriticalSection(intr_status);
 }
 
 bool cm33_ipc_safe_get_and_clear_cached_detection(ipc_payload_t* target)
 {
-    taskENTER_CRITICAL();
+    uint32_t intr_status = Cy_SysLib_EnterCriticalSection();
     if (ipc_has_saved_detection) {
         memcpy(target, &ipc_last_detection_payload, sizeof(ipc_payload_t));
         ipc_has_saved_detection = false;
-        taskEXIT_CRITICAL();
+        Cy_SysLib_ExitCriticalSection(intr_status);
         return true;
     } else { 
         // else use the last payload - it will not have a detection
-        memcpy(target, &ipc_recv_msg.payload, sizeof(ipc_payload_t));
-        taskEXIT_CRITICAL();
+        memcpy(target, &ipc_recv_payload, sizeof(ipc_payload_t));
+        Cy_SysLib_ExitCriticalSection(intr_status);
         return false;
     }
 }
+
+ipc_control_status_e cm33_ipc_send_control(const ipc_control_request_t* request, uint32_t timeout_ms)
+{
+    static uint32_t request_id = 0;
+    const TickType_t start = xTaskGetTickCount();
+    const TickType_t timeout = pdMS_TO_TICKS(timeout_ms);
+    cy_en_ipc_pipe_status_t pipe_status;
+
+    // The response carries the id in its upper 24 bits, 0 is never used
+    request_id = (request_id + 1) & 0x00FFFFFFUL;
+    if (0 == request_id) {
+        request_id = 1;
+    }
+    ipc_control_msg.client_id = CM55_IPC_PIPE_CLIENT_ID;
+    ipc_control_msg.intr_mask = CY_IPC_CYPIPE_INTR_MASK_EP1;
+    ipc_control_msg.request_id = request_id;
+    ipc_control_msg.request = *request;
+    ipc_control_msg.response = 0;
+
+    do {
+        pipe_status = Cy_IPC_Pipe_SendMessage(CM55_IPC_PIPE_EP_ADDR, CM33_IPC_PIPE_EP_ADDR,
+                                              (void *) &ipc_control_msg, NULL);
+        if (CY_IPC_PIPE_ERROR_SEND_BUSY != pipe_status) {
+            break;
+        }
+        vTaskDelay(1); // CM55 has not taken the previous request yet
+    } while ((xTaskGetTickCount() - start) < timeout);
+    if (CY_IPC_PIPE_SUCCESS != pipe_status) {
+        return IPC_CONTROL_STATUS_TIMEOUT;
+    }
+
+    // Applied by the model task at its next frame
+    do {
+        uint32_t response = ipc_control_msg.response;
+        if ((response >> 8) == request_id) {
+            return (ipc_control_status_e) (response & 0xFFUL);
+        }
+        vTaskDelay(pdMS_TO_TICKS(IPC_CONTROL_POLL_MS));
+    } while ((xTaskGetTickCount() - start) < timeout);
+    return IPC_CONTROL_STATUS_TIMEOUT;
+}
+
+void cm33_ipc_set_result_handler(cm33_ipc_result_handler_t handler)
+{
+    ipc_result_handler = handler;
+}
+
+const char* cm33_ipc_get_label(const ipc_payload_t* payload)
+{
+    uint32_t intr_status = Cy_SysLib_EnterCriticalSection();
+    const char* label = ipc_label_table_get(&ipc_label_table, payload);
+    Cy_SysLib_ExitCriticalSection(intr_status);
+    return label;
+}
+
+bool cm33_ipc_take_detection_window(ipc_detection_window_t* target)
+{
+    uint32_t intr_status = Cy_SysLib_EnterCriticalSection();
+    memcpy(target, &ipc_detection_window, sizeof(ipc_detection_window_t));
+    ipc_detection_window_reset(&ipc_detection_window);
+    Cy_SysLib_ExitCriticalSection(intr_status);
+    return target->detections != 0;
+}
+
+int cm33_ipc_format_detection_window(const ipc_detection_window_t* window, char* buf, size_t size)
+{
+    // Format from a copy, to keep the interrupts disabled only briefly
+    ipc_label_table_t table;
+    uint32_t intr_status = Cy_SysLib_EnterCriticalSection();
+    memcpy(&table, &ipc_label_table, sizeof(ipc_label_table_t));
+    Cy_SysLib_ExitCriticalSection(intr_status);
+    return ipc_detection_window_format(window, &table, buf, size);
+}
+
+void cm33_ipc_get_stats(ipc_result_stats_t* stats)
+{
+    uint32_t intr_status = Cy_SysLib_EnterCriticalSection();
+    if (ipc_result_ring != NULL) {
+        ipc_result_ring_get_stats(ipc_result_ring, stats);
+    } else {
+        memset(stats, 0, sizeof(*stats));
+    }
+    stats->received = ipc_received_count;
+    Cy_SysLib_ExitCriticalSection(intr_status);
+}
@@ -44,6 +44,8 @@
  */
 
 #include "ipc_communication.h"
+#include "FreeRTOS.h"
+#include "task.h"
 
 /*******************************************************************************
 * Global Variable(s)
@@ -54,8 +56,25 @@ static cy_stc_ipc_pipe_ep_t cm55_ipc_pipe_array[CY_IPC_MAX_ENDPOINTS];
 /* CB Array for EP2 */
 static cy_ipc_pipe_callback_ptr_t ep2_cb_array[CY_IPC_CYPIPE_CLIENT_CNT];
 
+/* Results and labels for CM33 and the doorbell message that points CM33 to them */
+CY_SECTION_SHAREDMEM static ipc_result_ring_t cm55_result_ring;
+CY_SECTION_SHAREDMEM static ipc_label_table_t cm55_label_table;
 CY_SECTION_SHAREDMEM static ipc_msg_t cm55_msg_data;
 
+/* Set when a doorbell could not be sent because CM33 still held the channel,
+   cleared by the release callback */
+static volatile bool cm55_doorbell_pending = false;
+
+static uint32_t cm55_result_sequence = 0;
+
+/* Control request from CM33, taken over in the pipe ISR and applied by the model task */
+static ipc_control_msg_t* cm55_control_msg = NULL;
+static ipc_control_request_t cm55_control_request;
+static uint32_t cm55_control_request_id = 0;
+static volatile bool cm55_control_pending = false;
+
+static void cm55_doorbell_release_callback(void);
+
 
 __STATIC_INLINE void handle_app_error(void)
 {
@@ -88,6 +107,45 @@ void Cy_SysIpcPipeIsrCm55(void)
 }
 
 
+/*******************************************************************************
+* Function Name: cm55_control_callback
+********************************************************************************
+* Summary:
+*  Callback for a control request from CM33. Keeps a copy of the request for
+*  the model task. A request that arrives while the previous one is still being
+*  applied is answered with IPC_CONTROL_STATUS_BUSY right away.
+*
+* Parameters:
+*  msg_data: the ipc_control_msg_t sent by CM33
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+static void cm55_control_callback(uint32_t * msg_data)
+{
+    ipc_control_msg_t* msg = (ipc_control_msg_t *) msg_data;
+
+    if (msg == NULL)
+    {
+        return;
+    }
+
+    IPC_RESULT_RING_INVALIDATE(msg, sizeof(*msg));
+    if (cm55_control_pending)
+    {
+        msg->response = (msg->request_id << 8) | IPC_CONTROL_STATUS_BUSY;
+        IPC_RESULT_RING_CLEAN(msg, sizeof(*msg));
+        return;
+    }
+
+    cm55_control_msg = msg;
+    cm55_control_request = msg->request;
+    cm55_control_request_id = msg->request_id;
+    cm55_control_pending = true;
+}
+
+
 /*******************************************************************************
 * Function Name: cm55_ipc_communication_setup
 ********************************************************************************
@@ -139,25 +197,211 @@ void cm55_ipc_communication_setup(void)
     Cy_IPC_Pipe_Config(cm55_ipc_pipe_array);
 
     Cy_IPC_Pipe_Init(&cm55_ipc_pipe_config);
+
+    /* Register a callback function to handle control requests from CM33 */
+    if (CY_IPC_PIPE_SUCCESS != Cy_IPC_Pipe_RegisterCallback(CM55_IPC_PIPE_EP_ADDR,
+                                   &cm55_control_callback, (uint32_t) CM55_IPC_PIPE_CLIENT_ID))
+    {
+        handle_app_error();
+    }
+
+    ipc_result_ring_init(&cm55_result_ring);
+    cm55_msg_data.client_id = CM33_IPC_PIPE_CLIENT_ID;
+    cm55_msg_data.intr_mask = CY_IPC_CYPIPE_INTR_MASK_EP2;
+    cm55_msg_data.ring = &cm55_result_ring;
+    cm55_msg_data.labels = &cm55_label_table;
 }
 
 
-ipc_payload_t* cm55_ipc_get_payload_ptr(void)
+/*******************************************************************************
+* Function Name: cm55_ipc_set_labels
+********************************************************************************
+* Summary:
+*  Stores the model id and its labels in shared memory, where CM33 picks them
+*  up with the first result. Results only carry the label index.
+*
+* Parameters:
+*  model_id: model that produces the results
+*  labels: label of each class
+*  num_labels: number of labels, at most IPC_MAX_CLASSES are kept
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void cm55_ipc_set_labels(ipc_model_id_e model_id, const char* const* labels, uint32_t num_labels)
 {
-    return &cm55_msg_data.payload;
+    taskENTER_CRITICAL();
+    ipc_label_table_init(&cm55_label_table, (uint8_t) model_id, labels, num_labels);
+    IPC_RESULT_RING_CLEAN(&cm55_label_table, sizeof(cm55_label_table));
+    taskEXIT_CRITICAL();
 }
 
-void cm55_ipc_send_to_cm33(void)
+
+/*******************************************************************************
+* Function Name: cm55_ipc_get_control_request
+********************************************************************************
+* Summary:
+*  Copies the control request from CM33 that is waiting to be applied. It stays
+*  pending until cm55_ipc_complete_control_request() is called.
+*
+* Parameters:
+*  request: receives the request
+*
+* Return :
+*  true if there is a request to apply
+*
+*******************************************************************************/
+bool cm55_ipc_get_control_request(ipc_control_request_t* request)
 {
-    cy_en_ipc_pipe_status_t pipe_status;
+    if (!cm55_control_pending)
+    {
+        return false;
+    }
 
-    cm55_msg_data.client_id = CM33_IPC_PIPE_CLIENT_ID;
-    cm55_msg_data.intr_mask = CY_IPC_CYPIPE_INTR_MASK_EP2;
+    taskENTER_CRITICAL();
+    *request = cm55_control_request;
+    taskEXIT_CRITICAL();
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: cm55_ipc_complete_control_request
+********************************************************************************
+* Summary:
+*  Reports the outcome of the pending control request back to CM33.
+*
+* Parameters:
+*  status: outcome of the request
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void cm55_ipc_complete_control_request(ipc_control_status_e status)
+{
+    taskENTER_CRITICAL();
+    if (cm55_control_pending)
+    {
+        /* One write, so CM33 never sees the status of another request */
+        cm55_control_msg->response = (cm55_control_request_id << 8) | (uint32_t) status;
+        IPC_RESULT_RING_CLEAN(cm55_control_msg, sizeof(*cm55_control_msg));
+        cm55_control_pending = false;
+    }
+    taskEXIT_CRITICAL();
+}
+
+
+/*******************************************************************************
+* Function Name: cm55_ring_doorbell
+********************************************************************************
+* Summary:
+*  Sends the doorbell message to CM33. If CM33 still holds the channel, the
+*  doorbell is kept pending and sent again from
+*  cm55_doorbell_release_callback() once CM33 releases it. Must be called with
+*  interrupts masked, so that the release cannot come in between.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+static void cm55_ring_doorbell(void)
+{
+    cy_en_ipc_pipe_status_t pipe_status;
 
     pipe_status = Cy_IPC_Pipe_SendMessage(CM33_IPC_PIPE_EP_ADDR,
                              CM55_IPC_PIPE_EP_ADDR,
-                             (void *) &cm55_msg_data, 0);
-    if (CY_IPC_PIPE_SUCCESS != pipe_status) {
+                             (void *) &cm55_msg_data, &cm55_doorbell_release_callback);
+    if (CY_IPC_PIPE_SUCCESS == pipe_status)
+    {
+        ipc_result_ring_count_doorbell(&cm55_result_ring);
+        cm55_doorbell_pending = false;
+    }
+    else if (CY_IPC_PIPE_ERROR_SEND_BUSY == pipe_status)
+    {
+        /* CM33 is still finishing the previous doorbell and may already have
+           drained the ring */
+        cm55_doorbell_pending = true;
+    }
+    else
+    {
         handle_app_error();
     }
-}
\ No newline at end of file
+}
+
+
+/*******************************************************************************
+* Function Name: cm55_doorbell_release_callback
+********************************************************************************
+* Summary:
+*  Called from the pipe ISR when CM33 releases the channel after a doorbell.
+*  Rings again if a doorbell could not be sent meanwhile and CM33 has not
+*  drained the ring since, so that the last results of a burst are not left
+*  in the ring until the next result.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+static void cm55_doorbell_release_callback(void)
+{
+    if (cm55_doorbell_pending)
+    {
+        if (ipc_result_ring_has_records(&cm55_result_ring))
+        {
+            cm55_ring_doorbell();
+        }
+        else
+        {
+            cm55_doorbell_pending = false;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: cm55_ipc_send_to_cm33
+********************************************************************************
+* Summary:
+*  Fills in the model id and the sequence number and queues a copy of the
+*  payload in the shared result ring. CM33 is only
+*  interrupted when the ring was empty, as it drains the whole ring on every
+*  doorbell. A doorbell that finds the channel busy is sent when CM33 releases
+*  it. If the ring is full, the payload is dropped and counted.
+*
+* Parameters:
+*  payload: result to send
+*
+* Return :
+*  true if the payload was queued
+*
+*******************************************************************************/
+bool cm55_ipc_send_to_cm33(ipc_payload_t* payload)
+{
+    ipc_result_ring_push_e push_status;
+    uint32_t intr_status;
+
+    /* Several tasks publish results, keep the ring single producer */
+    taskENTER_CRITICAL();
+    payload->model_id = cm55_label_table.model_id;
+    payload->sequence = cm55_result_sequence++;
+    push_status = ipc_result_ring_push(&cm55_result_ring, payload);
+    if ((IPC_RESULT_RING_PUSHED_WAKE == push_status) || cm55_doorbell_pending)
+    {
+        /* Mask the pipe ISR whatever its priority, so that its release
+           callback sees the outcome of this doorbell */
+        intr_status = Cy_SysLib_EnterCriticalSection();
+        cm55_ring_doorbell();
+        Cy_SysLib_ExitCriticalSection(intr_status);
+    }
+    taskEXIT_CRITICAL();
+
+    return (IPC_RESULT_RING_FULL != push_status);
+}